@@ -44,6 +44,17 @@ defined in linker script */
 .word	_sbss
 /* end address for the .bss section. defined in linker script */
 .word	_ebss
+/* start address for the initialization values of the .ccmram section.
+defined in linker script */
+.word	_siccmram
+/* start address for the .ccmram section. defined in linker script */
+.word	_sccmram
+/* end address for the .ccmram section. defined in linker script */
+.word	_eccmram
+/* start address for the .ccmram_bss section. defined in linker script */
+.word	_sccmram_bss
+/* end address for the .ccmram_bss section. defined in linker script */
+.word	_eccmram_bss
 
 .equ  BootRAM,        0xF1E0F85F
 /**
@@ -95,6 +106,38 @@ FillZerobss:
 LoopFillZerobss:
   cmp r2, r4
   bcc FillZerobss
+
+/* Copy the CCMSRAM code and data from flash */
+  ldr r0, =_sccmram
+  ldr r1, =_eccmram
+  ldr r2, =_siccmram
+  movs r3, #0
+  b	LoopCopyCcmramInit
+
+CopyCcmramInit:
+  ldr r4, [r2, r3]
+  str r4, [r0, r3]
+  adds r3, r3, #4
+
+LoopCopyCcmramInit:
+  adds r4, r0, r3
+  cmp r4, r1
+  bcc CopyCcmramInit
+
+/* Zero fill the CCMSRAM bss segment. */
+  ldr r2, =_sccmram_bss
+  ldr r4, =_eccmram_bss
+  movs r3, #0
+  b LoopFillZeroCcmramBss
+
+FillZeroCcmramBss:
+  str  r3, [r2]
+  adds r2, r2, #4
+
+LoopFillZeroCcmramBss:
+  cmp r2, r4
+  bcc FillZeroCcmramBss
+
 /* Call static constructors */
     bl __libc_init_array
 /* Call the application's entry point.*/
@@ -4,7 +4,9 @@ int main(void)
 {
     HAL_Init();
     clock_init();
+    isr_prof_init();
     usart1_init();
+    telemetry_init();
     led1_init();
     key_init();
     led2_init();
@@ -13,18 +15,30 @@ int main(void)
     tim1_init();
     adc1_init();
 
-    sensorless_luenberger_init(2000); // Luenberger 无感
+    // 运行模式管理: 运行中由串口命令切换模式 (stop / align / if / cur / spd / fw / sl / status)
+    mode_manager_init();
+    mode_manager_sensorless(2000); // 上电默认: Luenberger 无感, 2000 RPM
+
+    // 单独的模式初始化仍可使用 (与 mode_manager_init 二选一, 编译期选择)
+    // sensorless_luenberger_init(2000); // Luenberger 无感
     // speed_closed_with_luenberger_init(200); //  Luenberger 速度闭环
     // sensorless_smo_init(1000); // 滑模无感
+
+    // 遥测: JustFloat (VOFA+), 每 5 个控制周期一个样本 (2kHz), 通道在模式初始化中登记
+    telemetry_config(TELEMETRY_FORMAT_JUSTFLOAT, 5);
+    telemetry_start();
+
     while (1)
     {
         if (key_scan() == 1)
         {
+            mode_manager_stop(); // 按键停机, 之后可由串口命令重新启动
             printf("Stop!\n");
-            break;
         }
 
-        print_sensorless_luenberger_info();
+        mode_manager_poll(); // 执行串口命令
+        telemetry_poll();    // 打包遥测并启动 DMA, 不阻塞
+        // print_sensorless_luenberger_info(); // 旧 printf_vofa 输出 (与遥测二选一)
         // print_speed_luenberger_info();
         // print_sensorless_smo_info();
     }
@@ -9,6 +9,9 @@
 #include "bsp/led.h"
 #include "bsp/clock.h"
 
+#include "utils/isr_prof.h"
+#include "utils/telemetry.h"
+
 #include "motor/sensorless_luenberger.h"
 #include "motor/if_open.h"
 #include "motor/current_closed.h"
@@ -17,6 +20,7 @@
 #include "motor/flux_weak_speed_closed.h"
 #include "motor/speed_closed_with_smo.h"
 #include "motor/speed_closed_with_luenberger.h"
+#include "motor/mode_manager.h"
 
 
 #endif /* __MAIN_H__ */
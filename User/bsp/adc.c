@@ -1,4 +1,8 @@
 #include "adc.h"
+#include "tim.h"
+#include "utils/isr_prof.h"
+#include "utils/telemetry.h"
+#include "utils/ccmram.h"
 
 /* ADC1句柄 */
 ADC_HandleTypeDef hadc1;
@@ -7,31 +11,17 @@ DMA_HandleTypeDef hdma_adc1;
 /* 规则组缓冲区 */
 static uint16_t adc_regular_buf[4] = {0};
 
-/* 注入组数据缓冲区 */
-static uint16_t adc_injected_buf[4] = {0};
+/* 注入组换算结果, 中断中更新 */
+CCMRAM_BSS static adc_values_t adc_injected_values = {0};
 
 /* 三相电流零点补偿 */
 static adc_offset_t adc_offset = {0};
 
-/* ADC注入组中断回调函数指针 */
-static adc_injected_callback_p adc_injected_callback = NULL;
-
-/* 转换原始ADC值为实际电流和电压 */
-static void adc1_value_convert(uint16_t *adc_buf, adc_values_t *adc_values_converted)
-{
-    float voltage;
-
-    voltage = adc_buf[0] * 3.3f / 4096.0f - ADC_REF_VOLTAGE;
-    adc_values_converted->ia = ADC_CURRENT_SCALE * (voltage - adc_offset.ia_offset);
+/* 换算系数 */
+CCMRAM_BSS static adc_scale_t adc_scale = {0};
 
-    voltage = adc_buf[1] * 3.3f / 4096.0f - ADC_REF_VOLTAGE;
-    adc_values_converted->ib = ADC_CURRENT_SCALE * (voltage - adc_offset.ib_offset);
-
-    voltage = adc_buf[2] * 3.3f / 4096.0f - ADC_REF_VOLTAGE;
-    adc_values_converted->ic = ADC_CURRENT_SCALE * (voltage - adc_offset.ic_offset);
-
-    adc_values_converted->udc = ADC_UDC_SCALE * (adc_buf[3] * 3.3f / 4096.0f);
-}
+/* ADC注入组中断回调函数指针 */
+CCMRAM_BSS static adc_injected_callback_p adc_injected_callback = NULL;
 
 /* adc1初始化 + 校准零点 */
 void adc1_init(void)
@@ -114,6 +104,26 @@ void adc1_init(void)
     adc_channel_struct.Rank = ADC_REGULAR_RANK_4;
     HAL_ADC_ConfigChannel(&hadc1, &adc_channel_struct);
 
+#if ADC_SINGLE_SHUNT
+    /* 注入组两次都转换 PA0/IN1 (母线电阻), 间断模式: OC5 / OC6 (TIM1 TRGO2) 每次触发只转换一个通道 */
+    adc_injected_struct.InjectedChannel = ADC_CHANNEL_1;
+    adc_injected_struct.InjectedRank = ADC_INJECTED_RANK_1;
+    adc_injected_struct.InjectedSamplingTime = ADC_SAMPLETIME_12CYCLES_5; /* 采样时间12.5周期, 在 TIM1_SS_SAMPLE 以内 */
+    adc_injected_struct.InjectedSingleDiff = ADC_SINGLE_ENDED;            /* 单端输入 */
+    adc_injected_struct.InjectedOffsetNumber = ADC_OFFSET_NONE;           /* 无偏移 */
+    adc_injected_struct.InjectedOffset = 0;
+    adc_injected_struct.InjectedNbrOfConversion = 2;                                       /* 注入组2次转换 */
+    adc_injected_struct.InjectedDiscontinuousConvMode = ENABLE;                            /* 间断模式 */
+    adc_injected_struct.AutoInjectedConv = DISABLE;                                        /* 禁用自动注入转换 */
+    adc_injected_struct.QueueInjectedContext = DISABLE;                                    /* 禁用注入上下文队列 */
+    adc_injected_struct.ExternalTrigInjecConv = ADC_EXTERNALTRIGINJEC_T1_TRGO2;            /* TIM1 TRGO2 触发 */
+    adc_injected_struct.ExternalTrigInjecConvEdge = ADC_EXTERNALTRIGINJECCONV_EDGE_RISING; /* 上升沿触发 */
+    adc_injected_struct.InjecOversamplingMode = DISABLE;                                   /* 禁用过采样 */
+    HAL_ADCEx_InjectedConfigChannel(&hadc1, &adc_injected_struct);
+
+    adc_injected_struct.InjectedRank = ADC_INJECTED_RANK_2;
+    HAL_ADCEx_InjectedConfigChannel(&hadc1, &adc_injected_struct);
+#else
     /* 配置注入通道1 - PA0/IN1 */
     adc_injected_struct.InjectedChannel = ADC_CHANNEL_1;
     adc_injected_struct.InjectedRank = ADC_INJECTED_RANK_1;
@@ -144,6 +154,7 @@ void adc1_init(void)
     adc_injected_struct.InjectedChannel = ADC_CHANNEL_4;
     adc_injected_struct.InjectedRank = ADC_INJECTED_RANK_4;
     HAL_ADCEx_InjectedConfigChannel(&hadc1, &adc_injected_struct);
+#endif /* ADC_SINGLE_SHUNT */
 
     /* 配置ADC中断优先级 */
     HAL_NVIC_SetPriority(ADC1_2_IRQn, 1, 0);
@@ -170,10 +181,24 @@ void adc1_init(void)
         delay_us(10);
     }
 
+#if ADC_SINGLE_SHUNT
+    /* 单电阻采样: 规则组保持连续转换, 母线电压取 adc_regular_buf[3] (注入组触发时打断规则组, 结束后自动重启) */
+#else
     HAL_ADC_Stop_DMA(&hadc1);
+#endif
+
+    /* 零点补偿完成, 计算换算系数 */
+    adc1_scale_init(&adc_scale, &adc_offset);
 
     /* 开启注入组转换中断 */
     HAL_ADCEx_InjectedStart_IT(&hadc1);
+
+#if ADC1_ISR_DIRECT
+    /* 每个序列只进一次中断: 关闭单次转换结束中断 JEOC, 改用序列结束中断 JEOS */
+    __HAL_ADC_DISABLE_IT(&hadc1, ADC_IT_JEOC);
+    __HAL_ADC_CLEAR_FLAG(&hadc1, ADC_FLAG_JEOC | ADC_FLAG_JEOS);
+    __HAL_ADC_ENABLE_IT(&hadc1, ADC_IT_JEOS);
+#endif
 }
 
 /* 获取三相电流偏移量 */
@@ -187,16 +212,23 @@ void adc1_get_offset(adc_offset_t *offsets)
 /* 获取规则组转换值 */
 void adc1_get_regular_values(adc_values_t *values)
 {
+#if ADC_SINGLE_SHUNT
+    /* 规则组一直在连续转换 */
+    adc1_scale_convert(&adc_scale, adc_regular_buf[0], adc_regular_buf[1],
+                       adc_regular_buf[2], adc_regular_buf[3], values);
+#else
     HAL_ADC_Start_DMA(&hadc1, (uint32_t *)adc_regular_buf, 4); /* 开启采样 */
     HAL_Delay(10);                                             /* 延时确保采样完成 */
-    adc1_value_convert(adc_regular_buf, values);               /* 计数值转换为实际值 */
+    adc1_scale_convert(&adc_scale, adc_regular_buf[0], adc_regular_buf[1],
+                       adc_regular_buf[2], adc_regular_buf[3], values); /* 计数值转换为实际值 */
     HAL_ADC_Stop_DMA(&hadc1);
+#endif
 }
 
-/* 获取注入组转换值 */
-void adc1_get_injected_values(adc_values_t *values)
+/* 获取注入组转换值 (中断中已换算, 此处仅拷贝), 供中断外读取; 控制回调直接使用回调参数 */
+CCMRAM_FUNC void adc1_get_injected_values(adc_values_t *values)
 {
-    adc1_value_convert(adc_injected_buf, values);
+    *values = adc_injected_values;
 }
 
 /* 注册ADC注入组中断回调函数 */
@@ -205,27 +237,90 @@ void adc1_register_injected_callback(adc_injected_callback_p callback)
     adc_injected_callback = callback;
 }
 
+/* 注入组码值换算: 三电阻为三相电流 + 母线电压; 单电阻为两次母线电流采样, 母线电压取规则组 */
+static inline void adc1_injected_convert(uint32_t raw_1, uint32_t raw_2, uint32_t raw_3, uint32_t raw_4)
+{
+#if ADC_SINGLE_SHUNT
+    uint8_t phase_min, phase_max;
+
+    /* 采样所在周期的窗口不足时保持上一次的电流 */
+    if (tim1_single_shunt_sampled(&phase_min, &phase_max))
+    {
+        adc1_single_shunt_convert(&adc_scale, raw_1, raw_2, phase_min, phase_max, &adc_injected_values);
+    }
+    adc_injected_values.udc = adc_scale.udc_gain * (float)adc_regular_buf[3];
+    (void)raw_3;
+    (void)raw_4;
+#else
+    adc1_scale_convert(&adc_scale, raw_1, raw_2, raw_3, raw_4, &adc_injected_values);
+#endif
+}
+
+#if ADC1_ISR_DIRECT
+
+/* ADC注入组序列转换完成中断处理函数 (直接读写寄存器) */
+CCMRAM_FUNC void ADC1_2_IRQHandler(void)
+{
+    isr_prof_begin();
+
+    if (ADC1->ISR & ADC_ISR_JEOS)
+    {
+        /* 写 1 清零 */
+        ADC1->ISR = ADC_ISR_JEOC | ADC_ISR_JEOS;
+
+        /* 读取注入组转换结果并换算 */
+        adc1_injected_convert(ADC1->JDR1, ADC1->JDR2, ADC1->JDR3, ADC1->JDR4);
+        isr_prof_mark(ISR_PROF_ADC_READ);
+
+        /* 调用注册的回调函数 */
+        if (adc_injected_callback != NULL)
+        {
+            adc_injected_callback(&adc_injected_values);
+        }
+
+        /* 遥测采样 (控制律计算完成后, 未启动时立即返回) */
+        telemetry_sample();
+    }
+    else
+    {
+        /* 其他事件 (如规则组溢出) 交给 HAL 处理 */
+        HAL_ADC_IRQHandler(&hadc1);
+    }
+
+    isr_prof_end();
+}
+
+#else
+
 /* ADC注入组转换完成中断处理函数 */
-void ADC1_2_IRQHandler(void)
+CCMRAM_FUNC void ADC1_2_IRQHandler(void)
 {
+    isr_prof_begin();
     HAL_ADC_IRQHandler(&hadc1);
+    isr_prof_end();
 }
 
 /* ADC注入转换完成回调函数 */
-void HAL_ADCEx_InjectedConvCpltCallback(ADC_HandleTypeDef *hadc)
+CCMRAM_FUNC void HAL_ADCEx_InjectedConvCpltCallback(ADC_HandleTypeDef *hadc)
 {
     if (hadc->Instance == ADC1)
     {
-        /* 读取注入组转换结果 */
-        adc_injected_buf[0] = HAL_ADCEx_InjectedGetValue(hadc, ADC_INJECTED_RANK_1);
-        adc_injected_buf[1] = HAL_ADCEx_InjectedGetValue(hadc, ADC_INJECTED_RANK_2);
-        adc_injected_buf[2] = HAL_ADCEx_InjectedGetValue(hadc, ADC_INJECTED_RANK_3);
-        adc_injected_buf[3] = HAL_ADCEx_InjectedGetValue(hadc, ADC_INJECTED_RANK_4);
+        /* 读取注入组转换结果并换算 */
+        adc1_injected_convert(HAL_ADCEx_InjectedGetValue(hadc, ADC_INJECTED_RANK_1),
+                              HAL_ADCEx_InjectedGetValue(hadc, ADC_INJECTED_RANK_2),
+                              HAL_ADCEx_InjectedGetValue(hadc, ADC_INJECTED_RANK_3),
+                              HAL_ADCEx_InjectedGetValue(hadc, ADC_INJECTED_RANK_4));
+        isr_prof_mark(ISR_PROF_ADC_READ);
 
         /* 调用注册的回调函数 */
         if (adc_injected_callback != NULL)
         {
-            adc_injected_callback();
+            adc_injected_callback(&adc_injected_values);
         }
+
+        /* 遥测采样 (控制律计算完成后, 未启动时立即返回) */
+        telemetry_sample();
     }
 }
+
+#endif /* ADC1_ISR_DIRECT */
@@ -21,8 +21,18 @@ typedef struct
     float ic_offset;
 } adc_offset_t;
 
-/* ADC注入组中断回调函数类型 */
-typedef void (*adc_injected_callback_p)(void);
+/* 注入组换算系数: 物理量 = gain * 码值 + bias, 零点补偿完成后计算一次 */
+typedef struct
+{
+    float i_gain;   /* 电流增益, 单位A/bit */
+    float ia_bias;  /* 含参考电压与零点补偿的电流偏置, 单位A */
+    float ib_bias;
+    float ic_bias;
+    float udc_gain; /* 母线电压增益, 单位V/bit */
+} adc_scale_t;
+
+/* ADC注入组中断回调函数类型: 参数为中断中换算好的本周期采样值, 回调内直接读取, 不需要再拷贝 */
+typedef void (*adc_injected_callback_p)(const adc_values_t *values);
 
 /* ADC句柄声明 */
 extern ADC_HandleTypeDef hadc1;
@@ -32,11 +42,101 @@ extern DMA_HandleTypeDef hdma_adc1;
 #define ADC_CURRENT_SCALE (100.0f / 16.5f) /* 电流传感器比例系数，单位V/A */
 #define ADC_UDC_SCALE 25.0f                /* Udc母线电压转换比例，单位V/bit */
 
+/* 注入组中断实现: 1 = 直接读写寄存器 (JEOS 中断, 读 JDR1~4), 0 = HAL_ADC_IRQHandler 路径 */
+#ifndef ADC1_ISR_DIRECT
+#define ADC1_ISR_DIRECT 1
+#endif
+
+/*
+ * 电流采样方式 (板级编译选项):
+ * 0: 三个下桥电阻, PA0 ~ PA2 分别接 A、B、C 相运放, 谷底 (TIM1 TRGO) 触发注入组同时采三相
+ * 1: 单个直流母线电阻, 运放接 PA0。TIM1 OC5 / OC6 (TRGO2) 在向下计数半周期的两个有效矢量内各触发一次注入组
+ *    (间断模式, 每次转换一个通道), 由采样周期的扇区重构三相电流 (svpwm_single_shunt / adc1_single_shunt_convert);
+ *    母线电压改由规则组 DMA 连续转换
+ */
+#ifndef ADC_SINGLE_SHUNT
+#define ADC_SINGLE_SHUNT 0
+#endif
+
+/**
+ * @brief 由零点补偿值计算换算系数
+ * @note  与 (码值 * 3.3 / 4096 - ADC_REF_VOLTAGE - offset) * ADC_CURRENT_SCALE 等价, 合并为一次乘加
+ */
+static inline void adc1_scale_init(adc_scale_t *scale, const adc_offset_t *offset)
+{
+    scale->i_gain = ADC_CURRENT_SCALE * 3.3f / 4096.0f;
+    scale->ia_bias = -ADC_CURRENT_SCALE * (ADC_REF_VOLTAGE + offset->ia_offset);
+    scale->ib_bias = -ADC_CURRENT_SCALE * (ADC_REF_VOLTAGE + offset->ib_offset);
+    scale->ic_bias = -ADC_CURRENT_SCALE * (ADC_REF_VOLTAGE + offset->ic_offset);
+    scale->udc_gain = ADC_UDC_SCALE * 3.3f / 4096.0f;
+}
+
+/**
+ * @brief 码值换算为相电流与母线电压, 每个通道一次乘加
+ */
+static inline void adc1_scale_convert(const adc_scale_t *scale, uint32_t raw_a, uint32_t raw_b, uint32_t raw_c,
+                                      uint32_t raw_udc, adc_values_t *values)
+{
+    values->ia = scale->i_gain * (float)raw_a + scale->ia_bias;
+    values->ib = scale->i_gain * (float)raw_b + scale->ib_bias;
+    values->ic = scale->i_gain * (float)raw_c + scale->ic_bias;
+    values->udc = scale->udc_gain * (float)raw_udc;
+}
+
+/**
+ * @brief 两相电流重构: 丢弃一相的采样值, 由 ia + ib + ic = 0 从另外两相计算
+ * @param values 本周期的采样值
+ * @param drop   丢弃的相 (0: A, 1: B, 2: C), 其他值不修改
+ * @note  下桥电阻采样时, 占空比最高的一相下桥导通时间最短, 高调制比时采样落在开关振荡中;
+ *        drop 取本次采样时生效的占空比中最高的一相 (svpwm_modulator_max_phase)
+ */
+static inline void adc1_current_reconstruct(adc_values_t *values, uint8_t drop)
+{
+    switch (drop)
+    {
+    case 0:
+        values->ia = -values->ib - values->ic;
+        break;
+    case 1:
+        values->ib = -values->ia - values->ic;
+        break;
+    case 2:
+        values->ic = -values->ia - values->ib;
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief 单电阻采样: 两次母线电流采样换算为三相电流
+ * @param raw_1     第一个窗口 (最低相关断后) 的码值, 母线电流 = -i[phase_min]
+ * @param raw_2     第二个窗口 (只有最高相导通) 的码值, 母线电流 = +i[phase_max]
+ * @param phase_min 占空比最低的相 (0: A, 1: B, 2: C)
+ * @param phase_max 占空比最高的相, 与 phase_min 不同
+ * @note  母线电阻运放接在 A 相通道上, 使用 A 相的换算系数; 不修改 udc
+ */
+static inline void adc1_single_shunt_convert(const adc_scale_t *scale, uint32_t raw_1, uint32_t raw_2, uint8_t phase_min,
+                                             uint8_t phase_max, adc_values_t *values)
+{
+    float i[3];
+    float i_min = -(scale->i_gain * (float)raw_1 + scale->ia_bias);
+    float i_max = scale->i_gain * (float)raw_2 + scale->ia_bias;
+
+    i[phase_min] = i_min;
+    i[phase_max] = i_max;
+    i[3U - phase_min - phase_max] = -i_min - i_max;
+
+    values->ia = i[0];
+    values->ib = i[1];
+    values->ic = i[2];
+}
+
 void adc1_get_offset(adc_offset_t *offsets); /* 调试接口，仅供测试使用 */
 
 void adc1_init(void);
 void adc1_get_regular_values(adc_values_t *values);
-void adc1_get_injected_values(adc_values_t *values);
+void adc1_get_injected_values(adc_values_t *values); /* 中断外读取最近一次注入组结果 (拷贝) */
 
 /* 注册ADC注入组中断回调函数 */
 void adc1_register_injected_callback(adc_injected_callback_p callback);
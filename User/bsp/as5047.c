@@ -1,8 +1,14 @@
 #include "as5047.h"
+#include "tim.h"
+#include <string.h>
 
 /* CS 引脚控制宏 */
 #define AS5047_CS_LOW() HAL_GPIO_WritePin(GPIOA, GPIO_PIN_15, GPIO_PIN_RESET)
 #define AS5047_CS_HIGH() HAL_GPIO_WritePin(GPIOA, GPIO_PIN_15, GPIO_PIN_SET)
+#define AS5047_CS_HIGH_FAST() (GPIOA->BSRR = GPIO_PIN_15) /* 中断中使用 */
+
+/* 读 ANGLECOM 命令帧 (含校验位) */
+#define AS5047_CMD_ANGLECOM 0xFFFF
 
 /**
  * @brief 速度计算相关的静态变量
@@ -18,6 +24,27 @@ static struct
     uint8_t is_initialized;    /* 初始化标志位 */
 } as5047_speed_data = {0, 0.0f, 0.0f, 0.0f, 0, 0, 0};
 
+/**
+ * @brief 帧流水线与缓存采样
+ * @note  AS5047P 的响应在下一帧返回: 第 N 帧收到的是第 N-1 帧命令的结果。
+ *        连续发送读 ANGLECOM 时, 每个 PWM 周期一帧即可得到一次角度。
+ */
+static struct
+{
+    const as5047_transport_t *transport;
+    uint16_t cmd_sent;          /* 当前帧发送的命令 */
+    uint16_t cmd_prev;          /* 上一帧发送的命令, 当前帧收到其响应 */
+    volatile uint8_t errfl_req; /* 请求在流水线中插入一次 ERRFL 读取 */
+    uint8_t running;            /* 周期采集已启动 */
+
+    /* 缓存采样, 所有使用者共享 */
+    volatile uint16_t angle_raw;
+    volatile angle_t angle_el;
+    volatile uint16_t errfl;
+
+    as5047_diag_t diag;
+} as5047;
+
 /**
  * @brief 计算奇偶校验位
  * @param data 需要计算的数据 (15位)
@@ -37,63 +64,119 @@ static uint16_t as5047_calc_parity(uint16_t data)
 }
 
 /**
- * @brief SPI 发送接收一个字 (16位)
+ * @brief 构建读命令: bit14 = 1 (读操作), bit15 = 偶校验
  */
-static uint16_t as5047_spi_transfer(uint16_t tx_data)
+static uint16_t as5047_read_cmd(uint16_t reg_addr)
 {
-    uint16_t rx_data = 0;
-
-    AS5047_CS_LOW();
+    uint16_t cmd = reg_addr | AS5047_FRAME_RW;
 
-    HAL_SPI_TransmitReceive(&hspi1, (uint8_t *)&tx_data, (uint8_t *)&rx_data, 1, 1);
+    if (as5047_calc_parity(cmd) == 1)
+    {
+        cmd |= AS5047_FRAME_PARITY;
+    }
 
-    AS5047_CS_HIGH();
+    return cmd;
+}
 
-    return rx_data;
+/* 更新缓存角度 */
+static void as5047_publish_angle(uint16_t raw)
+{
+    as5047.angle_raw = raw;
+    /* 14 位机械角左移到 32 位整数角, 乘极对数即电角度, 溢出自然回绕 */
+    as5047.angle_el = ((angle_t)raw << AS5047_ANGLE_SHIFT) * AS5047_MOTOR_POLE_PAIR;
 }
 
 /**
- * @brief 读取 AS5047P 寄存器
+ * @brief 处理一帧响应
+ * @param cmd 该响应对应的命令
+ * @param rx  响应帧
  */
-static uint16_t as5047_read_reg(uint16_t reg_addr)
+static void as5047_handle_response(uint16_t cmd, uint16_t rx)
 {
-    uint16_t cmd;
-    uint16_t data;
+    /* 响应帧同样为偶校验: 16 位中 1 的个数为偶数 */
+    if (as5047_calc_parity(rx) != (rx >> 15))
+    {
+        as5047.diag.parity_error++;
+        return;
+    }
 
-    /* 构建读命令: bit14 = 1 (读操作) */
-    cmd = reg_addr | 0x4000;
+    if (rx & AS5047_FRAME_EF)
+    {
+        as5047.diag.flag_error++;
+        return;
+    }
 
-    /* 计算并添加奇偶校验位 (bit15) */
-    if (as5047_calc_parity(cmd) == 1)
+    switch (cmd & AS5047_FRAME_DATA)
+    {
+    case AS5047_REG_ANGLECOM:
+        as5047_publish_angle(rx & AS5047_FRAME_DATA);
+        as5047.diag.angle_count++;
+        break;
+
+    case AS5047_REG_ERRFL:
+        as5047.errfl = rx & AS5047_FRAME_DATA;
+        break;
+
+    default:
+        break;
+    }
+}
+
+uint16_t as5047_frame_isr(uint16_t rx)
+{
+    as5047_handle_response(as5047.cmd_prev, rx);
+    as5047.diag.frame_count++;
+
+    /* 默认继续读角度, 有请求时插入一帧 ERRFL (该周期角度沿用上一帧) */
+    uint16_t next = AS5047_CMD_ANGLECOM;
+    if (as5047.errfl_req)
     {
-        cmd |= 0x8000;
+        as5047.errfl_req = 0;
+        next = as5047_read_cmd(AS5047_REG_ERRFL);
     }
 
-    /* 发送读命令，忽略返回值 (返回的是上一次命令的结果) */
-    as5047_spi_transfer(cmd);
+    as5047.cmd_prev = as5047.cmd_sent;
+    as5047.cmd_sent = next;
 
-    /* 发送 NOP 命令，获取实际数据 */
-    data = as5047_spi_transfer(0xC000); /* NOP with read bit */
+    return next;
+}
 
-    /* 提取 14 位数据 (去掉 bit14 和 bit15) */
-    data &= 0x3FFF;
+/**
+ * @brief 等待当前周期帧完成
+ * @note  CS 在 PWM 谷底前拉低, 帧长约 3us; 控制中断在注入组转换结束 (约 2.4us) 后进入,
+ *        此时最多再等待不足 1us, 保证读到本周期的角度
+ */
+static void as5047_sync(void)
+{
+    if (!as5047.running)
+        return;
 
-    return data;
+    uint32_t loops = 0;
+    while (as5047.transport->busy())
+    {
+        if (++loops >= AS5047_WAIT_LOOPS)
+        {
+            as5047.diag.wait_timeout++;
+            break;
+        }
+    }
 }
 
 /**
- * @brief 读取角度原始值 (带补偿)
+ * @brief 复位速度计算
+ * @note  下一次 as5047_update_speed() 只记录角度, 之后每 AS5047_SPEED_CALC_DIV 次调用刷新一次转速,
+ *        调用方据此把速度环安排在转速刷新的周期执行; 须在控制中断之外 (或中断未运行时) 调用
  */
-static uint16_t as5047_get_angle_raw(void)
+void as5047_speed_reset(void)
 {
-    return as5047_read_reg(AS5047_REG_ANGLECOM);
+    as5047_speed_data.is_initialized = 0;
 }
 
 /**
  * @brief 更新 AS5047P 速度数据
  * @note  处理角度翻转（0->2PI 或 2PI->0），固定采样周期中调用
- * @note  调用频率为10KHz (ADC注入中断)
- * @note  每10次中断累加delta_raw，每1ms(1kHz)计算一次速度
+ * @note  每个控制周期调用一次 (ADC注入中断, 10kHz, 双更新时 20kHz)
+ * @note  每 AS5047_SPEED_CALC_DIV 次中断累加delta_raw，每1ms(1kHz)计算一次速度
  */
 void as5047_update_speed(void)
 {
@@ -130,17 +213,17 @@ void as5047_update_speed(void)
     /* theta_sum: 用于速度计算，每1ms清零一次 */
     as5047_speed_data.theta_sum += delta_raw;
     
-    /* update_cnt: 更新计数器，每调用一次+1，用于分频(10kHz->1kHz) */
+    /* update_cnt: 更新计数器，每调用一次+1，用于分频(控制频率->1kHz) */
     as5047_speed_data.update_cnt++;
 
-    /* 每10次中断 (1ms/1kHz) 计算一次速度 */
+    /* 每 AS5047_SPEED_CALC_DIV 次中断 (1ms/1kHz) 计算一次速度 */
     if (as5047_speed_data.update_cnt >= AS5047_SPEED_CALC_DIV)
     {
         /* 计算转速 (RPM): 
          * speed_rpm = (角度变化量 / 一圈分辨率) * 60秒 / 采样时间
          * 例如：theta_sum=1638, 则转了0.1圈, 在0.001秒内, 速度=0.1*60/0.001=6000RPM
          */
-        as5047_speed_data.speed_rpm = ((float)as5047_speed_data.theta_sum / AS5047_RESOLUTION) * 60.0f / AS5047_SPEED_SAMPLE_TIME;
+        as5047_speed_data.speed_rpm = (float)as5047_speed_data.theta_sum * (60.0f / (AS5047_RESOLUTION * AS5047_SPEED_SAMPLE_TIME));
 
         /* 一阶低通滤波，平滑转速波动，用于显示 */
         as5047_speed_data.speed_rpm_lpf = AS5047_SPEED_FILTER_ALPHA * as5047_speed_data.speed_rpm +
@@ -156,7 +239,31 @@ void as5047_update_speed(void)
     as5047_speed_data.last_angle_rad = ((float)current_angle_raw / AS5047_RESOLUTION) * 2.0f * M_PI;  // 保存当前角度(弧度)
 }
 
-void as5047_init(void)
+#ifndef FOC_SIM_HOST
+
+/*----------------------------------------- TIM1 触发的 DMA 传输 -----------------------------------------*/
+
+/**
+ * 时序 (一个 PWM 周期):
+ *   TIM1 CC4 (向下计数, 谷底前 TIM1_ENCODER_CS_LEAD) -> DMA2_CH1 写 GPIOA->BSRR, CS 拉低, 传感器锁存角度
+ *   TIM1 更新 (谷底, 同时触发 ADC 注入组)              -> DMA2_CH2 写 SPI1->DR, 发送下一条命令
+ *   SPI1 RX (约 3us 后)                                -> DMA2_CH3 读 SPI1->DR, 完成中断拉高 CS 并解析响应
+ *
+ * 双更新 (PWM_DOUBLE_UPDATE) 与单电阻采样 (ADC_SINGLE_SHUNT) 时峰值也是更新事件, 每个更新事件各读一帧:
+ * TIM1 为中心对齐模式3, CC4 上下计数都触发,
+ * 帧完成中断按计数方向把 CCR4 改到下一个更新事件之前 (谷底后改为 ARR - CS_LEAD, 峰值后改回 CS_LEAD)。
+ * 另一个方向上的同值匹配落在本帧传输期间 (更新事件后 0.5us), CS 已为低, 重复写 BSRR 无影响。
+ */
+
+DMA_HandleTypeDef hdma_as5047_cs;
+DMA_HandleTypeDef hdma_as5047_tx;
+DMA_HandleTypeDef hdma_as5047_rx;
+
+static const uint32_t as5047_cs_low_word = (uint32_t)GPIO_PIN_15 << 16; /* BSRR 高 16 位: 复位 PA15 */
+static volatile uint16_t as5047_tx_word = AS5047_CMD_ANGLECOM;
+static volatile uint16_t as5047_rx_word = 0;
+
+static void as5047_dma_init(void)
 {
     GPIO_InitTypeDef gpio_init = {0};
 
@@ -175,17 +282,174 @@ void as5047_init(void)
 
     /* 初始化 SPI */
     spi_init();
+
+    __HAL_RCC_DMAMUX1_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    /* CS 拉低: 内存 -> GPIOA->BSRR, 32 位 */
+    hdma_as5047_cs.Instance = DMA2_Channel1;
+    hdma_as5047_cs.Init.Request = DMA_REQUEST_TIM1_CH4;
+    hdma_as5047_cs.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_as5047_cs.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_as5047_cs.Init.MemInc = DMA_MINC_DISABLE;
+    hdma_as5047_cs.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    hdma_as5047_cs.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    hdma_as5047_cs.Init.Mode = DMA_CIRCULAR;
+    hdma_as5047_cs.Init.Priority = DMA_PRIORITY_VERY_HIGH;
+    HAL_DMA_Init(&hdma_as5047_cs);
+
+    /* 命令帧: 内存 -> SPI1->DR, 16 位 */
+    hdma_as5047_tx.Instance = DMA2_Channel2;
+    hdma_as5047_tx.Init.Request = DMA_REQUEST_TIM1_UP;
+    hdma_as5047_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_as5047_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_as5047_tx.Init.MemInc = DMA_MINC_DISABLE;
+    hdma_as5047_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    hdma_as5047_tx.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    hdma_as5047_tx.Init.Mode = DMA_CIRCULAR;
+    hdma_as5047_tx.Init.Priority = DMA_PRIORITY_VERY_HIGH;
+    HAL_DMA_Init(&hdma_as5047_tx);
+
+    /* 响应帧: SPI1->DR -> 内存, 16 位 */
+    hdma_as5047_rx.Instance = DMA2_Channel3;
+    hdma_as5047_rx.Init.Request = DMA_REQUEST_SPI1_RX;
+    hdma_as5047_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    hdma_as5047_rx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_as5047_rx.Init.MemInc = DMA_MINC_DISABLE;
+    hdma_as5047_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    hdma_as5047_rx.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    hdma_as5047_rx.Init.Mode = DMA_CIRCULAR;
+    hdma_as5047_rx.Init.Priority = DMA_PRIORITY_VERY_HIGH;
+    HAL_DMA_Init(&hdma_as5047_rx);
+
+    /* 帧完成中断优先级高于 ADC 注入组中断, 控制回调中等待时可抢占 */
+    HAL_NVIC_SetPriority(DMA2_Channel3_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(DMA2_Channel3_IRQn);
 }
 
 /**
- * @brief 读取电角度 (弧度)
- * @return 电角度 = 机械角度 × 极对数
+ * @brief SPI 发送接收一个字 (16位), 阻塞
+ */
+static uint16_t as5047_dma_transfer(uint16_t tx_data)
+{
+    uint16_t rx_data = 0;
+
+    AS5047_CS_LOW();
+
+    HAL_SPI_TransmitReceive(&hspi1, (uint8_t *)&tx_data, (uint8_t *)&rx_data, 1, 1);
+
+    AS5047_CS_HIGH();
+
+    return rx_data;
+}
+
+static void as5047_dma_start(uint16_t tx)
+{
+    as5047_tx_word = tx;
+
+    HAL_DMA_Start(&hdma_as5047_cs, (uint32_t)&as5047_cs_low_word, (uint32_t)&GPIOA->BSRR, 1);
+    HAL_DMA_Start(&hdma_as5047_tx, (uint32_t)&as5047_tx_word, (uint32_t)&SPI1->DR, 1);
+    HAL_DMA_Start(&hdma_as5047_rx, (uint32_t)&SPI1->DR, (uint32_t)&as5047_rx_word, 1);
+    __HAL_DMA_ENABLE_IT(&hdma_as5047_rx, DMA_IT_TC);
+
+    /* SPI 收到数据后请求 DMA; 发送由 TIM1 更新事件的 DMA 直接写 DR 启动 */
+    __HAL_SPI_ENABLE(&hspi1);
+    SET_BIT(SPI1->CR2, SPI_CR2_RXDMAEN);
+}
+
+/* CS 为低表示本周期的帧仍在传输 */
+static uint8_t as5047_dma_busy(void)
+{
+    return (GPIOA->ODR & GPIO_PIN_15) == 0;
+}
+
+static const as5047_transport_t as5047_transport_dma = {
+    .init = as5047_dma_init,
+    .transfer = as5047_dma_transfer,
+    .start = as5047_dma_start,
+    .busy = as5047_dma_busy,
+};
+
+/* SPI1 RX DMA 完成中断: 一帧结束 */
+void DMA2_Channel3_IRQHandler(void)
+{
+    DMA2->IFCR = DMA_IFCR_CGIF3;
+
+    /* CS 未被拉低的帧 (传感器未响应) 直接丢弃, 重发同一条命令 */
+    if (GPIOA->ODR & GPIO_PIN_15)
+        return;
+
+    AS5047_CS_HIGH_FAST();
+
+#if TIM1_UPDATE_AT_PEAK
+    /* 向上计数 (谷底之后): 下一帧在峰值前拉低 CS; 向下计数 (峰值之后): 在谷底前拉低 */
+    TIM1->CCR4 = (TIM1->CR1 & TIM_CR1_DIR) ? TIM1_ENCODER_CS_LEAD : (TIM1_PERIOD - TIM1_ENCODER_CS_LEAD);
+#endif
+
+    as5047_tx_word = as5047_frame_isr(as5047_rx_word);
+}
+
+#endif /* FOC_SIM_HOST */
+
+void as5047_set_transport(const as5047_transport_t *transport)
+{
+    as5047.transport = transport;
+}
+
+void as5047_init(void)
+{
+    const as5047_transport_t *transport = as5047.transport;
+
+#ifndef FOC_SIM_HOST
+    if (transport == NULL)
+    {
+        transport = &as5047_transport_dma;
+    }
+#endif
+
+    memset(&as5047, 0, sizeof(as5047));
+    memset(&as5047_speed_data, 0, sizeof(as5047_speed_data));
+    as5047.transport = transport;
+
+    transport->init();
+
+    /* 阻塞读取 ERRFL 与第一帧角度, 同时填充流水线 */
+    transport->transfer(as5047_read_cmd(AS5047_REG_ERRFL));
+    as5047_handle_response(as5047_read_cmd(AS5047_REG_ERRFL), transport->transfer(AS5047_CMD_ANGLECOM));
+    as5047_handle_response(AS5047_CMD_ANGLECOM, transport->transfer(AS5047_CMD_ANGLECOM));
+
+    /* 启动周期采集: 第一帧收到的是上面最后一条 ANGLECOM 命令的响应 */
+    as5047.cmd_prev = AS5047_CMD_ANGLECOM;
+    as5047.cmd_sent = AS5047_CMD_ANGLECOM;
+    as5047.running = 1;
+    transport->start(AS5047_CMD_ANGLECOM);
+}
+
+/**
+ * @brief 读取电角度
+ * @return 电角度 = 机械角度 × 极对数 (2^32 = 2π, 回绕), 取自本周期的缓存采样
+ */
+angle_t as5047_get_angle_el(void)
+{
+    as5047_sync();
+    return as5047.angle_el;
+}
+
+/**
+ * @brief 读取电角度 (弧度, [0, 2π)), 用于显示
  */
 float as5047_get_angle_rad(void)
 {
-    uint16_t raw = as5047_get_angle_raw();
-    float mech_angle = ((float)raw / (float)AS5047_RESOLUTION) * 2.0f * M_PI;
-    return mech_angle * AS5047_MOTOR_POLE_PAIR;
+    return angle_to_rad_pos(as5047_get_angle_el());
+}
+
+/**
+ * @brief 读取机械角度码值 (0~16383), 取自本周期的缓存采样
+ */
+uint16_t as5047_get_angle_raw(void)
+{
+    as5047_sync();
+    return as5047.angle_raw;
 }
 
 /**
@@ -208,8 +472,18 @@ float as5047_get_speed_rpm_lpf(void)
 
 /**
  * @brief 读取错误标志
+ * @note  返回最近一次读到的 ERRFL, 并请求在下一帧插入一次 ERRFL 读取 (不阻塞)
  */
 uint16_t as5047_get_error(void)
 {
-    return as5047_read_reg(AS5047_REG_ERRFL);
+    as5047.errfl_req = 1;
+    return as5047.errfl;
+}
+
+/**
+ * @brief 读取诊断计数
+ */
+void as5047_get_diag(as5047_diag_t *diag)
+{
+    *diag = as5047.diag;
 }
@@ -3,6 +3,8 @@
 
 #include "stm32g4xx_hal.h"
 #include "spi.h"
+#include "foc/motor_profile.h"
+#include "utils/angle.h"
 #include <math.h>
 
 /* AS5047P 寄存器地址定义 */
@@ -20,25 +22,79 @@
 #define AS5047_REG_SETTINGS1    0x0018  /* 设置寄存器1 */
 #define AS5047_REG_SETTINGS2    0x0019  /* 设置寄存器2 */
 
+/* SPI 帧格式: bit15 偶校验, bit14 读标志 (命令帧) / 错误标志 EF (响应帧), bit13~0 地址或数据 */
+#define AS5047_FRAME_PARITY     0x8000
+#define AS5047_FRAME_RW         0x4000
+#define AS5047_FRAME_EF         0x4000
+#define AS5047_FRAME_DATA       0x3FFF
+
 /* AS5047P 分辨率 */
 #define AS5047_RESOLUTION       16384   /* 14位分辨率 (2^14) */
+#define AS5047_ANGLE_SHIFT      18      /* 码值 -> 32 位整数角 (angle_t) 的左移位数 */
 
 /* 速度计算参数 */
 #define AS5047_SPEED_SAMPLE_TIME 0.001f  /* 速度计算周期 (秒) - 1ms (1kHz) */
-#define AS5047_SPEED_CALC_DIV    10      /* 速度计算分频系数 (10kHz / 10 = 1kHz) */
+#define AS5047_SPEED_CALC_DIV    (10U * MOTOR_CTRL_PER_PWM) /* 速度计算分频系数 (控制频率 / 分频 = 1kHz) */
 #define AS5047_SPEED_FILTER_ALPHA 0.05f  /* 速度滤波系数 (一阶低通) */
 
+/*
+ * 传感器内部传播延迟 (s): 读 ANGLECOM 时由动态角度误差补偿 (DAEC) 抵消, 取 0;
+ * 读 ANGLEUNC 或关闭 DAEC 时约 110us (数据手册 system propagation delay)
+ */
+#ifndef AS5047_SENSOR_DELAY_TS
+#define AS5047_SENSOR_DELAY_TS 0.0f
+#endif
+
 /* 电机参数 */
-#define AS5047_MOTOR_POLE_PAIR   7       /* 电机极对数 */
+#define AS5047_MOTOR_POLE_PAIR   MOTOR_POLE_PAIRS /* 电机极对数, 见 foc/motor_profile.h */
+
+/* 等待当前帧完成的最大轮询次数 (正常情况下 < 1us) */
+#define AS5047_WAIT_LOOPS        1000
+
+/**
+ * SPI 传输接口
+ *
+ * 固件中由 TIM1 触发 DMA 完成周期采集: CC4 (谷底前) 拉低 CS, 更新事件写 SPI1->DR,
+ * SPI1 RX DMA 完成中断拉高 CS 并调用 as5047_frame_isr()。
+ * 主机端测试 / 仿真通过 as5047_set_transport() 替换为传感器模型。
+ */
+typedef struct
+{
+    void (*init)(void);                /* 初始化 CS / SPI / DMA */
+    uint16_t (*transfer)(uint16_t tx); /* 阻塞收发一帧, 仅在 start 之前使用 */
+    void (*start)(uint16_t tx);        /* 启动周期采集, tx 为第一帧命令 */
+    uint8_t (*busy)(void);             /* 周期采集的当前帧是否仍在传输 */
+} as5047_transport_t;
+
+/* 诊断计数 */
+typedef struct
+{
+    uint32_t frame_count;   /* 已完成的周期帧数 */
+    uint32_t angle_count;   /* 有效角度帧数 */
+    uint32_t parity_error;  /* 响应帧奇偶校验错误 */
+    uint32_t flag_error;    /* 响应帧 EF 置位 (传感器报告上一条命令出错) */
+    uint32_t wait_timeout;  /* 等待当前帧超时 */
+} as5047_diag_t;
 
 void as5047_init(void);
-float as5047_get_angle_rad(void);        /* 返回电角度 (弧度) */
+angle_t as5047_get_angle_el(void);       /* 返回电角度 (2^32 = 2π) */
+float as5047_get_angle_rad(void);        /* 返回电角度 (弧度, [0, 2π)) */
+uint16_t as5047_get_angle_raw(void);     /* 返回机械角度码值 (0~16383) */
 void as5047_update_speed(void);
+void as5047_speed_reset(void);           /* 下一次 as5047_update_speed() 重新开始计数, 用于与调度器对齐相位 */
 float as5047_get_speed_rpm(void);
 float as5047_get_speed_rpm_lpf(void);
 uint16_t as5047_get_error(void);
+void as5047_get_diag(as5047_diag_t *diag);
 
+/* 替换传输接口, 需在 as5047_init() 之前调用 */
+void as5047_set_transport(const as5047_transport_t *transport);
 
-
+/**
+ * @brief 周期帧完成处理 (由传输接口在每帧结束时调用)
+ * @param rx 本帧收到的响应 (对应上一帧发送的命令)
+ * @return 下一帧要发送的命令
+ */
+uint16_t as5047_frame_isr(uint16_t rx);
 
 #endif /* __AS5047_H__ */
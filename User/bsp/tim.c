@@ -1,8 +1,34 @@
 #include "tim.h"
+#include "utils/ccmram.h"
+#if ADC_SINGLE_SHUNT
+#include "foc/svpwm.h"
+#endif
 
 /* 高级定时器1句柄 */
 TIM_HandleTypeDef htim1;
 
+#if ADC_SINGLE_SHUNT
+/* 单电阻采样: 一个 PWM 周期的比较值 (前后半周期) 与两次采样的触发点 */
+typedef struct
+{
+    uint32_t compare_up[3];   /* 向上计数半周期 */
+    uint32_t compare_down[3]; /* 向下计数半周期 */
+    uint32_t trigger[2];      /* OC5 / OC6 比较值: 向下计数经过时触发注入组 */
+    uint8_t phase_min;        /* 第一次采样 = -i[phase_min] */
+    uint8_t phase_max;        /* 第二次采样 = +i[phase_max] */
+    uint8_t valid;
+} tim1_ss_set_t;
+
+/*
+ * 控制中断写 pending (双缓冲, 写完后切换 ready), 峰值更新中断锁存为 active, 上一组 active 转为 sampled:
+ * active 在下一个谷底 / 峰值装载, 其向下计数半周期的采样在再下一个峰值之前由 ADC 中断换算, 届时 sampled 即为这一组
+ */
+CCMRAM_BSS static tim1_ss_set_t tim1_ss_pending[2];
+CCMRAM_BSS static volatile uint8_t tim1_ss_ready;
+CCMRAM_BSS static tim1_ss_set_t tim1_ss_active;
+CCMRAM_BSS static tim1_ss_set_t tim1_ss_sampled;
+#endif
+
 /* PA8-A10 为 TIM1_CH1-3, PB13-B15 为 TIM1_CHN 1-3 */
 void tim1_init(void)
 {
@@ -45,17 +71,25 @@ void tim1_init(void)
     htim1.Instance = TIM1;
     htim1.Init.Prescaler = TIM1_PRESCALER;                        /* 预分频值 */
     htim1.Init.Period = TIM1_PERIOD;                              /* 自动重装载值 */
-    htim1.Init.CounterMode = TIM_COUNTERMODE_CENTERALIGNED1;      /* 中心对齐模式2 */
+#if TIM1_UPDATE_AT_PEAK
+    htim1.Init.CounterMode = TIM_COUNTERMODE_CENTERALIGNED3;      /* 中心对齐模式3: CC4 在上下计数时都产生 DMA 请求 */
+#else
+    htim1.Init.CounterMode = TIM_COUNTERMODE_CENTERALIGNED1;      /* 中心对齐模式1 */
+#endif
     htim1.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;            /* 时钟分频因子 */
-    htim1.Init.RepetitionCounter = 1;                             /* 溢出更新次数 */
+    htim1.Init.RepetitionCounter = TIM1_REPETITION;               /* 0: 峰值与谷底都更新, 1: 只在谷底更新 */
     htim1.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE; /* 使能自动重装载预装载 */
     HAL_TIM_Base_Init(&htim1);                                    /* 先初始化Base */
 
     HAL_TIM_PWM_Init(&htim1); /* 初始化TIM1 PWM模式 */
 
-    /* 配置TIM1为主模式，触发ADC采样 */
+    /* 配置TIM1为主模式，触发ADC采样 (双更新时峰值、谷底各触发一次; 单电阻采样由 OC5 / OC6 经 TRGO2 触发) */
     tim1_master_init_struct.MasterOutputTrigger = TIM_TRGO_UPDATE; /* 设置TRGO输出触发源为更新事件 */
+#if ADC_SINGLE_SHUNT
+    tim1_master_init_struct.MasterOutputTrigger2 = TIM_TRGO2_OC5REF_RISING_OC6REF_RISING;
+#else
     tim1_master_init_struct.MasterOutputTrigger2 = TIM_TRGO2_RESET;
+#endif
     tim1_master_init_struct.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
     HAL_TIMEx_MasterConfigSynchronization(&htim1, &tim1_master_init_struct);
 
@@ -71,6 +105,31 @@ void tim1_init(void)
     HAL_TIM_PWM_ConfigChannel(&htim1, &tim1_oc_init_struct, TIM_CHANNEL_2);
     HAL_TIM_PWM_ConfigChannel(&htim1, &tim1_oc_init_struct, TIM_CHANNEL_3);
 
+    /* 配置CH4为定时通道，触发编码器采集 (CC4: CS拉低, 更新事件: 发送命令帧) */
+    tim1_oc_init_struct.OCMode = TIM_OCMODE_TIMING;   /* 冻结模式，不输出 */
+    tim1_oc_init_struct.Pulse = TIM1_ENCODER_CS_LEAD; /* 谷底前0.5us (CCR4 无预装载, 双更新时由帧完成中断改写) */
+    HAL_TIM_OC_ConfigChannel(&htim1, &tim1_oc_init_struct, TIM_CHANNEL_4);
+    __HAL_TIM_ENABLE_DMA(&htim1, TIM_DMA_CC4 | TIM_DMA_UPDATE);
+
+#if ADC_SINGLE_SHUNT
+    /*
+     * CH5 / CH6 (内部通道) 触发两次母线电流采样: PWM 模式1 (CNT < CCR 时 OCREF 有效), 向下计数经过比较值时
+     * OCREF 上升沿经 TRGO2 触发注入组; 向上计数时为下降沿, 不触发。比较值预装载, 与三相一起在峰值生效
+     */
+    tim1_oc_init_struct.OCMode = TIM_OCMODE_PWM1;
+    tim1_oc_init_struct.Pulse = 0;
+    HAL_TIM_PWM_ConfigChannel(&htim1, &tim1_oc_init_struct, TIM_CHANNEL_5);
+    HAL_TIM_PWM_ConfigChannel(&htim1, &tim1_oc_init_struct, TIM_CHANNEL_6);
+
+    /* 初始 50% 占空比的一组, 更新中断在每个更新事件后写入下一个半周期的比较值 */
+    tim1_set_pwm_duty(0.5f, 0.5f, 0.5f);
+    tim1_ss_active = tim1_ss_pending[tim1_ss_ready];
+    tim1_ss_sampled = tim1_ss_active;
+    HAL_NVIC_SetPriority(TIM1_UP_TIM16_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(TIM1_UP_TIM16_IRQn);
+    __HAL_TIM_ENABLE_IT(&htim1, TIM_IT_UPDATE);
+#endif
+
     /* 配置死区时间 */
     tim1_bdtr_init_struct.DeadTime = TIM1_DEADTIME;           /* 死区时间 */
     tim1_bdtr_init_struct.OffStateRunMode = TIM_OSSR_ENABLE;  /* 运行模式下关闭状态选择 */
@@ -95,12 +154,92 @@ void tim1_init(void)
     HAL_TIMEx_PWMN_Start(&htim1, TIM_CHANNEL_3);
 }
 
-void tim1_set_pwm_duty(float duty1, float duty2, float duty3)
+/*
+ * 占空比换算为比较值: DPWM 钳位相 (占空比 1.0) 的比较值取 ARR + 1, 整个周期输出不翻转;
+ * 若取 ARR, 计数器到达峰值时仍会输出一个计数的窄脉冲, 经死区插入后变成一次完整的开关动作。
+ */
+static inline uint32_t tim1_duty_to_compare(float duty)
+{
+    if (duty >= 1.0f)
+        return TIM1_PERIOD + 1U;
+    if (duty <= 0.0f)
+        return 0U;
+    return (uint32_t)(duty * TIM1_PERIOD);
+}
+
+#if ADC_SINGLE_SHUNT
+
+/*
+ * 单电阻采样: 按占空比移相并计算采样点, 写入待装载的一组, 由峰值更新中断锁存。
+ * 采样时刻 τ (峰值后经过的时间 / 半周期) 在向下计数时对应计数值 ARR · (1 - τ)
+ */
+CCMRAM_FUNC void tim1_set_pwm_duty(float duty1, float duty2, float duty3)
+{
+    svpwm_single_shunt_t ss;
+    svpwm_single_shunt(&ss, duty1, duty2, duty3, (float)TIM1_SS_MIN_WINDOW / TIM1_PERIOD,
+                       (float)TIM1_SS_SAMPLE / TIM1_PERIOD);
+
+    uint8_t next = tim1_ss_ready ^ 1U;
+    tim1_ss_set_t *set = &tim1_ss_pending[next];
+    for (int i = 0; i < 3; i++)
+    {
+        set->compare_up[i] = tim1_duty_to_compare(ss.duty_up[i]);
+        set->compare_down[i] = tim1_duty_to_compare(ss.duty_down[i]);
+    }
+    set->trigger[0] = TIM1_PERIOD - tim1_duty_to_compare(ss.sample[0]);
+    set->trigger[1] = TIM1_PERIOD - tim1_duty_to_compare(ss.sample[1]);
+    set->phase_min = ss.phase[0];
+    set->phase_max = ss.phase[1];
+    set->valid = ss.valid;
+
+    tim1_ss_ready = next;
+}
+
+/* TIM1 更新中断 (峰值与谷底): 写入下一个半周期的比较值, 预装载在下一个更新事件生效 */
+CCMRAM_FUNC void TIM1_UP_TIM16_IRQHandler(void)
+{
+    TIM1->SR = ~(uint32_t)TIM_SR_UIF; /* 写 0 清零, 其余位写 1 不影响 */
+
+    if (TIM1->CR1 & TIM_CR1_DIR)
+    {
+        /* 峰值之后: 锁存最新的一组, 下一个谷底装载其向上计数半周期 */
+        tim1_ss_sampled = tim1_ss_active;
+        tim1_ss_active = tim1_ss_pending[tim1_ss_ready];
+        TIM1->CCR1 = tim1_ss_active.compare_up[0];
+        TIM1->CCR2 = tim1_ss_active.compare_up[1];
+        TIM1->CCR3 = tim1_ss_active.compare_up[2];
+    }
+    else
+    {
+        /* 谷底之后: 下一个峰值装载向下计数半周期 (移相后的比较值与两次采样触发点) */
+        TIM1->CCR1 = tim1_ss_active.compare_down[0];
+        TIM1->CCR2 = tim1_ss_active.compare_down[1];
+        TIM1->CCR3 = tim1_ss_active.compare_down[2];
+        TIM1->CCR5 = tim1_ss_active.trigger[0];
+        TIM1->CCR6 = tim1_ss_active.trigger[1];
+    }
+}
+
+CCMRAM_FUNC uint8_t tim1_single_shunt_sampled(uint8_t *phase_min, uint8_t *phase_max)
+{
+    *phase_min = tim1_ss_sampled.phase_min;
+    *phase_max = tim1_ss_sampled.phase_max;
+    return tim1_ss_sampled.valid;
+}
+
+#else
+
+/*
+ * 比较值预装载已使能 (HAL_TIM_PWM_ConfigChannel 置位 OCxPE), 写入的比较值在下一个更新事件 (谷底, 双更新时为
+ * 下一个峰值或谷底) 生效, 与 ADC 注入组触发是同一事件, 因此调制方式切换、DPWM 钳位相变化都对齐到采样时刻。
+ * 双更新时前后半个周期的比较值可以不同 (非对称 PWM), 每半个周期的平均电压仍为 duty · Udc。
+ */
+CCMRAM_FUNC void tim1_set_pwm_duty(float duty1, float duty2, float duty3)
 {
     /* 计算比较值：compare = duty * TIM1_PERIOD */
-    uint32_t compare1 = (uint32_t)(duty1 * TIM1_PERIOD);
-    uint32_t compare2 = (uint32_t)(duty2 * TIM1_PERIOD);
-    uint32_t compare3 = (uint32_t)(duty3 * TIM1_PERIOD);
+    uint32_t compare1 = tim1_duty_to_compare(duty1);
+    uint32_t compare2 = tim1_duty_to_compare(duty2);
+    uint32_t compare3 = tim1_duty_to_compare(duty3);
 
     /* 设置比较值 */
     __HAL_TIM_SET_COMPARE(&htim1, TIM_CHANNEL_1, compare1);
@@ -108,6 +247,8 @@ void tim1_set_pwm_duty(float duty1, float duty2, float duty3)
     __HAL_TIM_SET_COMPARE(&htim1, TIM_CHANNEL_3, compare3);
 }
 
+#endif /* ADC_SINGLE_SHUNT */
+
 /*-----------------------------------------TIM3-----------------------------------------------------*/
 
 /* TIM3 编码器句柄 */
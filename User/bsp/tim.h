@@ -2,6 +2,8 @@
 #define __TIM_H__
 
 #include "stm32g4xx_hal.h"
+#include "foc/motor_profile.h"
+#include "bsp/adc.h"
 
 extern TIM_HandleTypeDef htim1;
 extern TIM_HandleTypeDef htim3;
@@ -14,13 +16,60 @@ extern TIM_HandleTypeDef htim3;
  * PWM频率: 170MHz / (1+0) / (8500*2) = 10kHz（中心对齐模式下ARR计两次）
  * 死区时间: 约1us
  */
+#define TIM1_CLK_FREQ 170000000.0f /* 定时器时钟 (Hz) */
 #define TIM1_PRESCALER 0  /* 预分频值 */
 #define TIM1_PERIOD 8400  /* 自动重装载值（ARR） */
 #define TIM1_DEADTIME 170 /* 死区时间：170/170MHz ≈ 1us */
 
+/*
+ * 更新方式 (编译选项 PWM_DOUBLE_UPDATE, 见 foc/motor_profile.h):
+ * 0: 重复计数器 = 1, 只在谷底产生更新事件, 每个 PWM 周期采样、控制、装载占空比各一次 (10kHz)
+ * 1: 重复计数器 = 0, 峰值与谷底都产生更新事件, TRGO 触发两次注入组转换, 占空比每半个周期装载一次 (20kHz),
+ *    控制延迟减半。峰值时上桥导通, 要求电流采样与开关状态无关 (相线串联采样);
+ *    下桥臂采样电阻方案只能在谷底采样, 不能使用双更新
+ *
+ * 单电阻采样 (ADC_SINGLE_SHUNT, 见 bsp/adc.h) 也需要峰值更新事件: 前后半个周期装载不同的比较值 (移相 PWM),
+ * 由 TIM1 更新中断在每个更新事件后写入下一个半周期的一组; 控制仍为每个 PWM 周期一次, 不能与双更新同时使用
+ */
+#if PWM_DOUBLE_UPDATE && ADC_SINGLE_SHUNT
+#error "ADC_SINGLE_SHUNT samples once per PWM period and cannot be combined with PWM_DOUBLE_UPDATE"
+#endif
+
+#define TIM1_UPDATE_AT_PEAK (PWM_DOUBLE_UPDATE || ADC_SINGLE_SHUNT)
+
+#if TIM1_UPDATE_AT_PEAK
+#define TIM1_REPETITION 0
+#else
+#define TIM1_REPETITION 1
+#endif
+
+/*
+ * TIM1 CH4 (无输出引脚) 用于触发 AS5047P 采集:
+ * 中心对齐模式1下输出比较标志只在向下计数时置位, CC4 事件位于谷底 (更新事件) 之前 CS_LEAD 个计数
+ * 85/170MHz = 0.5us, 满足 AS5047P CS 下降沿到第一个时钟沿 ≥350ns 的要求。
+ * 峰值也有更新事件时 (双更新, 单电阻采样) 改用中心对齐模式3 (上下计数都置位), 每帧结束后把 CCR4 改到下一个更新事件之前,
+ * 见 as5047.c
+ */
+#define TIM1_ENCODER_CS_LEAD 85
+
+/*
+ * 单电阻采样时序 (计数值): 有效矢量开始后经过死区与振荡稳定时间, 母线电流才等于相电流;
+ * 采样点放在窗口结束前 TIM1_SS_SAMPLE 个计数 (ADC 采样保持 12.5 个 ADC 时钟 ≈ 0.3us, 另留触发裕量)。
+ * 有效矢量短于 TIM1_SS_MIN_WINDOW 时 svpwm_single_shunt 移相补足。
+ */
+#define TIM1_SS_SETTLE 170 /* 死区后的振荡稳定时间: 1us */
+#define TIM1_SS_SAMPLE 85  /* 采样保持: 0.5us */
+#define TIM1_SS_MIN_WINDOW (TIM1_DEADTIME + TIM1_SS_SETTLE + TIM1_SS_SAMPLE) /* 最小窗口: 2.5us */
+
 void tim1_init(void);
 void tim1_set_pwm_duty(float duty1, float duty2, float duty3);
 
+/*
+ * 单电阻采样: 最近一组采样 (上一个向下计数半周期) 所用的相, 由 ADC 注入组中断在换算时调用
+ * 返回 0 表示该周期的窗口不足, 采样值不可用
+ */
+uint8_t tim1_single_shunt_sampled(uint8_t *phase_min, uint8_t *phase_max);
+
 void tim3_init(void);
 
 #endif /* __TIM_H__ */
@@ -8,6 +8,7 @@ _fff_init(fifo_uart_tx);                   // 初始化FIFO
 static uint8_t tx_dma_buf[256];
 static volatile uint8_t tx_dma_busy = 0;
 static volatile uint32_t tx_overflow_count = 0;  // 溢出计数器
+static usart1_tx_callback_p tx_callback = NULL;  // DMA 发送完成回调 (遥测等)
 
 /* 启动DMA发送 */
 static void usart1_start_dma_tx(void)
@@ -37,7 +38,13 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
     if (huart->Instance == USART1)
     {
         tx_dma_busy = 0;
-        
+
+        /* 先交给注册的回调 (如遥测的下一个缓冲区), 再续传 printf FIFO */
+        if (tx_callback != NULL)
+        {
+            tx_callback();
+        }
+
         /* 如果FIFO还有数据，继续发送 */
         usart1_start_dma_tx();
     }
@@ -190,6 +197,24 @@ void usart1_send_data(uint8_t *data, uint16_t size)
     HAL_UART_Transmit_DMA(&huart1, data, size); /* DMA 方式发送数据 */
 }
 
+/* 非阻塞 DMA 发送, 与 printf FIFO 共用 tx_dma_busy 标志, 调用方需保证与发送完成中断互斥 */
+uint8_t usart1_send_dma_async(uint8_t *data, uint16_t size)
+{
+    if (tx_dma_busy || huart1.gState != HAL_UART_STATE_READY)
+    {
+        return 1;
+    }
+
+    tx_dma_busy = 1;
+    HAL_UART_Transmit_DMA(&huart1, data, size);
+    return 0;
+}
+
+void usart1_register_tx_callback(usart1_tx_callback_p callback)
+{
+    tx_callback = callback;
+}
+
 /* 从FIFO读取指定数量的数据 */
 uint16_t usart1_read_data(uint8_t *buf, uint16_t max_size)
 {
@@ -12,8 +12,22 @@ extern DMA_HandleTypeDef hdma_usart1_tx; /* 声明USART1发送DMA句柄 */
 #define RX_BUF_TEMP_SIZE 64 /* 定义临时接收缓冲区大小为64字节 */
 #define RX_BUFFER_SIZE 128  /* 定义接收缓冲区大小为128字节 */
 
+/* DMA 发送完成回调 (中断上下文) */
+typedef void (*usart1_tx_callback_p)(void);
+
 void usart1_init(void);
 void usart1_send_data(uint8_t *data, uint16_t size);
+
+/**
+ * @brief 非阻塞 DMA 发送
+ * @param data 发送缓冲区, 发送完成前不能修改
+ * @param size 字节数
+ * @return 0: 已启动; 1: 上一次发送尚未完成
+ */
+uint8_t usart1_send_dma_async(uint8_t *data, uint16_t size);
+
+/* 注册 DMA 发送完成回调, 在 printf FIFO 续传之前调用 */
+void usart1_register_tx_callback(usart1_tx_callback_p callback);
 uint16_t usart1_read_data(uint8_t *buf, uint16_t max_size);
 
 uint16_t usart1_get_available_buffer(void);
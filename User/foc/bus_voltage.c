@@ -0,0 +1,32 @@
+#include "bus_voltage.h"
+#include "utils/ccmram.h"
+
+void bus_voltage_init(bus_voltage_t *bus, float ts, float fc, float udc_nominal, float udc_min, float udc_max)
+{
+    float wc_ts = 2.0f * 3.14159265f * fc * ts;
+
+    bus->k_filter = wc_ts / (1.0f + wc_ts);
+    bus->udc_min = udc_min;
+    bus->udc_max = udc_max;
+    bus->inv_udc_nominal = 1.0f / udc_nominal;
+
+    bus->udc = udc_nominal;
+    bus->inv_udc = bus->inv_udc_nominal;
+    bus->ratio = 1.0f;
+}
+
+CCMRAM_FUNC float bus_voltage_update(bus_voltage_t *bus, float udc_meas)
+{
+    float udc = bus->udc + bus->k_filter * (udc_meas - bus->udc);
+
+    if (udc < bus->udc_min)
+        udc = bus->udc_min;
+    else if (udc > bus->udc_max)
+        udc = bus->udc_max;
+
+    bus->udc = udc;
+    bus->inv_udc = 1.0f / udc; /* 每周期唯一的一次除法 */
+    bus->ratio = udc * bus->inv_udc_nominal;
+
+    return udc;
+}
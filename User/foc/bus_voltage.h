@@ -0,0 +1,53 @@
+#ifndef __BUS_VOLTAGE_H__
+#define __BUS_VOLTAGE_H__
+
+#include <math.h>
+
+/**
+ * 母线电压估计
+ *
+ * 每个控制周期用注入组采样的 Udc 更新一次: 一阶低通滤波后限幅, 计算一次 1/Udc,
+ * SVPWM 占空比归一化、电压限幅与弱磁参考都只用乘法, 不在每相上做除法。
+ * 本周期计算的占空比在下一个 PWM 周期才生效, 电机阻抗很小 (0.12Ω), 母线估计的相位滞后会直接变成电流扰动,
+ * 因此截止频率取得较高 (默认 2kHz, 滞后约 0.8 个周期), 只滤除采样噪声, 跟踪负载引起的跌落与纹波。
+ */
+
+/* 默认滤波截止频率 (Hz) */
+#ifndef BUS_VOLTAGE_FILTER_FC
+#define BUS_VOLTAGE_FILTER_FC 2000.0f
+#endif
+
+typedef struct
+{
+    /* 参数 */
+    float k_filter;        /* 一阶低通系数 */
+    float udc_min;         /* 限幅下限 (V), 采样异常或欠压时按下限归一化, 避免占空比被过度放大 */
+    float udc_max;         /* 限幅上限 (V) */
+    float inv_udc_nominal; /* 1 / 额定电压 */
+
+    /* 输出 */
+    float udc;     /* 滤波后母线电压 (V) */
+    float inv_udc; /* 1 / udc */
+    float ratio;   /* udc / 额定电压, 用于缩放按额定电压整定的电压限幅 */
+} bus_voltage_t;
+
+/**
+ * @brief 初始化, 输出置为额定电压
+ * @param bus         句柄
+ * @param ts          控制周期 (s)
+ * @param fc          滤波截止频率 (Hz)
+ * @param udc_nominal 额定母线电压 (V)
+ * @param udc_min     限幅下限 (V)
+ * @param udc_max     限幅上限 (V)
+ */
+void bus_voltage_init(bus_voltage_t *bus, float ts, float fc, float udc_nominal, float udc_min, float udc_max);
+
+/**
+ * @brief 每个控制周期调用一次: 滤波 + 限幅 + 计算 1/Udc
+ * @param bus      句柄
+ * @param udc_meas 本周期采样的母线电压 (V)
+ * @return 滤波后母线电压 (V)
+ */
+float bus_voltage_update(bus_voltage_t *bus, float udc_meas);
+
+#endif /* __BUS_VOLTAGE_H__ */
@@ -1,16 +1,18 @@
 #include "clark_park.h"
+#include "utils/ccmram.h"
 
-alphabeta_t clark_transform(abc_t abc)
+#define ONE_BY_SQRT3 0.57735026919f /* 1/√3 */
+#define SQRT3_BY_2 0.86602540378f   /* √3/2 */
+
+CCMRAM_FUNC alphabeta_t clark_transform(abc_t abc)
 {
     alphabeta_t alpha_beta;
 
-    float one_by_sqrt3 = 1.0f / sqrtf(3.0f);
-
     // iα = Ia
     alpha_beta.alpha = abc.a;
 
     // iβ = (1/√3)Ia + (2/√3)Ib
-    alpha_beta.beta = one_by_sqrt3 * abc.a + 2.0f * one_by_sqrt3 * abc.b;
+    alpha_beta.beta = ONE_BY_SQRT3 * abc.a + 2.0f * ONE_BY_SQRT3 * abc.b;
 
     return alpha_beta;
 }
@@ -19,13 +21,11 @@ abc_t iclark_transform(alphabeta_t alpha_beta)
 {
     abc_t abc;
 
-    float sqrt3_by_2 = sqrtf(3.0f) / 2.0f;
-
     // Ia = iα
     abc.a = alpha_beta.alpha;
 
     // Ib = -iα/2 + (√3/2)iβ
-    abc.b = -0.5f * alpha_beta.alpha + sqrt3_by_2 * alpha_beta.beta;
+    abc.b = -0.5f * alpha_beta.alpha + SQRT3_BY_2 * alpha_beta.beta;
 
     // Ic = -Ia - Ib
     abc.c = -abc.a - abc.b;
@@ -33,14 +33,14 @@ abc_t iclark_transform(alphabeta_t alpha_beta)
     return abc;
 }
 
-dq_t park_transform(alphabeta_t alpha_beta, float theta)
+CCMRAM_FUNC dq_t park_transform(alphabeta_t alpha_beta, angle_t theta)
 {
     dq_t dq;
 
     float sin_theta, cos_theta;
 
     // 计算sinθ和cosθ
-    fast_sin_cos(theta, &sin_theta, &cos_theta);
+    angle_sin_cos(theta, &sin_theta, &cos_theta);
 
     // id = iα*cosθ + iβ*sinθ
     dq.d = alpha_beta.alpha * cos_theta + alpha_beta.beta * sin_theta;
@@ -51,14 +51,14 @@ dq_t park_transform(alphabeta_t alpha_beta, float theta)
     return dq;
 }
 
-alphabeta_t ipark_transform(dq_t dq, float theta)
+CCMRAM_FUNC alphabeta_t ipark_transform(dq_t dq, angle_t theta)
 {
     alphabeta_t alpha_beta;
 
     float sin_theta, cos_theta;
 
     // 计算sinθ和cosθ
-    fast_sin_cos(theta, &sin_theta, &cos_theta);
+    angle_sin_cos(theta, &sin_theta, &cos_theta);
 
     // 反Park变换公式 Iα = Id*cosθ - Iq*sinθ
     alpha_beta.alpha = dq.d * cos_theta - dq.q * sin_theta;
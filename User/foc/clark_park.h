@@ -3,6 +3,7 @@
 
 #include "stm32g4xx_hal.h"
 #include "./utils/fast_sin_cos.h"
+#include "./utils/angle.h"
 
 /* 三相坐标系 */
 typedef struct
@@ -28,7 +29,7 @@ typedef struct
 
 alphabeta_t clark_transform(abc_t abc);
 abc_t iclark_transform(alphabeta_t alpha_beta);
-dq_t park_transform(alphabeta_t alpha_beta, float theta);
-alphabeta_t ipark_transform(dq_t dq, float theta);
+dq_t park_transform(alphabeta_t alpha_beta, angle_t theta);
+alphabeta_t ipark_transform(dq_t dq, angle_t theta);
 
 #endif /* __CLARK_PARK_H__ */
\ No newline at end of file
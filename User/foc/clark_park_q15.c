@@ -0,0 +1,71 @@
+#include "clark_park_q15.h"
+
+#define Q15_ONE_BY_SQRT3 18919  /* 1/√3 */
+#define Q15_TWO_BY_SQRT3 37837  /* 2/√3, 超出 Q15 范围, 仅用于 32 位乘法 */
+#define Q15_SQRT3_BY_2 28378    /* √3/2 */
+
+alphabeta_q15_t clark_transform_q15(abc_q15_t abc)
+{
+    alphabeta_q15_t alpha_beta;
+
+    // iα = Ia
+    alpha_beta.alpha = abc.a;
+
+    // iβ = (1/√3)Ia + (2/√3)Ib
+    alpha_beta.beta = q15_sat((Q15_ONE_BY_SQRT3 * abc.a + Q15_TWO_BY_SQRT3 * abc.b + (1 << 14)) >> 15);
+
+    return alpha_beta;
+}
+
+abc_q15_t iclark_transform_q15(alphabeta_q15_t alpha_beta)
+{
+    abc_q15_t abc;
+
+    // Ia = iα
+    abc.a = alpha_beta.alpha;
+
+    // Ib = -iα/2 + (√3/2)iβ
+    int32_t b = (-16384 * alpha_beta.alpha + Q15_SQRT3_BY_2 * alpha_beta.beta + (1 << 14)) >> 15;
+    abc.b = q15_sat(b);
+
+    // Ic = -Ia - Ib
+    abc.c = q15_sat(-(int32_t)alpha_beta.alpha - b);
+
+    return abc;
+}
+
+dq_q15_t park_transform_q15(alphabeta_q15_t alpha_beta, uint16_t theta)
+{
+    dq_q15_t dq;
+
+    q15_t sin_theta, cos_theta;
+
+    // 计算sinθ和cosθ
+    qmath_sin_cos(theta, &sin_theta, &cos_theta);
+
+    // id = iα*cosθ + iβ*sinθ
+    dq.d = q15_sat((alpha_beta.alpha * cos_theta + alpha_beta.beta * sin_theta + (1 << 14)) >> 15);
+
+    // iq = -iα*sinθ + iβ*cosθ
+    dq.q = q15_sat((-alpha_beta.alpha * sin_theta + alpha_beta.beta * cos_theta + (1 << 14)) >> 15);
+
+    return dq;
+}
+
+alphabeta_q15_t ipark_transform_q15(dq_q15_t dq, uint16_t theta)
+{
+    alphabeta_q15_t alpha_beta;
+
+    q15_t sin_theta, cos_theta;
+
+    // 计算sinθ和cosθ
+    qmath_sin_cos(theta, &sin_theta, &cos_theta);
+
+    // 反Park变换公式 Iα = Id*cosθ - Iq*sinθ
+    alpha_beta.alpha = q15_sat((dq.d * cos_theta - dq.q * sin_theta + (1 << 14)) >> 15);
+
+    // Iβ = Id*sinθ + Iq*cosθ
+    alpha_beta.beta = q15_sat((dq.d * sin_theta + dq.q * cos_theta + (1 << 14)) >> 15);
+
+    return alpha_beta;
+}
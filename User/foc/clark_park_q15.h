@@ -0,0 +1,52 @@
+#ifndef __CLARK_PARK_Q15_H__
+#define __CLARK_PARK_Q15_H__
+
+#include "clark_park.h"
+#include "svpwm.h"
+#include "./utils/qmath.h"
+
+/**
+ * 定点后端标幺值基准
+ *
+ * - 电流: Q15 1.0 = FOC_Q15_I_BASE (A), 覆盖 ADC 电流量程 (±10 A) 并留余量
+ * - 电压: Q15 1.0 = FOC_Q15_U_BASE (V), 取母线电压, SVPWM 因此无需除以 U_DC
+ * - 电角速度: Q15 1.0 = FOC_Q15_W_BASE (rad/s), 对应 7 对极 10000 rpm 以上
+ * - 角度: uint16_t, 65536 = 2π (电角度)
+ */
+#define FOC_Q15_I_BASE 16.0f
+#define FOC_Q15_U_BASE U_DC
+#define FOC_Q15_W_BASE 8192.0f
+
+/* 物理量 -> Q15 (仅用于常量与初始化) */
+#define FOC_Q15_CURRENT(a) Q15((a) / FOC_Q15_I_BASE)
+#define FOC_Q15_VOLTAGE(v) Q15((v) / FOC_Q15_U_BASE)
+#define FOC_Q15_SPEED(w) Q15((w) / FOC_Q15_W_BASE)
+
+/* 三相坐标系 */
+typedef struct
+{
+    q15_t a; /* U */
+    q15_t b; /* V */
+    q15_t c; /* W */
+} abc_q15_t;
+
+/* 静止坐标系 */
+typedef struct
+{
+    q15_t alpha;
+    q15_t beta;
+} alphabeta_q15_t;
+
+/* 旋转坐标系 */
+typedef struct
+{
+    q15_t d;
+    q15_t q;
+} dq_q15_t;
+
+alphabeta_q15_t clark_transform_q15(abc_q15_t abc);
+abc_q15_t iclark_transform_q15(alphabeta_q15_t alpha_beta);
+dq_q15_t park_transform_q15(alphabeta_q15_t alpha_beta, uint16_t theta);
+alphabeta_q15_t ipark_transform_q15(dq_q15_t dq, uint16_t theta);
+
+#endif /* __CLARK_PARK_Q15_H__ */
@@ -0,0 +1,48 @@
+#include "deadtime_comp.h"
+#include "utils/ccmram.h"
+
+void deadtime_comp_init(deadtime_comp_t *dtc, float t_dead, float t_pwm, float v_drop, float i_band)
+{
+    dtc->t_ratio = t_dead / t_pwm;
+    dtc->v_drop = v_drop;
+    dtc->inv_i_band = 1.0f / i_band;
+    dtc->v_comp.alpha = 0.0f;
+    dtc->v_comp.beta = 0.0f;
+    dtc->enable = 1;
+}
+
+/* 带线性过渡区的符号函数: [-1, 1] */
+static inline float deadtime_sat(float x)
+{
+    if (x > 1.0f)
+        return 1.0f;
+    if (x < -1.0f)
+        return -1.0f;
+    return x;
+}
+
+CCMRAM_FUNC alphabeta_t deadtime_comp_update(deadtime_comp_t *dtc, alphabeta_t i_alphabeta, float udc)
+{
+    if (!dtc->enable)
+    {
+        dtc->v_comp.alpha = 0.0f;
+        dtc->v_comp.beta = 0.0f;
+        return dtc->v_comp;
+    }
+
+    /* 反 Clark 得到三相参考电流, 逐相按极性给出补偿量 */
+    float ia = i_alphabeta.alpha;
+    float ib = -0.5f * i_alphabeta.alpha + 0.866025f * i_alphabeta.beta;
+    float ic = -0.5f * i_alphabeta.alpha - 0.866025f * i_alphabeta.beta;
+
+    float dv = dtc->t_ratio * udc + dtc->v_drop;
+    float da = dv * deadtime_sat(ia * dtc->inv_i_band);
+    float db = dv * deadtime_sat(ib * dtc->inv_i_band);
+    float dc = dv * deadtime_sat(ic * dtc->inv_i_band);
+
+    /* Clark 变换 (等幅值), 共模分量不影响线电压 */
+    dtc->v_comp.alpha = (2.0f / 3.0f) * (da - 0.5f * (db + dc));
+    dtc->v_comp.beta = (db - dc) * 0.577350f;
+
+    return dtc->v_comp;
+}
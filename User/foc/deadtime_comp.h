@@ -0,0 +1,54 @@
+#ifndef __DEADTIME_COMP_H__
+#define __DEADTIME_COMP_H__
+
+#include <math.h>
+#include "clark_park.h"
+
+/**
+ * 死区 / 逆变器非线性补偿
+ *
+ * 死区期间桥臂输出由续流方向决定: 电流流出桥臂 (i > 0) 时输出被拉低, 流入时被抬高,
+ * 每相平均电压损失 Δv = (t_dead / T_pwm)·Udc + v_drop, 符号与相电流相反。
+ * 10kHz PWM、约 1.25us 死区时相当于 1.25% 的母线电压, 低速小电压时占指令电压的相当比例,
+ * 使相电流在过零附近畸变, 观测器使用的指令电压也与实际电压不符。
+ *
+ * 补偿在反 Park 之后、SVPWM 之前叠加到 αβ 电压上: 按电流参考 (Id / Iq 指令转到三相) 的极性给每相
+ * 加 +Δv·sat(i / i_band), |i| < i_band 的过渡区内线性变化, 避免电流过零时补偿电压来回跳变。
+ * 使用参考电流而不是采样电流, 采样噪声不会引起补偿抖动。
+ * 观测器仍读取补偿前的指令电压 (即期望加到电机上的电压)。
+ */
+
+/* TIM1_DEADTIME = 170: DTG[7:6] = 10b, 死区 = (64 + DTG[5:0])·2·tDTS = (64 + 42)·2 / 170MHz ≈ 1.25us */
+#ifndef DEADTIME_COMP_T_DEAD
+#define DEADTIME_COMP_T_DEAD 1.247e-6f
+#endif
+
+typedef struct
+{
+    uint8_t enable;     /* 0: 不补偿 (输出 0) */
+    float t_ratio;      /* 死区时间 / PWM 周期 */
+    float v_drop;       /* 开关管导通压降 (V) */
+    float inv_i_band;   /* 1 / 过渡区半宽 (1/A) */
+    alphabeta_t v_comp; /* 最近一次补偿电压 (αβ, V) */
+} deadtime_comp_t;
+
+/**
+ * @brief 初始化并使能
+ * @param dtc    句柄
+ * @param t_dead 死区时间 (s)
+ * @param t_pwm  PWM 周期 (s)
+ * @param v_drop 开关管 / 二极管导通压降 (V), 不建模时取 0
+ * @param i_band 过渡区半宽 (A), 通常取电流纹波峰峰值的一半
+ */
+void deadtime_comp_init(deadtime_comp_t *dtc, float t_dead, float t_pwm, float v_drop, float i_band);
+
+/**
+ * @brief 计算本周期补偿电压
+ * @param dtc         句柄
+ * @param i_alphabeta αβ 电流参考 (A)
+ * @param udc         母线电压 (V)
+ * @return αβ 补偿电压 (V), 叠加到 SVPWM 输入上
+ */
+alphabeta_t deadtime_comp_update(deadtime_comp_t *dtc, alphabeta_t i_alphabeta, float udc);
+
+#endif /* __DEADTIME_COMP_H__ */
@@ -1,9 +1,11 @@
 #include "flux_weakening.h"
+#include "utils/ccmram.h"
 
 void flux_weak_init(flux_weak_t *flux_weak, float u_dc, float u_ref_ratio, float ki, float id_min)
 {
     flux_weak->id_ref = 0.0f;
     flux_weak->u_dc = u_dc;
+    flux_weak->u_max_k = 1.0f;
     flux_weak->u_ref_ratio = u_ref_ratio;
 
     // 初始化 PID 控制器: 纯积分控制 (Kp=0)
@@ -14,7 +16,16 @@ void flux_weak_init(flux_weak_t *flux_weak, float u_dc, float u_ref_ratio, float
     flux_weak->voltage_filter_const = 0.02f;
 }
 
-float flux_weak_calculate(flux_weak_t *flux_weak, float v_d, float v_q)
+void flux_weak_set_div(flux_weak_t *flux_weak, uint16_t div)
+{
+    if (div <= 1)
+        return;
+
+    flux_weak->pid.ki *= (float)div;
+    flux_weak->voltage_filter_const = 1.0f - powf(1.0f - flux_weak->voltage_filter_const, (float)div);
+}
+
+CCMRAM_FUNC float flux_weak_calculate(flux_weak_t *flux_weak, float v_d, float v_q)
 {
     /* 计算当前电压模值 */
     float u_mag = sqrtf(v_d * v_d + v_q * v_q);
@@ -23,7 +34,7 @@ float flux_weak_calculate(flux_weak_t *flux_weak, float v_d, float v_q)
     flux_weak->u_current_filtered = flux_weak->u_current_filtered * (1.0f - flux_weak->voltage_filter_const) + u_mag * flux_weak->voltage_filter_const;
 
     /* 计算目标电压参考值 */
-    float u_ref = flux_weak->u_dc * flux_weak->u_ref_ratio;
+    float u_ref = flux_weak->u_dc * flux_weak->u_max_k * flux_weak->u_ref_ratio;
 
     /* 当 u_current > u_ref (反馈>目标) 时，误差 < 0，PID 输出负值 (弱磁电流) */
     flux_weak->id_ref = pid_calculate(&flux_weak->pid, u_ref, flux_weak->u_current_filtered);
@@ -7,7 +7,8 @@
 typedef struct {
     float id_ref;           /* 输出的 Id 参考值 */
     float u_dc;             /* 母线电压 */
-    float u_ref_ratio;      /* 弱磁起始电压占比 (如 0.95) */
+    float u_max_k;          /* 可用电压矢量幅值 / 母线电压 (默认 1.0, FOC 中为电压矢量上限系数) */
+    float u_ref_ratio;      /* 弱磁起始电压占比 (如 0.95), 起始电压 = u_dc · u_max_k · u_ref_ratio */
     
     pid_controller_t pid;   /* 使用通用 PID 控制器 */
 
@@ -25,6 +26,27 @@ typedef struct {
  */
 void flux_weak_init(flux_weak_t *flux_weak, float u_dc, float u_ref_ratio, float ki, float id_min);
 
+/**
+ * @brief 按执行间隔缩放积分系数与电压滤波系数 (flux_weak_init 之后调用一次)
+ * @param flux_weak 句柄
+ * @param div       每 div 个控制周期执行一次 flux_weak_calculate
+ * @note  init 中的 ki 与滤波系数按每周期执行整定, 分频执行时积分放大 div 倍, 滤波系数取 1 - (1 - a)^div,
+ *        连续时间下的积分增益与滤波时间常数不变
+ */
+void flux_weak_set_div(flux_weak_t *flux_weak, uint16_t div);
+
+/* 更新母线电压 (每个控制周期由 foc_set_bus_voltage 调用), 弱磁起始电压随之变化 */
+static inline void flux_weak_set_udc(flux_weak_t *flux_weak, float u_dc)
+{
+    flux_weak->u_dc = u_dc;
+}
+
+/* 设置可用电压矢量幅值与母线电压之比 (线性调制 ≤ 1/√3, 过调制到六拍为 2/π) */
+static inline void flux_weak_set_u_max_k(flux_weak_t *flux_weak, float u_max_k)
+{
+    flux_weak->u_max_k = u_max_k;
+}
+
 /**
  * @brief 计算弱磁电流
  * @param flux_weak 句柄
@@ -1,4 +1,5 @@
 #include "foc.h"
+#include "utils/ccmram.h"
 
 void foc_init(foc_t *handle, pid_controller_t *pid_id, pid_controller_t *pid_iq, pid_controller_t *pid_speed)
 {
@@ -22,12 +23,41 @@ void foc_init(foc_t *handle, pid_controller_t *pid_id, pid_controller_t *pid_iq,
     handle->duty_cycle.b = 0.0f;
     handle->duty_cycle.c = 0.0f;
 
-    handle->angle_offset = 0.0f;
-    handle->open_loop_angle_el = 0.0f;
+    foc_transform_init(&handle->transform);
+
+    /* 母线电压: 从额定值开始, 电流环限幅以 pid_init 中按 U_DC 整定的值为基准 */
+    bus_voltage_init(&handle->bus, MOTOR_TS, BUS_VOLTAGE_FILTER_FC, U_DC, 0.5f * U_DC, 2.0f * U_DC);
+    handle->v_limit_nom = pid_iq->out_max;
+    handle->v_max_k = FOC_V_MAX_K;
+    handle->v_max = FOC_V_MAX_K * U_DC;
+    handle->v_limited = 0;
+
+    /* 解耦前馈默认关闭, 由 foc_decouple_init 给出电机参数后使能 */
+    handle->decouple.enable = 0;
+    handle->decouple.ld = 0.0f;
+    handle->decouple.lq = 0.0f;
+    handle->decouple.flux = 0.0f;
+    handle->decouple.omega_e = 0.0f;
+
+    /* 死区补偿默认关闭, 需要时用 deadtime_comp_init 按实际死区 / 压降重新初始化 */
+    deadtime_comp_init(&handle->deadtime, DEADTIME_COMP_T_DEAD, MOTOR_PWM_TS, 0.0f, 0.1f);
+    handle->deadtime.enable = 0;
+
+    handle->current_recon = FOC_CURRENT_RECON;
+
+    /* 速度环分频: 第 0 个周期执行, 与 as5047_speed_reset() 之后的转速刷新同相 */
+    sched_task_init(&handle->speed_task, FOC_SPEED_DIV, 0);
+
+    /* 角度延迟补偿: 编译时默认值, 运行中可用 foc_set_delay_comp 修改 */
+    foc_set_delay_comp(handle, FOC_PWM_DELAY_TS, FOC_ENCODER_DELAY_TS);
+
+    handle->angle_offset = 0;
+    handle->open_loop_angle_el = 0;
 
     /* 初始化弱磁控制器 */
     // 弱磁电流限制，防止永磁体退磁
     flux_weak_init(&handle->flux_weak, U_DC, 0.85f, 0.005f, -2.0f);
+    flux_weak_set_u_max_k(&handle->flux_weak, FOC_V_MAX_K); /* 起始电压相对电流环实际可用的电压矢量上限 */
 }
 
 void foc_alignment(foc_t *handle)
@@ -44,14 +74,14 @@ void foc_alignment(foc_t *handle)
     HAL_Delay(1000);
 
     /* 读取当前电角度作为零点偏移 */
-    handle->angle_offset = as5047_get_angle_rad();
+    handle->angle_offset = as5047_get_angle_el();
 
     /* 关闭PWM输出 */
     tim1_set_pwm_duty(0.5f, 0.5f, 0.5f);
 }
 
 /**
- * @brief 开环速度运行 - 在定时中断中调用 (10kHz)
+ * @brief 开环速度运行 - 在定时中断中调用 (每个控制周期)
  * @param handle    FOC 控制句柄
  * @param speed_rpm 目标转速 (RPM)，是旋转磁场速度，不能太大，否则电机会失步
  * @param voltage_q Q轴电压幅值 (V)
@@ -59,84 +89,195 @@ void foc_alignment(foc_t *handle)
 void foc_open_loop_run(foc_t *handle, float speed_rpm, float voltage_q)
 {
     /* 计算每次中断的角度增量
-     * delta_angle = 2π × 极对数 × (转速RPM / 60) × 采样周期
-     * 采样周期 = 1/10000 = 0.0001s
+     * delta_angle = 2π × 极对数 × (转速RPM / 60) × 采样周期, 系数由 motor_profile.h 预先算好
      */
-    float delta_angle = 2.0f * M_PI * AS5047_MOTOR_POLE_PAIR * (speed_rpm / 60.0f) * 0.0001f;
+    angle_t delta_angle = angle_delta_from_rad(speed_rpm * MOTOR_RPM_TO_DELTA_ANGLE);
 
-    /* 累加电角度 */
+    /* 累加电角度 (整数角度溢出即回绕) */
     handle->open_loop_angle_el += delta_angle;
 
     /* 输出电压矢量：d轴为0，q轴为设定电压 */
     dq_t u_dq = {.d = 0.0f, .q = voltage_q};
 
-    /* 执行开环输出 */
-    alphabeta_t alpha_beta = ipark_transform(u_dq, handle->open_loop_angle_el);
-    abc_t duty_abc = svpwm_update(alpha_beta);
+    /* 执行开环输出: 反 Park + SVPWM */
+    foc_transform_set_angle(&handle->transform, handle->open_loop_angle_el);
+    abc_t duty_abc = foc_transform_modulate(&handle->transform, u_dq);
+    isr_prof_mark(ISR_PROF_SVPWM);
     tim1_set_pwm_duty(duty_abc.a, duty_abc.b, duty_abc.c);
+    isr_prof_mark(ISR_PROF_PWM_WRITE);
+}
+
+/**
+ * @brief dq 电压矢量圆限幅
+ * @param v     PI 输出的 dq 电压 (V)
+ * @param v_max 矢量幅值上限 (V)
+ * @return 限幅后的 dq 电压
+ * @note  d 轴优先: vd 先限到 ±v_max, vq 再限到剩余幅值 √(v_max² - vd²)。
+ *        各轴单独限幅时矢量可超出 SVPWM 六边形, 由 SVPWM 等比缩小后 d 轴电压也被削减,
+ *        两个积分项都在饱和; d 轴优先保证磁场控制 (弱磁) 不受转矩指令影响。
+ *        未饱和时只做一次比较, 不开方。
+ */
+CCMRAM_FUNC dq_t foc_voltage_limit(dq_t v, float v_max)
+{
+    if (v.d * v.d + v.q * v.q <= v_max * v_max)
+        return v;
+
+    if (v.d > v_max)
+        v.d = v_max;
+    else if (v.d < -v_max)
+        v.d = -v_max;
+
+    float vq_max = sqrtf(v_max * v_max - v.d * v.d);
+    if (v.q > vq_max)
+        v.q = vq_max;
+    else if (v.q < -vq_max)
+        v.q = -vq_max;
+
+    return v;
+}
+
+/**
+ * @brief 交叉耦合 + 反电势前馈电压
+ * @param dec  解耦参数
+ * @param i_dq dq 轴电流反馈
+ * @return 前馈电压 (V): vd_ff = -ωe·Lq·iq, vq_ff = ωe·(Ld·id + ψf)
+ * @note  电机 dq 电压方程 vd = Rs·id + Ld·did/dt - ωe·Lq·iq, vq = Rs·iq + Lq·diq/dt + ωe·(Ld·id + ψf),
+ *        前馈抵消速度相关项后两个 PI 只看到 Rs + sL 的 RL 负载, 电流阶跃响应与转速无关
+ */
+CCMRAM_FUNC static dq_t foc_decouple_ff(const foc_decouple_t *dec, dq_t i_dq)
+{
+    if (!dec->enable)
+        return (dq_t){.d = 0.0f, .q = 0.0f};
+
+    return (dq_t){.d = -dec->omega_e * dec->lq * i_dq.q,
+                  .q = dec->omega_e * (dec->ld * i_dq.d + dec->flux)};
+}
+
+/**
+ * @brief 电流环 PI + 前馈 + 电压矢量圆限幅, 输出写入 v_d_out / v_q_out
+ * @param v_ff 前馈电压 (V), 不需要时传 0
+ * @note  限幅作用在 PI + 前馈的合成电压上, 限幅量反算回两个积分项 (扣除前馈),
+ *        电压饱和时电流环仍保持线性, 退出饱和无超调
+ */
+CCMRAM_FUNC static void foc_current_pi(foc_t *handle, dq_t i_dq, dq_t v_ff)
+{
+    dq_t v_pi = {.d = pid_calculate(handle->pid_id, handle->target_id, i_dq.d) + v_ff.d,
+                 .q = pid_calculate(handle->pid_iq, handle->target_iq, i_dq.q) + v_ff.q};
+
+    dq_t v = foc_voltage_limit(v_pi, handle->v_max);
+    handle->v_limited = (v.d != v_pi.d) || (v.q != v_pi.q);
+    if (handle->v_limited)
+    {
+        pid_back_calculate(handle->pid_id, v.d - v_ff.d);
+        pid_back_calculate(handle->pid_iq, v.q - v_ff.q);
+    }
+
+    handle->v_d_out = v.d;
+    handle->v_q_out = v.q;
 }
 
 /**
- * @brief I/F 电流开环运行 - 在定时中断中调用 (10kHz)
+ * @brief 死区补偿电压: 按本周期电流指令 (转到 αβ) 的极性计算, 需先设置本周期角度
+ */
+CCMRAM_FUNC static alphabeta_t foc_deadtime_comp(foc_t *handle)
+{
+    if (!handle->deadtime.enable)
+        return (alphabeta_t){.alpha = 0.0f, .beta = 0.0f};
+
+    alphabeta_t i_ref = foc_transform_ipark(&handle->transform, (dq_t){.d = handle->target_id, .q = handle->target_iq});
+    return deadtime_comp_update(&handle->deadtime, i_ref, handle->bus.udc);
+}
+
+/**
+ * @brief I/F 电流开环运行 - 在定时中断中调用 (每个控制周期)
  * @param handle    FOC 控制句柄
  * @param i_dq      dq 轴电流反馈
  * @param speed_rpm 目标转速 (RPM)，旋转磁场速度
  * @param current_q Q轴目标电流 (A)
  */
-void foc_if_current_run(foc_t *handle, dq_t i_dq, float speed_rpm, float current_iq)
+CCMRAM_FUNC void foc_if_current_run(foc_t *handle, dq_t i_dq, float speed_rpm, float current_iq)
 {
-    float delta_angle = 2.0f * M_PI * AS5047_MOTOR_POLE_PAIR * (speed_rpm / 60.0f) * 0.0001f;
+    angle_t delta_angle = angle_delta_from_rad(speed_rpm * MOTOR_RPM_TO_DELTA_ANGLE);
 
-    /* 累加电角度 */
+    /* 累加电角度 (整数角度溢出即回绕) */
     handle->open_loop_angle_el += delta_angle;
 
     /* 设置目标电流 */
     handle->target_id = 0.0f;
     handle->target_iq = current_iq;
 
-    /* 电流环 PID 控制 */
-    handle->v_d_out = pid_calculate(handle->pid_id, handle->target_id, i_dq.d);
-    handle->v_q_out = pid_calculate(handle->pid_iq, handle->target_iq, i_dq.q);
-
-    /* 逆 Park 变换 - 使用 I/F 角度 */
-    alphabeta_t v_alphabeta = ipark_transform((dq_t){.d = handle->v_d_out, .q = handle->v_q_out}, handle->open_loop_angle_el);
+    /* 电流环 PID 控制 (I/F 角度与转子角度不一致, 不做解耦前馈) */
+    foc_current_pi(handle, i_dq, (dq_t){.d = 0.0f, .q = 0.0f});
+    isr_prof_mark(ISR_PROF_PI);
 
-    /* SVPWM 输出 */
-    handle->duty_cycle = svpwm_update(v_alphabeta);
+    /* 逆 Park + SVPWM 输出 - 使用 I/F 角度 (下一周期 Park 沿用同一角度, 命中缓存) */
+    foc_transform_set_angle(&handle->transform, handle->open_loop_angle_el);
+    handle->duty_cycle = foc_transform_modulate_comp(&handle->transform, (dq_t){.d = handle->v_d_out, .q = handle->v_q_out},
+                                                     foc_deadtime_comp(handle));
+    isr_prof_mark(ISR_PROF_SVPWM);
     tim1_set_pwm_duty(handle->duty_cycle.a, handle->duty_cycle.b, handle->duty_cycle.c);
+    isr_prof_mark(ISR_PROF_PWM_WRITE);
 }
 
 /**
  * @brief 电流闭环运行
  * @param handle    FOC 控制句柄
  * @param i_dq      dq 轴电流反馈
- * @param angle_el  电角度 (rad)
+ * @param angle_el  电角度 (2^32 = 2π), 本周期采样时刻的转子角度
+ * @note  反 Park 使用 angle_el + ωe · delay.pwm_ts (ωe 由 foc_set_speed_el 给出), 补偿占空比的装载与输出延迟;
+ *        编码器角度需先经 foc_encoder_angle 外推到采样时刻
  */
-void foc_current_closed_loop_run(foc_t *handle, dq_t i_dq, float angle_el)
+CCMRAM_FUNC void foc_current_closed_loop_run(foc_t *handle, dq_t i_dq, angle_t angle_el)
 {
-    /* 电流环 PID */
-    handle->v_d_out = pid_calculate(handle->pid_id, handle->target_id, i_dq.d);
-    handle->v_q_out = pid_calculate(handle->pid_iq, handle->target_iq, i_dq.q);
+    /* 电流环 PID + 解耦前馈 */
+    foc_current_pi(handle, i_dq, foc_decouple_ff(&handle->decouple, i_dq));
+    isr_prof_mark(ISR_PROF_PI);
+
+    /* 逆 Park + SVPWM 输出: 输出超前角由本周期 Park 的 sinθ / cosθ 旋转得到, 每周期只计算一次 sin / cos (超出 ±π 时饱和) */
+    foc_transform_set_angle(&handle->transform, angle_el);
+    foc_transform_advance(&handle->transform, angle_delta_sat(handle->decouple.omega_e * handle->delay.k_pwm));
+    handle->duty_cycle = foc_transform_modulate_comp(&handle->transform, (dq_t){.d = handle->v_d_out, .q = handle->v_q_out},
+                                                     foc_deadtime_comp(handle));
+    isr_prof_mark(ISR_PROF_SVPWM);
+    tim1_set_pwm_duty(handle->duty_cycle.a, handle->duty_cycle.b, handle->duty_cycle.c);
+    isr_prof_mark(ISR_PROF_PWM_WRITE);
+}
 
-    /* 逆 Park 变换 */
-    alphabeta_t v_alphabeta = ipark_transform((dq_t){.d = handle->v_d_out, .q = handle->v_q_out}, angle_el);
+/**
+ * @brief 速度环单步: 由转速误差计算目标 Iq
+ * @param handle    FOC 控制句柄
+ * @param speed_rpm 速度反馈 (RPM)
+ * @note  多速率调度时按速度环分频调用, pid_speed 的 ki 需按分频放大; 两次调用之间 target_iq 保持
+ */
+CCMRAM_FUNC void foc_speed_loop_step(foc_t *handle, float speed_rpm)
+{
+    handle->target_iq = pid_calculate(handle->pid_speed, handle->target_speed, speed_rpm);
+}
 
-    /* SVPWM 输出 */
-    handle->duty_cycle = svpwm_update(v_alphabeta);
-    tim1_set_pwm_duty(handle->duty_cycle.a, handle->duty_cycle.b, handle->duty_cycle.c);
+/**
+ * @brief 弱磁环单步: 由上一周期的 dq 电压输出计算目标 Id (<= 0)
+ * @param handle FOC 控制句柄
+ * @note  多速率调度时按弱磁分频调用, 见 flux_weak_set_div
+ */
+CCMRAM_FUNC void foc_flux_weak_step(foc_t *handle)
+{
+    handle->target_id = flux_weak_calculate(&handle->flux_weak, handle->v_d_out, handle->v_q_out);
 }
 
 /**
  * @brief 速度闭环运行
  * @param handle    FOC 控制句柄
  * @param i_dq      dq 轴电流反馈
- * @param angle_el  电角度 (rad)
+ * @param angle_el  电角度 (2^32 = 2π)
  * @param speed_rpm 速度反馈 (RPM)
+ * @note  速度 PI 每 FOC_SPEED_DIV 个周期执行一次 (handle->speed_task), 电流环每周期执行
  */
-void foc_speed_closed_loop_run(foc_t *handle, dq_t i_dq, float angle_el, float speed_rpm)
+CCMRAM_FUNC void foc_speed_closed_loop_run(foc_t *handle, dq_t i_dq, angle_t angle_el, float speed_rpm)
 {
-    /* 速度环 → 输出目标 Iq */
-    handle->target_iq = pid_calculate(handle->pid_speed, handle->target_speed, speed_rpm);
+    /* 速度环 → 输出目标 Iq (每 FOC_SPEED_DIV 个周期) */
+    if (sched_task_due(&handle->speed_task))
+        foc_speed_loop_step(handle, speed_rpm);
+    foc_set_speed_el(handle, speed_rpm);
 
     /* Id 目标设为 0  */
     handle->target_id = 0.0f;
@@ -149,21 +290,164 @@ void foc_speed_closed_loop_run(foc_t *handle, dq_t i_dq, float angle_el, float s
  * @brief 弱磁速度闭环运行
  * @param handle    FOC 控制句柄
  * @param i_dq      dq 轴电流反馈
- * @param angle_el  电角度 (rad)
+ * @param angle_el  电角度 (2^32 = 2π)
  * @param speed_rpm 速度反馈 (RPM)
+ * @note  速度 PI 每 FOC_SPEED_DIV 个周期执行一次 (handle->speed_task), 电流环每周期执行
  */
-void foc_flux_weak_speed_closed_loop_run(foc_t *handle, dq_t i_dq, float angle_el, float speed_rpm)
+CCMRAM_FUNC void foc_flux_weak_speed_closed_loop_run(foc_t *handle, dq_t i_dq, angle_t angle_el, float speed_rpm)
 {
-    /* 速度环输出目标 Iq */
-    handle->target_iq = pid_calculate(handle->pid_speed, handle->target_speed, speed_rpm);
-    /* 弱磁环输出 Id 补偿 */
-    float id_weak = flux_weak_calculate(&handle->flux_weak, handle->v_d_out, handle->v_q_out);
-    /* 目标 Id = 弱磁补偿值 */
-    handle->target_id = id_weak;
+    /* 速度环输出目标 Iq (每 FOC_SPEED_DIV 个周期) */
+    if (sched_task_due(&handle->speed_task))
+        foc_speed_loop_step(handle, speed_rpm);
+    foc_set_speed_el(handle, speed_rpm);
+    /* 弱磁环输出 Id 补偿, 目标 Id = 弱磁补偿值 */
+    foc_flux_weak_step(handle);
     /* 进入电流闭环 */
     foc_current_closed_loop_run(handle, i_dq, angle_el);
 }
 
+/**
+ * @brief 设置解耦前馈的电机参数并使能
+ * @param handle FOC 控制句柄
+ * @param ld     D轴电感 (H)
+ * @param lq     Q轴电感 (H)
+ * @param flux   永磁体磁链 (Wb)
+ */
+void foc_decouple_init(foc_t *handle, float ld, float lq, float flux)
+{
+    handle->decouple.ld = ld;
+    handle->decouple.lq = lq;
+    handle->decouple.flux = flux;
+    handle->decouple.omega_e = 0.0f;
+    handle->decouple.enable = 1;
+}
+
+/**
+ * @brief 开关解耦前馈 (参数保留)
+ * @param handle FOC 控制句柄
+ * @param enable 0: 关闭
+ */
+void foc_set_decoupling(foc_t *handle, uint8_t enable)
+{
+    handle->decouple.enable = enable;
+}
+
+/**
+ * @brief 开关过调制
+ * @param handle FOC 控制句柄
+ * @param enable 0: 电压矢量限制在线性调制圆内 (FOC_V_MAX_K)
+ * @note  使能后调制器按基波补偿进入过调制区域 I / II, 电流环输出限幅、dq 电压矢量上限与弱磁起始电压
+ *        一起提高到 FOC_V_MAX_K_OVERMOD, 弱磁环因此在更高转速才开始注入负 Id; 下一次 foc_set_bus_voltage 生效
+ */
+void foc_set_overmodulation(foc_t *handle, uint8_t enable)
+{
+    handle->v_max_k = enable ? FOC_V_MAX_K_OVERMOD : FOC_V_MAX_K;
+    svpwm_modulator_set_overmod(&handle->transform.modulator, enable);
+    flux_weak_set_u_max_k(&handle->flux_weak, handle->v_max_k);
+}
+
+/**
+ * @brief 更新解耦前馈与输出延迟补偿使用的电角速度
+ * @param handle    FOC 控制句柄
+ * @param speed_rpm 转速 (RPM, 编码器或观测器)
+ * @note  速度环 / 弱磁速度环内部自动调用; 单独运行电流闭环时需在 foc_current_closed_loop_run 之前调用
+ */
+CCMRAM_FUNC void foc_set_speed_el(foc_t *handle, float speed_rpm)
+{
+    handle->decouple.omega_e = speed_rpm * MOTOR_RPM_TO_RAD_S;
+}
+
+/**
+ * @brief 设置角度延迟补偿
+ * @param handle     FOC 控制句柄
+ * @param pwm_ts     PWM 输出延迟 (s): 采样时刻到输出区间中点, 默认 FOC_PWM_DELAY_TS
+ * @param encoder_ts 编码器读数延迟 (s): 角度锁存时刻到电流采样时刻, 默认 FOC_ENCODER_DELAY_TS
+ * @note  补偿角 = ωe · 延迟, 要求 |ωe| · 延迟 < π
+ */
+void foc_set_delay_comp(foc_t *handle, float pwm_ts, float encoder_ts)
+{
+    handle->delay.pwm_ts = pwm_ts;
+    handle->delay.encoder_ts = encoder_ts;
+    handle->delay.k_pwm = pwm_ts * ANGLE_FROM_RAD_K;
+    handle->delay.k_encoder = encoder_ts * MOTOR_RPM_TO_RAD_S * ANGLE_FROM_RAD_K;
+}
+
+/**
+ * @brief 编码器电角度外推到电流采样时刻
+ * @param handle    FOC 控制句柄
+ * @param angle_raw 编码器电角度 (as5047_get_angle_el, 未减零点)
+ * @param speed_rpm 编码器转速 (RPM)
+ * @return 减去零点偏移并按读数延迟超前 ωe · delay.encoder_ts 后的电角度, Park / 反 Park 共用
+ * @note  超前角超出 ±π (大延迟 + 高转速) 时饱和, 见 angle_delta_sat
+ */
+CCMRAM_FUNC angle_t foc_encoder_angle(const foc_t *handle, angle_t angle_raw, float speed_rpm)
+{
+    return angle_raw - handle->angle_offset + angle_delta_sat(speed_rpm * handle->delay.k_encoder);
+}
+
+/**
+ * @brief 相电流两相重构
+ * @param handle FOC 控制句柄
+ * @param adc    本周期的采样值 (注入组中断换算结果, 只读)
+ * @return 三相电流, current_recon 使能时丢弃一相并重构
+ * @note  本周期采样时生效的占空比是上一次调制的结果 (在本次更新事件装载), 因此用调制器保存的扇区选择丢弃的相;
+ *        停机 (foc_closed_loop_stop) 后扇区清零, 三相采样都保留
+ */
+CCMRAM_FUNC abc_t foc_current_reconstruct(const foc_t *handle, const adc_values_t *adc)
+{
+    adc_values_t values = *adc;
+
+    if (handle->current_recon)
+    {
+        adc1_current_reconstruct(&values, svpwm_modulator_max_phase(&handle->transform.modulator));
+    }
+    return (abc_t){.a = values.ia, .b = values.ib, .c = values.ic};
+}
+
+/**
+ * @brief 母线电压前馈
+ * @param handle   FOC 控制句柄
+ * @param udc_meas 本周期采样的母线电压 (V)
+ * @note  滤波后计算一次 1/Udc 交给调制, 电流环输出限幅与弱磁起始电压按 udc / U_DC 缩放, 电压矢量上限为 v_max_k · udc,
+ *        母线跌落时电流环增益与电压余量不变
+ */
+CCMRAM_FUNC void foc_set_bus_voltage(foc_t *handle, float udc_meas)
+{
+    bus_voltage_update(&handle->bus, udc_meas);
+    foc_transform_set_udc(&handle->transform, handle->bus.inv_udc);
+
+    /* 单轴限幅按 pid_init 的整定值缩放, 使能过调制时按 v_max_k / FOC_V_MAX_K 放宽 */
+    float v_max = handle->v_limit_nom * handle->bus.ratio * (handle->v_max_k * (1.0f / FOC_V_MAX_K));
+    handle->pid_id->out_max = v_max;
+    handle->pid_id->out_min = -v_max;
+    handle->pid_id->integral_max = v_max;
+    handle->pid_iq->out_max = v_max;
+    handle->pid_iq->out_min = -v_max;
+    handle->pid_iq->integral_max = v_max;
+    handle->v_max = handle->v_max_k * handle->bus.udc;
+
+    flux_weak_set_udc(&handle->flux_weak, handle->bus.udc);
+}
+
+/**
+ * @brief 速度环无扰切入: 积分项预置为给定 Iq, 切入后第一个周期的 Iq 指令与切入前连续
+ * @param handle FOC 控制句柄
+ * @param iq     切入前的 Iq 指令 (A), 按速度环输出范围限幅
+ */
+void foc_speed_loop_preload(foc_t *handle, float iq)
+{
+    pid_controller_t *pid = handle->pid_speed;
+
+    if (iq > pid->out_max)
+        iq = pid->out_max;
+    else if (iq < pid->out_min)
+        iq = pid->out_min;
+
+    pid->integral = iq;
+    pid->out = iq;
+    handle->target_iq = iq;
+}
+
 void foc_set_target_id(foc_t *handle, float id)
 {
     handle->target_id = id;
@@ -174,7 +458,7 @@ void foc_set_target_iq(foc_t *handle, float iq)
     handle->target_iq = iq;
 }
 
-void foc_set_target_speed(foc_t *handle, float speed_rpm)
+CCMRAM_FUNC void foc_set_target_speed(foc_t *handle, float speed_rpm)
 {
     handle->target_speed = speed_rpm;
 }
@@ -195,6 +479,7 @@ void foc_closed_loop_stop(foc_t *handle)
     handle->v_d_out = 0.0f;
     handle->v_q_out = 0.0f;
 
-    /* 输出50%占空比，电机停止 */
+    /* 输出50%占空比，电机停止 (三相占空比相同, 不再丢弃任何一相的采样) */
+    handle->transform.modulator.sector = 0;
     tim1_set_pwm_duty(0.5f, 0.5f, 0.5f);
 }
@@ -4,14 +4,89 @@
 #include "stm32g4xx_hal.h"
 #include "clark_park.h"
 #include "svpwm.h"
+#include "foc_transform.h"
 #include "pid.h"
+#include "motor_profile.h"
 #include "bsp/as5047.h"
 #include "bsp/tim.h"
 #include "bsp/adc.h"
 #include "flux_weakening.h"
+#include "bus_voltage.h"
+#include "deadtime_comp.h"
+#include "utils/isr_prof.h"
+#include "utils/sched.h"
 
 /* 电机参数 */
-#define U_DC 12.0f /* 直流母线电压 (V) */
+#define U_DC 12.0f /* 额定直流母线电压 (V), 运行时使用 bus 中的实测值 */
+
+/* dq 电压矢量幅值上限 / Udc: 线性调制圆半径为 Udc/√3 ≈ 0.577·Udc, 留 5% 余量给电流采样窗口 */
+#ifndef FOC_V_MAX_K
+#define FOC_V_MAX_K 0.55f
+#endif
+
+/* 使能过调制后的 dq 电压矢量幅值上限 / Udc: 六拍基波为 2/π ≈ 0.637·Udc, 保留约 2% 使电流环仍有调节余量 */
+#ifndef FOC_V_MAX_K_OVERMOD
+#define FOC_V_MAX_K_OVERMOD 0.625f
+#endif
+
+/*
+ * PWM 输出延迟 (s): 第 k 个周期采样、计算的占空比在下一个更新事件装载, 在 [k+1, k+2] 个周期内输出,
+ * 平均比采样时刻晚 1.5 个控制周期, 其间转子转过 ωe · FOC_PWM_DELAY_TS。电流闭环的反 Park 按此提前角度,
+ * 输出的电压矢量落在输出区间中点的转子坐标上。双更新 (PWM_DOUBLE_UPDATE) 时控制周期减半, 延迟随之减半。
+ */
+#ifndef FOC_PWM_DELAY_TS
+#define FOC_PWM_DELAY_TS (1.5f * MOTOR_TS)
+#endif
+
+/*
+ * 编码器角度读数延迟 (s): AS5047P 在 CS 下降沿锁存角度, 比电流采样 (更新事件) 早 TIM1_ENCODER_CS_LEAD 个计数,
+ * 另加传感器内部的传播延迟 (AS5047_SENSOR_DELAY_TS)。编码器角度按此外推到电流采样时刻, Park 与反 Park 都使用外推后的角度。
+ */
+#ifndef FOC_ENCODER_DELAY_TS
+#define FOC_ENCODER_DELAY_TS ((float)TIM1_ENCODER_CS_LEAD / TIM1_CLK_FREQ + AS5047_SENSOR_DELAY_TS)
+#endif
+
+/*
+ * 两相电流重构默认开关: 每个周期丢弃本次采样时占空比最高的一相 (下桥导通时间最短), 由另外两相重构,
+ * 调制比接近上限 (及过调制) 时不会用到落在开关振荡中的采样值。三相都有可靠采样窗口时可关闭。
+ * 单电阻采样 (ADC_SINGLE_SHUNT) 的三相电流已由两次母线电流采样重构, 默认关闭。
+ */
+#ifndef FOC_CURRENT_RECON
+#if ADC_SINGLE_SHUNT
+#define FOC_CURRENT_RECON 0
+#else
+#define FOC_CURRENT_RECON 1
+#endif
+#endif
+
+/*
+ * 单独运行模式 (motor/ 下各模式) 的速度环分频: foc_speed_closed_loop_run / foc_flux_weak_speed_closed_loop_run 每 FOC_SPEED_DIV
+ * 个周期执行一次速度 PI (两次之间 target_iq 保持), 默认与编码器转速刷新 (AS5047_SPEED_CALC_DIV) 同相, 不再用同一个转速样本
+ * 重复积分。速度环 ki 按每个 PWM 周期执行整定, pid_init 时乘以 FOC_SPEED_KI_K。
+ */
+#ifndef FOC_SPEED_DIV
+#define FOC_SPEED_DIV AS5047_SPEED_CALC_DIV
+#endif
+#define FOC_SPEED_KI_K ((float)FOC_SPEED_DIV / MOTOR_CTRL_PER_PWM)
+
+/* dq 电流环解耦前馈 */
+typedef struct
+{
+    uint8_t enable; /* 0: 关闭 (两个 PI 完全独立) */
+    float ld;       /* D轴电感 (H) */
+    float lq;       /* Q轴电感 (H) */
+    float flux;     /* 永磁体磁链 (Wb) */
+    float omega_e;  /* 电角速度 (rad/s), 由 foc_set_speed_el 每周期更新 (输出延迟补偿也使用, 与 enable 无关) */
+} foc_decouple_t;
+
+/* 角度延迟补偿 (运行时可用 foc_set_delay_comp 修改, 保存换算到整数角度的系数, 控制中断中只做乘法) */
+typedef struct
+{
+    float pwm_ts;     /* PWM 输出延迟 (s), 默认 FOC_PWM_DELAY_TS */
+    float encoder_ts; /* 编码器读数延迟 (s), 默认 FOC_ENCODER_DELAY_TS */
+    float k_pwm;      /* 输出超前角 / ωe: pwm_ts · 2^32 / 2π */
+    float k_encoder;  /* 编码器外推角 / 转速 (RPM): encoder_ts · ωe / RPM · 2^32 / 2π */
+} foc_delay_comp_t;
 
 /* FOC 核心控制对象 */
 typedef struct
@@ -24,6 +99,18 @@ typedef struct
 
     flux_weak_t flux_weak; /* 弱磁控制对象 */
 
+    bus_voltage_t bus;  /* 母线电压估计 (调制归一化 / 电压限幅 / 弱磁参考) */
+    float v_limit_nom;  /* 额定母线电压下电流环输出限幅 (V), 实际限幅 = v_limit_nom · udc / U_DC */
+    float v_max_k;      /* 电压矢量上限 / Udc: FOC_V_MAX_K, 过调制时 FOC_V_MAX_K_OVERMOD */
+    float v_max;        /* dq 电压矢量幅值上限 (V) = v_max_k · udc */
+    uint8_t v_limited;  /* 本周期电压矢量被限幅 */
+
+    foc_decouple_t decouple; /* 交叉耦合 + 反电势前馈 */
+    deadtime_comp_t deadtime; /* 死区补偿 (默认关闭, deadtime_comp_init 后使能) */
+    foc_delay_comp_t delay;   /* 输出延迟 / 编码器读数延迟补偿 */
+    uint8_t current_recon;    /* 两相电流重构 (foc_current_reconstruct), 0: 直接使用三相采样 */
+    sched_task_t speed_task;  /* 速度环分频 (foc_speed_closed_loop_run 等), foc_init 时相位清零 */
+
     float v_d_out; /* D轴电压输出 */
     float v_q_out; /* Q轴电压输出 */
     float i_q_out; /* Q轴电流输出 (速度环) */
@@ -34,9 +121,11 @@ typedef struct
 
     abc_t duty_cycle; /* 输出占空比 */
 
-    float angle_offset; /* 编码器零点偏移 */
+    foc_transform_t transform; /* 本周期坐标变换上下文 (sinθ / cosθ 缓存, 输出 αβ 电压) */
 
-    float open_loop_angle_el; /* 开环运行角度 */
+    angle_t angle_offset; /* 编码器零点偏移 (电角度) */
+
+    angle_t open_loop_angle_el; /* 开环运行角度 */
 } foc_t;
 
 /* FOC 控制函数 */
@@ -48,9 +137,39 @@ void foc_open_loop_run(foc_t *handle, float speed_rpm, float voltage_q);
 void foc_if_current_run(foc_t *handle, dq_t i_dq, float speed_rpm, float current_q);
 
 /* 闭环控制 */
-void foc_current_closed_loop_run(foc_t *handle, dq_t i_dq, float angle_el);
-void foc_speed_closed_loop_run(foc_t *handle, dq_t i_dq, float angle_el, float speed_rpm);
-void foc_flux_weak_speed_closed_loop_run(foc_t *handle, dq_t i_dq, float angle_el, float speed_rpm);
+void foc_current_closed_loop_run(foc_t *handle, dq_t i_dq, angle_t angle_el);
+void foc_speed_closed_loop_run(foc_t *handle, dq_t i_dq, angle_t angle_el, float speed_rpm);
+void foc_flux_weak_speed_closed_loop_run(foc_t *handle, dq_t i_dq, angle_t angle_el, float speed_rpm);
+
+/* 外环单步 (多速率调度时按分频调用, 之后每周期调用 foc_current_closed_loop_run) */
+void foc_speed_loop_step(foc_t *handle, float speed_rpm);
+void foc_flux_weak_step(foc_t *handle);
+
+/* 解耦前馈: 设置电机参数并使能 / 开关 / 更新电角速度 */
+void foc_decouple_init(foc_t *handle, float ld, float lq, float flux);
+void foc_set_decoupling(foc_t *handle, uint8_t enable);
+
+/* 过调制开关: 调制器进入过调制区域 I / II, 电压矢量上限与弱磁起始电压提高到 FOC_V_MAX_K_OVERMOD · udc */
+void foc_set_overmodulation(foc_t *handle, uint8_t enable);
+void foc_set_speed_el(foc_t *handle, float speed_rpm);
+
+/* 角度延迟补偿: 设置 PWM 输出延迟与编码器读数延迟 (s), 0 表示不补偿 */
+void foc_set_delay_comp(foc_t *handle, float pwm_ts, float encoder_ts);
+
+/* 编码器电角度 (减零点) 外推到电流采样时刻 */
+angle_t foc_encoder_angle(const foc_t *handle, angle_t angle_raw, float speed_rpm);
+
+/* dq 电压矢量圆限幅 (d 轴优先) */
+dq_t foc_voltage_limit(dq_t v, float v_max);
+
+/* 相电流采样预处理: 按上一次调制的扇区丢弃占空比最高的一相并重构, 返回 Clark 的输入, 每个控制周期调用一次 */
+abc_t foc_current_reconstruct(const foc_t *handle, const adc_values_t *adc);
+
+/* 母线电压前馈: 每个控制周期在调制前调用一次 */
+void foc_set_bus_voltage(foc_t *handle, float udc_meas);
+
+/* 速度环无扰切入 */
+void foc_speed_loop_preload(foc_t *handle, float iq);
 
 /* 设置目标值 */
 void foc_set_target_id(foc_t *handle, float id);
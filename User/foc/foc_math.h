@@ -0,0 +1,125 @@
+/**
+ * @file foc_math.h
+ * @brief FOC 运算后端选择 (浮点 / Q15 定点)
+ *
+ * 两套实现同时参与编译, 由本头文件:
+ * - 按 FOC_MATH_BACKEND 选择 foc_real_t / foc_abc_t 等类型别名, 电机模式用这些类型声明变量;
+ * - 用 C11 _Generic 按实参类型分派到 clark_transform / clark_transform_q15 等函数,
+ *   同一份调用代码在两种后端下都能编译。
+ *
+ * 目前只有主机端的精度 / 耗时对比 (test/test_fixed_point.c, test/bench/bench_foc.c) 包含本头文件:
+ * FOC_MATH_BACKEND 只改变包含本头文件的代码所用的类型与实现。foc.c、foc_transform 与 motor/ 下的运行模式
+ * 直接调用浮点实现, 不受该选项影响; 固件切换到定点需先把控制路径改写为 foc_* 类型与接口。
+ */
+
+#ifndef __FOC_MATH_H__
+#define __FOC_MATH_H__
+
+#include "clark_park.h"
+#include "svpwm.h"
+#include "pid.h"
+#include "smo.h"
+#include "luenberger.h"
+
+#include "clark_park_q15.h"
+#include "svpwm_q15.h"
+#include "pid_q15.h"
+#include "smo_q15.h"
+#include "luenberger_q15.h"
+
+#define FOC_MATH_FLOAT 0
+#define FOC_MATH_Q15 1
+
+#ifndef FOC_MATH_BACKEND
+#define FOC_MATH_BACKEND FOC_MATH_FLOAT
+#endif
+
+#if FOC_MATH_BACKEND == FOC_MATH_Q15
+
+typedef q15_t foc_real_t;            /* 标幺值 */
+typedef uint16_t foc_angle_t;        /* 65536 = 2π */
+typedef abc_q15_t foc_abc_t;
+typedef alphabeta_q15_t foc_alphabeta_t;
+typedef dq_q15_t foc_dq_t;
+typedef pid_q15_t foc_pid_t;
+typedef smo_q15_t foc_smo_t;
+typedef luenberger_q15_t foc_luenberger_t;
+
+/* 物理量 <-> 后端数值 */
+#define FOC_CURRENT(a) FOC_Q15_CURRENT(a)
+#define FOC_VOLTAGE(v) FOC_Q15_VOLTAGE(v)
+#define FOC_ANGLE(rad) QANGLE_FROM_RAD(rad)
+#define FOC_CURRENT_TO_FLOAT(x) (Q15_TO_FLOAT(x) * FOC_Q15_I_BASE)
+#define FOC_VOLTAGE_TO_FLOAT(x) (Q15_TO_FLOAT(x) * FOC_Q15_U_BASE)
+#define FOC_ANGLE_TO_FLOAT(x) QANGLE_TO_RAD(x)
+#define FOC_DUTY_TO_FLOAT(x) Q15_TO_FLOAT(x)
+
+/* 参数与浮点版相同 (物理单位) */
+#define foc_pid_init(pid, kp, ki, out_min, out_max, in_base, out_base)                               \
+    pid_q15_init((pid), PID_Q15_GAIN((kp), (in_base), (out_base)), PID_Q15_GAIN((ki), (in_base), (out_base)), \
+                 Q15((out_min) / (out_base)), Q15((out_max) / (out_base)))
+#define foc_smo_init smo_q15_init
+#define foc_luenberger_init luenberger_q15_init
+
+#else
+
+typedef float foc_real_t;
+typedef angle_t foc_angle_t;         /* 2^32 = 2π */
+typedef abc_t foc_abc_t;
+typedef alphabeta_t foc_alphabeta_t;
+typedef dq_t foc_dq_t;
+typedef pid_controller_t foc_pid_t;
+typedef smo_t foc_smo_t;
+typedef luenberger_t foc_luenberger_t;
+
+#define FOC_CURRENT(a) (a)
+#define FOC_VOLTAGE(v) (v)
+#define FOC_ANGLE(rad) angle_from_rad(rad)
+#define FOC_CURRENT_TO_FLOAT(x) (x)
+#define FOC_VOLTAGE_TO_FLOAT(x) (x)
+#define FOC_ANGLE_TO_FLOAT(x) angle_to_rad(x)
+#define FOC_DUTY_TO_FLOAT(x) (x)
+
+/* in_base / out_base 仅定点后端使用 */
+#define foc_pid_init(pid, kp, ki, out_min, out_max, in_base, out_base) \
+    pid_init((pid), (kp), (ki), (out_min), (out_max))
+#define foc_smo_init smo_init
+#define foc_luenberger_init luenberger_init
+
+#endif /* FOC_MATH_BACKEND */
+
+/* 类型泛型接口: 按实参类型分派, 与 FOC_MATH_BACKEND 无关 */
+#define foc_clark(abc) \
+    _Generic((abc), abc_t: clark_transform, abc_q15_t: clark_transform_q15)(abc)
+
+#define foc_iclark(alpha_beta) \
+    _Generic((alpha_beta), alphabeta_t: iclark_transform, alphabeta_q15_t: iclark_transform_q15)(alpha_beta)
+
+#define foc_park(alpha_beta, theta) \
+    _Generic((alpha_beta), alphabeta_t: park_transform, alphabeta_q15_t: park_transform_q15)(alpha_beta, theta)
+
+#define foc_ipark(dq, theta) \
+    _Generic((dq), dq_t: ipark_transform, dq_q15_t: ipark_transform_q15)(dq, theta)
+
+#define foc_svpwm(u_alphabeta) \
+    _Generic((u_alphabeta), alphabeta_t: svpwm_update, alphabeta_q15_t: svpwm_update_q15)(u_alphabeta)
+
+#define foc_pid_calculate(pid, setpoint, feedback) \
+    _Generic((pid), pid_controller_t *: pid_calculate, pid_q15_t *: pid_q15_calculate)(pid, setpoint, feedback)
+
+#define foc_pid_reset(pid) \
+    _Generic((pid), pid_controller_t *: pid_reset, pid_q15_t *: pid_q15_reset)(pid)
+
+#define foc_smo_estimate(smo) \
+    _Generic((smo), smo_t *: smo_estimate, smo_q15_t *: smo_q15_estimate)(smo)
+
+#define foc_smo_get_angle(smo) \
+    _Generic((smo), smo_t *: smo_get_angle, smo_q15_t *: smo_q15_get_angle)(smo)
+
+#define foc_luenberger_estimate(luenberger) \
+    _Generic((luenberger), luenberger_t *: luenberger_estimate, luenberger_q15_t *: luenberger_q15_estimate)(luenberger)
+
+#define foc_luenberger_get_angle(luenberger) \
+    _Generic((luenberger), luenberger_t *: luenberger_get_angle, luenberger_q15_t *: luenberger_q15_get_angle)(luenberger)
+
+#endif /* __FOC_MATH_H__ */
@@ -0,0 +1,105 @@
+#include "foc_transform.h"
+#include "utils/ccmram.h"
+
+void foc_transform_init(foc_transform_t *ctx)
+{
+    ctx->theta = 0;
+    ctx->sin_theta = 0.0f;
+    ctx->cos_theta = 1.0f;
+    ctx->angle_valid = 0;
+    ctx->sin_cos_count = 0;
+
+    ctx->inv_udc = SVPWM_INV_UDC;
+    svpwm_modulator_init(&ctx->modulator, SVPWM_MODE_SVPWM);
+
+    ctx->v_alphabeta.alpha = 0.0f;
+    ctx->v_alphabeta.beta = 0.0f;
+
+    ctx->duty.a = 0.5f;
+    ctx->duty.b = 0.5f;
+    ctx->duty.c = 0.5f;
+}
+
+CCMRAM_FUNC void foc_transform_set_angle(foc_transform_t *ctx, angle_t theta)
+{
+    /* 同一周期内重复设置相同角度时直接复用 */
+    if (ctx->angle_valid && theta == ctx->theta)
+        return;
+
+    angle_sin_cos(theta, &ctx->sin_theta, &ctx->cos_theta);
+    ctx->theta = theta;
+    ctx->angle_valid = 1;
+    ctx->sin_cos_count++;
+}
+
+CCMRAM_FUNC void foc_transform_advance(foc_transform_t *ctx, angle_t delta)
+{
+    /* 静止时角度不变, 缓存保持与独立变换逐位一致 */
+    if (delta == 0)
+        return;
+
+    if (!ctx->angle_valid)
+    {
+        foc_transform_set_angle(ctx, ctx->theta + delta);
+        return;
+    }
+
+    // sinΔ ≈ Δ - Δ³/6, cosΔ ≈ 1 - Δ²/2 + Δ⁴/24
+    float d = angle_to_rad(delta);
+    float d2 = d * d;
+    float sin_d = d * (1.0f - d2 * (1.0f / 6.0f));
+    float cos_d = 1.0f - d2 * (0.5f - d2 * (1.0f / 24.0f));
+
+    // sin(θ+Δ) = sinθ·cosΔ + cosθ·sinΔ, cos(θ+Δ) = cosθ·cosΔ - sinθ·sinΔ
+    float s = ctx->sin_theta;
+    float c = ctx->cos_theta;
+    ctx->sin_theta = s * cos_d + c * sin_d;
+    ctx->cos_theta = c * cos_d - s * sin_d;
+    ctx->theta += delta;
+}
+
+CCMRAM_FUNC dq_t foc_transform_park(const foc_transform_t *ctx, alphabeta_t i_alphabeta)
+{
+    dq_t dq;
+
+    // id = iα*cosθ + iβ*sinθ
+    dq.d = i_alphabeta.alpha * ctx->cos_theta + i_alphabeta.beta * ctx->sin_theta;
+
+    // iq = -iα*sinθ + iβ*cosθ
+    dq.q = -i_alphabeta.alpha * ctx->sin_theta + i_alphabeta.beta * ctx->cos_theta;
+
+    return dq;
+}
+
+CCMRAM_FUNC alphabeta_t foc_transform_ipark(const foc_transform_t *ctx, dq_t v_dq)
+{
+    alphabeta_t alpha_beta;
+
+    // Vα = Vd*cosθ - Vq*sinθ
+    alpha_beta.alpha = v_dq.d * ctx->cos_theta - v_dq.q * ctx->sin_theta;
+
+    // Vβ = Vd*sinθ + Vq*cosθ
+    alpha_beta.beta = v_dq.d * ctx->sin_theta + v_dq.q * ctx->cos_theta;
+
+    return alpha_beta;
+}
+
+CCMRAM_FUNC abc_t foc_transform_modulate(foc_transform_t *ctx, dq_t v_dq)
+{
+    ctx->v_alphabeta = foc_transform_ipark(ctx, v_dq);
+
+    /* 扇区法 SVPWM (或 DPWM) 直接由 αβ 电压计算占空比, 按本周期母线电压归一化 */
+    ctx->duty = svpwm_modulate(&ctx->modulator, ctx->v_alphabeta, ctx->inv_udc);
+
+    return ctx->duty;
+}
+
+CCMRAM_FUNC abc_t foc_transform_modulate_comp(foc_transform_t *ctx, dq_t v_dq, alphabeta_t v_comp)
+{
+    ctx->v_alphabeta = foc_transform_ipark(ctx, v_dq);
+
+    alphabeta_t v = {.alpha = ctx->v_alphabeta.alpha + v_comp.alpha, .beta = ctx->v_alphabeta.beta + v_comp.beta};
+    ctx->duty = svpwm_modulate(&ctx->modulator, v, ctx->inv_udc);
+
+    return ctx->duty;
+}
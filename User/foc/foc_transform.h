@@ -0,0 +1,90 @@
+#ifndef __FOC_TRANSFORM_H__
+#define __FOC_TRANSFORM_H__
+
+#include "clark_park.h"
+#include "svpwm.h"
+
+/**
+ * 单个控制周期的坐标变换上下文
+ *
+ * 一个周期内 Park、反 Park 使用同一电角度, 且观测器还需要输出的 αβ 电压。
+ * 上下文只在角度变化时计算一次 sinθ / cosθ 并缓存, Park / 反 Park / 调制都复用,
+ * 调制时顺带保存 αβ 电压, 观测器直接读取, 不再做第二次反 Park。
+ * 调制按 foc_transform_set_udc() 设置的 1/Udc 归一化 (初始为额定电压 U_DC),
+ * 计算公式与 park_transform() / ipark_transform() / svpwm_update() 完全相同, 额定电压下结果逐位一致。
+ * 调制方式由上下文中的调制器决定 (默认 SVPWM), 可在运行中用 foc_transform_set_pwm_mode() 切换为 DPWM。
+ */
+typedef struct
+{
+    angle_t theta;               /* 缓存对应的电角度 (2^32 = 2π) */
+    float sin_theta;             /* sinθ */
+    float cos_theta;             /* cosθ */
+    uint8_t angle_valid;         /* 缓存是否有效 */
+    uint32_t sin_cos_count;      /* angle_sin_cos 调用次数 (诊断用, 溢出回绕) */
+
+    float inv_udc;               /* 1 / 母线电压, 调制归一化用 */
+    svpwm_modulator_t modulator; /* 调制方式 (SVPWM / DPWM / 混合) */
+
+    alphabeta_t v_alphabeta;     /* 最近一次调制的 αβ 电压 (V) */
+    abc_t duty;                  /* 最近一次调制的三相占空比 */
+} foc_transform_t;
+
+/* 初始化 (缓存失效, 电压 / 占空比清零, 按额定母线电压、SVPWM 方式调制) */
+void foc_transform_init(foc_transform_t *ctx);
+
+/**
+ * @brief 设置本周期电角度, 与缓存角度不同时才重新计算 sinθ / cosθ
+ * @param ctx   变换上下文
+ * @param theta 电角度 (2^32 = 2π)
+ */
+void foc_transform_set_angle(foc_transform_t *ctx, angle_t theta);
+
+/**
+ * @brief 缓存角度超前一个小角度 Δ (如输出延迟补偿), 由缓存的 sinθ / cosθ 旋转得到, 不重新计算 sin / cos
+ * @param ctx   变换上下文, 须已由 foc_transform_set_angle 设置角度
+ * @param delta 超前角 (2^32 = 2π), sinΔ / cosΔ 取三阶 / 四阶泰勒展开, |Δ| <= 0.5 rad 时角度误差 < 0.02°, 幅值误差 < 0.02%
+ */
+void foc_transform_advance(foc_transform_t *ctx, angle_t delta);
+
+/* 设置本周期母线电压倒数 (bus_voltage_t.inv_udc) */
+static inline void foc_transform_set_udc(foc_transform_t *ctx, float inv_udc)
+{
+    ctx->inv_udc = inv_udc;
+}
+
+/* 设置调制方式 (下一次调制生效) */
+static inline void foc_transform_set_pwm_mode(foc_transform_t *ctx, svpwm_mode_t mode)
+{
+    svpwm_modulator_set_mode(&ctx->modulator, mode);
+}
+
+/* Park 变换 (使用缓存的 sinθ / cosθ) */
+dq_t foc_transform_park(const foc_transform_t *ctx, alphabeta_t i_alphabeta);
+
+/* 反 Park 变换 (使用缓存的 sinθ / cosθ) */
+alphabeta_t foc_transform_ipark(const foc_transform_t *ctx, dq_t v_dq);
+
+/**
+ * @brief 反 Park + SVPWM, 直接由 dq 电压得到占空比
+ * @param ctx  变换上下文, 保存 αβ 电压与占空比
+ * @param v_dq dq 轴电压 (V)
+ * @return 三相占空比 (0.0 ~ 1.0)
+ */
+abc_t foc_transform_modulate(foc_transform_t *ctx, dq_t v_dq);
+
+/**
+ * @brief 反 Park + 叠加 αβ 补偿电压 (如死区补偿) + SVPWM
+ * @param ctx    变换上下文, 保存的 αβ 电压为补偿前的指令电压 (观测器使用)
+ * @param v_dq   dq 轴电压 (V)
+ * @param v_comp αβ 补偿电压 (V)
+ * @return 三相占空比 (0.0 ~ 1.0)
+ */
+abc_t foc_transform_modulate_comp(foc_transform_t *ctx, dq_t v_dq, alphabeta_t v_comp);
+
+/* 最近一次调制输出的 αβ 电压, 供观测器使用 */
+static inline alphabeta_t foc_transform_get_v_alphabeta(const foc_transform_t *ctx)
+{
+    return ctx->v_alphabeta;
+}
+
+#endif /* __FOC_TRANSFORM_H__ */
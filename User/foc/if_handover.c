@@ -0,0 +1,106 @@
+#include "if_handover.h"
+#include "utils/ccmram.h"
+
+#define IF_HANDOVER_PI 3.14159265358979f
+
+/* 收敛指标的滤波时间常数 (s) */
+#define IF_HANDOVER_FILTER_TAU 0.01f
+
+void if_handover_init(if_handover_t *handover, float ts, float min_speed_rpm, float speed_tol_rpm,
+                      float angle_tol, float settle_time, float blend_rate)
+{
+    handover->ts = ts;
+    handover->k_filter = ts / IF_HANDOVER_FILTER_TAU;
+    handover->min_speed_rpm = min_speed_rpm;
+    handover->speed_tol_rpm = speed_tol_rpm;
+    handover->angle_tol = angle_tol;
+    handover->settle_ticks = (uint32_t)(settle_time / ts + 0.5f);
+    handover->blend_step = (int32_t)angle_delta_from_rad(blend_rate * ts);
+
+    if_handover_reset(handover);
+}
+
+void if_handover_reset(if_handover_t *handover)
+{
+    handover->state = IF_HANDOVER_IF;
+    handover->angle_err = 0.0f;
+    handover->angle_err_mean = 0;
+    handover->angle_err_dev = IF_HANDOVER_PI; /* 从 "未收敛" 开始 */
+    handover->speed_err = handover->speed_tol_rpm * 10.0f;
+    handover->stable_ticks = 0;
+    handover->offset = 0;
+    handover->switch_event = 0;
+    handover->if_ticks = 0;
+}
+
+void if_handover_force_done(if_handover_t *handover)
+{
+    handover->state = IF_HANDOVER_DONE;
+    handover->offset = 0;
+    handover->switch_event = 0;
+}
+
+CCMRAM_FUNC angle_t if_handover_update(if_handover_t *handover, angle_t if_angle, float if_speed_rpm, angle_t obs_angle, float obs_speed_rpm)
+{
+    handover->switch_event = 0;
+
+    if (handover->state == IF_HANDOVER_IF)
+    {
+        handover->if_ticks++;
+
+        /* 收敛指标: 角度误差 (相对滤波均值取最短角差, 避免 ±π 附近跳变) 与转速误差; 均值为整数角度, 溢出即回绕 */
+        float k = handover->k_filter;
+        angle_t err_angle = obs_angle - if_angle;
+        float dev = angle_diff_rad(err_angle, handover->angle_err_mean);
+
+        handover->angle_err = angle_to_rad(err_angle);
+        handover->angle_err_mean += angle_delta_from_rad(k * dev); /* k < 1, |k·dev| < π */
+        handover->angle_err_dev += k * (fabsf(dev) - handover->angle_err_dev);
+        handover->speed_err += k * (fabsf(obs_speed_rpm - if_speed_rpm) - handover->speed_err);
+
+        uint8_t converged = (fabsf(obs_speed_rpm) >= handover->min_speed_rpm) &&
+                            (handover->speed_err < handover->speed_tol_rpm) &&
+                            (handover->angle_err_dev < handover->angle_tol);
+
+        handover->stable_ticks = converged ? handover->stable_ticks + 1 : 0;
+        if (handover->stable_ticks < handover->settle_ticks)
+        {
+            return if_angle;
+        }
+
+        /* 切换: 本周期控制角仍等于开环角 */
+        handover->state = IF_HANDOVER_BLEND;
+        handover->offset = err_angle;
+        handover->switch_event = 1;
+        return if_angle;
+    }
+
+    if (handover->state == IF_HANDOVER_BLEND)
+    {
+        /* 角度偏差斜坡归零 (按 [-π, π) 内的有符号值, 整数运算) */
+        int32_t offset = (int32_t)handover->offset;
+        if (offset > handover->blend_step)
+        {
+            offset -= handover->blend_step;
+        }
+        else if (offset < -handover->blend_step)
+        {
+            offset += handover->blend_step;
+        }
+        else
+        {
+            offset = 0;
+            handover->state = IF_HANDOVER_DONE;
+        }
+        handover->offset = (angle_t)offset;
+    }
+
+    return obs_angle - handover->offset;
+}
+
+float if_handover_iq_preload(const if_handover_t *handover, float iq_if)
+{
+    float s, c;
+    angle_sin_cos(handover->offset, &s, &c);
+    return iq_if * c;
+}
@@ -0,0 +1,87 @@
+#ifndef __IF_HANDOVER_H__
+#define __IF_HANDOVER_H__
+
+#include <math.h>
+#include "stm32g4xx_hal.h"
+#include "utils/angle.h"
+
+/**
+ * I/F 开环 -> 观测器闭环 无扰切换
+ *
+ * I/F 阶段转子滞后 (或超前) 开环角一个负载角, 直接把控制角度从开环角换成观测角会使电流矢量突变。
+ * 本模块在 I/F 阶段持续统计观测器收敛指标:
+ *   - 观测角与开环角之差 e 的滤波均值与平均偏差 (e 稳定说明观测器已锁定转子, 与负载角大小无关)
+ *   - 观测转速与开环转速之差的滤波绝对值
+ * 指标持续满足 settle_time 后切换; 切换时记录角度偏差 offset = e, 控制角取 观测角 - offset
+ * (切换瞬间与开环角相同), 随后 offset 以 blend_rate 斜坡归零, 控制角平滑过渡到观测角。
+ */
+
+/* 切换阶段 */
+typedef enum
+{
+    IF_HANDOVER_IF = 0, /* I/F 拖动, 统计收敛指标 */
+    IF_HANDOVER_BLEND,  /* 已切换到速度闭环, 角度偏差斜坡归零 */
+    IF_HANDOVER_DONE,   /* 完全使用观测角 */
+} if_handover_state_t;
+
+typedef struct
+{
+    /* 参数 */
+    float ts;            /* 控制周期 (s) */
+    float k_filter;      /* 指标滤波系数 */
+    float min_speed_rpm; /* 允许切换的最低观测转速 (RPM) */
+    float speed_tol_rpm; /* 转速误差门限 (RPM) */
+    float angle_tol;     /* 角度误差平均偏差门限 (rad) */
+    uint32_t settle_ticks; /* 指标持续满足的周期数 */
+    int32_t blend_step;  /* 每周期角度偏差减小量 (2^32 = 2π) */
+
+    /* 状态 */
+    if_handover_state_t state;
+    float angle_err;      /* 本周期 观测角 - 开环角 (rad, [-π, π)) */
+    angle_t angle_err_mean; /* 角度误差滤波均值 (2^32 = 2π) */
+    float angle_err_dev;  /* 角度误差平均偏差 */
+    float speed_err;      /* 转速误差滤波绝对值 (RPM) */
+    uint32_t stable_ticks;
+    angle_t offset;       /* 控制角 = 观测角 - offset (2^32 = 2π) */
+    uint8_t switch_event; /* 本周期发生切换 (仅一个周期为 1) */
+    uint32_t if_ticks;    /* I/F 阶段周期数 */
+} if_handover_t;
+
+/**
+ * @brief 初始化
+ * @param handover      句柄
+ * @param ts            控制周期 (s)
+ * @param min_speed_rpm 允许切换的最低观测转速 (RPM), 低于此值反电势过小, 观测角不可靠
+ * @param speed_tol_rpm 转速误差门限 (RPM)
+ * @param angle_tol     角度误差平均偏差门限 (rad)
+ * @param settle_time   指标持续满足的时间 (s)
+ * @param blend_rate    角度偏差归零速率 (rad/s, 电角度)
+ */
+void if_handover_init(if_handover_t *handover, float ts, float min_speed_rpm, float speed_tol_rpm,
+                      float angle_tol, float settle_time, float blend_rate);
+
+/* 回到 I/F 阶段, 清除统计 */
+void if_handover_reset(if_handover_t *handover);
+
+/* 不经 I/F 直接使用观测角 (如转动中切入无感) */
+void if_handover_force_done(if_handover_t *handover);
+
+/**
+ * @brief 每个控制周期调用, 返回本周期的控制角度
+ * @param handover      句柄
+ * @param if_angle      开环角 (2^32 = 2π)
+ * @param if_speed_rpm  开环转速 (RPM)
+ * @param obs_angle     观测角 (2^32 = 2π)
+ * @param obs_speed_rpm 观测转速 (RPM)
+ * @return I/F 阶段返回开环角, 之后返回 观测角 - offset
+ */
+angle_t if_handover_update(if_handover_t *handover, angle_t if_angle, float if_speed_rpm, angle_t obs_angle, float obs_speed_rpm);
+
+/**
+ * @brief 切换瞬间速度环积分的预置值
+ * @param iq_if I/F 阶段的 Iq 给定 (A)
+ * @return I/F 电流在观测 (转子) 坐标系 q 轴上的投影 iq_if·cos(offset), 使切换前后转矩连续
+ */
+float if_handover_iq_preload(const if_handover_t *handover, float iq_if);
+
+#endif /* __IF_HANDOVER_H__ */
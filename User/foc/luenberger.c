@@ -1,6 +1,14 @@
 #include "luenberger.h"
-
-void luenberger_init(luenberger_t *luenberger, float rs, float ls, float poles, float ts, float l1, float l2, float pll_fc, float k_speed_lpf)
+#include "motor_profile.h"
+#include "utils/ccmram.h"
+
+/*
+ * 保存参数与预先算好的系数, 状态清零
+ * f / g: 离散电流模型 i(k+1) = f·i(k) + g·(u - e), 即 1 - ts·rs/ls 与 ts/ls
+ * kp / ki: PLL 增益, ki 已乘 ts
+ */
+static void luenberger_setup(luenberger_t *luenberger, float rs, float ls, float poles, float ts, float l1, float l2,
+                             float f, float g, float kp, float ki, float k_speed_lpf)
 {
     // 保存电机参数
     luenberger->rs = rs;
@@ -13,25 +21,26 @@ void luenberger_init(luenberger_t *luenberger, float rs, float ls, float poles,
     luenberger->l2 = l2;
     luenberger->k_speed_lpf = k_speed_lpf;
 
+    // 观测中用到的系数, 除法只在这里做一次
+    luenberger->k_tl = g;
+    luenberger->k_trl = 1.0f - f;
+    luenberger->l1_ts = l1 * ts;
+    luenberger->l2_ts = l2 * ts;
+    luenberger->k_rad_s_to_rpm = 60.0f / (2.0f * 3.14159265f * poles);
+    luenberger->k_theta = ts * ANGLE_FROM_RAD_K;
+
     // 状态清零
     luenberger->i_alpha_est = 0.0f;
     luenberger->i_beta_est = 0.0f;
     luenberger->e_alpha_est = 0.0f;
     luenberger->e_beta_est = 0.0f;
 
-    luenberger->theta_est = 0.0f;
+    luenberger->theta_est = 0;
     luenberger->speed_est = 0.0f;
     luenberger->speed_est_filt = 0.0f;
     luenberger->speed_rad_s = 0.0f;
 
     // PLL 初始化
-    // 典型值：Kp = 2 * ζ * ωn, Ki = ωn^2
-    // ωn = 2π * fc
-    float wn = 2 * 3.14159 * pll_fc;
-    float zeta = 1.0f; // 阻尼系数
-    float kp = 2.0f * zeta * wn;
-    float ki = wn * wn * ts; // 注意：pid_calculate 内部不乘 ts，所以这里预乘
-
     luenberger->k_pll_kp = kp;
     luenberger->k_pll_ki = ki;
 
@@ -42,12 +51,30 @@ void luenberger_init(luenberger_t *luenberger, float rs, float ls, float poles,
     pid_init(&luenberger->pll, kp, ki, -max_speed_rad_s, max_speed_rad_s);
 }
 
-void luenberger_estimate(luenberger_t *luenberger)
+void luenberger_init(luenberger_t *luenberger, float rs, float ls, float poles, float ts, float l1, float l2, float pll_fc, float k_speed_lpf)
 {
-    // 提取电机参数
+    // PLL 典型值：Kp = 2 * ζ * ωn, Ki = ωn^2
+    // ωn = 2π * fc
+    float wn = 2.0f * 3.14159265f * pll_fc;
+    float zeta = 1.0f; // 阻尼系数
+    float kp = 2.0f * zeta * wn;
+    float ki = wn * wn * ts; // 注意：pid_calculate 内部不乘 ts，所以这里预乘
+
+    luenberger_setup(luenberger, rs, ls, poles, ts, l1, l2, 1.0f - ts * rs / ls, ts / ls, kp, ki, k_speed_lpf);
+}
+
+void luenberger_init_profile(luenberger_t *luenberger, float k_speed_lpf)
+{
+    luenberger_setup(luenberger, MOTOR_RS, MOTOR_LS, MOTOR_POLE_PAIRS, MOTOR_TS, MOTOR_LUENBERGER_L1, MOTOR_LUENBERGER_L2,
+                     MOTOR_OBS_F, MOTOR_OBS_G, MOTOR_PLL_KP, MOTOR_PLL_KI, k_speed_lpf);
+}
+
+CCMRAM_FUNC void luenberger_estimate(luenberger_t *luenberger)
+{
+    // 提取系数
     float ts = luenberger->ts;
-    float rs = luenberger->rs;
-    float ls = luenberger->ls;
+    float k_tl = luenberger->k_tl;
+    float k_trl = luenberger->k_trl;
 
     // 获取当前时刻(k)的状态变量
     float i_alpha_k = luenberger->i_alpha_est;
@@ -68,16 +95,13 @@ void luenberger_estimate(luenberger_t *luenberger)
     float i_err_alpha = i_alpha_k - i_alpha_meas;
     float i_err_beta = i_beta_k - i_beta_meas;
 
-    float k_tl = ts / ls;
-    float k_trl = ts * rs / ls;
-
     // 电流观测器更新
-    float i_alpha_next = i_alpha_k - k_trl * i_alpha_k - k_tl * e_alpha_k + k_tl * u_alpha + luenberger->l1 * ts * i_err_alpha;
-    float i_beta_next = i_beta_k - k_trl * i_beta_k - k_tl * e_beta_k + k_tl * u_beta + luenberger->l1 * ts * i_err_beta;
+    float i_alpha_next = i_alpha_k - k_trl * i_alpha_k - k_tl * e_alpha_k + k_tl * u_alpha + luenberger->l1_ts * i_err_alpha;
+    float i_beta_next = i_beta_k - k_trl * i_beta_k - k_tl * e_beta_k + k_tl * u_beta + luenberger->l1_ts * i_err_beta;
 
     // 反电势观测器更新
-    float e_alpha_next = e_alpha_k - we * ts * e_beta_k + luenberger->l2 * ts * i_err_alpha;
-    float e_beta_next = e_beta_k + we * ts * e_alpha_k + luenberger->l2 * ts * i_err_beta;
+    float e_alpha_next = e_alpha_k - we * ts * e_beta_k + luenberger->l2_ts * i_err_alpha;
+    float e_beta_next = e_beta_k + we * ts * e_alpha_k + luenberger->l2_ts * i_err_beta;
 
     // 更新状态
     luenberger->i_alpha_est = i_alpha_next;
@@ -87,7 +111,7 @@ void luenberger_estimate(luenberger_t *luenberger)
 
     // --- PLL 锁相环 ---
     float sin_theta, cos_theta;
-    fast_sin_cos(luenberger->theta_est, &sin_theta, &cos_theta);
+    angle_sin_cos_pll(luenberger->theta_est, &sin_theta, &cos_theta);
 
     // 计算 PLL 误差
     float pll_err = -(luenberger->e_alpha_est * cos_theta + luenberger->e_beta_est * sin_theta);
@@ -96,27 +120,21 @@ void luenberger_estimate(luenberger_t *luenberger)
     luenberger->speed_rad_s = pid_calculate(&luenberger->pll, pll_err, 0.0f);
 
     // 计算机械转速 (RPM)
-    luenberger->speed_est = luenberger->speed_rad_s * 60.0f / (2.0f * 3.14159265f * luenberger->poles);
+    luenberger->speed_est = luenberger->speed_rad_s * luenberger->k_rad_s_to_rpm;
 
     // 对速度进行低通滤波
     luenberger->speed_est_filt = (1.0f - luenberger->k_speed_lpf) * luenberger->speed_est_filt + luenberger->k_speed_lpf * luenberger->speed_est;
     
-    // 积分得到角度
-    luenberger->theta_est += luenberger->speed_rad_s * ts;
-
-    // 角度归一化 (-pi, pi]
-    if (luenberger->theta_est > 3.14159265f)
-        luenberger->theta_est -= 2.0f * 3.14159265f;
-    else if (luenberger->theta_est <= -3.14159265f)
-        luenberger->theta_est += 2.0f * 3.14159265f;
+    // 积分得到角度 (整数角度溢出即回绕)
+    luenberger->theta_est += (angle_t)(int32_t)(luenberger->speed_rad_s * luenberger->k_theta);
 }
 
-float luenberger_get_angle(luenberger_t *luenberger)
+CCMRAM_FUNC angle_t luenberger_get_angle(luenberger_t *luenberger)
 {
     return luenberger->theta_est;
 }
 
-float luenberger_get_speed_rpm(luenberger_t *luenberger)
+CCMRAM_FUNC float luenberger_get_speed_rpm(luenberger_t *luenberger)
 {
     return luenberger->speed_est_filt;
 }
@@ -3,6 +3,7 @@
 
 #include <math.h>
 #include "utils/fast_sin_cos.h"
+#include "utils/angle.h"
 #include "pid.h"
 
 // Luenberger 观测器结构体
@@ -18,6 +19,14 @@ typedef struct
     float ts;    // 控制周期 (s)
     float poles; // 电机极对数
 
+    // 初始化时预先算好的系数 (观测中只做乘法)
+    float k_tl;           // ts/ls
+    float k_trl;          // ts·rs/ls
+    float l1_ts;          // l1·ts
+    float l2_ts;          // l2·ts
+    float k_rad_s_to_rpm; // 电角速度 (rad/s) -> 机械转速 (RPM)
+    float k_theta;        // 电角速度 (rad/s) -> 每周期整数角增量
+
     float l1;       // 电流观测器增益
     float l2;       // 反电势观测器增益
     float k_pll_kp; // PLL KP
@@ -28,7 +37,7 @@ typedef struct
     float e_alpha_est; // 估算反电动势 alpha (k)
     float e_beta_est;  // 估算反电动势 beta (k)
 
-    float theta_est;   // 估算角度 (rad)
+    angle_t theta_est; // 估算角度 (2^32 = 2π)
     float speed_est;   // 估算速度 (rpm)
     float speed_est_filt; // 滤波后的速度 (rpm)
     float k_speed_lpf; // 速度低通滤波系数
@@ -53,6 +62,14 @@ typedef struct
  */
 void luenberger_init(luenberger_t *luenberger, float rs, float ls, float poles, float ts, float l1, float l2, float pll_fc, float k_speed_lpf);
 
+/**
+ * @brief 按当前电机配置 (motor_profile.h) 初始化 Luenberger 观测器
+ * @param luenberger 观测器句柄
+ * @param k_speed_lpf 速度滤波系数
+ * @note  电机参数、控制周期、观测器增益 L1 / L2、离散模型 F / G 与 PLL 增益都取生成的常量, 不再重新推导
+ */
+void luenberger_init_profile(luenberger_t *luenberger, float k_speed_lpf);
+
 /**
  * @brief 运行 Luenberger 观测器
  * @param luenberger 观测器句柄
@@ -60,11 +77,11 @@ void luenberger_init(luenberger_t *luenberger, float rs, float ls, float poles,
 void luenberger_estimate(luenberger_t *luenberger);
 
 /**
- * @brief 获取估算的角度 (rad)
+ * @brief 获取估算的角度
  * @param luenberger 观测器句柄
- * @return float 角度
+ * @return angle_t 电角度 (2^32 = 2π)
  */
-float luenberger_get_angle(luenberger_t *luenberger);
+angle_t luenberger_get_angle(luenberger_t *luenberger);
 
 /**
  * @brief 获取估算的速度 (rpm)
@@ -0,0 +1,99 @@
+#include "luenberger_q15.h"
+
+#define LUENBERGER_Q15_TWO_PI 6.28318530718f
+
+void luenberger_q15_init(luenberger_q15_t *luenberger, float rs, float ls, float poles, float ts, float l1, float l2, float pll_fc, float k_speed_lpf)
+{
+    // 电流方程系数, 电流以 I_BASE, 电压以 U_BASE 为基准
+    luenberger->k_tl = QGAIN(ts / ls * FOC_Q15_U_BASE / FOC_Q15_I_BASE);
+    luenberger->k_trl = QGAIN(ts * rs / ls);
+
+    // 观测器增益
+    luenberger->l1_ts = QGAIN(l1 * ts);
+    luenberger->l2_ts = QGAIN(l2 * ts * FOC_Q15_I_BASE / FOC_Q15_U_BASE);
+    luenberger->k_speed_lpf = QGAIN(k_speed_lpf);
+
+    // 速度 (Q15) -> ωe*ts (s15.16) 与每周期角度增量
+    luenberger->k_wts = QGAIN(FOC_Q15_W_BASE * ts);
+    luenberger->k_theta = QGAIN(FOC_Q15_W_BASE * ts / LUENBERGER_Q15_TWO_PI * 131072.0f);
+
+    // 状态清零
+    luenberger->i_alpha_est = 0;
+    luenberger->i_beta_est = 0;
+    luenberger->e_alpha_est = 0;
+    luenberger->e_beta_est = 0;
+
+    luenberger->theta_est = 0;
+    luenberger->speed_est_filt = 0;
+    luenberger->speed = 0;
+
+    // PLL 初始化, 与浮点版相同, 折算为标幺增益 (输入电压, 输出电角速度)
+    float wn = 2 * 3.14159 * pll_fc;
+    float zeta = 1.0f; // 阻尼系数
+    float kp = 2.0f * zeta * wn;
+    float ki = wn * wn * ts;
+
+    // 估算最大转速用于限幅
+    float max_rpm = 10000.0f;
+    float max_speed_rad_s = max_rpm * 2.0f * 3.14159265f * poles / 60.0f;
+    q15_t max_speed = FOC_Q15_SPEED(max_speed_rad_s);
+
+    pid_q15_init(&luenberger->pll, PID_Q15_GAIN(kp, FOC_Q15_U_BASE, FOC_Q15_W_BASE),
+                 PID_Q15_GAIN(ki, FOC_Q15_U_BASE, FOC_Q15_W_BASE), (q15_t)-max_speed, max_speed);
+}
+
+void luenberger_q15_estimate(luenberger_q15_t *luenberger)
+{
+    // 获取当前时刻(k)的状态变量
+    int32_t i_alpha_k = luenberger->i_alpha_est;
+    int32_t i_beta_k = luenberger->i_beta_est;
+    int32_t e_alpha_k = luenberger->e_alpha_est;
+    int32_t e_beta_k = luenberger->e_beta_est;
+
+    // 使用上一时刻估计的电角速度: ωe*ts (s15.16)
+    int32_t we_ts = (luenberger->speed * luenberger->k_wts) >> 15;
+
+    // 计算电流估算误差: i_est(k) - i_meas(k)
+    int32_t i_err_alpha = i_alpha_k - q27_from_q15(luenberger->i_alpha);
+    int32_t i_err_beta = i_beta_k - q27_from_q15(luenberger->i_beta);
+
+    // 电流观测器更新
+    luenberger->i_alpha_est = i_alpha_k - qgain_mul(i_alpha_k, luenberger->k_trl) +
+                              qgain_mul(q27_from_q15(luenberger->u_alpha) - e_alpha_k, luenberger->k_tl) +
+                              qgain_mul(i_err_alpha, luenberger->l1_ts);
+    luenberger->i_beta_est = i_beta_k - qgain_mul(i_beta_k, luenberger->k_trl) +
+                             qgain_mul(q27_from_q15(luenberger->u_beta) - e_beta_k, luenberger->k_tl) +
+                             qgain_mul(i_err_beta, luenberger->l1_ts);
+
+    // 反电势观测器更新
+    luenberger->e_alpha_est = e_alpha_k - qgain_mul(e_beta_k, we_ts) + qgain_mul(i_err_alpha, luenberger->l2_ts);
+    luenberger->e_beta_est = e_beta_k + qgain_mul(e_alpha_k, we_ts) + qgain_mul(i_err_beta, luenberger->l2_ts);
+
+    // --- PLL 锁相环 ---
+    q15_t sin_theta, cos_theta;
+    qmath_sin_cos((uint16_t)(luenberger->theta_est >> 16), &sin_theta, &cos_theta);
+
+    // 计算 PLL 误差
+    int64_t pll_err = -((int64_t)luenberger->e_alpha_est * cos_theta + (int64_t)luenberger->e_beta_est * sin_theta);
+    q15_t pll_err_q15 = q15_sat((int32_t)(pll_err >> (15 + Q27_SHIFT)));
+
+    // PI 计算得到角速度
+    luenberger->speed = pid_q15_calculate(&luenberger->pll, pll_err_q15, 0);
+
+    // 对速度进行低通滤波
+    luenberger->speed_est_filt += qgain_mul(q27_from_q15(luenberger->speed) - luenberger->speed_est_filt,
+                                            luenberger->k_speed_lpf);
+
+    // 积分得到角度, 32 位角度溢出即完成归一化
+    luenberger->theta_est += (uint32_t)qgain_mul(luenberger->speed, luenberger->k_theta);
+}
+
+uint16_t luenberger_q15_get_angle(luenberger_q15_t *luenberger)
+{
+    return (uint16_t)(luenberger->theta_est >> 16);
+}
+
+q15_t luenberger_q15_get_speed(luenberger_q15_t *luenberger)
+{
+    return q15_from_q27(luenberger->speed_est_filt);
+}
@@ -0,0 +1,64 @@
+#ifndef __LUENBERGER_Q15_H__
+#define __LUENBERGER_Q15_H__
+
+#include "clark_park_q15.h"
+#include "pid_q15.h"
+
+// Luenberger 观测器结构体 (定点)
+typedef struct
+{
+    q15_t i_alpha; // 实测电流 alpha (Q15)
+    q15_t i_beta;  // 实测电流 beta (Q15)
+    q15_t u_alpha; // 以此计算出的电压 alpha (Q15)
+    q15_t u_beta;  // 以此计算出的电压 beta (Q15)
+
+    // 预计算系数 (s15.16)
+    int32_t k_tl;        // ts/ls, 已折算电压/电流基准
+    int32_t k_trl;       // ts*rs/ls
+    int32_t l1_ts;       // 电流观测器增益 l1*ts
+    int32_t l2_ts;       // 反电势观测器增益 l2*ts, 已折算电流/电压基准
+    int32_t k_wts;       // 速度 (Q15) -> ωe*ts
+    int32_t k_speed_lpf; // 速度低通滤波系数
+    int32_t k_theta;     // 速度 (Q15) -> 每周期角度增量 (2^32 = 2π)
+
+    int32_t i_alpha_est; // 估算电流 alpha (k), Q27
+    int32_t i_beta_est;  // 估算电流 beta (k), Q27
+    int32_t e_alpha_est; // 估算反电动势 alpha (k), Q27
+    int32_t e_beta_est;  // 估算反电动势 beta (k), Q27
+
+    uint32_t theta_est;     // 估算角度 (2^32 = 2π)
+    int32_t speed_est_filt; // 滤波后的电角速度 (Q27)
+    q15_t speed;            // 估算电角速度 (Q15)
+
+    // PLL PI 控制器
+    pid_q15_t pll;
+
+} luenberger_q15_t;
+
+/**
+ * @brief 初始化 Luenberger 观测器 (定点)
+ * @note  参数含义与 luenberger_init() 相同 (物理单位), 初始化时折算为标幺系数
+ */
+void luenberger_q15_init(luenberger_q15_t *luenberger, float rs, float ls, float poles, float ts, float l1, float l2, float pll_fc, float k_speed_lpf);
+
+/**
+ * @brief 运行 Luenberger 观测器 (定点)
+ * @param luenberger 观测器句柄
+ */
+void luenberger_q15_estimate(luenberger_q15_t *luenberger);
+
+/**
+ * @brief 获取估算的角度
+ * @param luenberger 观测器句柄
+ * @return uint16_t 角度 (65536 = 2π)
+ */
+uint16_t luenberger_q15_get_angle(luenberger_q15_t *luenberger);
+
+/**
+ * @brief 获取滤波后的电角速度
+ * @param luenberger 观测器句柄
+ * @return q15_t 电角速度 (以 FOC_Q15_W_BASE 为基准)
+ */
+q15_t luenberger_q15_get_speed(luenberger_q15_t *luenberger);
+
+#endif /* __LUENBERGER_Q15_H__ */
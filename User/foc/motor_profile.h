@@ -0,0 +1,105 @@
+/**
+ * @file motor_profile.h
+ * @brief 电机参数配置 (由 python_tools/motor_profile.py 根据 motor_profiles.json 生成, 请勿手工修改)
+ *
+ * 编译选项中定义 MOTOR_PROFILE=MOTOR_PROFILE_<名称> 选择电机, 未定义时使用默认配置。
+ * 所有常量在生成时算好, 控制中断中只需乘法。
+ */
+
+#ifndef __MOTOR_PROFILE_H__
+#define __MOTOR_PROFILE_H__
+
+#define MOTOR_PROFILE_BENCH 0
+#define MOTOR_PROFILE_L970UH 1
+
+#ifndef MOTOR_PROFILE
+#define MOTOR_PROFILE MOTOR_PROFILE_BENCH
+#endif
+
+/* PWM 周期; PWM_DOUBLE_UPDATE=1 时峰值与谷底各有一次更新事件 (采样 + 控制中断), 控制周期减半 */
+#ifndef PWM_DOUBLE_UPDATE
+#define PWM_DOUBLE_UPDATE 0
+#endif
+
+#define MOTOR_PWM_TS 0.0001f  /* PWM 周期 (s) */
+#define MOTOR_PWM_FREQ 10000U /* PWM 频率 (Hz) */
+#if PWM_DOUBLE_UPDATE
+#define MOTOR_CTRL_PER_PWM 2U /* 每个 PWM 周期的控制周期数 */
+#else
+#define MOTOR_CTRL_PER_PWM 1U
+#endif
+#define MOTOR_CTRL_FREQ (MOTOR_PWM_FREQ * MOTOR_CTRL_PER_PWM) /* 控制频率 (Hz) */
+
+#if MOTOR_PROFILE == MOTOR_PROFILE_BENCH
+
+#define MOTOR_PROFILE_NAME "BENCH"      /* 台架电机 (AS5047 编码器, 仿真被控对象默认参数) */
+#define MOTOR_RS 0.12f                  /* 定子电阻 (Ω) */
+#define MOTOR_LD 3e-05f                 /* D 轴电感 (H) */
+#define MOTOR_LQ 3e-05f                 /* Q 轴电感 (H) */
+#define MOTOR_LS 3e-05f                 /* 观测器使用的平均电感 (H) */
+#define MOTOR_FLUX 0.0015f              /* 永磁体磁链 (Wb) */
+#define MOTOR_POLE_PAIRS 7              /* 极对数 */
+#define MOTOR_PLL_FC 50.0f              /* PLL 带宽 (Hz) */
+#define MOTOR_PLL_KP 628.318531f        /* PLL 增益, ζ = 1, ki 已乘 Ts */
+#define MOTOR_CURRENT_KP 0.017f         /* 电流环 PI (实测整定值), ki 已乘 Ts */
+#define MOTOR_RPM_TO_RAD_S 0.733038286f /* 机械转速 (RPM) -> 电角速度 (rad/s) */
+#define MOTOR_RAD_S_TO_RPM 1.36418523f  /* 电角速度 (rad/s) -> 机械转速 (RPM) */
+#if PWM_DOUBLE_UPDATE
+#define MOTOR_TS 5e-05f                          /* 控制周期 (s) */
+#define MOTOR_OBS_F 0.8f                         /* 离散电流模型 i(k+1) = F·i(k) + G·(u - e) */
+#define MOTOR_OBS_G 1.66666667f
+#define MOTOR_LUENBERGER_L1 -30000.0f            /* Luenberger 增益, 极点系数 f = 6 */
+#define MOTOR_LUENBERGER_L2 8666.66667f
+#define MOTOR_PLL_KI 4.9348022f
+#define MOTOR_CURRENT_KI 0.001413f
+#define MOTOR_RPM_TO_DELTA_ANGLE 3.66519143e-05f /* 机械转速 (RPM) -> 每周期电角度增量 (rad) */
+#else
+#define MOTOR_TS 0.0001f                         /* 控制周期 (s) */
+#define MOTOR_OBS_F 0.6f                         /* 离散电流模型 i(k+1) = F·i(k) + G·(u - e) */
+#define MOTOR_OBS_G 3.33333333f
+#define MOTOR_LUENBERGER_L1 -13333.3333f         /* Luenberger 增益, 极点系数 f = 6 */
+#define MOTOR_LUENBERGER_L2 2250.0f
+#define MOTOR_PLL_KI 9.8696044f
+#define MOTOR_CURRENT_KI 0.002826f
+#define MOTOR_RPM_TO_DELTA_ANGLE 7.33038286e-05f /* 机械转速 (RPM) -> 每周期电角度增量 (rad) */
+#endif
+
+#elif MOTOR_PROFILE == MOTOR_PROFILE_L970UH
+
+#define MOTOR_PROFILE_NAME "L970UH"     /* luenberger_calulate.py 示例电机 (磁链、极对数为估计值, 使用前需实测) */
+#define MOTOR_RS 0.11f                  /* 定子电阻 (Ω) */
+#define MOTOR_LD 0.00097f               /* D 轴电感 (H) */
+#define MOTOR_LQ 0.00097f               /* Q 轴电感 (H) */
+#define MOTOR_LS 0.00097f               /* 观测器使用的平均电感 (H) */
+#define MOTOR_FLUX 0.0055f              /* 永磁体磁链 (Wb) */
+#define MOTOR_POLE_PAIRS 7              /* 极对数 */
+#define MOTOR_PLL_FC 50.0f              /* PLL 带宽 (Hz) */
+#define MOTOR_PLL_KP 628.318531f        /* PLL 增益, ζ = 1, ki 已乘 Ts */
+#define MOTOR_CURRENT_KP 3.04734487f    /* 电流环 PI (带宽 500 Hz), ki 已乘 Ts */
+#define MOTOR_RPM_TO_RAD_S 0.733038286f /* 机械转速 (RPM) -> 电角速度 (rad/s) */
+#define MOTOR_RAD_S_TO_RPM 1.36418523f  /* 电角速度 (rad/s) -> 机械转速 (RPM) */
+#if PWM_DOUBLE_UPDATE
+#define MOTOR_TS 5e-05f                          /* 控制周期 (s) */
+#define MOTOR_OBS_F 0.994329897f                 /* 离散电流模型 i(k+1) = F·i(k) + G·(u - e) */
+#define MOTOR_OBS_G 0.0515463918f
+#define MOTOR_LUENBERGER_L1 -33238.8316f         /* Luenberger 增益, 极点系数 f = 6 */
+#define MOTOR_LUENBERGER_L2 269750.0f
+#define MOTOR_PLL_KI 4.9348022f
+#define MOTOR_CURRENT_KI 0.0172787596f
+#define MOTOR_RPM_TO_DELTA_ANGLE 3.66519143e-05f /* 机械转速 (RPM) -> 每周期电角度增量 (rad) */
+#else
+#define MOTOR_TS 0.0001f                         /* 控制周期 (s) */
+#define MOTOR_OBS_F 0.988659794f                 /* 离散电流模型 i(k+1) = F·i(k) + G·(u - e) */
+#define MOTOR_OBS_G 0.103092784f
+#define MOTOR_LUENBERGER_L1 -16572.1649f         /* Luenberger 增益, 极点系数 f = 6 */
+#define MOTOR_LUENBERGER_L2 67513.8889f
+#define MOTOR_PLL_KI 9.8696044f
+#define MOTOR_CURRENT_KI 0.0345575192f
+#define MOTOR_RPM_TO_DELTA_ANGLE 7.33038286e-05f /* 机械转速 (RPM) -> 每周期电角度增量 (rad) */
+#endif
+
+#else
+#error "MOTOR_PROFILE: 未知的电机配置"
+#endif
+
+#endif /* __MOTOR_PROFILE_H__ */
@@ -1,4 +1,5 @@
 #include "pid.h"
+#include "utils/ccmram.h"
 
 /**
  * @brief PI控制器初始化
@@ -22,6 +23,9 @@ void pid_init(pid_controller_t *pid, float kp, float ki, float out_min, float ou
 
     /* 积分限幅取输出范围的绝对值上限，适配单边/双边输出 */
     pid->integral_max = fmaxf(fabsf(out_min), fabsf(out_max));
+
+    /* 反算时间常数取积分时间 Ti = kp / ki (离散积分项每周期累加 ki·e, 故系数为 ki / kp) */
+    pid->kb = (kp > 0.0f) ? ki / kp : 0.0f;
 }
 
 /**
@@ -31,7 +35,7 @@ void pid_init(pid_controller_t *pid, float kp, float ki, float out_min, float ou
  * @param feedback 反馈值
  * @return 控制输出, 范围[out_min, out_max]
  */
-float pid_calculate(pid_controller_t *pid, float setpoint, float feedback)
+CCMRAM_FUNC float pid_calculate(pid_controller_t *pid, float setpoint, float feedback)
 {
     /* 计算当前误差 */
     pid->error = setpoint - feedback;
@@ -69,6 +73,19 @@ float pid_calculate(pid_controller_t *pid, float setpoint, float feedback)
     return pid->out;
 }
 
+/**
+ * @brief 反算抗饱和 (back-calculation)
+ * @param pid PI控制器结构体指针
+ * @param out_limited 外部限幅后实际输出的值 (如 dq 电压矢量圆限幅)
+ * @note  pid_calculate 之后调用: 积分项按 kb·(实际输出 - PI 输出) 回退, 限幅期间积分不再累积,
+ *        退出限幅时 PI 仍工作在线性区; 同时把 out 改为实际输出值
+ */
+CCMRAM_FUNC void pid_back_calculate(pid_controller_t *pid, float out_limited)
+{
+    pid->integral += pid->kb * (out_limited - pid->out);
+    pid->out = out_limited;
+}
+
 /**
  * @brief PI复位
  * @param pid PI控制器结构体指针
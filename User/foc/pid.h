@@ -17,6 +17,7 @@ typedef struct
     float out_min;      /* 输出下限 */
     float out_max;      /* 输出上限 */
     float integral_max; /* 积分抗饱和限幅 */
+    float kb;           /* 反算抗饱和系数 (外部限幅时使用, 默认 ki / kp) */
 } pid_controller_t;
 
 /* PI控制器初始化 */
@@ -25,6 +26,9 @@ void pid_init(pid_controller_t *pid, float kp, float ki, float out_min, float ou
 /* PI计算 */
 float pid_calculate(pid_controller_t *pid, float setpoint, float feedback);
 
+/* 反算抗饱和: 输出在 PI 之外被再次限幅时回馈限幅量 */
+void pid_back_calculate(pid_controller_t *pid, float out_limited);
+
 /* PI复位 */
 void pid_reset(pid_controller_t *pid);
 
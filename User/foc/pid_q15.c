@@ -0,0 +1,86 @@
+#include "pid_q15.h"
+
+/**
+ * @brief PI控制器初始化 (定点)
+ * @param pid PI控制器结构体指针
+ * @param kp 比例系数 (标幺)
+ * @param ki 积分系数 (标幺, 已乘控制周期)
+ * @param out_min 输出下限 (Q15)
+ * @param out_max 输出上限 (Q15)
+ */
+void pid_q15_init(pid_q15_t *pid, float kp, float ki, q15_t out_min, q15_t out_max)
+{
+    pid->kp = QGAIN(kp);
+    pid->ki = QGAIN(ki);
+
+    pid->error = 0;
+    pid->integral = 0;
+
+    pid->out = 0;
+    pid->out_min = out_min;
+    pid->out_max = out_max;
+
+    /* 积分限幅取输出范围的绝对值上限，适配单边/双边输出 */
+    int32_t abs_min = (out_min < 0) ? -(int32_t)out_min : out_min;
+    int32_t abs_max = (out_max < 0) ? -(int32_t)out_max : out_max;
+    int32_t limit = (abs_min > abs_max) ? abs_min : abs_max;
+    pid->integral_max = (limit > Q15_MAX) ? Q31_MAX : (limit << 16);
+}
+
+/**
+ * @brief PI计算 (定点)
+ * @param pid PI控制器结构体指针
+ * @param setpoint 设定值 (Q15)
+ * @param feedback 反馈值 (Q15)
+ * @return 控制输出 (Q15), 范围[out_min, out_max]
+ */
+q15_t pid_q15_calculate(pid_q15_t *pid, q15_t setpoint, q15_t feedback)
+{
+    /* 计算当前误差 */
+    pid->error = q15_sat((int32_t)setpoint - feedback);
+
+    /* 比例项 (Q15) */
+    int32_t proportional = qgain_mul(pid->error, pid->kp);
+
+    /* 积分项 (Q15 × s15.16 = Q31) */
+    int64_t integral_increment = qgain_mul_q31(pid->error, pid->ki);
+
+    /* 抗积分饱和：输出饱和时，阻止同向积分 */
+    uint8_t saturated_high = (pid->out >= pid->out_max) && (integral_increment > 0);
+    uint8_t saturated_low  = (pid->out <= pid->out_min) && (integral_increment < 0);
+
+    if (!saturated_high && !saturated_low)
+    {
+        pid->integral = q31_sat((int64_t)pid->integral + integral_increment);
+    }
+
+    /* 积分限幅 */
+    if (pid->integral > pid->integral_max)
+        pid->integral = pid->integral_max;
+    else if (pid->integral < -pid->integral_max)
+        pid->integral = -pid->integral_max;
+
+    /* PI输出 = 比例 + 积分 */
+    int32_t out = proportional + (int32_t)(((int64_t)pid->integral + (1 << 15)) >> 16);
+
+    /* 输出限幅 */
+    if (out > pid->out_max)
+        out = pid->out_max;
+    else if (out < pid->out_min)
+        out = pid->out_min;
+
+    pid->out = (q15_t)out;
+
+    return pid->out;
+}
+
+/**
+ * @brief PI复位
+ * @param pid PI控制器结构体指针
+ */
+void pid_q15_reset(pid_q15_t *pid)
+{
+    pid->error = 0;
+    pid->integral = 0;
+    pid->out = 0;
+}
@@ -0,0 +1,39 @@
+#ifndef __PID_Q15_H__
+#define __PID_Q15_H__
+
+#include "stm32g4xx_hal.h"
+#include "./utils/qmath.h"
+
+/**
+ * PI控制器结构体 (定点)
+ *
+ * 输入 / 输出为 Q15 标幺值, 增益为 s15.16 标幺增益 (kp_pu = kp * 输入基准 / 输出基准),
+ * 积分项以 Q31 累加, 避免小 ki 时积分增量被截断为 0。
+ */
+typedef struct
+{
+    int32_t kp;           /* 比例系数 s15.16 */
+    int32_t ki;           /* 积分系数 s15.16 */
+
+    q15_t error;          /* 当前误差 */
+    q31_t integral;       /* 积分项累加 Q31 */
+
+    q15_t out;            /* PI输出 */
+    q15_t out_min;        /* 输出下限 */
+    q15_t out_max;        /* 输出上限 */
+    q31_t integral_max;   /* 积分抗饱和限幅 Q31 */
+} pid_q15_t;
+
+/* 物理增益 -> 标幺增益 */
+#define PID_Q15_GAIN(k, in_base, out_base) ((k) * (in_base) / (out_base))
+
+/* PI控制器初始化, kp / ki 为标幺增益 */
+void pid_q15_init(pid_q15_t *pid, float kp, float ki, q15_t out_min, q15_t out_max);
+
+/* PI计算 */
+q15_t pid_q15_calculate(pid_q15_t *pid, q15_t setpoint, q15_t feedback);
+
+/* PI复位 */
+void pid_q15_reset(pid_q15_t *pid);
+
+#endif /* __PID_Q15_H__ */
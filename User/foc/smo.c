@@ -1,8 +1,10 @@
 #include "smo.h"
 #include "pid.h"
+#include "motor_profile.h"
+#include "utils/ccmram.h"
 
 // 滑模控制率 - 饱和函数
-static float smo_fun(float error, float boundary)
+CCMRAM_FUNC static float smo_fun(float error, float boundary, float inv_boundary)
 {
     // 饱和函数：在边界层内线性，边界层外饱和
     if (error > boundary)
@@ -10,10 +12,16 @@ static float smo_fun(float error, float boundary)
     else if (error < -boundary)
         return -1.0f;
     else
-        return error / boundary; // 边界层内线性过渡
+        return error * inv_boundary; // 边界层内线性过渡
 }
 
-void smo_init(smo_t *smo, float rs, float ls, float poles, float ts, float k_slide, float k_lpf, float boundary, float fc, float k_speed_lpf)
+/*
+ * 保存参数与预先算好的系数, 状态清零
+ * f / g: 离散电流模型 i(k+1) = f·i(k) + g·(u - e - z), 即 1 - rs·ts/ls 与 ts/ls
+ * kp / ki: PLL 增益, ki 已乘 ts
+ */
+static void smo_setup(smo_t *smo, float rs, float ls, float poles, float ts, float k_slide, float k_lpf, float boundary,
+                      float f, float g, float kp, float ki, float k_speed_lpf)
 {
     // 电机参数
     smo->rs = rs;
@@ -27,18 +35,19 @@ void smo_init(smo_t *smo, float rs, float ls, float poles, float ts, float k_sli
     smo->boundary = boundary;
     smo->k_speed_lpf = k_speed_lpf;
 
-    // PLL 参数 - 使用 pid_init 初始化
-    // 典型值：Kp = 2 * ζ * ωn, Ki = ωn^2
-    // ωn = 2π * fc
-    float wn = 2.0f * 3.14159265f * fc;
-    float zeta = 1.0f; // 阻尼系数
-    float kp = 2.0f * zeta * wn;
-    float ki = wn * wn * ts; // 注意：pid_calculate 内部不乘 ts，所以这里预乘
+    // 观测中用到的系数, 除法只在这里做一次
+    smo->f = f;
+    smo->g = g;
+    smo->inv_boundary = 1.0f / boundary;
+    smo->k_lag = ts * (1.0f - k_lpf) / k_lpf;
+    smo->k_rpm_to_rad_s = 2.0f * 3.14159265f * poles / 60.0f;
+    smo->k_rad_s_to_rpm = 1.0f / smo->k_rpm_to_rad_s;
+    smo->k_theta = ts * ANGLE_FROM_RAD_K;
 
     // 速度范围：假设最大 ±10000 RPM
     // 转换为电角速度：ω_elec = RPM * 2π * poles / 60
     float max_rpm = 10000.0f;
-    float max_speed_rad_s = max_rpm * 2.0f * 3.14159265f * poles / 60.0f;
+    float max_speed_rad_s = max_rpm * smo->k_rpm_to_rad_s;
 
     pid_init(&smo->pll, kp, ki, -max_speed_rad_s, max_speed_rad_s);
 
@@ -55,17 +64,36 @@ void smo_init(smo_t *smo, float rs, float ls, float poles, float ts, float k_sli
     smo->z_alpha = 0.0f;
     smo->z_beta = 0.0f;
 
-    smo->theta_est = 0.0f;
-    smo->theta_comp = 0.0f;
+    smo->theta_est = 0;
+    smo->theta_comp = 0;
     smo->speed_est = 0.0f;
     smo->speed_est_filt = 0.0f;
 }
 
-void smo_estimate(smo_t *smo)
+void smo_init(smo_t *smo, float rs, float ls, float poles, float ts, float k_slide, float k_lpf, float boundary, float fc, float k_speed_lpf)
 {
-    // 中间变量计算
-    float F = 1.0f - smo->rs * smo->ts / smo->ls;
-    float G = smo->ts / smo->ls;
+    // PLL 参数
+    // 典型值：Kp = 2 * ζ * ωn, Ki = ωn^2
+    // ωn = 2π * fc
+    float wn = 2.0f * 3.14159265f * fc;
+    float zeta = 1.0f; // 阻尼系数
+    float kp = 2.0f * zeta * wn;
+    float ki = wn * wn * ts; // 注意：pid_calculate 内部不乘 ts，所以这里预乘
+
+    smo_setup(smo, rs, ls, poles, ts, k_slide, k_lpf, boundary, 1.0f - rs * ts / ls, ts / ls, kp, ki, k_speed_lpf);
+}
+
+void smo_init_profile(smo_t *smo, float k_slide, float k_lpf, float boundary, float k_speed_lpf)
+{
+    smo_setup(smo, MOTOR_RS, MOTOR_LS, MOTOR_POLE_PAIRS, MOTOR_TS, k_slide, k_lpf, boundary,
+              MOTOR_OBS_F, MOTOR_OBS_G, MOTOR_PLL_KP, MOTOR_PLL_KI, k_speed_lpf);
+}
+
+CCMRAM_FUNC void smo_estimate(smo_t *smo)
+{
+    // 离散电流模型系数 (初始化时算好)
+    float F = smo->f;
+    float G = smo->g;
 
     // 先更新 (k+1) 时刻电流估计值
     smo->i_alpha_est = F * smo->i_alpha_est + G * (smo->u_alpha - smo->e_alpha - smo->z_alpha);
@@ -76,8 +104,8 @@ void smo_estimate(smo_t *smo)
     float i_err_beta = smo->i_beta_est - smo->i_beta;
 
     // 计算滑模控制量
-    smo->z_alpha = smo->k_slide * smo_fun(i_err_alpha, smo->boundary);
-    smo->z_beta = smo->k_slide * smo_fun(i_err_beta, smo->boundary);
+    smo->z_alpha = smo->k_slide * smo_fun(i_err_alpha, smo->boundary, smo->inv_boundary);
+    smo->z_beta = smo->k_slide * smo_fun(i_err_beta, smo->boundary, smo->inv_boundary);
 
     // 低通滤波得到反电势估计
     smo->e_alpha = (1 - smo->k_lpf) * smo->e_alpha + smo->k_lpf * smo->z_alpha;
@@ -85,7 +113,7 @@ void smo_estimate(smo_t *smo)
 
     // 利用 PLL 估算角度和速度
     float sin_theta, cos_theta;
-    fast_sin_cos(smo->theta_est, &sin_theta, &cos_theta);
+    angle_sin_cos_pll(smo->theta_est, &sin_theta, &cos_theta);
 
     // PLL 误差计算
     // ΔE = -Êα × cos(θ̂e) - Êβ × sin(θ̂e)
@@ -95,32 +123,18 @@ void smo_estimate(smo_t *smo)
     float speed_rad_s = pid_calculate(&smo->pll, pll_err, 0.0f);
 
     // 转换为机械转速 RPM: ω_mech = ω_elec / poles
-    smo->speed_est = speed_rad_s * 60.0f / (2.0f * 3.14159265f * smo->poles);
+    smo->speed_est = speed_rad_s * smo->k_rad_s_to_rpm;
 
     // 对速度进行低通滤波
     smo->speed_est_filt = (1.0f - smo->k_speed_lpf) * smo->speed_est_filt + smo->k_speed_lpf * smo->speed_est;
 
-    // 积分速度得到角度（rad/s）
-    smo->theta_est += speed_rad_s * smo->ts;
-
-    // 角度归一化到 [0, 2π]
-    const float TWO_PI = 2.0f * 3.14159265f;
-    while (smo->theta_est >= TWO_PI)
-        smo->theta_est -= TWO_PI;
-    while (smo->theta_est < 0.0f)
-        smo->theta_est += TWO_PI;
-
-    // 计算低通滤波带来的相位滞后并进行补偿
-    float omega_e = smo->speed_est_filt * smo->poles * TWO_PI / 60.0f;
-    float delta_theta = atanf((omega_e * smo->ts * (1.0f - smo->k_lpf)) / smo->k_lpf);
+    // 积分速度得到角度 (整数角度溢出即回绕)
+    smo->theta_est += (angle_t)(int32_t)(speed_rad_s * smo->k_theta);
 
-    smo->theta_comp = smo->theta_est + delta_theta;
+    // 计算低通滤波带来的相位滞后 atan(ωe·k_lag) 并进行补偿 (|Δθ| < π/2, 多项式反正切直接得到整数角度)
+    float omega_e = smo->speed_est_filt * smo->k_rpm_to_rad_s;
 
-    // 补偿后的角度归一化
-    while (smo->theta_comp >= TWO_PI)
-        smo->theta_comp -= TWO_PI;
-    while (smo->theta_comp < 0.0f)
-        smo->theta_comp += TWO_PI;
+    smo->theta_comp = smo->theta_est + fast_atan_u32(omega_e * smo->k_lag);
 }
 
 float smo_get_bemf_alpha(smo_t *smo)
@@ -133,12 +147,12 @@ float smo_get_bemf_beta(smo_t *smo)
     return smo->e_beta;
 }
 
-float smo_get_angle(smo_t *smo)
+CCMRAM_FUNC angle_t smo_get_angle(smo_t *smo)
 {
     return smo->theta_comp;
 }
 
-float smo_get_speed_rpm(smo_t *smo)
+CCMRAM_FUNC float smo_get_speed_rpm(smo_t *smo)
 {
     return smo->speed_est_filt; // 返回滤波后的速度
 }
\ No newline at end of file
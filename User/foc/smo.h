@@ -3,6 +3,7 @@
 
 #include <math.h>
 #include "utils/fast_sin_cos.h"
+#include "utils/angle.h"
 #include "pid.h"
 
 // 滑模观测器结构体
@@ -20,6 +21,15 @@ typedef struct
     float ts;    // 控制周期 (s)
     float poles; // 电机极对数
 
+    // --- 初始化时预先算好的系数 (观测中只做乘法) ---
+    float f;              // 1 - rs·ts/ls
+    float g;              // ts/ls
+    float inv_boundary;   // 1 / boundary
+    float k_lag;          // ts·(1 - k_lpf) / k_lpf, 低通相位滞后补偿
+    float k_rad_s_to_rpm; // 电角速度 (rad/s) -> 机械转速 (RPM)
+    float k_rpm_to_rad_s; // 机械转速 (RPM) -> 电角速度 (rad/s)
+    float k_theta;        // 电角速度 (rad/s) -> 每周期整数角增量
+
     // --- 可调参数 ---
     float k_slide;  // 滑模增益 (Gain)
     float k_lpf;    // 低通滤波器系数 (0.0 ~ 1.0)
@@ -34,8 +44,8 @@ typedef struct
     float z_beta;
 
     // 观测角度和速度
-    float theta_est;       // 估算角度 (rad)
-    float theta_comp;      // 补偿后的角度 (rad)
+    angle_t theta_est;     // 估算角度 (2^32 = 2π)
+    angle_t theta_comp;    // 补偿后的角度 (2^32 = 2π)
     float speed_est;       // 估算速度 (rpm)
     float speed_est_filt;  // 滤波后的速度 (rpm)
     float k_speed_lpf;     // 速度低通滤波系数 (0.0 ~ 1.0)
@@ -47,13 +57,16 @@ typedef struct
 
 void smo_init(smo_t *smo, float rs, float ls, float poles, float ts, float k_slide, float k_lpf, float boundary, float fc, float k_speed_lpf);
 
+/* 按当前电机配置 (motor_profile.h) 初始化: 电机参数、控制周期、离散模型 F / G 与 PLL 增益取生成的常量 */
+void smo_init_profile(smo_t *smo, float k_slide, float k_lpf, float boundary, float k_speed_lpf);
+
 void smo_estimate(smo_t *smo);
 
 float smo_get_bemf_alpha(smo_t *smo);
 
 float smo_get_bemf_beta(smo_t *smo);
 
-float smo_get_angle(smo_t *smo);
+angle_t smo_get_angle(smo_t *smo);
 
 float smo_get_speed_rpm(smo_t *smo);
 
@@ -0,0 +1,132 @@
+#include "smo_q15.h"
+
+#define SMO_Q15_TWO_PI 6.28318530718f
+
+// 滑模控制率 - 饱和函数 (Q27), 边界层内线性过渡
+static int32_t smo_q15_fun(int32_t error, int32_t inv_boundary)
+{
+    int32_t r = qgain_mul(error, inv_boundary);
+
+    if (r > Q27_ONE)
+        return Q27_ONE;
+    else if (r < -Q27_ONE)
+        return -Q27_ONE;
+    else
+        return r;
+}
+
+void smo_q15_init(smo_q15_t *smo, float rs, float ls, float poles, float ts, float k_slide, float k_lpf, float boundary, float fc, float k_speed_lpf)
+{
+    // 电流方程系数, 电流以 I_BASE, 电压以 U_BASE 为基准
+    smo->f = QGAIN(1.0f - rs * ts / ls);
+    smo->g = QGAIN(ts / ls * FOC_Q15_U_BASE / FOC_Q15_I_BASE);
+
+    // 可调参数
+    smo->k_slide = QGAIN(k_slide / FOC_Q15_U_BASE);
+    smo->inv_boundary = QGAIN(FOC_Q15_I_BASE / boundary);
+    smo->k_lpf = QGAIN(k_lpf);
+    smo->k_speed_lpf = QGAIN(k_speed_lpf);
+
+    // 角度积分: Δθ = ω * ts, 折算为 32 位角度
+    smo->k_theta = QGAIN(FOC_Q15_W_BASE * ts / SMO_Q15_TWO_PI * 131072.0f);
+
+    // 相位补偿: tan(Δθ) = ω * ts * (1 - k_lpf) / k_lpf
+    smo->k_comp = QGAIN(FOC_Q15_W_BASE * ts * (1.0f - k_lpf) / k_lpf);
+
+    // PLL 参数与浮点版相同, 折算为标幺增益 (输入电压, 输出电角速度)
+    float wn = 2.0f * 3.14159265f * fc;
+    float zeta = 1.0f; // 阻尼系数
+    float kp = 2.0f * zeta * wn;
+    float ki = wn * wn * ts;
+
+    // 速度范围：最大 ±10000 RPM
+    float max_rpm = 10000.0f;
+    float max_speed_rad_s = max_rpm * 2.0f * 3.14159265f * poles / 60.0f;
+    q15_t max_speed = FOC_Q15_SPEED(max_speed_rad_s);
+
+    pid_q15_init(&smo->pll, PID_Q15_GAIN(kp, FOC_Q15_U_BASE, FOC_Q15_W_BASE),
+                 PID_Q15_GAIN(ki, FOC_Q15_U_BASE, FOC_Q15_W_BASE), (q15_t)-max_speed, max_speed);
+
+    // 初始化状态
+    smo->i_alpha = 0;
+    smo->i_beta = 0;
+    smo->u_alpha = 0;
+    smo->u_beta = 0;
+
+    smo->i_alpha_est = 0;
+    smo->i_beta_est = 0;
+    smo->e_alpha = 0;
+    smo->e_beta = 0;
+    smo->z_alpha = 0;
+    smo->z_beta = 0;
+
+    smo->theta_est = 0;
+    smo->theta_comp = 0;
+    smo->speed_est = 0;
+    smo->speed_est_filt = 0;
+}
+
+void smo_q15_estimate(smo_q15_t *smo)
+{
+    // 先更新 (k+1) 时刻电流估计值
+    smo->i_alpha_est = qgain_mul(smo->i_alpha_est, smo->f) +
+                       qgain_mul(q27_from_q15(smo->u_alpha) - smo->e_alpha - smo->z_alpha, smo->g);
+    smo->i_beta_est = qgain_mul(smo->i_beta_est, smo->f) +
+                      qgain_mul(q27_from_q15(smo->u_beta) - smo->e_beta - smo->z_beta, smo->g);
+
+    // 用最新的估计值计算误差
+    int32_t i_err_alpha = smo->i_alpha_est - q27_from_q15(smo->i_alpha);
+    int32_t i_err_beta = smo->i_beta_est - q27_from_q15(smo->i_beta);
+
+    // 计算滑模控制量
+    smo->z_alpha = qgain_mul(smo_q15_fun(i_err_alpha, smo->inv_boundary), smo->k_slide);
+    smo->z_beta = qgain_mul(smo_q15_fun(i_err_beta, smo->inv_boundary), smo->k_slide);
+
+    // 低通滤波得到反电势估计
+    smo->e_alpha += qgain_mul(smo->z_alpha - smo->e_alpha, smo->k_lpf);
+    smo->e_beta += qgain_mul(smo->z_beta - smo->e_beta, smo->k_lpf);
+
+    // 利用 PLL 估算角度和速度
+    q15_t sin_theta, cos_theta;
+    qmath_sin_cos((uint16_t)(smo->theta_est >> 16), &sin_theta, &cos_theta);
+
+    // PLL 误差计算
+    // ΔE = -Êα × cos(θ̂e) - Êβ × sin(θ̂e)
+    int64_t pll_err = -((int64_t)smo->e_alpha * cos_theta + (int64_t)smo->e_beta * sin_theta);
+    q15_t pll_err_q15 = q15_sat((int32_t)(pll_err >> (15 + Q27_SHIFT)));
+
+    // 使用 PI 控制器调节速度
+    smo->speed_est = pid_q15_calculate(&smo->pll, pll_err_q15, 0);
+
+    // 对速度进行低通滤波
+    smo->speed_est_filt += qgain_mul(q27_from_q15(smo->speed_est) - smo->speed_est_filt, smo->k_speed_lpf);
+
+    // 积分速度得到角度, 32 位角度溢出即完成归一化
+    smo->theta_est += (uint32_t)qgain_mul(smo->speed_est, smo->k_theta);
+
+    // 计算低通滤波带来的相位滞后并进行补偿
+    int32_t tan_delta = qgain_mul(q15_from_q27(smo->speed_est_filt), smo->k_comp);
+    uint16_t delta_theta = qmath_atan2(tan_delta, 32768);
+
+    smo->theta_comp = (uint16_t)((smo->theta_est >> 16) + delta_theta);
+}
+
+q15_t smo_q15_get_bemf_alpha(smo_q15_t *smo)
+{
+    return q15_from_q27(smo->e_alpha);
+}
+
+q15_t smo_q15_get_bemf_beta(smo_q15_t *smo)
+{
+    return q15_from_q27(smo->e_beta);
+}
+
+uint16_t smo_q15_get_angle(smo_q15_t *smo)
+{
+    return smo->theta_comp;
+}
+
+q15_t smo_q15_get_speed(smo_q15_t *smo)
+{
+    return q15_from_q27(smo->speed_est_filt); // 返回滤波后的速度
+}
@@ -0,0 +1,58 @@
+#ifndef __SMO_Q15_H__
+#define __SMO_Q15_H__
+
+#include "clark_park_q15.h"
+#include "pid_q15.h"
+
+// 滑模观测器结构体 (定点)
+typedef struct
+{
+    // --- 输入 (Q15 标幺值) ---
+    q15_t i_alpha; // 实测电流 alpha
+    q15_t i_beta;  // 实测电流 beta
+    q15_t u_alpha; // 以此计算出的电压 alpha
+    q15_t u_beta;  // 以此计算出的电压 beta
+
+    // --- 预计算系数 (s15.16) ---
+    int32_t f;            // 1 - rs*ts/ls
+    int32_t g;            // ts/ls, 已折算电压/电流基准
+    int32_t k_slide;      // 滑模增益 (标幺)
+    int32_t inv_boundary; // 1/边界层厚度 (标幺)
+    int32_t k_lpf;        // 低通滤波器系数
+    int32_t k_speed_lpf;  // 速度低通滤波系数
+    int32_t k_theta;      // 速度 (Q15) -> 每周期角度增量 (2^32 = 2π)
+    int32_t k_comp;       // 速度 (Q15) -> 相位补偿 tan 值 (Q15)
+
+    // 观测状态 (Q27)
+    int32_t i_alpha_est; // 估算电流 alpha
+    int32_t i_beta_est;  // 估算电流 beta
+    int32_t e_alpha;     // 滤波后的反电动势 alpha
+    int32_t e_beta;      // 滤波后的反电动势 beta
+    int32_t z_alpha;     // 滑模控制量 (Raw BEMF)
+    int32_t z_beta;
+
+    // 观测角度和速度
+    uint32_t theta_est;     // 估算角度 (2^32 = 2π)
+    uint16_t theta_comp;    // 补偿后的角度 (65536 = 2π)
+    q15_t speed_est;        // 估算电角速度 (Q15)
+    int32_t speed_est_filt; // 滤波后的电角速度 (Q27)
+
+    // PLL 使用 PI 控制器
+    pid_q15_t pll;
+
+} smo_q15_t;
+
+/* 参数含义与 smo_init() 相同 (物理单位), 初始化时折算为标幺系数 */
+void smo_q15_init(smo_q15_t *smo, float rs, float ls, float poles, float ts, float k_slide, float k_lpf, float boundary, float fc, float k_speed_lpf);
+
+void smo_q15_estimate(smo_q15_t *smo);
+
+q15_t smo_q15_get_bemf_alpha(smo_q15_t *smo);
+
+q15_t smo_q15_get_bemf_beta(smo_q15_t *smo);
+
+uint16_t smo_q15_get_angle(smo_q15_t *smo);
+
+q15_t smo_q15_get_speed(smo_q15_t *smo); // 滤波后的电角速度 (Q15)
+
+#endif /* __SMO_Q15_H__ */
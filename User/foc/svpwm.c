@@ -1,12 +1,14 @@
 #include "svpwm.h"
+#include "utils/ccmram.h"
 
 /**
  * @brief  标准七段式SVPWM (扇区法)
  * @param  u_alphabeta - αβ轴电压 (V)
+ * @param  inv_udc     - 1 / 母线电压, 用乘法代替对母线电压的除法
  * @retval duty - 输出的三相占空比 (范围 0.0 ~ 1.0)
  * @note   占空比围绕0.25中心分布，与min-max注入法输出一致
  */
-abc_t svpwm_sector1(alphabeta_t u_alphabeta)
+abc_t svpwm_sector1(alphabeta_t u_alphabeta, float inv_udc)
 {
     abc_t duty;
     int N;
@@ -58,8 +60,8 @@ abc_t svpwm_sector1(alphabeta_t u_alphabeta)
     }
 
     /* 归一化时间 */
-    t1 = t1 * 1.732051f / U_DC;
-    t2 = t2 * 1.732051f / U_DC;
+    t1 = t1 * (1.732051f * inv_udc);
+    t2 = t2 * (1.732051f * inv_udc);
 
     /* 过调制处理 */
     if ((t1 + t2) > 1.0f)
@@ -112,22 +114,11 @@ abc_t svpwm_sector1(alphabeta_t u_alphabeta)
     return duty;
 }
 
-/**
- * @brief  标准SVPWM调制函数
- * @param  u_alphabeta - αβ轴电压 (V)
- * @retval duty - 输出的三相占空比 (范围 0.0 ~ 1.0)
- * @note   参考《现代永磁同步电机控制原理及MATLAB仿真》 2.4.2节
- */
-abc_t svpwm_sector2(alphabeta_t u_alphabeta)
+/* 扇区判断, 返回扇区 1 ~ 6 (零矢量返回 0) */
+static inline int32_t svpwm_sector_of(float v_alpha, float v_beta)
 {
-    abc_t duty;
     int32_t N = 0, sector = 0;
-    float Tx = 0.0f, Ty = 0.0f;
 
-    float v_alpha = u_alphabeta.alpha;
-    float v_beta = u_alphabeta.beta;
-
-    /* 扇区判断 */
     if (v_beta > 0.0f)
         N = 1;
     if ((1.732051f * v_alpha - v_beta) > 0.0f)
@@ -156,11 +147,18 @@ abc_t svpwm_sector2(alphabeta_t u_alphabeta)
         sector = 6;
         break;
     }
+    return sector;
+}
+
+/* 扇区内两个相邻基本矢量的归一化作用时间: Tx 对应扇区起始边的矢量, Ty 对应结束边的矢量 */
+static inline void svpwm_vector_times(int32_t sector, float v_alpha, float v_beta, float inv_udc, float *tx, float *ty)
+{
+    float Tx = 0.0f, Ty = 0.0f;
 
     /* 预计算公共项 */
-    float X = 1.732051f * v_beta / U_DC;
-    float Y = (1.5f * v_alpha - 0.866025f * v_beta) / U_DC;
-    float Z = (-1.5f * v_alpha - 0.866025f * v_beta) / U_DC;
+    float X = (1.732051f * inv_udc) * v_beta;
+    float Y = (1.5f * inv_udc) * v_alpha - (0.866025f * inv_udc) * v_beta;
+    float Z = -(1.5f * inv_udc) * v_alpha - (0.866025f * inv_udc) * v_beta;
 
     /* 计算矢量作用时间 (复用预计算项) */
     switch (sector)
@@ -191,13 +189,14 @@ abc_t svpwm_sector2(alphabeta_t u_alphabeta)
         break;
     }
 
-    /* 过调制处理 */
-    if ((Tx + Ty) > 1.0f)
-    {
-        float k = 1.0f / (Tx + Ty);
-        Tx *= k;
-        Ty *= k;
-    }
+    *tx = Tx;
+    *ty = Ty;
+}
+
+/* 由作用时间分配三相占空比 (零矢量时间两端平分, 中心对称) */
+static inline abc_t svpwm_sector_duty(int32_t sector, float Tx, float Ty)
+{
+    abc_t duty;
 
     /* 计算零矢量时间的一半 */
     float t0_half = (1.0f - Tx - Ty) * 0.5f;
@@ -243,16 +242,42 @@ abc_t svpwm_sector2(alphabeta_t u_alphabeta)
     return duty;
 }
 
+/**
+ * @brief  标准SVPWM调制函数
+ * @param  u_alphabeta - αβ轴电压 (V)
+ * @param  inv_udc     - 1 / 母线电压
+ * @retval duty - 输出的三相占空比 (范围 0.0 ~ 1.0)
+ * @note   参考《现代永磁同步电机控制原理及MATLAB仿真》 2.4.2节
+ */
+CCMRAM_FUNC abc_t svpwm_sector2(alphabeta_t u_alphabeta, float inv_udc)
+{
+    float Tx, Ty;
+
+    int32_t sector = svpwm_sector_of(u_alphabeta.alpha, u_alphabeta.beta);
+    svpwm_vector_times(sector, u_alphabeta.alpha, u_alphabeta.beta, inv_udc, &Tx, &Ty);
+
+    /* 过调制处理 (等比缩小到六边形边界, 调制器使能过调制时先经 svpwm_overmod 补偿基波) */
+    if ((Tx + Ty) > 1.0f)
+    {
+        float k = 1.0f / (Tx + Ty);
+        Tx *= k;
+        Ty *= k;
+    }
+
+    return svpwm_sector_duty(sector, Tx, Ty);
+}
+
 /**
  * @brief  SVPWM调制函数 (min-max零序注入法)
  * @param  u_alphabeta - αβ轴电压 (V)
+ * @param  inv_udc     - 1 / 母线电压
  * @retval duty - 输出的三相占空比 (范围 0.0 ~ 1.0)
  */
-abc_t svpwm_minmax(alphabeta_t u_alphabeta)
+abc_t svpwm_minmax(alphabeta_t u_alphabeta, float inv_udc)
 {
     abc_t duty;
     float u_max, u_min, u_zero;
-    float inv_half_udc = 1.0f / (U_DC * 0.5f);
+    float inv_half_udc = 2.0f * inv_udc;
 
     /* 反Clark变换: αβ -> abc */
     abc_t u_abc = iclark_transform(u_alphabeta);
@@ -290,8 +315,293 @@ abc_t svpwm_minmax(alphabeta_t u_alphabeta)
     return duty;
 }
 
-/* 默认使用扇区法 */
+/**
+ * @brief  不连续调制 (零序注入, 一相钳位到母线正端或负端)
+ * @param  u_alphabeta - αβ轴电压 (V)
+ * @param  inv_udc     - 1 / 母线电压
+ * @param  mode        - 钳位方式
+ * @retval duty - 输出的三相占空比 (范围 0.0 ~ 1.0)
+ * @note   线电压与扇区法相同; 过调制时与扇区法一样按 (Tx + Ty) 等比缩小
+ */
+CCMRAM_FUNC abc_t svpwm_dpwm(alphabeta_t u_alphabeta, float inv_udc, svpwm_mode_t mode)
+{
+    abc_t duty;
+
+    /* 反Clark变换并归一化: 相电压 / Udc */
+    float xa = u_alphabeta.alpha * inv_udc;
+    float xb = (-0.5f * u_alphabeta.alpha + 0.866025f * u_alphabeta.beta) * inv_udc;
+    float xc = -xa - xb;
+
+    float x_max = (xa > xb) ? ((xa > xc) ? xa : xc) : ((xb > xc) ? xb : xc);
+    float x_min = (xa < xb) ? ((xa < xc) ? xa : xc) : ((xb < xc) ? xb : xc);
+
+    /* 过调制处理: 最大线电压 (= Tx + Ty) 超过母线时等比缩小 */
+    float span = x_max - x_min;
+    if (span > 1.0f)
+    {
+        float k = 1.0f / span;
+        xa *= k;
+        xb *= k;
+        xc *= k;
+        x_max *= k;
+        x_min *= k;
+    }
+
+    /*
+     * 钳位到正端还是负端:
+     * DPWM1 钳位绝对值最大的一相; DPWM0 / DPWM2 用超前 / 滞后 30° 的矢量判断,
+     * 超前 30° 的三相电压与线电压 (uab, ubc, uca) 成正比, 滞后 30° 的与其相反数成正比,
+     * 三个量之和为零, max + min = -mid, 只需看线电压中间值的符号。
+     * 无论判断结果如何, 钳位的都是实际电压最高 (正端) 或最低 (负端) 的一相, 其余两相不会越界。
+     */
+    uint8_t clamp_top;
+    switch (mode)
+    {
+    case SVPWM_MODE_DPWMMAX:
+        clamp_top = 1;
+        break;
+    case SVPWM_MODE_DPWMMIN:
+        clamp_top = 0;
+        break;
+    case SVPWM_MODE_DPWM0:
+    case SVPWM_MODE_DPWM2:
+    {
+        float l_ab = xa - xb;
+        float l_bc = xb - xc;
+        float l_ca = xc - xa;
+        float l_max = (l_ab > l_bc) ? ((l_ab > l_ca) ? l_ab : l_ca) : ((l_bc > l_ca) ? l_bc : l_ca);
+        float l_min = (l_ab < l_bc) ? ((l_ab < l_ca) ? l_ab : l_ca) : ((l_bc < l_ca) ? l_bc : l_ca);
+        float l_mid = -(l_max + l_min);
+        clamp_top = (mode == SVPWM_MODE_DPWM0) ? (l_mid <= 0.0f) : (l_mid >= 0.0f);
+        break;
+    }
+    default: /* DPWM1 */
+        clamp_top = (x_max + x_min >= 0.0f);
+        break;
+    }
+
+    /* 注入零序分量: 钳位相 1 - (x_max - x_max) / x_min - x_min 恰好为 1 或 0 */
+    if (clamp_top)
+    {
+        duty.a = 1.0f - (x_max - xa);
+        duty.b = 1.0f - (x_max - xb);
+        duty.c = 1.0f - (x_max - xc);
+    }
+    else
+    {
+        duty.a = xa - x_min;
+        duty.b = xb - x_min;
+        duty.c = xc - x_min;
+    }
+
+    /* 占空比限幅 (过调制缩放后的舍入误差) */
+    duty.a = (duty.a > 1.0f) ? 1.0f : ((duty.a < 0.0f) ? 0.0f : duty.a);
+    duty.b = (duty.b > 1.0f) ? 1.0f : ((duty.b < 0.0f) ? 0.0f : duty.b);
+    duty.c = (duty.c > 1.0f) ? 1.0f : ((duty.c < 0.0f) ? 0.0f : duty.c);
+
+    return duty;
+}
+
+/*
+ * 过调制补偿表, 按基波数值求解 (见 svpwm.h):
+ * 区域 I  m = 1 + (SVPWM_M_OM2 - 1)·i/16 时参考矢量的放大倍数 g
+ * 区域 II m = SVPWM_M_OM2 + (SVPWM_M_SIX_STEP - SVPWM_M_OM2)·i/16 时每条边两端的顶点停留比例 h
+ */
+#define SVPWM_OM_LUT_N 16
+static const float svpwm_om1_gain[SVPWM_OM_LUT_N + 1] = {
+    1.000000f, 1.000360f, 1.001102f, 1.002162f, 1.003537f, 1.005241f, 1.007300f, 1.009751f, 1.012649f,
+    1.016068f, 1.020111f, 1.024931f, 1.030766f, 1.038015f, 1.047467f, 1.061161f, 1.100644f};
+static const float svpwm_om2_hold[SVPWM_OM_LUT_N + 1] = {
+    0.000000f, 0.017950f, 0.036284f, 0.055055f, 0.074324f, 0.094171f, 0.114690f, 0.136000f, 0.158257f,
+    0.181665f, 0.206508f, 0.233193f, 0.262349f, 0.295039f, 0.333339f, 0.382637f, 0.500000f};
+
+/* 查表线性插值, x 为表内位置 (0 ~ SVPWM_OM_LUT_N) */
+static inline float svpwm_om_lut(const float *table, float x)
+{
+    int32_t i = (int32_t)x;
+    if (i >= SVPWM_OM_LUT_N)
+        i = SVPWM_OM_LUT_N - 1;
+    float f = x - (float)i;
+    return table[i] + (table[i + 1] - table[i]) * f;
+}
+
+/**
+ * @brief  过调制区域 II: 矢量在六边形边上运动, 顶点附近停留
+ * @param  u_alphabeta - αβ轴电压 (V), 幅值超过 SVPWM_M_OM2
+ * @param  inv_udc     - 1 / 母线电压
+ * @param  m           - 调制比
+ * @retval duty - 三相占空比 (零矢量时间为零, 各调制方式结果相同)
+ */
+CCMRAM_FUNC static abc_t svpwm_overmod_edge(alphabeta_t u_alphabeta, float inv_udc, float m)
+{
+    float Tx, Ty;
+    float hold = (m >= SVPWM_M_SIX_STEP)
+                     ? 0.5f
+                     : svpwm_om_lut(svpwm_om2_hold, (m - SVPWM_M_OM2) * (SVPWM_OM_LUT_N / (SVPWM_M_SIX_STEP - SVPWM_M_OM2)));
+
+    int32_t sector = svpwm_sector_of(u_alphabeta.alpha, u_alphabeta.beta);
+    svpwm_vector_times(sector, u_alphabeta.alpha, u_alphabeta.beta, inv_udc, &Tx, &Ty);
+
+    /* 参考矢量方向与六边形边的交点: 距扇区起始顶点 t (0 ~ 1) */
+    float t = Ty / (Tx + Ty);
+
+    /* 两端各停留 hold, 中间按 (t - hold) / (1 - 2·hold) 沿边走完; hold = 0.5 时只取最近的顶点 (六拍) */
+    float t_out;
+    if (hold >= 0.5f)
+    {
+        t_out = (t < 0.5f) ? 0.0f : 1.0f;
+    }
+    else
+    {
+        t_out = (t - hold) / (1.0f - 2.0f * hold);
+        t_out = (t_out > 1.0f) ? 1.0f : ((t_out < 0.0f) ? 0.0f : t_out);
+    }
+
+    return svpwm_sector_duty(sector, 1.0f - t_out, t_out);
+}
+
+void svpwm_modulator_init(svpwm_modulator_t *mod, svpwm_mode_t mode)
+{
+    mod->mode = (mode < SVPWM_MODE_NUM) ? mode : SVPWM_MODE_SVPWM;
+    mod->dpwm_active = 0;
+    mod->overmod = 0;
+    mod->om_region = 0;
+    mod->sector = 0;
+}
+
+CCMRAM_FUNC abc_t svpwm_modulate(svpwm_modulator_t *mod, alphabeta_t u_alphabeta, float inv_udc)
+{
+    svpwm_mode_t mode = mod->mode;
+
+    /* 过调制区域 I 的放大与等比缩小都不改变矢量方向, 扇区按指令矢量判断 */
+    mod->sector = (uint8_t)svpwm_sector_of(u_alphabeta.alpha, u_alphabeta.beta);
+
+    if (mode == SVPWM_MODE_HYBRID || mod->overmod)
+    {
+        /* 调制比平方 m² = |u|²·3 / Udc², 与阈值平方比较, 只有进入过调制时才开方 */
+        float k = 1.732051f * inv_udc;
+        float m2 = (u_alphabeta.alpha * u_alphabeta.alpha + u_alphabeta.beta * u_alphabeta.beta) * (k * k);
+
+        if (mode == SVPWM_MODE_HYBRID)
+        {
+            if (m2 > SVPWM_HYBRID_M_ON * SVPWM_HYBRID_M_ON)
+                mod->dpwm_active = 1;
+            else if (m2 < SVPWM_HYBRID_M_OFF * SVPWM_HYBRID_M_OFF)
+                mod->dpwm_active = 0;
+
+            mode = mod->dpwm_active ? SVPWM_HYBRID_DPWM : SVPWM_MODE_SVPWM;
+        }
+
+        mod->om_region = 0;
+        if (mod->overmod && m2 > 1.0f)
+        {
+            float m = sqrtf(m2);
+            if (m > SVPWM_M_OM2)
+            {
+                mod->om_region = 2;
+                return svpwm_overmod_edge(u_alphabeta, inv_udc, m);
+            }
+
+            /* 区域 I: 放大后由下面的调制按原角度截到六边形边界 */
+            float g = svpwm_om_lut(svpwm_om1_gain, (m - 1.0f) * (SVPWM_OM_LUT_N / (SVPWM_M_OM2 - 1.0f)));
+            u_alphabeta.alpha *= g;
+            u_alphabeta.beta *= g;
+            mod->om_region = 1;
+        }
+    }
+
+    if (mode == SVPWM_MODE_SVPWM)
+        return svpwm_sector2(u_alphabeta, inv_udc);
+
+    return svpwm_dpwm(u_alphabeta, inv_udc, mode);
+}
+
+/* 默认使用扇区法, 按额定母线电压归一化 */
 abc_t svpwm_update(alphabeta_t u_alphabeta)
 {
-    return svpwm_sector2(u_alphabeta);
+    return svpwm_sector2(u_alphabeta, SVPWM_INV_UDC);
+}
+
+/* 默认使用扇区法, 按实测母线电压归一化 */
+CCMRAM_FUNC abc_t svpwm_update_udc(alphabeta_t u_alphabeta, float inv_udc)
+{
+    return svpwm_sector2(u_alphabeta, inv_udc);
+}
+
+/* 移相量限幅: 前后半周期的占空比 d ∓ shift 都在 [0, 1] 内, 不足时返回 0 */
+static inline uint8_t svpwm_shift_limit(float duty, float *shift)
+{
+    float limit = (duty < 1.0f - duty) ? duty : 1.0f - duty;
+    if (limit < 0.0f)
+        limit = 0.0f; /* 过调制输出可能略超出 [0, 1] */
+    if (*shift > limit)
+    {
+        *shift = limit;
+        return 0;
+    }
+    return 1;
+}
+
+CCMRAM_FUNC void svpwm_single_shunt(svpwm_single_shunt_t *ss, float duty_a, float duty_b, float duty_c, float t_min,
+                                    float t_sample)
+{
+    float d[3] = {duty_a, duty_b, duty_c};
+    uint8_t hi, mid, lo;
+
+    /* 占空比从高到低的顺序即电压矢量所在扇区 (各调制方式只改变零序分量, 顺序不变) */
+    if (d[0] >= d[1])
+    {
+        hi = 0;
+        lo = 1;
+    }
+    else
+    {
+        hi = 1;
+        lo = 0;
+    }
+    if (d[2] > d[hi])
+    {
+        mid = hi;
+        hi = 2;
+    }
+    else if (d[2] < d[lo])
+    {
+        mid = lo;
+        lo = 2;
+    }
+    else
+    {
+        mid = 2;
+    }
+
+    for (int i = 0; i < 3; i++)
+    {
+        ss->duty_up[i] = d[i];
+        ss->duty_down[i] = d[i];
+    }
+    ss->valid = 1;
+
+    /* 窗口 1 [d_lo, d_mid] (i_dc = -i_lo): 最低相在采样半周期提前关断 */
+    float shift = t_min - (d[mid] - d[lo]);
+    if (shift > 0.0f)
+    {
+        ss->valid &= svpwm_shift_limit(d[lo], &shift);
+        ss->duty_down[lo] = d[lo] - shift;
+        ss->duty_up[lo] = d[lo] + shift;
+    }
+
+    /* 窗口 2 [d_mid, d_hi] (i_dc = +i_hi): 最高相在采样半周期推迟关断 */
+    shift = t_min - (d[hi] - d[mid]);
+    if (shift > 0.0f)
+    {
+        ss->valid &= svpwm_shift_limit(d[hi], &shift);
+        ss->duty_down[hi] = d[hi] + shift;
+        ss->duty_up[hi] = d[hi] - shift;
+    }
+
+    /* 采样点放在窗口结束前, 开关振荡已衰减, 采样保持在下一次翻转之前完成 */
+    ss->sample[0] = d[mid] - t_sample;
+    ss->sample[1] = ss->duty_down[hi] - t_sample;
+    ss->phase[0] = lo;
+    ss->phase[1] = hi;
 }
@@ -4,14 +4,179 @@
 #include "clark_park.h"
 #include "./utils/fast_sin_cos.h"
 
-/* 直流母线电压 (V) */
+/* 额定直流母线电压 (V), 运行时的实测值见 bus_voltage.h */
 #define U_DC 12.0f
 
+/* 额定母线电压下的归一化系数 */
+#define SVPWM_INV_UDC (1.0f / U_DC)
+
 /**
- * @brief  SVPWM调制函数
+ * @brief  SVPWM调制函数 (按额定母线电压 U_DC 归一化)
  * @param  u_alphabeta - αβ轴电压 (V)
  * @return duty - 输出的三相占空比 (范围 0.0 ~ 1.0)
  */
 abc_t svpwm_update(alphabeta_t u_alphabeta);
 
+/**
+ * @brief  SVPWM调制函数 (按实测母线电压归一化)
+ * @param  u_alphabeta - αβ轴电压 (V)
+ * @param  inv_udc     - 1 / 母线电压, 每个控制周期计算一次 (bus_voltage_update)
+ * @return duty - 输出的三相占空比 (范围 0.0 ~ 1.0)
+ */
+abc_t svpwm_update_udc(alphabeta_t u_alphabeta, float inv_udc);
+
+/* 各调制实现 (svpwm_update 默认使用 svpwm_sector2), inv_udc = 1 / 母线电压 */
+abc_t svpwm_sector1(alphabeta_t u_alphabeta, float inv_udc);
+abc_t svpwm_sector2(alphabeta_t u_alphabeta, float inv_udc);
+abc_t svpwm_minmax(alphabeta_t u_alphabeta, float inv_udc);
+
+/**
+ * 不连续调制 (DPWM)
+ *
+ * 与 min-max 注入相同, 只改变零序分量, 线电压 (基波) 与 SVPWM 完全相同; 区别是每个时刻把一相钳位到母线正端或负端,
+ * 该相整个 PWM 周期不开关, 开关次数减少 1/3。各方式的钳位区间 (以 A 相为例, θ 为电压矢量角, A 相电压峰值在 0°):
+ *   DPWM0   每 60° 钳位一次, A 相正端钳位区间 [-60°, 0°] (超前电压峰值 30°, 适合电流超前的场合)
+ *   DPWM1   每 60° 钳位一次, 区间 [-30°, 30°] 以电压峰值为中心 (电流与电压同相时开关损耗最小)
+ *   DPWM2   每 60° 钳位一次, 区间 [0°, 60°] (滞后电压峰值 30°, 适合感性负载电流滞后的场合)
+ *   DPWMMAX 电压最高的一相始终钳位到正端 (每相连续 120°)
+ *   DPWMMIN 电压最低的一相始终钳位到负端 (每相连续 120°)
+ * 混合方式在调制比低时用 SVPWM (低压时电流纹波小), 高于 SVPWM_HYBRID_M_ON 时切换到 SVPWM_HYBRID_DPWM,
+ * 低于 SVPWM_HYBRID_M_OFF 时切回, 两个阈值之间保持原方式, 避免调制比在阈值附近时来回切换。
+ *
+ * 占空比由 TIM1 比较值预装载, 只在更新事件 (谷底, 同时触发 ADC 注入组) 生效, 方式切换与钳位相的变化
+ * 都发生在采样时刻, 不会在一个 PWM 周期中间改变开关状态。
+ */
+
+/* 混合方式: 切换到 DPWM / 切回 SVPWM 的调制比 (|u|·√3 / Udc, 线性区上限为 1) 与使用的 DPWM 方式 */
+#ifndef SVPWM_HYBRID_M_ON
+#define SVPWM_HYBRID_M_ON 0.6f
+#endif
+#ifndef SVPWM_HYBRID_M_OFF
+#define SVPWM_HYBRID_M_OFF 0.5f
+#endif
+#ifndef SVPWM_HYBRID_DPWM
+#define SVPWM_HYBRID_DPWM SVPWM_MODE_DPWM1
+#endif
+
+/* 调制方式 */
+typedef enum
+{
+    SVPWM_MODE_SVPWM = 0, /* 七段式 SVPWM (svpwm_sector2) */
+    SVPWM_MODE_DPWM0,     /* 钳位区间超前 30° */
+    SVPWM_MODE_DPWM1,     /* 钳位区间以电压峰值为中心 */
+    SVPWM_MODE_DPWM2,     /* 钳位区间滞后 30° */
+    SVPWM_MODE_DPWMMAX,   /* 最高相钳位到正端 */
+    SVPWM_MODE_DPWMMIN,   /* 最低相钳位到负端 */
+    SVPWM_MODE_HYBRID,    /* 低调制比 SVPWM, 高调制比 DPWM */
+    SVPWM_MODE_NUM
+} svpwm_mode_t;
+
+/**
+ * 过调制 (调制器 overmod 使能时)
+ *
+ * 调制比 m = |u|·√3 / Udc: 线性区 m ≤ 1, 六拍 (方波) 的基波 m = 2√3/π ≈ 1.1027, 比线性区上限高约 10%。
+ * 不使能时超出六边形的矢量按原角度等比缩到六边形边界, 输出基波比指令小, 可用电压止于线性区。
+ *   区域 I  (1 < m ≤ SVPWM_M_OM2): 参考矢量放大 g(m) 倍后按原角度截到六边形边界, 圆弧段多出的基波
+ *           补偿边界段损失的基波, 输出基波幅值等于指令
+ *   区域 II (SVPWM_M_OM2 < m ≤ SVPWM_M_SIX_STEP): 矢量只在六边形边上运动, 在顶点停留 (每条边两端各占比例 h(m)),
+ *           其余部分沿边加速走完, h = 0.5 时即六拍
+ * g(m) 与 h(m) 由轨迹基波分量离线数值求解后制成 17 点表, 线性插值, 基波误差 < 0.1%。
+ * 过调制时零矢量时间为零, 相电压含 5、7、11、13 ... 次谐波 (电流环看到 6 倍电频率的纹波);
+ * 下桥电阻采样的窗口也随之消失, 需要配合按占空比选择的两相电流重构。
+ */
+#define SVPWM_M_OM2 1.0490975f      /* 区域 I / II 分界: 输出轨迹恰好为六边形时的基波 */
+#define SVPWM_M_SIX_STEP 1.1026578f /* 六拍基波 2√3/π */
+
+/* 调制器: 运行时可切换的调制方式 + 混合方式 / 过调制的状态 */
+typedef struct
+{
+    svpwm_mode_t mode;   /* 当前方式, 主循环直接写入, 控制中断下一次调制时生效 */
+    uint8_t dpwm_active; /* 混合方式: 当前处于 DPWM */
+    uint8_t overmod;     /* 过调制使能 (区域 I / II + 六拍), 0: 超出六边形时等比缩小 */
+    uint8_t om_region;   /* 最近一次调制所处区域: 0 线性区, 1 过调制区域 I, 2 过调制区域 II */
+    uint8_t sector;      /* 最近一次调制的电压矢量扇区 1 ~ 6 (0: 零矢量) */
+} svpwm_modulator_t;
+
+/*
+ * 占空比最高的相 (0: A, 1: B, 2: C)
+ *
+ * 各调制方式只改变零序分量, 三相占空比的大小顺序与相电压相同, 由扇区即可确定:
+ * 扇区 1 / 6 为 A 相, 2 / 3 为 B 相, 4 / 5 为 C 相 (过调制时零矢量消失, 仍成立)。
+ * 该相下桥臂导通时间最短, 下桥电阻采样时由其余两相重构 (adc1_current_reconstruct)。
+ * 零矢量 (扇区 0) 时三相占空比相同, 返回 SVPWM_PHASE_NONE。
+ */
+#define SVPWM_PHASE_NONE 3U
+
+static inline uint8_t svpwm_modulator_max_phase(const svpwm_modulator_t *mod)
+{
+    static const uint8_t max_phase[7] = {SVPWM_PHASE_NONE, 0U, 1U, 1U, 2U, 2U, 0U};
+    return max_phase[mod->sector < 7U ? mod->sector : 0U];
+}
+
+/**
+ * @brief  不连续调制
+ * @param  u_alphabeta - αβ轴电压 (V)
+ * @param  inv_udc     - 1 / 母线电压
+ * @param  mode        - SVPWM_MODE_DPWM0 ~ SVPWM_MODE_DPWMMIN (其他值按 DPWM1 处理)
+ * @return duty - 输出的三相占空比 (范围 0.0 ~ 1.0), 钳位相恰好为 0.0 或 1.0
+ */
+abc_t svpwm_dpwm(alphabeta_t u_alphabeta, float inv_udc, svpwm_mode_t mode);
+
+/* 初始化调制器 */
+void svpwm_modulator_init(svpwm_modulator_t *mod, svpwm_mode_t mode);
+
+/* 切换调制方式 (任意时刻调用, 下一次调制生效) */
+static inline void svpwm_modulator_set_mode(svpwm_modulator_t *mod, svpwm_mode_t mode)
+{
+    if (mode < SVPWM_MODE_NUM)
+        mod->mode = mode;
+}
+
+/* 过调制开关 (任意时刻调用, 下一次调制生效) */
+static inline void svpwm_modulator_set_overmod(svpwm_modulator_t *mod, uint8_t enable)
+{
+    mod->overmod = enable;
+}
+
+/**
+ * @brief  按调制器当前方式计算占空比, SVPWM 方式 (未使能过调制) 与 svpwm_update_udc 逐位一致
+ * @param  mod         - 调制器
+ * @param  u_alphabeta - αβ轴电压 (V)
+ * @param  inv_udc     - 1 / 母线电压
+ * @return duty - 输出的三相占空比 (范围 0.0 ~ 1.0)
+ */
+abc_t svpwm_modulate(svpwm_modulator_t *mod, alphabeta_t u_alphabeta, float inv_udc);
+
+/**
+ * 单电阻采样 (直流母线电阻) 的移相 PWM
+ *
+ * 中心对齐 PWM, 峰值附近为零矢量 V7 (三相上桥导通), 谷底附近为 V0。向下计数半周期 (峰值 -> 谷底) 内
+ * 占空比为 d 的相在峰值后 d · Tpwm/2 关断, 按占空比从低到高依次关断, 两个有效矢量期间母线电流分别为
+ *   [d_min, d_mid]: 最高、中间相导通, i_dc = -i_min
+ *   [d_mid, d_max]: 只有最高相导通,   i_dc = +i_max
+ * 第三相由 ia + ib + ic = 0 得到。两次采样都放在向下计数半周期, 时刻以 "峰值后经过的时间 / 半周期" 表示,
+ * 与占空比同一刻度 (占空比为 s 的相恰在 s 处翻转), 比较值换算与三相相同。
+ *
+ * 调制比低或电压矢量靠近扇区边界时有效矢量短于最小窗口 (死区 + 振荡稳定 + ADC 采样), 采样落在开关过程中。
+ * 此时在采样半周期内把最低相提前关断、最高相推迟关断, 使两个窗口都不短于最小窗口, 另一半周期反向移动同样的量
+ * (非对称 PWM), 每相整个周期的平均占空比不变。移动后超出 [0, 1] 的窗口 (钳位相、过调制) 无法保证, valid 清零。
+ */
+typedef struct
+{
+    float duty_up[3];   /* 向上计数半周期 (谷底 -> 峰值) 各相占空比 */
+    float duty_down[3]; /* 向下计数半周期 (峰值 -> 谷底, 采样所在的半周期) 各相占空比 */
+    float sample[2];    /* 两次采样时刻 (峰值后经过的时间 / 半周期): 各窗口结束前 t_sample */
+    uint8_t phase[2];   /* 采样 1 为 -i[phase[0]] (占空比最低相), 采样 2 为 +i[phase[1]] (最高相) */
+    uint8_t valid;      /* 两个窗口都不短于最小窗口 */
+} svpwm_single_shunt_t;
+
+/**
+ * @brief  单电阻采样的移相与采样时刻
+ * @param  ss         - 输出: 前后半周期占空比、采样时刻、采样对应的相
+ * @param  duty_a ~ c - 调制输出的三相占空比 (任意调制方式)
+ * @param  t_min      - 最小窗口 (半周期的比例): 死区 + 振荡稳定 + 采样保持
+ * @param  t_sample   - 采样保持时间 (半周期的比例), 采样点取窗口结束前 t_sample, 留给振荡稳定的时间最长
+ */
+void svpwm_single_shunt(svpwm_single_shunt_t *ss, float duty_a, float duty_b, float duty_c, float t_min, float t_sample);
+
 #endif /* __SVPWM_H__ */
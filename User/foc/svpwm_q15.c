@@ -0,0 +1,148 @@
+#include "svpwm_q15.h"
+
+/* Q14 常量, 保证 32 位中间结果不溢出 */
+#define Q14_SQRT3 28378         /* √3 */
+#define Q14_THREE_BY_2 24576    /* 3/2 */
+#define Q14_SQRT3_BY_2 14189    /* √3/2 */
+
+#define Q15_ONE 32768
+
+static q15_t svpwm_q15_duty(int32_t duty)
+{
+    if (duty < 0)
+        return 0;
+    if (duty > Q15_MAX)
+        return Q15_MAX;
+    return (q15_t)duty;
+}
+
+/**
+ * @brief  标准SVPWM调制函数 (定点, 与 svpwm_sector2 相同的扇区法)
+ * @param  u_alphabeta - αβ轴电压 (Q15 标幺值)
+ * @retval duty - 输出的三相占空比 (Q15)
+ * @note   电压以母线电压为基准, X/Y/Z 不再需要除以 U_DC
+ */
+abc_q15_t svpwm_update_q15(alphabeta_q15_t u_alphabeta)
+{
+    abc_q15_t duty;
+    int32_t N = 0, sector = 0;
+    int32_t Tx = 0, Ty = 0;
+
+    int32_t v_alpha = u_alphabeta.alpha;
+    int32_t v_beta = u_alphabeta.beta;
+
+    /* 扇区判断 */
+    if (v_beta > 0)
+        N = 1;
+    if ((Q14_SQRT3 * v_alpha - (v_beta << 14)) > 0)
+        N += 2;
+    if ((-Q14_SQRT3 * v_alpha - (v_beta << 14)) > 0)
+        N += 4;
+
+    switch (N)
+    {
+    case 3:
+        sector = 1;
+        break;
+    case 1:
+        sector = 2;
+        break;
+    case 5:
+        sector = 3;
+        break;
+    case 4:
+        sector = 4;
+        break;
+    case 6:
+        sector = 5;
+        break;
+    case 2:
+        sector = 6;
+        break;
+    }
+
+    /* 预计算公共项 (Q15) */
+    int32_t X = (Q14_SQRT3 * v_beta + (1 << 13)) >> 14;
+    int32_t Y = (Q14_THREE_BY_2 * v_alpha - Q14_SQRT3_BY_2 * v_beta + (1 << 13)) >> 14;
+    int32_t Z = (-Q14_THREE_BY_2 * v_alpha - Q14_SQRT3_BY_2 * v_beta + (1 << 13)) >> 14;
+
+    /* 计算矢量作用时间 */
+    switch (sector)
+    {
+    case 1:
+        Tx = Y;
+        Ty = X;
+        break;
+    case 2:
+        Tx = -Z;
+        Ty = -Y;
+        break;
+    case 3:
+        Tx = X;
+        Ty = Z;
+        break;
+    case 4:
+        Tx = -Y;
+        Ty = -X;
+        break;
+    case 5:
+        Tx = Z;
+        Ty = Y;
+        break;
+    case 6:
+        Tx = -X;
+        Ty = -Z;
+        break;
+    }
+
+    /* 过调制处理 (仅在饱和时做一次除法) */
+    int32_t sum = Tx + Ty;
+    if (sum > Q15_ONE)
+    {
+        Tx = (int32_t)(((int64_t)Tx << 15) / sum);
+        Ty = Q15_ONE - Tx;
+    }
+
+    /* 计算零矢量时间的一半 */
+    int32_t t0_half = (Q15_ONE - Tx - Ty) >> 1;
+
+    /* 根据扇区分配占空比 (中心对称分布，与sector2一致) */
+    switch (sector)
+    {
+    case 1:
+        duty.a = svpwm_q15_duty(Tx + Ty + t0_half);
+        duty.b = svpwm_q15_duty(Ty + t0_half);
+        duty.c = svpwm_q15_duty(t0_half);
+        break;
+    case 2:
+        duty.a = svpwm_q15_duty(Tx + t0_half);
+        duty.b = svpwm_q15_duty(Tx + Ty + t0_half);
+        duty.c = svpwm_q15_duty(t0_half);
+        break;
+    case 3:
+        duty.a = svpwm_q15_duty(t0_half);
+        duty.b = svpwm_q15_duty(Tx + Ty + t0_half);
+        duty.c = svpwm_q15_duty(Ty + t0_half);
+        break;
+    case 4:
+        duty.a = svpwm_q15_duty(t0_half);
+        duty.b = svpwm_q15_duty(Tx + t0_half);
+        duty.c = svpwm_q15_duty(Tx + Ty + t0_half);
+        break;
+    case 5:
+        duty.a = svpwm_q15_duty(Ty + t0_half);
+        duty.b = svpwm_q15_duty(t0_half);
+        duty.c = svpwm_q15_duty(Tx + Ty + t0_half);
+        break;
+    case 6:
+        duty.a = svpwm_q15_duty(Tx + Ty + t0_half);
+        duty.b = svpwm_q15_duty(t0_half);
+        duty.c = svpwm_q15_duty(Tx + t0_half);
+        break;
+    default:
+        duty.a = duty.b = duty.c = Q15_ONE / 2;
+        break;
+    }
+
+    return duty;
+}
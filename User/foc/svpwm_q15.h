@@ -0,0 +1,13 @@
+#ifndef __SVPWM_Q15_H__
+#define __SVPWM_Q15_H__
+
+#include "clark_park_q15.h"
+
+/**
+ * @brief  SVPWM调制函数 (定点)
+ * @param  u_alphabeta - αβ轴电压 (Q15, 以母线电压 FOC_Q15_U_BASE 为基准)
+ * @return duty - 输出的三相占空比 (Q15, 0 ~ 32767 对应 0.0 ~ 1.0)
+ */
+abc_q15_t svpwm_update_q15(alphabeta_q15_t u_alphabeta);
+
+#endif /* __SVPWM_Q15_H__ */
@@ -12,34 +12,40 @@ static dq_t i_dq_temp = {
 };
 
 // 电流闭环模式回调
-static void current_closed_callback(void)
+static void current_closed_callback(const adc_values_t *adc_values)
 {
-    // 计算角度
-    float angle_el = as5047_get_angle_rad() - foc_current_closed_handle.angle_offset;
+    // 计算角度 (转速用于编码器读数延迟与输出延迟补偿)
+    as5047_update_speed();
+    float speed_rpm = as5047_get_speed_rpm();
+    angle_t angle_el = foc_encoder_angle(&foc_current_closed_handle, as5047_get_angle_el(), speed_rpm);
+    isr_prof_mark(ISR_PROF_ENCODER);
 
     // 获取电流反馈值
-    adc_values_t adc_values;
-    adc1_get_injected_values(&adc_values);
+    foc_set_bus_voltage(&foc_current_closed_handle, adc_values->udc);
+    isr_prof_mark(ISR_PROF_ADC_READ);
 
     // Clark 变换
-    abc_t i_abc = {.a = adc_values.ia, .b = adc_values.ib, .c = adc_values.ic};
+    abc_t i_abc = foc_current_reconstruct(&foc_current_closed_handle, adc_values);
     alphabeta_t i_alphabeta = clark_transform(i_abc);
 
     // Park 变换
-    dq_t i_dq = park_transform(i_alphabeta, angle_el);
+    foc_transform_set_angle(&foc_current_closed_handle.transform, angle_el);
+    dq_t i_dq = foc_transform_park(&foc_current_closed_handle.transform, i_alphabeta);
+    isr_prof_mark(ISR_PROF_CLARK_PARK);
 
     // 打印用
     i_dq_temp = i_dq;
 
     // 电流闭环
+    foc_set_speed_el(&foc_current_closed_handle, speed_rpm);
     foc_current_closed_loop_run(&foc_current_closed_handle, i_dq, angle_el);
 }
 
 void current_closed_init(float id, float iq)
 {
     // 初始化电流环 PID 控制器
-    pid_init(&pid_id, 0.017f, 0.002826f, -U_DC / 2.0f, U_DC / 2.0f);
-    pid_init(&pid_iq, 0.017f, 0.002826f, -U_DC / 2.0f, U_DC / 2.0f);
+    pid_init(&pid_id, MOTOR_CURRENT_KP, MOTOR_CURRENT_KI, -U_DC / 2.0f, U_DC / 2.0f);
+    pid_init(&pid_iq, MOTOR_CURRENT_KP, MOTOR_CURRENT_KI, -U_DC / 2.0f, U_DC / 2.0f);
 
     // 初始化 FOC 控制句柄
     foc_init(&foc_current_closed_handle, &pid_id, &pid_iq, NULL);
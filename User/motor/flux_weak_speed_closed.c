@@ -16,27 +16,30 @@ static float speed_rpm_temp = 0.0f;
 static float id_target_temp = 0.0f;
 
 // 弱磁速度闭环模式回调
-static void flux_weak_speed_closed_callback(void)
+static void flux_weak_speed_closed_callback(const adc_values_t *adc_values)
 {
     // 更新速度
     as5047_update_speed();
 
     // 获取角度和速度
-    float angle_el = as5047_get_angle_rad() - foc_flux_weak_speed_handle.angle_offset;
     float speed_feedback = as5047_get_speed_rpm();
+    angle_t angle_el = foc_encoder_angle(&foc_flux_weak_speed_handle, as5047_get_angle_el(), speed_feedback);
+    isr_prof_mark(ISR_PROF_ENCODER);
 
     // 打印用
     speed_rpm_temp = speed_feedback;
 
     // 获取电流反馈值
-    adc_values_t adc_values;
-    adc1_get_injected_values(&adc_values);
+    foc_set_bus_voltage(&foc_flux_weak_speed_handle, adc_values->udc);
+    isr_prof_mark(ISR_PROF_ADC_READ);
 
     // Clark 变换
-    abc_t i_abc = {.a = adc_values.ia, .b = adc_values.ib, .c = adc_values.ic};
+    abc_t i_abc = foc_current_reconstruct(&foc_flux_weak_speed_handle, adc_values);
     alphabeta_t i_alphabeta = clark_transform(i_abc);
     // Park 变换
-    dq_t i_dq = park_transform(i_alphabeta, angle_el);
+    foc_transform_set_angle(&foc_flux_weak_speed_handle.transform, angle_el);
+    dq_t i_dq = foc_transform_park(&foc_flux_weak_speed_handle.transform, i_alphabeta);
+    isr_prof_mark(ISR_PROF_CLARK_PARK);
 
     // 打印用
     i_dq_temp = i_dq;
@@ -51,9 +54,9 @@ static void flux_weak_speed_closed_callback(void)
 void flux_weak_speed_closed_init(float speed_rpm)
 {
     // 初始化 PID 控制器
-    pid_init(&pid_id, 0.017f, 0.002826f, -U_DC / 3.0f, U_DC / 3.0f);
-    pid_init(&pid_iq, 0.017f, 0.002826f, -U_DC / 3.0f, U_DC / 3.0f);
-    pid_init(&pid_speed, 0.005f, 0.000002f, -2.0f, 2.0f);
+    pid_init(&pid_id, MOTOR_CURRENT_KP, MOTOR_CURRENT_KI, -U_DC / 3.0f, U_DC / 3.0f);
+    pid_init(&pid_iq, MOTOR_CURRENT_KP, MOTOR_CURRENT_KI, -U_DC / 3.0f, U_DC / 3.0f);
+    pid_init(&pid_speed, 0.005f, 0.000002f * FOC_SPEED_KI_K, -2.0f, 2.0f);
 
     // 初始化 FOC 控制句柄
     foc_init(&foc_flux_weak_speed_handle, &pid_id, &pid_iq, &pid_speed);
@@ -65,6 +68,16 @@ void flux_weak_speed_closed_init(float speed_rpm)
     // 零点对齐
     foc_alignment(&foc_flux_weak_speed_handle);
 
+    // 登记遥测通道 (与 print 函数输出顺序一致)
+    telemetry_clear_channels();
+    telemetry_add_channel(&speed_rpm_temp, 4.0f);
+    telemetry_add_channel(&i_dq_temp.d, 1000.0f);
+    telemetry_add_channel(&i_dq_temp.q, 1000.0f);
+    telemetry_add_channel(&id_target_temp, 1000.0f);
+
+    // 速度环与编码器转速刷新同相: 第一次回调只记录角度, 之后每 FOC_SPEED_DIV 个周期同时刷新转速、执行速度环
+    as5047_speed_reset();
+
     // 注册回调函数
     adc1_register_injected_callback(flux_weak_speed_closed_callback);
 }
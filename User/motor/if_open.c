@@ -15,18 +15,20 @@ static dq_t i_dq_temp = {
 };
 
 // I/F 开环模式回调
-static void if_open_callback(void)
+static void if_open_callback(const adc_values_t *adc_values)
 {
     // 获取电流反馈值
-    adc_values_t adc_values;
-    adc1_get_injected_values(&adc_values);
+    foc_set_bus_voltage(&foc_if_open_handle, adc_values->udc);
+    isr_prof_mark(ISR_PROF_ADC_READ);
 
     // Clark 变换
-    abc_t i_abc = {.a = adc_values.ia, .b = adc_values.ib, .c = adc_values.ic};
+    abc_t i_abc = foc_current_reconstruct(&foc_if_open_handle, adc_values);
     alphabeta_t i_alphabeta = clark_transform(i_abc);
 
     // Park 变换 - 使用 I/F 角度
-    dq_t i_dq = park_transform(i_alphabeta, foc_if_open_handle.open_loop_angle_el);
+    foc_transform_set_angle(&foc_if_open_handle.transform, foc_if_open_handle.open_loop_angle_el);
+    dq_t i_dq = foc_transform_park(&foc_if_open_handle.transform, i_alphabeta);
+    isr_prof_mark(ISR_PROF_CLARK_PARK);
 
 
     // 打印用
@@ -39,8 +41,8 @@ static void if_open_callback(void)
 void if_open_init(float speed_rpm, float iq)
 {
     // 初始化电流环 PID 控制器
-    pid_init(&pid_id, 0.017f, 0.002826f, -U_DC / 2.0f, U_DC / 2.0f);
-    pid_init(&pid_iq, 0.017f, 0.002826f, -U_DC / 2.0f, U_DC / 2.0f);
+    pid_init(&pid_id, MOTOR_CURRENT_KP, MOTOR_CURRENT_KI, -U_DC / 2.0f, U_DC / 2.0f);
+    pid_init(&pid_iq, MOTOR_CURRENT_KP, MOTOR_CURRENT_KI, -U_DC / 2.0f, U_DC / 2.0f);
 
     // 初始化 FOC 控制句柄
     foc_init(&foc_if_open_handle, &pid_id, &pid_iq, NULL);
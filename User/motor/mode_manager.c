@@ -0,0 +1,746 @@
+#include "mode_manager.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bsp/usart.h"
+#include "utils/ccmram.h"
+
+#define MM_TS MOTOR_TS                          /* 控制周期 (s), 双更新时为半个 PWM 周期 */
+#define MM_TICKS_PER_MS (MOTOR_CTRL_FREQ / 1000U) /* 每毫秒控制周期数 */
+#define MM_ALIGN_TICKS (MODE_MANAGER_ALIGN_MS * MM_TICKS_PER_MS)
+#define MM_IF_RAMP_RATE 1000.0f                 /* I/F 拖动加速度 (RPM/s) */
+#define MM_SPEED_TS (MM_TS * MODE_MANAGER_SPEED_DIV) /* 速度环周期 (s) */
+
+/* 速度环 ki 换算: 参数按每个 PWM 周期 (10kHz) 执行整定, 实际每 MM_SPEED_TS 执行一次 */
+#define MM_SPEED_KI_K (MM_SPEED_TS / MOTOR_PWM_TS)
+
+/* 各速度模式的速度环参数 (与原各模式一致, ki 按每个 PWM 周期执行整定, 使用时乘以 MM_SPEED_KI_K) */
+typedef struct
+{
+    float kp;
+    float ki;
+    float iq_max;
+} mm_speed_gain_t;
+
+static const mm_speed_gain_t speed_gain_speed = {0.05f, 0.00002f, 2.0f};        /* speed_closed */
+static const mm_speed_gain_t speed_gain_flux_weak = {0.005f, 0.000002f, 2.0f};   /* flux_weak_speed_closed */
+static const mm_speed_gain_t speed_gain_sensorless = {0.005f, 0.000002f, 2.0f};  /* sensorless_luenberger */
+
+/* 控制对象 */
+CCMRAM_BSS static foc_t foc_handle;
+CCMRAM_BSS static luenberger_t luenberger;
+CCMRAM_BSS static pid_controller_t pid_id;
+CCMRAM_BSS static pid_controller_t pid_iq;
+CCMRAM_BSS static pid_controller_t pid_speed;
+CCMRAM_BSS static if_handover_t handover;
+
+/* 多速率调度 */
+CCMRAM_BSS static struct
+{
+    sched_task_t speed;
+    sched_task_t flux_weak;
+    sched_task_t telemetry;
+    uint8_t due; /* 本周期轮到的慢速任务 */
+    uint8_t ran; /* 本周期实际执行的慢速任务 */
+} sched;
+
+/* 模式请求邮箱: 主循环写 (关中断), 控制中断取走 */
+CCMRAM_BSS static volatile struct
+{
+    uint8_t pending;
+    motor_mode_t mode;
+    float ref_a;
+    float ref_b;
+} request;
+
+/* 运行状态, 只在控制中断中修改 */
+CCMRAM_BSS static struct
+{
+    motor_mode_t mode;
+    motor_mode_t align_next;
+    uint8_t aligned;
+    uint32_t align_ticks;
+    uint32_t align_count;
+    uint32_t switch_count;
+
+    /* 目标 */
+    float ref_a; /* 转速 (RPM) 或 Id (A) */
+    float ref_b; /* Iq (A) */
+
+    float speed_ref; /* 斜坡后的速度指令 / I/F 拖动转速 (RPM) */
+} mm;
+
+/* 本周期编码器 (减零点) / 观测器电角度, 控制使用 */
+CCMRAM_BSS static angle_t angle_encoder = 0;
+CCMRAM_BSS static angle_t angle_observer = 0;
+
+/* 遥测 / 状态用 (角度为弧度 [-π, π)) */
+CCMRAM_BSS static float speed_rpm_encoder = 0.0f;
+CCMRAM_BSS static float angle_el_encoder = 0.0f;
+CCMRAM_BSS static float speed_rpm_observer = 0.0f;
+CCMRAM_BSS static float angle_el_observer = 0.0f;
+CCMRAM_BSS static float i_d_temp = 0.0f;
+CCMRAM_BSS static float i_q_temp = 0.0f;
+
+/* 串口命令行 */
+static char cmd_line[MODE_MANAGER_LINE_MAX];
+static uint8_t cmd_len = 0;
+static uint8_t cmd_overflow = 0;
+
+static const char *const mode_names[MOTOR_MODE_NUM] = {
+    "stop", "align", "if", "cur", "spd", "fw", "sl",
+};
+
+static uint8_t mode_needs_encoder(motor_mode_t mode)
+{
+    return mode == MOTOR_MODE_CURRENT || mode == MOTOR_MODE_SPEED || mode == MOTOR_MODE_FLUX_WEAK;
+}
+
+/* 电流环正在工作 (切换时保留电流环积分) */
+static uint8_t mode_is_running(motor_mode_t mode)
+{
+    return mode != MOTOR_MODE_STOP && mode != MOTOR_MODE_ALIGN;
+}
+
+static void mode_set_speed_gain(const mm_speed_gain_t *gain)
+{
+    pid_speed.kp = gain->kp;
+    pid_speed.ki = gain->ki * MM_SPEED_KI_K;
+    pid_speed.out_min = -gain->iq_max;
+    pid_speed.out_max = gain->iq_max;
+    pid_speed.integral_max = gain->iq_max;
+}
+
+/* 进入速度环: 积分预置为切入前的 Iq, 速度指令从当前转速开始斜坡 */
+static void mode_enter_speed_loop(const mm_speed_gain_t *gain, float speed_now, float iq)
+{
+    mode_set_speed_gain(gain);
+    foc_speed_loop_preload(&foc_handle, iq);
+    foc_handle.target_id = 0.0f;
+    mm.speed_ref = speed_now;
+}
+
+/* 速度环 (每 MODE_MANAGER_SPEED_DIV 个周期): 指令斜坡 + 速度 PI, 两次之间 target_iq 保持 */
+CCMRAM_FUNC static void mode_speed_task(float speed_rpm)
+{
+    mm.speed_ref = ramp_update(mm.speed_ref, mm.ref_a, MODE_MANAGER_SPEED_RAMP_RATE, MM_SPEED_TS);
+    foc_set_target_speed(&foc_handle, mm.speed_ref);
+    foc_speed_loop_step(&foc_handle, speed_rpm);
+    sched.ran |= MODE_MANAGER_TASK_SPEED;
+}
+
+/**
+ * @brief 切换模式 (控制中断中调用)
+ * @param mode 目标模式
+ */
+static void mode_enter(motor_mode_t mode)
+{
+    motor_mode_t prev = mm.mode;
+
+    /* 编码器模式需要零点, 未对齐时先对齐 */
+    if (mode_needs_encoder(mode) && !mm.aligned)
+    {
+        mm.align_next = mode;
+        mode = MOTOR_MODE_ALIGN;
+    }
+
+    /* 从停机 / 对齐进入时电流环从零开始, 否则保留积分 */
+    if (!mode_is_running(prev))
+    {
+        pid_reset(&pid_id);
+        pid_reset(&pid_iq);
+        pid_reset(&pid_speed);
+        foc_handle.target_iq = 0.0f;
+        foc_handle.target_id = 0.0f;
+    }
+
+    switch (mode)
+    {
+    case MOTOR_MODE_STOP:
+        foc_closed_loop_stop(&foc_handle);
+        foc_handle.transform.v_alphabeta = (alphabeta_t){0.0f, 0.0f};
+        mm.speed_ref = 0.0f;
+        break;
+
+    case MOTOR_MODE_ALIGN:
+        foc_closed_loop_stop(&foc_handle);
+        mm.align_ticks = 0;
+        mm.aligned = 0;
+        break;
+
+    case MOTOR_MODE_IF:
+        /* 从闭环切入时沿用当前角度与转速, 避免电流矢量跳变 */
+        if (mode_is_running(prev))
+        {
+            foc_handle.open_loop_angle_el = foc_handle.transform.theta;
+            mm.speed_ref = (prev == MOTOR_MODE_SENSORLESS) ? speed_rpm_observer : speed_rpm_encoder;
+        }
+        else
+        {
+            mm.speed_ref = 0.0f;
+        }
+        break;
+
+    case MOTOR_MODE_CURRENT:
+        foc_handle.target_id = mm.ref_a;
+        foc_handle.target_iq = mm.ref_b;
+        break;
+
+    case MOTOR_MODE_SPEED:
+        mode_enter_speed_loop(&speed_gain_speed, speed_rpm_encoder, foc_handle.target_iq);
+        break;
+
+    case MOTOR_MODE_FLUX_WEAK:
+        if (prev != MOTOR_MODE_FLUX_WEAK)
+        {
+            flux_weak_init(&foc_handle.flux_weak, foc_handle.bus.udc, 0.85f, 0.005f, -2.0f);
+            /* 弱磁参数按每个 PWM 周期执行整定 (FW_DIV 是 AS5047_SPEED_CALC_DIV 的倍数, 总能整除) */
+            flux_weak_set_div(&foc_handle.flux_weak, MODE_MANAGER_FW_DIV / MOTOR_CTRL_PER_PWM);
+            flux_weak_set_u_max_k(&foc_handle.flux_weak, foc_handle.v_max_k);
+        }
+        mode_enter_speed_loop(&speed_gain_flux_weak, speed_rpm_encoder, foc_handle.target_iq);
+        break;
+
+    case MOTOR_MODE_SENSORLESS:
+        /* 转动中切入且观测器已与编码器一致: 直接使用观测器角度 */
+        if (mode_is_running(prev) && prev != MOTOR_MODE_IF &&
+            fabsf(speed_rpm_observer) >= MODE_MANAGER_SL_IF_RPM &&
+            fabsf(speed_rpm_observer - speed_rpm_encoder) < MODE_MANAGER_SL_SWITCH_ERR_RPM)
+        {
+            if_handover_force_done(&handover);
+            mode_enter_speed_loop(&speed_gain_sensorless, speed_rpm_observer, foc_handle.target_iq);
+        }
+        else
+        {
+            if_handover_reset(&handover);
+            if (mode_is_running(prev))
+            {
+                foc_handle.open_loop_angle_el = foc_handle.transform.theta;
+            }
+            else
+            {
+                mm.speed_ref = 0.0f;
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    mm.mode = mode;
+    mm.switch_count++;
+}
+
+/* 取走请求: 同一模式只更新目标, 否则切换 */
+CCMRAM_FUNC static void mode_take_request(void)
+{
+    if (!request.pending)
+    {
+        return;
+    }
+
+    motor_mode_t mode = request.mode;
+    mm.ref_a = request.ref_a;
+    mm.ref_b = request.ref_b;
+    request.pending = 0;
+
+    if (mode == MOTOR_MODE_ALIGN)
+    {
+        /* 强制重新对齐, 完成后停机 */
+        mm.aligned = 0;
+        mm.align_next = MOTOR_MODE_STOP;
+        mode_enter(MOTOR_MODE_ALIGN);
+    }
+    else if (mode == mm.mode)
+    {
+        if (mode == MOTOR_MODE_CURRENT)
+        {
+            foc_handle.target_id = mm.ref_a;
+            foc_handle.target_iq = mm.ref_b;
+        }
+    }
+    else if (mm.mode == MOTOR_MODE_ALIGN && mode_needs_encoder(mode))
+    {
+        /* 对齐中收到其他编码器模式: 对齐完成后进入新模式 */
+        mm.align_next = mode;
+    }
+    else
+    {
+        mode_enter(mode);
+    }
+}
+
+/* 对齐: 固定 0 电角度施加 d 轴电压, 结束时读取零点 */
+static void mode_align_run(void)
+{
+    if (mm.align_ticks < MM_ALIGN_TICKS)
+    {
+        foc_transform_set_angle(&foc_handle.transform, 0);
+        abc_t duty = foc_transform_modulate(&foc_handle.transform, (dq_t){.d = MODE_MANAGER_ALIGN_VOLTAGE, .q = 0.0f});
+        tim1_set_pwm_duty(duty.a, duty.b, duty.c);
+        mm.align_ticks++;
+        return;
+    }
+
+    foc_handle.angle_offset = as5047_get_angle_el();
+    mm.aligned = 1;
+    mm.align_count++;
+
+    /* 下一周期进入目标模式 */
+    mode_enter(mm.align_next);
+}
+
+/* 无感: I/F 拖动, 观测器收敛后经 if_handover 无扰切换到观测器闭环 */
+CCMRAM_FUNC static void mode_sensorless_run(alphabeta_t i_alphabeta)
+{
+    angle_t angle = if_handover_update(&handover, foc_handle.open_loop_angle_el, mm.speed_ref,
+                                       angle_observer, speed_rpm_observer);
+
+    foc_transform_set_angle(&foc_handle.transform, angle);
+    dq_t i_dq = foc_transform_park(&foc_handle.transform, i_alphabeta);
+    i_d_temp = i_dq.d;
+    i_q_temp = i_dq.q;
+
+    if (handover.state == IF_HANDOVER_IF)
+    {
+        mm.speed_ref = ramp_update(mm.speed_ref, MODE_MANAGER_SL_IF_RPM, MM_IF_RAMP_RATE, MM_TS);
+        foc_if_current_run(&foc_handle, i_dq, mm.speed_ref, MODE_MANAGER_SL_IF_IQ);
+        return;
+    }
+
+    if (handover.switch_event)
+    {
+        mode_enter_speed_loop(&speed_gain_sensorless, speed_rpm_observer,
+                              if_handover_iq_preload(&handover, MODE_MANAGER_SL_IF_IQ));
+    }
+
+    if (sched.due & MODE_MANAGER_TASK_SPEED)
+    {
+        mode_speed_task(speed_rpm_observer);
+    }
+    foc_set_speed_el(&foc_handle, speed_rpm_observer);
+    foc_current_closed_loop_run(&foc_handle, i_dq, angle);
+}
+
+CCMRAM_FUNC static void mode_manager_callback(const adc_values_t *adc_values)
+{
+    /* 调度计数每周期推进, 与模式无关, 相位保持固定 */
+    sched.due = (sched_task_due(&sched.speed) ? MODE_MANAGER_TASK_SPEED : 0U) |
+                (sched_task_due(&sched.flux_weak) ? MODE_MANAGER_TASK_FLUX_WEAK : 0U) |
+                (sched_task_due(&sched.telemetry) ? MODE_MANAGER_TASK_TELEMETRY : 0U);
+    sched.ran = 0;
+
+    /* 电流采样 + Clark */
+    foc_set_bus_voltage(&foc_handle, adc_values->udc);
+    isr_prof_mark(ISR_PROF_ADC_READ);
+
+    abc_t i_abc = foc_current_reconstruct(&foc_handle, adc_values);
+    alphabeta_t i_alphabeta = clark_transform(i_abc);
+
+    /* 编码器角度与转速每周期更新, 任意模式切换时都可直接使用; 转速在速度环执行的周期刷新, 角度外推到采样时刻 */
+    as5047_update_speed();
+    speed_rpm_encoder = as5047_get_speed_rpm();
+    angle_encoder = foc_encoder_angle(&foc_handle, as5047_get_angle_el(), speed_rpm_encoder);
+    angle_el_encoder = angle_to_rad(angle_encoder);
+    isr_prof_mark(ISR_PROF_ENCODER);
+
+    speed_rpm_observer = luenberger_get_speed_rpm(&luenberger);
+    angle_observer = luenberger_get_angle(&luenberger);
+    angle_el_observer = angle_to_rad(angle_observer);
+
+    mode_take_request();
+
+    switch (mm.mode)
+    {
+    case MOTOR_MODE_ALIGN:
+        mode_align_run();
+        break;
+
+    case MOTOR_MODE_IF:
+    {
+        foc_transform_set_angle(&foc_handle.transform, foc_handle.open_loop_angle_el);
+        dq_t i_dq = foc_transform_park(&foc_handle.transform, i_alphabeta);
+        i_d_temp = i_dq.d;
+        i_q_temp = i_dq.q;
+
+        mm.speed_ref = ramp_update(mm.speed_ref, mm.ref_a, MM_IF_RAMP_RATE, MM_TS);
+        foc_if_current_run(&foc_handle, i_dq, mm.speed_ref, mm.ref_b);
+        break;
+    }
+
+    case MOTOR_MODE_CURRENT:
+    case MOTOR_MODE_SPEED:
+    case MOTOR_MODE_FLUX_WEAK:
+    {
+        foc_transform_set_angle(&foc_handle.transform, angle_encoder);
+        dq_t i_dq = foc_transform_park(&foc_handle.transform, i_alphabeta);
+        isr_prof_mark(ISR_PROF_CLARK_PARK);
+        i_d_temp = i_dq.d;
+        i_q_temp = i_dq.q;
+
+        if (mm.mode == MOTOR_MODE_CURRENT)
+        {
+            foc_set_speed_el(&foc_handle, speed_rpm_encoder);
+            foc_current_closed_loop_run(&foc_handle, i_dq, angle_encoder);
+            break;
+        }
+
+        if (sched.due & MODE_MANAGER_TASK_SPEED)
+        {
+            mode_speed_task(speed_rpm_encoder);
+        }
+        if (mm.mode == MOTOR_MODE_FLUX_WEAK && (sched.due & MODE_MANAGER_TASK_FLUX_WEAK))
+        {
+            foc_flux_weak_step(&foc_handle);
+            sched.ran |= MODE_MANAGER_TASK_FLUX_WEAK;
+        }
+        foc_set_speed_el(&foc_handle, speed_rpm_encoder);
+        foc_current_closed_loop_run(&foc_handle, i_dq, angle_encoder);
+        break;
+    }
+
+    case MOTOR_MODE_SENSORLESS:
+        mode_sensorless_run(i_alphabeta);
+        break;
+
+    default:
+        /* 停机: 输出已在进入时置为 50%, 仅更新电流显示 */
+        i_d_temp = 0.0f;
+        i_q_temp = 0.0f;
+        break;
+    }
+
+    /* 观测器在所有模式下运行 (停机时电压为 0), 切换到无感时已收敛 */
+    alphabeta_t v_alphabeta = foc_transform_get_v_alphabeta(&foc_handle.transform);
+    luenberger.i_alpha = i_alphabeta.alpha;
+    luenberger.i_beta = i_alphabeta.beta;
+    luenberger.u_alpha = v_alphabeta.alpha;
+    luenberger.u_beta = v_alphabeta.beta;
+    luenberger_estimate(&luenberger);
+    isr_prof_mark(ISR_PROF_OBSERVER);
+
+    /* 遥测在本中断返回前采样 (telemetry_sample), 抽取相位对齐到分配的周期 */
+    if (sched.due & MODE_MANAGER_TASK_TELEMETRY)
+    {
+        telemetry_align();
+        sched.ran |= MODE_MANAGER_TASK_TELEMETRY;
+    }
+}
+
+void mode_manager_init(void)
+{
+    /* 单轴限幅取电压矢量上限, 由 foc_voltage_limit 做圆限幅 (d 轴优先), 高速时 q 轴可用全部剩余电压 */
+    pid_init(&pid_id, MOTOR_CURRENT_KP, MOTOR_CURRENT_KI, -FOC_V_MAX_K * U_DC, FOC_V_MAX_K * U_DC);
+    pid_init(&pid_iq, MOTOR_CURRENT_KP, MOTOR_CURRENT_KI, -FOC_V_MAX_K * U_DC, FOC_V_MAX_K * U_DC);
+    pid_init(&pid_speed, speed_gain_speed.kp, speed_gain_speed.ki * MM_SPEED_KI_K,
+             -speed_gain_speed.iq_max, speed_gain_speed.iq_max);
+
+    foc_init(&foc_handle, &pid_id, &pid_iq, &pid_speed);
+    foc_decouple_init(&foc_handle, MOTOR_LD, MOTOR_LQ, MOTOR_FLUX);
+    foc_set_decoupling(&foc_handle, MODE_MANAGER_DECOUPLING);
+    deadtime_comp_init(&foc_handle.deadtime, DEADTIME_COMP_T_DEAD, MOTOR_PWM_TS, MODE_MANAGER_DEADTIME_V_DROP, MODE_MANAGER_DEADTIME_I_BAND);
+    foc_handle.deadtime.enable = MODE_MANAGER_DEADTIME_COMP;
+    foc_transform_set_pwm_mode(&foc_handle.transform, MODE_MANAGER_PWM_MODE);
+    foc_set_overmodulation(&foc_handle, MODE_MANAGER_OVERMOD);
+
+    luenberger_init_profile(&luenberger, 0.05f); // k_speed_lpf
+
+    // I/F -> 观测器切换判据, 与 sensorless_luenberger 相同
+    if_handover_init(&handover, MM_TS, 100.0f, 30.0f, 0.1f, 0.02f, 20.0f);
+
+    /* 速度环与编码器转速刷新同相: 复位后第 0 个周期只记录角度, 每 AS5047_SPEED_CALC_DIV 个周期刷新一次 */
+    as5047_speed_reset();
+    sched_task_init(&sched.speed, MODE_MANAGER_SPEED_DIV, 0);
+    sched_task_init(&sched.flux_weak, MODE_MANAGER_FW_DIV, MODE_MANAGER_SPEED_DIV / 2);
+    sched_task_init(&sched.telemetry, MODE_MANAGER_SPEED_DIV, MODE_MANAGER_SPEED_DIV / 4);
+    sched.due = 0;
+    sched.ran = 0;
+
+    memset(&mm, 0, sizeof(mm));
+    request.pending = 0;
+    cmd_len = 0;
+    cmd_overflow = 0;
+
+    mm.mode = MOTOR_MODE_STOP;
+    foc_closed_loop_stop(&foc_handle);
+
+    // 登记遥测通道
+    telemetry_clear_channels();
+    telemetry_add_channel(&speed_rpm_encoder, 4.0f);
+    telemetry_add_channel(&speed_rpm_observer, 4.0f);
+    telemetry_add_angle_channel(&angle_el_encoder);
+    telemetry_add_angle_channel(&angle_el_observer);
+    telemetry_add_channel(&i_d_temp, 1000.0f);
+    telemetry_add_channel(&i_q_temp, 1000.0f);
+
+    adc1_register_injected_callback(mode_manager_callback);
+}
+
+/* 投递请求, 与控制中断互斥 */
+static void mode_manager_post(motor_mode_t mode, float ref_a, float ref_b)
+{
+#ifndef FOC_SIM_HOST
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+#endif
+
+    request.mode = mode;
+    request.ref_a = ref_a;
+    request.ref_b = ref_b;
+    request.pending = 1;
+
+#ifndef FOC_SIM_HOST
+    __set_PRIMASK(primask);
+#endif
+}
+
+void mode_manager_stop(void)
+{
+    mode_manager_post(MOTOR_MODE_STOP, 0.0f, 0.0f);
+}
+
+void mode_manager_align(void)
+{
+    mode_manager_post(MOTOR_MODE_ALIGN, 0.0f, 0.0f);
+}
+
+void mode_manager_if(float speed_rpm, float iq)
+{
+    mode_manager_post(MOTOR_MODE_IF, speed_rpm, iq);
+}
+
+void mode_manager_current(float id, float iq)
+{
+    mode_manager_post(MOTOR_MODE_CURRENT, id, iq);
+}
+
+void mode_manager_speed(float speed_rpm)
+{
+    mode_manager_post(MOTOR_MODE_SPEED, speed_rpm, 0.0f);
+}
+
+void mode_manager_flux_weak(float speed_rpm)
+{
+    mode_manager_post(MOTOR_MODE_FLUX_WEAK, speed_rpm, 0.0f);
+}
+
+void mode_manager_sensorless(float speed_rpm)
+{
+    mode_manager_post(MOTOR_MODE_SENSORLESS, speed_rpm, 0.0f);
+}
+
+/* 解析 n 个浮点参数, 之后只允许空白 */
+static uint8_t cmd_parse_args(const char *s, float *args, uint8_t n)
+{
+    for (uint8_t i = 0; i < n; i++)
+    {
+        char *end;
+        args[i] = strtof(s, &end);
+        if (end == s || !isfinite(args[i]))
+        {
+            return 0;
+        }
+        s = end;
+    }
+
+    while (*s == ' ' || *s == '\t')
+    {
+        s++;
+    }
+    return *s == '\0';
+}
+
+static uint8_t cmd_match(const char *line, const char *word, const char **args)
+{
+    size_t len = strlen(word);
+    if (strncmp(line, word, len) != 0 || (line[len] != '\0' && line[len] != ' ' && line[len] != '\t'))
+    {
+        return 0;
+    }
+    *args = line + len;
+    return 1;
+}
+
+void mode_manager_set_decoupling(uint8_t enable)
+{
+    /* 单字节写入, 控制中断下一周期读取, 无需经过模式请求 */
+    foc_set_decoupling(&foc_handle, enable);
+}
+
+void mode_manager_set_deadtime_comp(uint8_t enable)
+{
+    foc_handle.deadtime.enable = enable;
+}
+
+void mode_manager_set_pwm_mode(svpwm_mode_t mode)
+{
+    foc_transform_set_pwm_mode(&foc_handle.transform, mode);
+}
+
+void mode_manager_set_overmodulation(uint8_t enable)
+{
+    /* 调制器开关与电压上限系数都是单次写入, 电压上限在下一周期的 foc_set_bus_voltage 中更新 */
+    foc_set_overmodulation(&foc_handle, enable);
+}
+
+void mode_manager_set_delay_comp(float pwm_ts, float encoder_ts)
+{
+    /* 只改写补偿系数, 两个延迟在相邻周期先后生效也不影响稳定 */
+    foc_set_delay_comp(&foc_handle, pwm_ts, encoder_ts);
+}
+
+void mode_manager_set_current_recon(uint8_t enable)
+{
+    foc_handle.current_recon = enable;
+}
+
+int8_t mode_manager_command(const char *line)
+{
+    const char *args;
+    float v[2];
+
+    while (*line == ' ' || *line == '\t')
+    {
+        line++;
+    }
+
+    if (cmd_match(line, "stop", &args) && cmd_parse_args(args, v, 0))
+    {
+        mode_manager_stop();
+    }
+    else if (cmd_match(line, "align", &args) && cmd_parse_args(args, v, 0))
+    {
+        mode_manager_align();
+    }
+    else if (cmd_match(line, "if", &args) && cmd_parse_args(args, v, 2) &&
+             fabsf(v[0]) <= MODE_MANAGER_SPEED_MAX_RPM && fabsf(v[1]) <= MODE_MANAGER_CURRENT_MAX)
+    {
+        mode_manager_if(v[0], v[1]);
+    }
+    else if (cmd_match(line, "cur", &args) && cmd_parse_args(args, v, 2) &&
+             fabsf(v[0]) <= MODE_MANAGER_CURRENT_MAX && fabsf(v[1]) <= MODE_MANAGER_CURRENT_MAX)
+    {
+        mode_manager_current(v[0], v[1]);
+    }
+    else if (cmd_match(line, "spd", &args) && cmd_parse_args(args, v, 1) && fabsf(v[0]) <= MODE_MANAGER_SPEED_MAX_RPM)
+    {
+        mode_manager_speed(v[0]);
+    }
+    else if (cmd_match(line, "fw", &args) && cmd_parse_args(args, v, 1) && fabsf(v[0]) <= MODE_MANAGER_SPEED_MAX_RPM)
+    {
+        mode_manager_flux_weak(v[0]);
+    }
+    else if (cmd_match(line, "sl", &args) && cmd_parse_args(args, v, 1) && fabsf(v[0]) <= MODE_MANAGER_SPEED_MAX_RPM)
+    {
+        mode_manager_sensorless(v[0]);
+    }
+    else if (cmd_match(line, "dec", &args) && cmd_parse_args(args, v, 1) && (v[0] == 0.0f || v[0] == 1.0f))
+    {
+        mode_manager_set_decoupling((uint8_t)v[0]);
+    }
+    else if (cmd_match(line, "dt", &args) && cmd_parse_args(args, v, 1) && (v[0] == 0.0f || v[0] == 1.0f))
+    {
+        mode_manager_set_deadtime_comp((uint8_t)v[0]);
+    }
+    else if (cmd_match(line, "pwm", &args) && cmd_parse_args(args, v, 1) && v[0] >= 0.0f && v[0] < SVPWM_MODE_NUM &&
+             v[0] == (float)(int)v[0])
+    {
+        mode_manager_set_pwm_mode((svpwm_mode_t)v[0]);
+    }
+    else if (cmd_match(line, "om", &args) && cmd_parse_args(args, v, 1) && (v[0] == 0.0f || v[0] == 1.0f))
+    {
+        mode_manager_set_overmodulation((uint8_t)v[0]);
+    }
+    else if (cmd_match(line, "dly", &args) && cmd_parse_args(args, v, 2) && v[0] >= 0.0f && v[1] >= 0.0f &&
+             v[0] <= MODE_MANAGER_DELAY_MAX_US && v[1] <= MODE_MANAGER_DELAY_MAX_US)
+    {
+        mode_manager_set_delay_comp(v[0] * 1e-6f, v[1] * 1e-6f);
+    }
+    else if (cmd_match(line, "rec", &args) && cmd_parse_args(args, v, 1) && (v[0] == 0.0f || v[0] == 1.0f))
+    {
+        mode_manager_set_current_recon((uint8_t)v[0]);
+    }
+    else if (cmd_match(line, "status", &args) && cmd_parse_args(args, v, 0))
+    {
+        mode_manager_status_t status;
+        mode_manager_get_status(&status);
+        printf("mode=%s aligned=%u offset=%.3f enc=%.1f obs=%.1f ref=%.1f id=%.2f iq=%.2f\n",
+               mode_manager_mode_name(status.mode), status.aligned, status.angle_offset,
+               status.speed_rpm_encoder, status.speed_rpm_observer, status.speed_rpm_ref, status.i_d, status.i_q);
+    }
+    else if (cmd_match(line, "prof", &args) && cmd_parse_args(args, v, 0))
+    {
+        isr_prof_print();
+    }
+    else if (cmd_match(line, "prof reset", &args) && cmd_parse_args(args, v, 0))
+    {
+        /* 控制中断在下一周期清零统计 */
+        isr_prof_reset();
+    }
+    else
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+void mode_manager_poll(void)
+{
+    uint8_t buf[16];
+    uint16_t num;
+
+    while ((num = usart1_read_data(buf, sizeof(buf))) > 0)
+    {
+        for (uint16_t i = 0; i < num; i++)
+        {
+            char c = (char)buf[i];
+
+            if (c != '\r' && c != '\n')
+            {
+                if (cmd_len < MODE_MANAGER_LINE_MAX - 1)
+                    cmd_line[cmd_len++] = c;
+                else
+                    cmd_overflow = 1;
+                continue;
+            }
+
+            /* 空行 (如 "\r\n" 的第二个字符) 忽略 */
+            if (cmd_len == 0 && !cmd_overflow)
+            {
+                continue;
+            }
+
+            cmd_line[cmd_len] = '\0';
+            int8_t ret = cmd_overflow ? -1 : mode_manager_command(cmd_line);
+            printf(ret == 0 ? "ok\n" : "err\n");
+            cmd_len = 0;
+            cmd_overflow = 0;
+        }
+    }
+}
+
+void mode_manager_get_status(mode_manager_status_t *status)
+{
+    status->mode = mm.mode;
+    status->align_next = mm.align_next;
+    status->aligned = mm.aligned;
+    status->sensorless_locked = (mm.mode == MOTOR_MODE_SENSORLESS && handover.state != IF_HANDOVER_IF);
+    status->align_count = mm.align_count;
+    status->switch_count = mm.switch_count;
+    status->angle_offset = angle_to_rad_pos(foc_handle.angle_offset);
+    status->speed_rpm_encoder = speed_rpm_encoder;
+    status->speed_rpm_observer = speed_rpm_observer;
+    status->speed_rpm_ref = mm.speed_ref;
+    status->angle_el_encoder = angle_el_encoder;
+    status->angle_el_observer = angle_el_observer;
+    status->i_d = i_d_temp;
+    status->i_q = i_q_temp;
+    status->slow_tasks = sched.ran;
+}
+
+const char *mode_manager_mode_name(motor_mode_t mode)
+{
+    return (mode < MOTOR_MODE_NUM) ? mode_names[mode] : "?";
+}
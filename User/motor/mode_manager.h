@@ -0,0 +1,210 @@
+#ifndef __MODE_MANAGER_H__
+#define __MODE_MANAGER_H__
+
+#include "foc/foc.h"
+#include "foc/luenberger.h"
+#include "foc/if_handover.h"
+#include "utils/ramp.h"
+#include "utils/telemetry.h"
+#include "utils/sched.h"
+
+/**
+ * 运行模式管理
+ *
+ * 持有唯一的 FOC 句柄、PI 控制器与 Luenberger 观测器, 运行中按请求在各模式之间切换,
+ * 不重新初始化:
+ *   - 主循环 (或串口命令) 通过 mode_manager_stop() 等函数投递请求, 控制中断在周期开始时取走并切换,
+ *     FOC 状态只在中断中修改
+ *   - 需要编码器角度的模式 (电流 / 速度 / 弱磁) 在未对齐时先自动对齐, 对齐在中断中逐周期完成,
+ *     不阻塞主循环; 对齐结果保留, 之后停机再启动不再对齐
+ *   - 闭环模式之间切换时保留电流环积分, 速度环积分预置为当前 Iq 指令, 速度斜坡从当前转速开始
+ *   - 观测器每个周期都运行, 转动中切换到无感模式时若观测转速已与编码器一致则直接进入观测器闭环,
+ *     静止时经 I/F 启动, 由 if_handover 按收敛指标无扰切换
+ *
+ * 串口命令 (USART1, 一行一条, '\r' 或 '\n' 结束, 回复 "ok" / "err"):
+ *   stop               停机 (50% 占空比)
+ *   align              重新对齐, 完成后停机
+ *   if <rpm> <iq>      I/F 电流开环
+ *   cur <id> <iq>      电流闭环 (编码器)
+ *   spd <rpm>          速度闭环 (编码器)
+ *   fw <rpm>           弱磁速度闭环 (编码器)
+ *   sl <rpm>           无感: I/F 启动 -> Luenberger 速度闭环
+ *   dec <0|1>          电流环解耦前馈开关 (不切换模式)
+ *   dt <0|1>           死区补偿开关 (不切换模式)
+ *   pwm <0..6>         调制方式: 0 SVPWM, 1 DPWM0, 2 DPWM1, 3 DPWM2, 4 DPWMMAX, 5 DPWMMIN, 6 混合 (不切换模式)
+ *   om <0|1>           过调制开关 (不切换模式)
+ *   dly <pwm> <enc>    角度延迟补偿: PWM 输出延迟、编码器读数延迟 (us, 0 为不补偿, 不切换模式)
+ *   rec <0|1>          两相电流重构开关 (不切换模式)
+ *   status             打印当前状态
+ *   prof               打印控制中断分阶段耗时统计 (isr_prof_print)
+ *   prof reset         清零耗时统计 (下一个控制周期生效)
+ * 当前模式下再次发送同一模式的命令只修改目标值。
+ */
+
+/* 对齐: d 轴电压 (V) 与持续时间 (ms) */
+#ifndef MODE_MANAGER_ALIGN_VOLTAGE
+#define MODE_MANAGER_ALIGN_VOLTAGE 1.0f
+#endif
+#ifndef MODE_MANAGER_ALIGN_MS
+#define MODE_MANAGER_ALIGN_MS 1000U
+#endif
+
+/* 速度指令斜坡 (RPM/s) */
+#ifndef MODE_MANAGER_SPEED_RAMP_RATE
+#define MODE_MANAGER_SPEED_RAMP_RATE 1000.0f
+#endif
+
+/*
+ * 多速率调度: 电流环与观测器每个控制周期执行, 速度环 (含指令斜坡) 每 MODE_MANAGER_SPEED_DIV 个周期执行一次,
+ * 与编码器转速刷新 (AS5047_SPEED_CALC_DIV) 同相, 每次都用新的转速样本, ki 按分频放大;
+ * 弱磁环每 MODE_MANAGER_FW_DIV 个周期执行一次, 放在速度环两次执行的正中间, 遥测抽取对齐到 1/4 处,
+ * 慢速任务互不重叠 (速度环分频不小于 4 时)。提高电流环频率时只需保持速度环周期 (MM_TS · MODE_MANAGER_SPEED_DIV) 不变,
+ * 默认分频按每个 PWM 周期的控制周期数 (PWM_DOUBLE_UPDATE) 放大, 速度环与弱磁环保持 1kHz。
+ */
+#ifndef MODE_MANAGER_SPEED_DIV
+#define MODE_MANAGER_SPEED_DIV (10U * MOTOR_CTRL_PER_PWM)
+#endif
+#ifndef MODE_MANAGER_FW_DIV
+#define MODE_MANAGER_FW_DIV (10U * MOTOR_CTRL_PER_PWM)
+#endif
+
+#if (MODE_MANAGER_SPEED_DIV % AS5047_SPEED_CALC_DIV) != 0
+#error "MODE_MANAGER_SPEED_DIV 须为 AS5047_SPEED_CALC_DIV 的整数倍"
+#endif
+#if (MODE_MANAGER_FW_DIV % MODE_MANAGER_SPEED_DIV) != 0
+#error "MODE_MANAGER_FW_DIV 须为 MODE_MANAGER_SPEED_DIV 的整数倍"
+#endif
+
+/* 慢速任务 (mode_manager_status_t.slow_tasks 的位) */
+#define MODE_MANAGER_TASK_SPEED 0x01U
+#define MODE_MANAGER_TASK_FLUX_WEAK 0x02U
+#define MODE_MANAGER_TASK_TELEMETRY 0x04U
+
+/* 无感启动: I/F 拖动转速 (RPM)、Iq (A); 转动中直接切入观测器时观测与编码器转速的允许误差 (RPM) */
+#define MODE_MANAGER_SL_IF_RPM 200.0f
+#define MODE_MANAGER_SL_IF_IQ 0.5f
+#define MODE_MANAGER_SL_SWITCH_ERR_RPM 50.0f
+
+/*
+ * 电流环解耦默认开关, 前馈使用的电机参数见 foc/motor_profile.h。
+ * 该电机 Rs 大而 L 小, 不解耦时反电势 ωψf 相当于很强的粘性阻尼, 现有速度环增益 (如 speed_closed 的 kp = 0.05)
+ * 是在这一阻尼下整定的; 解耦后电流环真正跟踪 Iq 指令, 速度环需按 kt / J 重新整定, 因此默认关闭,
+ * 可用 "dec 1" 在电流闭环下打开。
+ */
+#ifndef MODE_MANAGER_DECOUPLING
+#define MODE_MANAGER_DECOUPLING 0
+#endif
+
+/*
+ * 死区补偿: 开关、开关管导通压降 (V)、过渡区半宽 (A); 死区时间见 DEADTIME_COMP_T_DEAD。
+ * 补偿电压 (12V 时约 0.15V) 与该电机 Rs·I 同一量级, 压降与过渡区需按实测电流波形整定,
+ * 参数不匹配时相当于给速度环增加了一个电流前馈增益, 因此默认关闭, 用 "dt 1" 打开。
+ */
+#ifndef MODE_MANAGER_DEADTIME_COMP
+#define MODE_MANAGER_DEADTIME_COMP 0
+#endif
+#ifndef MODE_MANAGER_DEADTIME_V_DROP
+#define MODE_MANAGER_DEADTIME_V_DROP 0.0f
+#endif
+#ifndef MODE_MANAGER_DEADTIME_I_BAND
+#define MODE_MANAGER_DEADTIME_I_BAND 0.2f
+#endif
+
+/* 默认调制方式 (svpwm_mode_t), 见 svpwm.h */
+#ifndef MODE_MANAGER_PWM_MODE
+#define MODE_MANAGER_PWM_MODE SVPWM_MODE_SVPWM
+#endif
+
+/*
+ * 过调制默认关闭: 过调制区零矢量消失, 下桥电阻采样的窗口随之变窄直至消失,
+ * 硬件上需确认采样方式后再用 "om 1" 打开; 打开后弱磁起始电压与电压上限提高到 FOC_V_MAX_K_OVERMOD · Udc。
+ */
+#ifndef MODE_MANAGER_OVERMOD
+#define MODE_MANAGER_OVERMOD 0
+#endif
+
+/* 命令参数范围 */
+#define MODE_MANAGER_SPEED_MAX_RPM 4000.0f
+#define MODE_MANAGER_CURRENT_MAX 2.0f
+#define MODE_MANAGER_DELAY_MAX_US 500.0f
+
+/* 串口命令行最大长度 */
+#define MODE_MANAGER_LINE_MAX 32
+
+/* 运行模式 */
+typedef enum
+{
+    MOTOR_MODE_STOP = 0,   /* 停机 */
+    MOTOR_MODE_ALIGN,      /* 零点对齐 (进入编码器模式前自动插入) */
+    MOTOR_MODE_IF,         /* I/F 电流开环 */
+    MOTOR_MODE_CURRENT,    /* 电流闭环 */
+    MOTOR_MODE_SPEED,      /* 速度闭环 */
+    MOTOR_MODE_FLUX_WEAK,  /* 弱磁速度闭环 */
+    MOTOR_MODE_SENSORLESS, /* 无感 (I/F 启动 + Luenberger) */
+    MOTOR_MODE_NUM
+} motor_mode_t;
+
+/* 状态 (主循环读取, 仅用于显示与测试) */
+typedef struct
+{
+    motor_mode_t mode;          /* 当前模式 */
+    motor_mode_t align_next;    /* 对齐完成后进入的模式 */
+    uint8_t aligned;            /* 已对齐 */
+    uint8_t sensorless_locked;  /* 无感模式已切换到观测器角度 */
+    uint32_t align_count;       /* 累计对齐次数 */
+    uint32_t switch_count;      /* 累计模式切换次数 */
+    float angle_offset;         /* 编码器零点偏移 (rad, [0, 2π)) */
+    float speed_rpm_encoder;    /* 编码器转速 */
+    float speed_rpm_observer;   /* 观测转速 */
+    float speed_rpm_ref;        /* 斜坡后的速度指令 */
+    float angle_el_encoder;     /* 编码器电角度 (减零点, rad, [-π, π)) */
+    float angle_el_observer;    /* 观测电角度 (rad, [-π, π)) */
+    float i_d;                  /* dq 电流反馈 */
+    float i_q;
+    uint8_t slow_tasks;         /* 最近一个控制周期执行的慢速任务 (MODE_MANAGER_TASK_*) */
+} mode_manager_status_t;
+
+/* 初始化: 创建控制对象, 注册控制中断回调与遥测通道, 进入停机模式 (不对齐) */
+void mode_manager_init(void);
+
+/* 模式请求 (主循环调用, 下一个控制周期生效) */
+void mode_manager_stop(void);
+void mode_manager_align(void);
+void mode_manager_if(float speed_rpm, float iq);
+void mode_manager_current(float id, float iq);
+void mode_manager_speed(float speed_rpm);
+void mode_manager_flux_weak(float speed_rpm);
+void mode_manager_sensorless(float speed_rpm);
+
+/* 电流环解耦前馈开关 (任意模式下立即生效) */
+void mode_manager_set_decoupling(uint8_t enable);
+
+/* 死区补偿开关 (任意模式下立即生效) */
+void mode_manager_set_deadtime_comp(uint8_t enable);
+
+/* 调制方式 (任意模式下生效, 新占空比在下一个 PWM 更新事件即 ADC 触发时刻装载) */
+void mode_manager_set_pwm_mode(svpwm_mode_t mode);
+
+/* 过调制开关 (任意模式下生效) */
+void mode_manager_set_overmodulation(uint8_t enable);
+
+/* 角度延迟补偿 (s), 所有闭环模式共用, 见 foc_set_delay_comp (任意模式下生效) */
+void mode_manager_set_delay_comp(float pwm_ts, float encoder_ts);
+
+/* 两相电流重构开关, 默认 FOC_CURRENT_RECON (任意模式下生效) */
+void mode_manager_set_current_recon(uint8_t enable);
+
+/**
+ * @brief 执行一条文本命令
+ * @param line 命令行 (不含行尾)
+ * @return 0: 成功; -1: 命令或参数无效
+ */
+int8_t mode_manager_command(const char *line);
+
+/* 读取 USART1 接收 FIFO 并执行完整的命令行, 在主循环中调用 */
+void mode_manager_poll(void);
+
+void mode_manager_get_status(mode_manager_status_t *status);
+const char *mode_manager_mode_name(motor_mode_t mode);
+
+#endif /* __MODE_MANAGER_H__ */
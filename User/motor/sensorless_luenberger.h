@@ -4,17 +4,21 @@
 #include <stdio.h>
 #include "foc/luenberger.h"
 #include "foc/foc.h"
+#include "foc/if_handover.h"
 #include "utils/ramp.h"
 #include "utils/print.h"
+#include "utils/telemetry.h"
 
 // 状态定义
 typedef enum
 {
     LUENBERGER_STATE_IF_STARTUP, // IF启动阶段
+    LUENBERGER_STATE_HANDOVER,   // 已切换到速度闭环, 控制角由 IF 角过渡到观测角
     LUENBERGER_STATE_RUNNING     // Luenberger闭环运行阶段
 } luenberger_state_t;
 
 void sensorless_luenberger_init(float speed_rpm);
 void print_sensorless_luenberger_info(void);
+luenberger_state_t sensorless_luenberger_get_state(void);
 
 #endif /* __SENSORLESS_LUENBERGER_H__ */
@@ -13,7 +13,14 @@ static pid_controller_t pid_speed;
 
 // 状态变量
 static sensorless_state_t current_state = STATE_IF_STARTUP;
-static uint32_t switch_counter = 0;
+static if_handover_t handover;
+
+// 速度指令
+static float target_speed = 0.0f;       // 闭环目标转速
+static float target_speed_ramp = 0.0f;  // 斜坡后的速度指令
+static const float SPEED_RAMP_RATE = 1000.0f; // 闭环速度指令斜坡: 1000 RPM/s
+static const float IF_SPEED = 200.0f;         // I/F 拖动转速 (RPM)
+static const float IF_IQ = 0.5f;              // I/F 电流 (A)
 
 // 打印用
 static float speed_rpm_actual_temp = 0.0f;
@@ -21,51 +28,52 @@ static float angle_el_actual_temp = 0.0f;
 static float speed_rpm_smo_temp = 0.0f;
 static float angle_el_smo_temp = 0.0f;
 
-static void sensorless_smo_callback(void)
+static void sensorless_smo_callback(const adc_values_t *adc_values)
 {
     // 获取电流反馈值
-    adc_values_t adc_values;
-    adc1_get_injected_values(&adc_values);
+    foc_set_bus_voltage(&foc_smo_handle, adc_values->udc);
+    isr_prof_mark(ISR_PROF_ADC_READ);
 
     // Clark 变换
-    abc_t i_abc = {.a = adc_values.ia, .b = adc_values.ib, .c = adc_values.ic};
+    abc_t i_abc = foc_current_reconstruct(&foc_smo_handle, adc_values);
     alphabeta_t i_alphabeta = clark_transform(i_abc);
 
     // 获取SMO观测的电角度和速度
-    float angle_el_smo = smo_get_angle(&smo);
+    angle_t angle_el_smo = smo_get_angle(&smo);
     float speed_feedback_smo = smo_get_speed_rpm(&smo);
 
-    // 根据状态选择角度源
-    float angle_for_control;
-    if (current_state == STATE_IF_STARTUP)
-    {
-        angle_for_control = foc_smo_handle.open_loop_angle_el; // IF角度
-    }
-    else
-    {
-        angle_for_control = angle_el_smo; // SMO角度
-    }
+    // 控制角度: I/F 阶段为开环角, 切换后由开环角平滑过渡到 SMO 角度
+    angle_t angle_for_control = if_handover_update(&handover, foc_smo_handle.open_loop_angle_el, IF_SPEED,
+                                                 angle_el_smo, speed_feedback_smo);
 
     // Park 变换 - 使用选定的角度
-    dq_t i_dq = park_transform(i_alphabeta, angle_for_control);
+    foc_transform_set_angle(&foc_smo_handle.transform, angle_for_control);
+    dq_t i_dq = foc_transform_park(&foc_smo_handle.transform, i_alphabeta);
+    isr_prof_mark(ISR_PROF_CLARK_PARK);
 
     // 根据状态执行不同的控制
-    if (current_state == STATE_IF_STARTUP)
+    if (handover.state == IF_HANDOVER_IF)
     {
         // I/F 电流开环
-        foc_if_current_run(&foc_smo_handle, i_dq, 200.0f, 0.5f);
+        foc_if_current_run(&foc_smo_handle, i_dq, IF_SPEED, IF_IQ);
     }
     else
     {
+        if (handover.switch_event)
+        {
+            // 切换瞬间: 速度环积分预置为 I/F 电流在转子 q 轴上的投影, 速度指令从观测转速开始斜坡
+            foc_speed_loop_preload(&foc_smo_handle, if_handover_iq_preload(&handover, IF_IQ));
+            target_speed_ramp = speed_feedback_smo;
+        }
+
         // 速度闭环
+        target_speed_ramp = ramp_update(target_speed_ramp, target_speed, SPEED_RAMP_RATE, MOTOR_TS);
+        foc_set_target_speed(&foc_smo_handle, target_speed_ramp);
         foc_speed_closed_loop_run(&foc_smo_handle, i_dq, angle_for_control, speed_feedback_smo);
     }
 
-    // 获取Vd和Vq
-    dq_t v_dq = {.d = foc_smo_handle.v_d_out, .q = foc_smo_handle.v_q_out};
-
-    // 反Park变换 - 使用选定的角度
-    alphabeta_t v_alphabeta = ipark_transform(v_dq, angle_for_control);
+    // 本周期实际输出的 αβ 电压 (调制时已由变换上下文保存, 无需再次反 Park)
+    alphabeta_t v_alphabeta = foc_transform_get_v_alphabeta(&foc_smo_handle.transform);
 
     // 更新SMO
     smo.i_alpha = i_alphabeta.alpha;
@@ -73,85 +81,77 @@ static void sensorless_smo_callback(void)
     smo.u_alpha = v_alphabeta.alpha;
     smo.u_beta = v_alphabeta.beta;
     smo_estimate(&smo);
+    isr_prof_mark(ISR_PROF_OBSERVER);
 
-    // 切换逻辑
-    if (current_state == STATE_IF_STARTUP)
-    {
-        float speed_error = fabsf(200 - speed_feedback_smo);
-
-        if (speed_error < 50.0f)
-        {
-            switch_counter++;
-            if (switch_counter > 2000)
-            { // 持续100个周期(约2000ms)
-                current_state = STATE_SMO_RUNNING;
-                switch_counter = 0;
-            }
-        }
-        else
-        {
-            switch_counter = 0; // 不满足条件则清零
-        }
-    }
+    // 运行阶段
+    if (handover.state == IF_HANDOVER_IF)
+        current_state = STATE_IF_STARTUP;
+    else if (handover.state == IF_HANDOVER_BLEND)
+        current_state = STATE_HANDOVER;
+    else
+        current_state = STATE_SMO_RUNNING;
 
     // 打印
     as5047_update_speed();
     speed_rpm_actual_temp = as5047_get_speed_rpm();
-    angle_el_actual_temp = as5047_get_angle_rad() - foc_smo_handle.angle_offset;
+    angle_el_actual_temp = angle_to_rad_pos(as5047_get_angle_el() - foc_smo_handle.angle_offset);
+    isr_prof_mark(ISR_PROF_ENCODER);
     speed_rpm_smo_temp = speed_feedback_smo;
-    angle_el_smo_temp = angle_el_smo;
+    angle_el_smo_temp = angle_to_rad_pos(angle_el_smo);
 }
 
 void sensorless_smo_init(float speed_rpm)
 {
     // pid 初始化
-    pid_init(&pid_id, 0.017f, 0.002826f, -U_DC / 3.0f, U_DC / 3.0f);
-    pid_init(&pid_iq, 0.017f, 0.002826f, -U_DC / 3.0f, U_DC / 3.0f);
-    pid_init(&pid_speed, 0.005f, 0.000002f, -4.0f, 4.0f);
+    pid_init(&pid_id, MOTOR_CURRENT_KP, MOTOR_CURRENT_KI, -U_DC / 3.0f, U_DC / 3.0f);
+    pid_init(&pid_iq, MOTOR_CURRENT_KP, MOTOR_CURRENT_KI, -U_DC / 3.0f, U_DC / 3.0f);
+    pid_init(&pid_speed, 0.005f, 0.000002f * FOC_SPEED_KI_K, -4.0f, 4.0f);
 
     foc_init(&foc_smo_handle, &pid_id, &pid_iq, &pid_speed);
 
-    // 初始化 SMO 观测器
-    smo_init(&smo, 0.12f, 0.00003f, 7.0f, 0.0001f,
-             1.4f,   // k_slide - 滑模增益
-             0.3f,   // k_lpf - 低通滤波系数
-             3.0f,   // boundary - 边界层厚度
-             50.0f, // fc - PLL截止频率
-             0.02f); // k_speed_lpf - 速度滤波系数
+    // 初始化 SMO 观测器 (电机参数、F / G 与 PLL 增益取 motor_profile.h)
+    smo_init_profile(&smo,
+                     1.4f,   // k_slide - 滑模增益
+                     0.3f,   // k_lpf - 低通滤波系数
+                     3.0f,   // boundary - 边界层厚度
+                     0.02f); // k_speed_lpf - 速度滤波系数
 
     foc_set_target_id(&foc_smo_handle, 0.0f);
 
     foc_set_target_speed(&foc_smo_handle, speed_rpm);
+    target_speed = speed_rpm;
+    target_speed_ramp = 0.0f;
+
+    // I/F -> SMO 切换: 最低 100 RPM, 转速误差 < 30 RPM, 角度误差波动 < 0.1 rad, 持续 20ms, 角度偏差 20 rad/s 归零
+    if_handover_init(&handover, MOTOR_TS, 100.0f, 30.0f, 0.1f, 0.02f, 20.0f);
 
     // 初始化状态
     current_state = STATE_IF_STARTUP;
-    switch_counter = 0;
 
     // 零点对齐
     foc_alignment(&foc_smo_handle);
 
+    // 登记遥测通道 (与 print 函数输出顺序一致)
+    telemetry_clear_channels();
+    telemetry_add_channel(&speed_rpm_actual_temp, 4.0f);
+    telemetry_add_angle_channel(&angle_el_actual_temp);
+    telemetry_add_channel(&speed_rpm_smo_temp, 4.0f);
+    telemetry_add_angle_channel(&angle_el_smo_temp);
+
     adc1_register_injected_callback(sensorless_smo_callback);
 }
 
 void print_sensorless_smo_info(void)
 {
-    // 归一化角度到 [0, 2π) 范围
-    float angle_actual_normalized = fmodf(angle_el_actual_temp, 2.0f * M_PI);
-    if (angle_actual_normalized < 0.0f)
-    {
-        angle_actual_normalized += 2.0f * M_PI;
-    }
-
-    float angle_smo_normalized = fmodf(angle_el_smo_temp, 2.0f * M_PI);
-    if (angle_smo_normalized < 0.0f)
-    {
-        angle_smo_normalized += 2.0f * M_PI;
-    }
-
-    // 转换为角度 (0-360°)
-    float angle_actual_deg = angle_actual_normalized * 57.2958f;
-    float angle_smo_deg = angle_smo_normalized * 57.2958f;
+    // 转换为角度 (0-360°, 显示变量已在 [0, 2π) 内)
+    float angle_actual_deg = angle_el_actual_temp * 57.2958f;
+    float angle_smo_deg = angle_el_smo_temp * 57.2958f;
 
     float data[4] = {speed_rpm_actual_temp, angle_actual_deg, speed_rpm_smo_temp, angle_smo_deg};
     printf_vofa(data, 4);
-}
\ No newline at end of file
+}
+
+sensorless_state_t sensorless_smo_get_state(void)
+{
+    return current_state;
+}
@@ -4,16 +4,21 @@
 #include <stdio.h>
 #include "foc/smo.h"
 #include "foc/foc.h"
+#include "foc/if_handover.h"
+#include "utils/ramp.h"
 #include "utils/print.h"
+#include "utils/telemetry.h"
 
 // 状态定义
 typedef enum
 {
     STATE_IF_STARTUP, // IF启动阶段
+    STATE_HANDOVER,   // 已切换到速度闭环, 控制角由 IF 角过渡到观测角
     STATE_SMO_RUNNING // SMO闭环运行阶段
 } sensorless_state_t;
 
 void sensorless_smo_init(float speed_rpm);
 void print_sensorless_smo_info(void);
+sensorless_state_t sensorless_smo_get_state(void);
 
 #endif /* __SENSORLESS_SMO__H__ */
@@ -12,29 +12,32 @@ static pid_controller_t pid_speed;
 static float speed_rpm_temp = 0.0f;
 static float angle_el_temp = 0.0f;
 
-static void speed_closed_callback(void)
+static void speed_closed_callback(const adc_values_t *adc_values)
 {
     // 更新速度
     as5047_update_speed();
 
     // 获取角度和速度
-    float angle_el = as5047_get_angle_rad() - foc_speed_closed_handle.angle_offset;
     float speed_feedback = as5047_get_speed_rpm();
+    angle_t angle_el = foc_encoder_angle(&foc_speed_closed_handle, as5047_get_angle_el(), speed_feedback);
+    isr_prof_mark(ISR_PROF_ENCODER);
 
     // 打印用
     speed_rpm_temp = speed_feedback;
-    angle_el_temp = angle_el;
+    angle_el_temp = angle_to_rad_pos(angle_el);
 
     // 获取电流反馈值
-    adc_values_t adc_values;
-    adc1_get_injected_values(&adc_values);
+    foc_set_bus_voltage(&foc_speed_closed_handle, adc_values->udc);
+    isr_prof_mark(ISR_PROF_ADC_READ);
 
     // Clark 变换
-    abc_t i_abc = {.a = adc_values.ia, .b = adc_values.ib, .c = adc_values.ic};
+    abc_t i_abc = foc_current_reconstruct(&foc_speed_closed_handle, adc_values);
     alphabeta_t i_alphabeta = clark_transform(i_abc);
 
     // Park 变换
-    dq_t i_dq = park_transform(i_alphabeta, angle_el);
+    foc_transform_set_angle(&foc_speed_closed_handle.transform, angle_el);
+    dq_t i_dq = foc_transform_park(&foc_speed_closed_handle.transform, i_alphabeta);
+    isr_prof_mark(ISR_PROF_CLARK_PARK);
 
     // 速度闭环
     foc_speed_closed_loop_run(&foc_speed_closed_handle, i_dq, angle_el, speed_feedback);
@@ -43,9 +46,9 @@ static void speed_closed_callback(void)
 void speed_closed_init(float speed_rpm)
 {
     // 初始化速度环 PID 控制器
-    pid_init(&pid_id, 0.017f, 0.002826f, -U_DC / 2.0f, U_DC / 2.0f);
-    pid_init(&pid_iq, 0.017f, 0.002826f, -U_DC / 2.0f, U_DC / 2.0f);
-    pid_init(&pid_speed, 0.05f, 0.00002f, -2.0f, 2.0f);
+    pid_init(&pid_id, MOTOR_CURRENT_KP, MOTOR_CURRENT_KI, -U_DC / 2.0f, U_DC / 2.0f);
+    pid_init(&pid_iq, MOTOR_CURRENT_KP, MOTOR_CURRENT_KI, -U_DC / 2.0f, U_DC / 2.0f);
+    pid_init(&pid_speed, 0.05f, 0.00002f * FOC_SPEED_KI_K, -2.0f, 2.0f);
 
     // 初始化 FOC 控制句柄
     foc_init(&foc_speed_closed_handle, &pid_id, &pid_iq, &pid_speed);
@@ -57,19 +60,22 @@ void speed_closed_init(float speed_rpm)
     // 零点对齐
     foc_alignment(&foc_speed_closed_handle);
 
+    // 登记遥测通道 (与 print 函数输出顺序一致)
+    telemetry_clear_channels();
+    telemetry_add_channel(&speed_rpm_temp, 4.0f);
+    telemetry_add_angle_channel(&angle_el_temp);
+
+    // 速度环与编码器转速刷新同相: 第一次回调只记录角度, 之后每 FOC_SPEED_DIV 个周期同时刷新转速、执行速度环
+    as5047_speed_reset();
+
     // 注册回调函数
     adc1_register_injected_callback(speed_closed_callback);
 }
 
 void print_speed_info(void)
 {
-    // 归一化角度到 [0, 2π) 范围
-    float angle_normalized = fmodf(angle_el_temp, 2.0f * M_PI);
-    if (angle_normalized < 0.0f) {
-        angle_normalized += 2.0f * M_PI;
-    }
-    // 转换为角度 (0-360°)
-    float angle_deg = angle_normalized * 57.2958f;
+    // 转换为角度 (0-360°, 显示变量已在 [0, 2π) 内)
+    float angle_deg = angle_el_temp * 57.2958f;
     
     float data[2] = {speed_rpm_temp, angle_deg};
     printf_vofa(data, 2);
@@ -4,6 +4,7 @@
 #include "foc/foc.h"
 #include "bsp/as5047.h"
 #include "utils/print.h"
+#include "utils/telemetry.h"
 
 void speed_closed_init(float speed_rpm);
 void print_speed_info(void);
@@ -19,34 +19,34 @@ static float angle_el_luenberger = 0.0f;
 static float bemf_alpha_luenberger = 0.0f;
 static float bemf_beta_luenberger = 0.0f;
 
-static void speed_closed_with_luenberger_callback(void)
+static void speed_closed_with_luenberger_callback(const adc_values_t *adc_values)
 {
     // 更新编码器速度
     as5047_update_speed();
 
     // 获取编码器角度和速度
-    float angle_el = as5047_get_angle_rad() - foc_handle.angle_offset;
     float speed_feedback = as5047_get_speed_rpm();
+    angle_t angle_el = foc_encoder_angle(&foc_handle, as5047_get_angle_el(), speed_feedback);
+    isr_prof_mark(ISR_PROF_ENCODER);
 
     // 获取电流反馈值
-    adc_values_t adc_values;
-    adc1_get_injected_values(&adc_values);
+    foc_set_bus_voltage(&foc_handle, adc_values->udc);
+    isr_prof_mark(ISR_PROF_ADC_READ);
 
     // Clark 变换
-    abc_t i_abc = {.a = adc_values.ia, .b = adc_values.ib, .c = adc_values.ic};
+    abc_t i_abc = foc_current_reconstruct(&foc_handle, adc_values);
     alphabeta_t i_alphabeta = clark_transform(i_abc);
 
     // Park 变换（使用编码器角度）
-    dq_t i_dq = park_transform(i_alphabeta, angle_el);
+    foc_transform_set_angle(&foc_handle.transform, angle_el);
+    dq_t i_dq = foc_transform_park(&foc_handle.transform, i_alphabeta);
+    isr_prof_mark(ISR_PROF_CLARK_PARK);
 
     // 速度闭环控制（使用编码器反馈）
     foc_speed_closed_loop_run(&foc_handle, i_dq, angle_el, speed_feedback);
 
-    // 获取输出电压
-    dq_t v_dq = {.d = foc_handle.v_d_out, .q = foc_handle.v_q_out};
-
-    // 反Park变换（使用编码器角度）
-    alphabeta_t v_alphabeta = ipark_transform(v_dq, angle_el);
+    // 本周期实际输出的 αβ 电压 (调制时已由变换上下文保存, 无需再次反 Park)
+    alphabeta_t v_alphabeta = foc_transform_get_v_alphabeta(&foc_handle.transform);
 
     // 更新Luenberger观测器（仅用于观测对比）
     luenberger.i_alpha = i_alphabeta.alpha;
@@ -54,16 +54,17 @@ static void speed_closed_with_luenberger_callback(void)
     luenberger.u_alpha = v_alphabeta.alpha;
     luenberger.u_beta = v_alphabeta.beta;
     luenberger_estimate(&luenberger);
+    isr_prof_mark(ISR_PROF_OBSERVER);
 
     // 获取Luenberger观测值
-    float angle_luenberger = luenberger_get_angle(&luenberger);
+    angle_t angle_luenberger = luenberger_get_angle(&luenberger);
     float speed_luenberger = luenberger_get_speed_rpm(&luenberger);
 
     // 保存打印数据
     speed_rpm_encoder = speed_feedback;
-    angle_el_encoder = angle_el;
+    angle_el_encoder = angle_to_rad_pos(angle_el);
     speed_rpm_luenberger = speed_luenberger;
-    angle_el_luenberger = angle_luenberger;
+    angle_el_luenberger = angle_to_rad_pos(angle_luenberger);
     bemf_alpha_luenberger = luenberger.e_alpha_est; // 直接访问结构体成员
     bemf_beta_luenberger = luenberger.e_beta_est;
 }
@@ -71,15 +72,15 @@ static void speed_closed_with_luenberger_callback(void)
 void speed_closed_with_luenberger_init(float speed_rpm)
 {
     // PID 初始化
-    pid_init(&pid_id, 0.017f, 0.002826f, -U_DC / 3.0f, U_DC / 3.0f);
-    pid_init(&pid_iq, 0.017f, 0.002826f, -U_DC / 3.0f, U_DC / 3.0f);
-    pid_init(&pid_speed, 0.05f, 0.00002f, -4.0f, 4.0f);
+    pid_init(&pid_id, MOTOR_CURRENT_KP, MOTOR_CURRENT_KI, -U_DC / 3.0f, U_DC / 3.0f);
+    pid_init(&pid_iq, MOTOR_CURRENT_KP, MOTOR_CURRENT_KI, -U_DC / 3.0f, U_DC / 3.0f);
+    pid_init(&pid_speed, 0.05f, 0.00002f * FOC_SPEED_KI_K, -4.0f, 4.0f);
 
     // FOC 初始化
     foc_init(&foc_handle, &pid_id, &pid_iq, &pid_speed);
 
     // 初始化 Luenberger 观测器
-    luenberger_init(&luenberger, 0.12f, 0.00003f, 7.0f, 0.0001f,
+    luenberger_init(&luenberger, MOTOR_RS, MOTOR_LS, MOTOR_POLE_PAIRS, MOTOR_TS,
                     -12800.0f, // l1: 电流观测器增益
                     2112.0f,   // l2: 反电势观测器增益
                     100.0f,    // pll_fc: PLL截止频率 (Hz) - 提高带宽以适应高速
@@ -92,28 +93,27 @@ void speed_closed_with_luenberger_init(float speed_rpm)
     // 零点对齐
     foc_alignment(&foc_handle);
 
+    // 登记遥测通道 (与 print 函数输出顺序一致)
+    telemetry_clear_channels();
+    telemetry_add_channel(&speed_rpm_encoder, 4.0f);
+    telemetry_add_channel(&speed_rpm_luenberger, 4.0f);
+    telemetry_add_angle_channel(&angle_el_encoder);
+    telemetry_add_angle_channel(&angle_el_luenberger);
+    telemetry_add_channel(&bemf_alpha_luenberger, 1000.0f);
+    telemetry_add_channel(&bemf_beta_luenberger, 1000.0f);
+
+    // 速度环与编码器转速刷新同相: 第一次回调只记录角度, 之后每 FOC_SPEED_DIV 个周期同时刷新转速、执行速度环
+    as5047_speed_reset();
+
     // 注册回调函数
     adc1_register_injected_callback(speed_closed_with_luenberger_callback);
 }
 
 void print_speed_luenberger_info(void)
 {
-    // 归一化角度到 [0, 2π) 范围
-    float angle_encoder_normalized = fmodf(angle_el_encoder, 2.0f * M_PI);
-    if (angle_encoder_normalized < 0.0f)
-    {
-        angle_encoder_normalized += 2.0f * M_PI;
-    }
-
-    float angle_luenberger_normalized = fmodf(angle_el_luenberger, 2.0f * M_PI);
-    if (angle_luenberger_normalized < 0.0f)
-    {
-        angle_luenberger_normalized += 2.0f * M_PI;
-    }
-
-    // 转换为角度 (0-360°)
-    float angle_encoder_deg = angle_encoder_normalized * 57.2958f;
-    float angle_luenberger_deg = angle_luenberger_normalized * 57.2958f;
+    // 转换为角度 (0-360°, 显示变量已在 [0, 2π) 内)
+    float angle_encoder_deg = angle_el_encoder * 57.2958f;
+    float angle_luenberger_deg = angle_el_luenberger * 57.2958f;
 
     // 发送 JustFloat 协议数据
     float data[6] = {speed_rpm_encoder, speed_rpm_luenberger, angle_encoder_deg, angle_luenberger_deg, bemf_alpha_luenberger, bemf_beta_luenberger};
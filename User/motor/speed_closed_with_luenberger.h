@@ -6,6 +6,7 @@
 #include "foc/luenberger.h"
 #include "bsp/as5047.h"
 #include "utils/print.h"
+#include "utils/telemetry.h"
 
 /**
  * @brief 初始化有感速度闭环控制（同时运行Luenberger观测器）
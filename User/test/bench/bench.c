@@ -0,0 +1,327 @@
+#ifdef FOC_SIM_HOST
+
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#define BENCH_NAME_LEN 64
+#define BENCH_MAX_BASELINE 128
+
+/* 基线条目 */
+typedef struct
+{
+    char name[BENCH_NAME_LEN];
+    double median_ns;
+} bench_baseline_t;
+
+double bench_now_ns(void)
+{
+    struct timespec ts;
+#ifdef CLOCK_MONOTONIC_RAW
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static int bench_cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * 参考内核: 固定的浮点乘加 + 访存 + 数据相关分支, 指令构成与被测内核相近, 与被测代码无关。
+ * 与基线比较时各内核先除以参考内核的中位数, 抵消机器整体变快 / 变慢
+ * (降频、虚拟机争用、超线程上另一线程占用执行单元)。
+ */
+static volatile float bench_ref_sink;
+static float bench_ref_data[64];
+
+static void bench_ref_run(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+    {
+        float acc0 = 0.0f, acc1 = 0.0f;
+        for (uint32_t k = 0; k < 16; k++)
+        {
+            float x = bench_ref_data[(i + k) & 63];
+            if (x > 0.0f)
+                acc0 += x * 1.5f;
+            else
+                acc1 -= x * 0.75f;
+        }
+        bench_ref_sink = acc0 + acc1;
+    }
+}
+
+static void bench_ref_setup(void)
+{
+    uint32_t seed = 1;
+    for (uint32_t k = 0; k < 64; k++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        bench_ref_data[k] = (float)(int32_t)seed * (1.0f / 2147483648.0f);
+    }
+}
+
+static const bench_kernel_t bench_ref_kernel = {BENCH_REF_NAME, bench_ref_setup, bench_ref_run};
+
+/* 预热并标定每批调用次数, 使一批约耗时 BENCH_BATCH_NS */
+static uint32_t bench_calibrate(const bench_kernel_t *kernel)
+{
+    uint32_t batch = 64;
+    double start = bench_now_ns();
+    double elapsed = 0.0;
+
+    while (elapsed < BENCH_WARMUP_NS)
+    {
+        double t0 = bench_now_ns();
+        kernel->run(batch);
+        double dt = bench_now_ns() - t0;
+
+        if (dt < BENCH_BATCH_NS * 0.5 && batch < (1u << 24))
+            batch *= 2;
+        else if (dt > BENCH_BATCH_NS * 2.0 && batch > 1)
+            batch /= 2;
+
+        elapsed = bench_now_ns() - start;
+    }
+
+    return batch;
+}
+
+void bench_measure(const bench_kernel_t *kernel, uint32_t reps, uint32_t batch, double *samples)
+{
+    for (uint32_t r = 0; r < reps; r++)
+    {
+        double t0 = bench_now_ns();
+        kernel->run(batch);
+        samples[r] = (bench_now_ns() - t0) / batch;
+    }
+}
+
+/* 样本排序后取分位数, q ∈ [0, 1] */
+static double bench_quantile(double *samples, uint32_t num, double q)
+{
+    qsort(samples, num, sizeof(double), bench_cmp_double);
+
+    uint32_t index = (uint32_t)ceil(q * num);
+    return samples[(index > 0 ? index : 1) - 1];
+}
+
+/* 读取基线 CSV, 返回条目数, 失败返回 -1 */
+static int bench_load_baseline(const char *path, bench_baseline_t *baseline, int max_num)
+{
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL)
+        return -1;
+
+    char line[256];
+    int num = 0;
+
+    while (fgets(line, sizeof(line), fp) != NULL && num < max_num)
+    {
+        char name[BENCH_NAME_LEN];
+        double median;
+
+        /* 跳过表头与注释 */
+        if (line[0] == '#' || strncmp(line, "kernel,", 7) == 0)
+            continue;
+        if (sscanf(line, "%63[^,],%lf", name, &median) == 2)
+        {
+            strcpy(baseline[num].name, name);
+            baseline[num].median_ns = median;
+            num++;
+        }
+    }
+
+    fclose(fp);
+    return num;
+}
+
+static const bench_baseline_t *bench_find_baseline(const bench_baseline_t *baseline, int num, const char *name)
+{
+    for (int i = 0; i < num; i++)
+    {
+        if (strcmp(baseline[i].name, name) == 0)
+            return &baseline[i];
+    }
+    return NULL;
+}
+
+int bench_main(const bench_kernel_t *kernels, uint32_t num, int argc, char **argv)
+{
+    const char *csv_path = NULL;
+    const char *baseline_path = NULL;
+    const char *filter = NULL;
+    double threshold = BENCH_DEFAULT_THRESHOLD;
+    uint32_t reps = BENCH_DEFAULT_REPS;
+    uint32_t rounds = BENCH_DEFAULT_ROUNDS;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+            csv_path = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)
+            baseline_path = argv[++i];
+        else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+            threshold = atof(argv[++i]);
+        else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc)
+            reps = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+            rounds = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else
+        {
+            fprintf(stderr, "usage: %s [--csv FILE] [--baseline FILE] [--threshold PCT] [--reps N] [--rounds N] [--filter STR]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    if (reps == 0)
+        reps = BENCH_DEFAULT_REPS;
+    if (rounds == 0)
+        rounds = BENCH_DEFAULT_ROUNDS;
+
+    static bench_baseline_t baseline[BENCH_MAX_BASELINE];
+    int baseline_num = 0;
+    if (baseline_path != NULL)
+    {
+        baseline_num = bench_load_baseline(baseline_path, baseline, BENCH_MAX_BASELINE);
+        if (baseline_num < 0)
+        {
+            fprintf(stderr, "cannot open baseline %s\n", baseline_path);
+            return 2;
+        }
+    }
+
+    FILE *csv = NULL;
+    if (csv_path != NULL)
+    {
+        csv = fopen(csv_path, "w");
+        if (csv == NULL)
+        {
+            fprintf(stderr, "cannot write %s\n", csv_path);
+            return 2;
+        }
+        fprintf(csv, "kernel,median_ns,p99_ns,min_ns,batch\n");
+    }
+
+    printf("%-26s %10s %10s %10s %8s", "kernel", "median ns", "p99 ns", "min ns", "batch");
+    if (baseline_path != NULL)
+        printf(" %10s %8s", "base ns", "delta");
+    printf("\n");
+
+    /* 参考内核放在第 0 项, 总是运行 */
+    uint32_t total = num + 1;
+    const bench_kernel_t **list = malloc(total * sizeof(bench_kernel_t *));
+    list[0] = &bench_ref_kernel;
+    for (uint32_t k = 0; k < num; k++)
+        list[k + 1] = &kernels[k];
+
+    /* 各内核的样本与结果; 按轮交错测量, 一段时间的系统噪声只影响每个内核的一轮 */
+    bench_result_t *results = calloc(total, sizeof(bench_result_t));
+    double *samples = malloc((size_t)total * rounds * reps * sizeof(double));
+    double *round_samples = malloc(reps * sizeof(double));
+
+    for (uint32_t round = 0; round < rounds; round++)
+    {
+        for (uint32_t k = 0; k < total; k++)
+        {
+            if (k > 0 && filter != NULL && strstr(list[k]->name, filter) == NULL)
+                continue;
+
+            if (round == 0)
+            {
+                if (list[k]->setup != NULL)
+                    list[k]->setup();
+                results[k].batch = bench_calibrate(list[k]);
+            }
+
+            bench_measure(list[k], reps, results[k].batch, round_samples);
+            memcpy(&samples[((size_t)k * rounds + round) * reps], round_samples, reps * sizeof(double));
+
+            /* 中位数取各轮中位数的最小值 */
+            double median = bench_quantile(round_samples, reps, 0.5);
+            if (round == 0 || median < results[k].median_ns)
+                results[k].median_ns = median;
+        }
+    }
+
+    /* 机器速度比例: 当前参考内核 / 基线参考内核 */
+    double scale = 1.0;
+    if (baseline_path != NULL)
+    {
+        const bench_baseline_t *base_ref = bench_find_baseline(baseline, baseline_num, BENCH_REF_NAME);
+        if (base_ref != NULL)
+            scale = results[0].median_ns / base_ref->median_ns;
+    }
+
+    int regressions = 0;
+
+    for (uint32_t k = 0; k < total; k++)
+    {
+        if (k > 0 && filter != NULL && strstr(list[k]->name, filter) == NULL)
+            continue;
+
+        /* p99 / min 取全部样本 */
+        bench_result_t *result = &results[k];
+        double *all = &samples[(size_t)k * rounds * reps];
+        result->p99_ns = bench_quantile(all, rounds * reps, 0.99);
+        result->min_ns = all[0];
+
+        printf("%-26s %10.2f %10.2f %10.2f %8u", list[k]->name, result->median_ns, result->p99_ns, result->min_ns,
+               result->batch);
+
+        if (baseline_path != NULL)
+        {
+            const bench_baseline_t *base = bench_find_baseline(baseline, baseline_num, list[k]->name);
+            if (base == NULL)
+            {
+                printf(" %10s %8s", "-", "new");
+            }
+            else if (k == 0)
+            {
+                printf(" %10.2f %+7.1f%%  (machine speed)", base->median_ns, (scale - 1.0) * 100.0);
+            }
+            else
+            {
+                /* 按参考内核归一化后比较 */
+                double delta = (result->median_ns / (base->median_ns * scale) - 1.0) * 100.0;
+                uint8_t regressed = delta > threshold;
+                regressions += regressed;
+                printf(" %10.2f %+7.1f%%%s", base->median_ns, delta, regressed ? "  REGRESSION" : "");
+            }
+        }
+        printf("\n");
+
+        if (csv != NULL)
+            fprintf(csv, "%s,%.3f,%.3f,%.3f,%u\n", list[k]->name, result->median_ns, result->p99_ns, result->min_ns,
+                    result->batch);
+    }
+
+    free(round_samples);
+    free(samples);
+    free(results);
+    free(list);
+
+    if (csv != NULL)
+        fclose(csv);
+
+    if (baseline_path != NULL)
+    {
+        printf("\n%s (%d kernel(s) slower than baseline by more than %.1f%%)\n",
+               regressions ? "REGRESSION" : "NO REGRESSION", regressions, threshold);
+    }
+
+    return regressions ? 1 : 0;
+}
+
+#endif /* FOC_SIM_HOST */
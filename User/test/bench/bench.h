@@ -0,0 +1,73 @@
+/**
+ * @file bench.h
+ * @brief 主机端微基准框架 (ns/call, 中位数 / p99, CSV 输出, 基线回归判定)
+ *
+ * 每个被测内核提供一个批量函数 run(calls): 在函数内部循环调用被测代码 calls 次,
+ * 框架只在批次之间读取时钟, 时钟与间接调用的开销被整批摊薄。
+ *
+ * 测量流程:
+ *   1. 每个内核先 setup() 初始化状态, 再预热: 连续运行至少 BENCH_WARMUP_NS,
+ *      同时按目标批次时长标定每批调用次数;
+ *   2. 采样按轮进行, 每轮依次测量所有内核 reps 个批次, 每批得到一个 ns/call 样本;
+ *   3. 中位数取各轮中位数的最小值, p99 / min 取全部样本。
+ *      交错测量使一段时间的系统噪声 (其他进程、降频) 只影响每个内核的一轮。
+ *
+ * 回归判定只比较中位数: 各内核先按参考内核 (BENCH_REF_NAME, 固定的浮点乘加 / 访存 / 分支) 的中位数归一化,
+ * 抵消机器整体速度的变化, 再与基线比较, 超过 (1 + threshold%) 即判为回归, bench_main() 返回非零。
+ */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#ifdef FOC_SIM_HOST
+
+#include <stdint.h>
+
+#define BENCH_WARMUP_NS 20000000.0   /* 预热时长 20 ms */
+#define BENCH_BATCH_NS 50000.0       /* 目标批次时长 50 us */
+#define BENCH_DEFAULT_REPS 21        /* 默认每轮采样批次数 */
+#define BENCH_DEFAULT_ROUNDS 31      /* 默认轮数 (多而短的轮次, 噪声只污染少数轮) */
+#define BENCH_DEFAULT_THRESHOLD 15.0 /* 默认回归阈值 (%) */
+#define BENCH_REF_NAME "bench_reference"  /* 参考内核名称 (结果 / 基线 CSV 的第一行) */
+#define BENCH_INPUT_NUM 1024         /* 输入样本表长度 (2 的幂) */
+#define BENCH_INPUT_MASK (BENCH_INPUT_NUM - 1)
+
+/* 被测内核 */
+typedef struct
+{
+    const char *name;
+    void (*setup)(void);         /* 可为 NULL */
+    void (*run)(uint32_t calls); /* 循环调用被测代码 calls 次 */
+} bench_kernel_t;
+
+/* 单个内核的统计结果 */
+typedef struct
+{
+    double min_ns;
+    double median_ns;
+    double p99_ns;
+    uint32_t batch;              /* 每批调用次数 */
+} bench_result_t;
+
+/* 高精度单调时钟 (ns) */
+double bench_now_ns(void);
+
+/* 运行 reps 个批次, 每批 batch 次调用, samples 得到每批的 ns/call */
+void bench_measure(const bench_kernel_t *kernel, uint32_t reps, uint32_t batch, double *samples);
+
+/**
+ * @brief 基准程序入口
+ * @note  命令行参数:
+ *          --csv FILE        结果写入 CSV (kernel,median_ns,p99_ns,min_ns,batch), 可直接作为基线
+ *          --baseline FILE   与基线 CSV 比较中位数
+ *          --threshold PCT   回归阈值, 默认 BENCH_DEFAULT_THRESHOLD
+ *          --reps N          每轮每个内核的采样批次数, 默认 BENCH_DEFAULT_REPS
+ *          --rounds N        轮数, 默认 BENCH_DEFAULT_ROUNDS
+ *          --filter STR      只运行名称包含 STR 的内核
+ * @return 0: 无回归; 1: 存在回归; 2: 参数或文件错误
+ */
+int bench_main(const bench_kernel_t *kernels, uint32_t num, int argc, char **argv);
+
+#endif /* FOC_SIM_HOST */
+
+#endif /* __BENCH_H__ */
@@ -0,0 +1,400 @@
+/**
+ * @file bench_foc.c
+ * @brief FOC 热路径内核基准（主机端）
+ *
+ * 编译命令（在 User 目录下运行）：
+ *   gcc -DFOC_SIM_HOST -std=gnu11 -O2 -I test/sim/hal -I . test/bench/bench.c test/bench/bench_foc.c \
+ *       foc/clark_park.c foc/svpwm.c foc/pid.c foc/smo.c foc/luenberger.c foc/flux_weakening.c \
+ *       foc/foc_transform.c foc/clark_park_q15.c foc/svpwm_q15.c foc/pid_q15.c foc/smo_q15.c foc/luenberger_q15.c \
+ *       -lm -o bench_foc
+ *
+ * 运行：
+ *   ./bench_foc                                        打印 ns/call 表
+ *   ./bench_foc --baseline test/bench/baseline.csv     与基线比较, 中位数变慢超过 15% 返回非零
+ *   ./bench_foc --csv test/bench/baseline.csv          在基准机器上更新基线
+ *
+ * 基线只在同一台机器、同一编译器与编译选项下有意义; 为减少噪声可用 taskset 绑定到单个核。
+ * 每个内核的输入取自预先生成的随机样本表, 避免常量折叠与分支预测对固定输入的偏向。
+ */
+
+#ifdef FOC_SIM_HOST
+
+#include <stdlib.h>
+#include <math.h>
+
+#include "bench.h"
+#include "foc/clark_park.h"
+#include "foc/svpwm.h"
+#include "foc/pid.h"
+#include "foc/smo.h"
+#include "foc/luenberger.h"
+#include "foc/flux_weakening.h"
+#include "foc/foc_transform.h"
+#include "foc/foc_math.h"
+
+#define BENCH_TWO_PI 6.28318530718f
+
+/* 防止编译器优化掉计算结果 */
+static volatile float sink_f;
+static volatile int32_t sink_i;
+
+/* 输入样本表 */
+static struct
+{
+    abc_t i_abc[BENCH_INPUT_NUM];       /* 平衡三相电流 (A) */
+    alphabeta_t i_ab[BENCH_INPUT_NUM];  /* αβ 电流 (A) */
+    alphabeta_t u_ab[BENCH_INPUT_NUM];  /* αβ 电压 (V), 含过调制 */
+    dq_t v_dq[BENCH_INPUT_NUM];         /* dq 电压 (V) */
+    float theta[BENCH_INPUT_NUM];       /* 电角度 (rad) */
+    angle_t theta_el[BENCH_INPUT_NUM];  /* 同一电角度, 整数表示 (2^32 = 2π) */
+    float err[BENCH_INPUT_NUM];         /* PI 反馈 (A) */
+    alphabeta_t motor_i[BENCH_INPUT_NUM]; /* 观测器输入: 匀速旋转的 PMSM 电流 (A) */
+    alphabeta_t motor_u[BENCH_INPUT_NUM]; /* 观测器输入: 对应的端电压 (V) */
+
+    abc_q15_t i_abc_q[BENCH_INPUT_NUM];
+    alphabeta_q15_t i_ab_q[BENCH_INPUT_NUM];
+    alphabeta_q15_t u_ab_q[BENCH_INPUT_NUM];
+    dq_q15_t v_dq_q[BENCH_INPUT_NUM];
+    uint16_t theta_q[BENCH_INPUT_NUM];
+    q15_t err_q[BENCH_INPUT_NUM];
+    alphabeta_q15_t motor_i_q[BENCH_INPUT_NUM];
+    alphabeta_q15_t motor_u_q[BENCH_INPUT_NUM];
+} in;
+
+static float bench_rand(float amplitude)
+{
+    return ((float)rand() / RAND_MAX * 2.0f - 1.0f) * amplitude;
+}
+
+static void bench_input_init(void)
+{
+    srand(1);
+
+    for (int i = 0; i < BENCH_INPUT_NUM; i++)
+    {
+        float ia = bench_rand(8.0f), ib = bench_rand(8.0f);
+        in.i_abc[i] = (abc_t){ia, ib, -ia - ib};
+        in.i_ab[i] = (alphabeta_t){bench_rand(8.0f), bench_rand(8.0f)};
+
+        float mag = (float)rand() / RAND_MAX * 0.7f * U_DC;
+        float angle = (float)rand() / RAND_MAX * BENCH_TWO_PI;
+        in.u_ab[i] = (alphabeta_t){mag * cosf(angle), mag * sinf(angle)};
+        in.v_dq[i] = (dq_t){bench_rand(3.0f), bench_rand(6.0f)};
+        in.theta[i] = (float)rand() / RAND_MAX * BENCH_TWO_PI;
+        in.theta_el[i] = angle_from_rad(in.theta[i]);
+        in.err[i] = bench_rand(2.0f);
+
+        in.i_abc_q[i] = (abc_q15_t){FOC_Q15_CURRENT(in.i_abc[i].a), FOC_Q15_CURRENT(in.i_abc[i].b),
+                                    FOC_Q15_CURRENT(in.i_abc[i].c)};
+        in.i_ab_q[i] = (alphabeta_q15_t){FOC_Q15_CURRENT(in.i_ab[i].alpha), FOC_Q15_CURRENT(in.i_ab[i].beta)};
+        in.u_ab_q[i] = (alphabeta_q15_t){FOC_Q15_VOLTAGE(in.u_ab[i].alpha), FOC_Q15_VOLTAGE(in.u_ab[i].beta)};
+        in.v_dq_q[i] = (dq_q15_t){FOC_Q15_VOLTAGE(in.v_dq[i].d), FOC_Q15_VOLTAGE(in.v_dq[i].q)};
+        in.theta_q[i] = QANGLE_FROM_RAD(in.theta[i]);
+        in.err_q[i] = FOC_Q15_CURRENT(in.err[i]);
+
+        /*
+         * 观测器输入为连续的电机信号 (样本表恰好 10 个电周期, 循环无跳变), 保证观测器状态有界,
+         * 与实际运行的数值范围一致; id = 0, iq = 2 A, Rs / Ls / ψf 与 motor/ 下的参数相同
+         */
+        float we = 10.0f * BENCH_TWO_PI / (BENCH_INPUT_NUM * 0.0001f);
+        float th = (float)i * 10.0f * BENCH_TWO_PI / BENCH_INPUT_NUM;
+        float sn = sinf(th), cs = cosf(th), iq = 2.0f;
+        in.motor_i[i] = (alphabeta_t){-iq * sn, iq * cs};
+        in.motor_u[i] = (alphabeta_t){0.12f * -iq * sn - 0.00003f * we * iq * cs - we * 0.0015f * sn,
+                                      0.12f * iq * cs - 0.00003f * we * iq * sn + we * 0.0015f * cs};
+        in.motor_i_q[i] = (alphabeta_q15_t){FOC_Q15_CURRENT(in.motor_i[i].alpha), FOC_Q15_CURRENT(in.motor_i[i].beta)};
+        in.motor_u_q[i] = (alphabeta_q15_t){FOC_Q15_VOLTAGE(in.motor_u[i].alpha), FOC_Q15_VOLTAGE(in.motor_u[i].beta)};
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  浮点内核                                                            */
+/* ------------------------------------------------------------------ */
+static void run_fast_sin_cos(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+    {
+        float s, c;
+        fast_sin_cos(in.theta[i & BENCH_INPUT_MASK], &s, &c);
+        sink_f = s + c;
+    }
+}
+
+static void run_clark(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+        sink_f = clark_transform(in.i_abc[i & BENCH_INPUT_MASK]).beta;
+}
+
+static void run_park(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+    {
+        uint32_t k = i & BENCH_INPUT_MASK;
+        sink_f = park_transform(in.i_ab[k], in.theta_el[k]).q;
+    }
+}
+
+static void run_ipark(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+    {
+        uint32_t k = i & BENCH_INPUT_MASK;
+        sink_f = ipark_transform(in.v_dq[k], in.theta_el[k]).beta;
+    }
+}
+
+static void run_svpwm_sector1(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+        sink_f = svpwm_sector1(in.u_ab[i & BENCH_INPUT_MASK], SVPWM_INV_UDC).a;
+}
+
+static void run_svpwm_sector2(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+        sink_f = svpwm_sector2(in.u_ab[i & BENCH_INPUT_MASK], SVPWM_INV_UDC).a;
+}
+
+static void run_svpwm_minmax(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+        sink_f = svpwm_minmax(in.u_ab[i & BENCH_INPUT_MASK], SVPWM_INV_UDC).a;
+}
+
+static pid_controller_t pid;
+
+static void setup_pid(void)
+{
+    pid_init(&pid, 0.017f, 0.002826f, -U_DC / 3.0f, U_DC / 3.0f);
+}
+
+static void run_pid(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+        sink_f = pid_calculate(&pid, 1.0f, in.err[i & BENCH_INPUT_MASK]);
+}
+
+static smo_t smo;
+
+static void setup_smo(void)
+{
+    smo_init(&smo, 0.12f, 0.00003f, 7.0f, 0.0001f, 1.4f, 0.3f, 3.0f, 50.0f, 0.02f);
+}
+
+static void run_smo(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+    {
+        uint32_t k = i & BENCH_INPUT_MASK;
+        smo.i_alpha = in.motor_i[k].alpha;
+        smo.i_beta = in.motor_i[k].beta;
+        smo.u_alpha = in.motor_u[k].alpha;
+        smo.u_beta = in.motor_u[k].beta;
+        smo_estimate(&smo);
+        sink_i = (int32_t)smo.theta_comp;
+    }
+}
+
+static luenberger_t luenberger;
+
+static void setup_luenberger(void)
+{
+    luenberger_init(&luenberger, 0.12f, 0.00003f, 7.0f, 0.0001f, -13000.0f, 2200.0f, 50.0f, 0.05f);
+}
+
+static void run_luenberger(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+    {
+        uint32_t k = i & BENCH_INPUT_MASK;
+        luenberger.i_alpha = in.motor_i[k].alpha;
+        luenberger.i_beta = in.motor_i[k].beta;
+        luenberger.u_alpha = in.motor_u[k].alpha;
+        luenberger.u_beta = in.motor_u[k].beta;
+        luenberger_estimate(&luenberger);
+        sink_i = (int32_t)luenberger.theta_est;
+    }
+}
+
+static flux_weak_t flux_weak;
+
+static void setup_flux_weak(void)
+{
+    flux_weak_init(&flux_weak, U_DC, 0.95f, 0.0005f, -5.0f);
+}
+
+static void run_flux_weak(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+    {
+        uint32_t k = i & BENCH_INPUT_MASK;
+        sink_f = flux_weak_calculate(&flux_weak, in.v_dq[k].d, in.v_dq[k].q);
+    }
+}
+
+/*
+ * 单个控制周期的变换链: Park、控制输出的反 Park + SVPWM、观测器所需的 αβ 电压
+ * tick_separate 为各模式回调原来的调用序列 (三次 sin/cos), tick_transform 使用变换上下文 (一次)。
+ * 两者使用同一个调制器 (svpwm_modulate, 含扇区记录), 差别只在 sin/cos 的次数;
+ * 主机 CPU 乱序执行, 相互独立的 sin/cos 部分重叠, Cortex-M4 上每次的耗时直接累加, 节省更明显
+ */
+static svpwm_modulator_t tick_modulator;
+
+static void setup_tick_separate(void)
+{
+    svpwm_modulator_init(&tick_modulator, SVPWM_MODE_SVPWM);
+}
+
+static void run_tick_separate(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+    {
+        uint32_t k = i & BENCH_INPUT_MASK;
+        dq_t i_dq = park_transform(in.i_ab[k], in.theta_el[k]);
+        abc_t duty = svpwm_modulate(&tick_modulator, ipark_transform(in.v_dq[k], in.theta_el[k]), SVPWM_INV_UDC);
+        alphabeta_t v_ab = ipark_transform(in.v_dq[k], in.theta_el[k]);
+        sink_f = i_dq.q + duty.a + v_ab.alpha;
+    }
+}
+
+static foc_transform_t transform;
+
+static void setup_tick_transform(void)
+{
+    foc_transform_init(&transform);
+}
+
+static void run_tick_transform(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+    {
+        uint32_t k = i & BENCH_INPUT_MASK;
+        foc_transform_set_angle(&transform, in.theta_el[k]);
+        dq_t i_dq = foc_transform_park(&transform, in.i_ab[k]);
+        abc_t duty = foc_transform_modulate(&transform, in.v_dq[k]);
+        alphabeta_t v_ab = foc_transform_get_v_alphabeta(&transform);
+        sink_f = i_dq.q + duty.a + v_ab.alpha;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  Q15 定点内核                                                        */
+/* ------------------------------------------------------------------ */
+static void run_clark_q15(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+        sink_i = clark_transform_q15(in.i_abc_q[i & BENCH_INPUT_MASK]).beta;
+}
+
+static void run_park_q15(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+    {
+        uint32_t k = i & BENCH_INPUT_MASK;
+        sink_i = park_transform_q15(in.i_ab_q[k], in.theta_q[k]).q;
+    }
+}
+
+static void run_ipark_q15(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+    {
+        uint32_t k = i & BENCH_INPUT_MASK;
+        sink_i = ipark_transform_q15(in.v_dq_q[k], in.theta_q[k]).beta;
+    }
+}
+
+static void run_svpwm_q15(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+        sink_i = svpwm_update_q15(in.u_ab_q[i & BENCH_INPUT_MASK]).a;
+}
+
+static pid_q15_t pid_q;
+
+static void setup_pid_q15(void)
+{
+    pid_q15_init(&pid_q, PID_Q15_GAIN(0.017f, FOC_Q15_I_BASE, FOC_Q15_U_BASE),
+                 PID_Q15_GAIN(0.002826f, FOC_Q15_I_BASE, FOC_Q15_U_BASE), FOC_Q15_VOLTAGE(-U_DC / 3.0f),
+                 FOC_Q15_VOLTAGE(U_DC / 3.0f));
+}
+
+static void run_pid_q15(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+        sink_i = pid_q15_calculate(&pid_q, FOC_Q15_CURRENT(1.0f), in.err_q[i & BENCH_INPUT_MASK]);
+}
+
+static smo_q15_t smo_q;
+
+static void setup_smo_q15(void)
+{
+    smo_q15_init(&smo_q, 0.12f, 0.00003f, 7.0f, 0.0001f, 1.4f, 0.3f, 3.0f, 50.0f, 0.02f);
+}
+
+static void run_smo_q15(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+    {
+        uint32_t k = i & BENCH_INPUT_MASK;
+        smo_q.i_alpha = in.motor_i_q[k].alpha;
+        smo_q.i_beta = in.motor_i_q[k].beta;
+        smo_q.u_alpha = in.motor_u_q[k].alpha;
+        smo_q.u_beta = in.motor_u_q[k].beta;
+        smo_q15_estimate(&smo_q);
+        sink_i = smo_q.theta_comp;
+    }
+}
+
+static luenberger_q15_t luenberger_q;
+
+static void setup_luenberger_q15(void)
+{
+    luenberger_q15_init(&luenberger_q, 0.12f, 0.00003f, 7.0f, 0.0001f, -13000.0f, 2200.0f, 50.0f, 0.05f);
+}
+
+static void run_luenberger_q15(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+    {
+        uint32_t k = i & BENCH_INPUT_MASK;
+        luenberger_q.i_alpha = in.motor_i_q[k].alpha;
+        luenberger_q.i_beta = in.motor_i_q[k].beta;
+        luenberger_q.u_alpha = in.motor_u_q[k].alpha;
+        luenberger_q.u_beta = in.motor_u_q[k].beta;
+        luenberger_q15_estimate(&luenberger_q);
+        sink_i = (int32_t)luenberger_q.theta_est;
+    }
+}
+
+static const bench_kernel_t kernels[] = {
+    {"fast_sin_cos", NULL, run_fast_sin_cos},
+    {"clark_transform", NULL, run_clark},
+    {"park_transform", NULL, run_park},
+    {"ipark_transform", NULL, run_ipark},
+    {"svpwm_sector1", NULL, run_svpwm_sector1},
+    {"svpwm_sector2", NULL, run_svpwm_sector2},
+    {"svpwm_minmax", NULL, run_svpwm_minmax},
+    {"pid_calculate", setup_pid, run_pid},
+    {"smo_estimate", setup_smo, run_smo},
+    {"luenberger_estimate", setup_luenberger, run_luenberger},
+    {"flux_weak_calculate", setup_flux_weak, run_flux_weak},
+    {"tick_separate", setup_tick_separate, run_tick_separate},
+    {"tick_transform", setup_tick_transform, run_tick_transform},
+    {"clark_transform_q15", NULL, run_clark_q15},
+    {"park_transform_q15", NULL, run_park_q15},
+    {"ipark_transform_q15", NULL, run_ipark_q15},
+    {"svpwm_update_q15", NULL, run_svpwm_q15},
+    {"pid_q15_calculate", setup_pid_q15, run_pid_q15},
+    {"smo_q15_estimate", setup_smo_q15, run_smo_q15},
+    {"luenberger_q15_estimate", setup_luenberger_q15, run_luenberger_q15},
+};
+
+int main(int argc, char **argv)
+{
+    bench_input_init();
+    return bench_main(kernels, sizeof(kernels) / sizeof(kernels[0]), argc, argv);
+}
+
+#endif /* FOC_SIM_HOST */
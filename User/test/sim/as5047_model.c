@@ -0,0 +1,93 @@
+#ifdef FOC_SIM_HOST
+
+#include "as5047_model.h"
+#include <string.h>
+
+#define MODEL_REG_NOP 0x0000
+#define MODEL_REG_ERRFL 0x0001
+#define MODEL_REG_DIAAGC 0x3FFC
+#define MODEL_REG_MAG 0x3FFD
+#define MODEL_REG_ANGLEUNC 0x3FFE
+#define MODEL_REG_ANGLECOM 0x3FFF
+
+/* 低 15 位中 1 的个数为奇数时返回 1 */
+static uint16_t model_parity15(uint16_t frame)
+{
+    return (uint16_t)(__builtin_popcount(frame & 0x7FFFu) & 1u);
+}
+
+uint16_t as5047_model_with_parity(uint16_t frame)
+{
+    frame &= 0x7FFF;
+    return frame | (uint16_t)(model_parity15(frame) << 15);
+}
+
+void as5047_model_init(as5047_model_t *model, uint16_t angle)
+{
+    memset(model, 0, sizeof(*model));
+    model->angle = angle & 0x3FFF;
+    model->cmd_prev = as5047_model_with_parity(0x4000 | MODEL_REG_NOP);
+}
+
+/* 读寄存器 */
+static uint16_t model_read(as5047_model_t *model, uint16_t addr)
+{
+    uint16_t data;
+
+    switch (addr)
+    {
+    case MODEL_REG_ERRFL:
+        data = model->errfl;
+        model->errfl = 0; /* 读后清零 */
+        break;
+    case MODEL_REG_DIAAGC:
+        data = 0x0100; /* LF = 1: 内部偏移环路已完成 */
+        break;
+    case MODEL_REG_MAG:
+        data = 0x1000;
+        break;
+    case MODEL_REG_ANGLEUNC:
+    case MODEL_REG_ANGLECOM:
+        data = model->angle;
+        break;
+    default:
+        data = 0;
+        break;
+    }
+
+    return data & 0x3FFF;
+}
+
+uint16_t as5047_model_transfer(as5047_model_t *model, uint16_t mosi)
+{
+    /* CS 下降沿: 装入上一帧命令的响应 */
+    uint16_t miso = 0;
+    if (model->cmd_prev & 0x4000)
+    {
+        miso = model_read(model, model->cmd_prev & 0x3FFF);
+    }
+    if (model->ef)
+    {
+        miso |= 0x4000;
+        model->ef = 0;
+    }
+    miso = as5047_model_with_parity(miso);
+
+    /* CS 上升沿: 执行本帧命令 */
+    if (model_parity15(mosi) != (mosi >> 15))
+    {
+        model->errfl |= AS5047_MODEL_ERR_PARERR;
+        model->ef = 1;
+        model->cmd_parity_error++;
+        model->cmd_prev = 0; /* 不执行 */
+    }
+    else
+    {
+        model->cmd_prev = mosi;
+    }
+
+    model->frame_count++;
+    return miso;
+}
+
+#endif /* FOC_SIM_HOST */
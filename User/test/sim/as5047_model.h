@@ -0,0 +1,42 @@
+#ifndef __AS5047_MODEL_H__
+#define __AS5047_MODEL_H__
+
+#include <stdint.h>
+
+/* ERRFL 位定义 */
+#define AS5047_MODEL_ERR_FRERR   0x0001 /* 帧错误 */
+#define AS5047_MODEL_ERR_INVCOMM 0x0002 /* 无效命令 */
+#define AS5047_MODEL_ERR_PARERR  0x0004 /* 命令帧奇偶校验错误 */
+
+/**
+ * AS5047P SPI 从机模型
+ *
+ * - 每帧在 CS 下降沿装入上一帧命令的响应 (读 ANGLECOM 时取此刻的角度)
+ * - 命令帧在 CS 上升沿执行: 校验失败时置位 ERRFL.PARERR, 下一帧响应的 EF 置位
+ * - 读 ERRFL 后清零
+ * - 响应帧 bit15 为偶校验
+ */
+typedef struct
+{
+    uint16_t angle;      /* 当前角度码值 (0~16383) */
+    uint16_t errfl;      /* ERRFL 寄存器 */
+    uint16_t cmd_prev;   /* 上一帧执行的命令 */
+    uint8_t ef;          /* 上一帧命令出错, 下一帧响应 EF 置位 */
+
+    uint32_t frame_count;
+    uint32_t cmd_parity_error; /* 收到的命令帧校验错误数 */
+} as5047_model_t;
+
+void as5047_model_init(as5047_model_t *model, uint16_t angle);
+
+/**
+ * @brief 一帧 SPI 传输 (CS 下降沿 -> 16 个时钟 -> CS 上升沿)
+ * @param mosi 主机发送的命令
+ * @return 从机返回的响应
+ */
+uint16_t as5047_model_transfer(as5047_model_t *model, uint16_t mosi);
+
+/* 16 位偶校验帧: 计算 bit15 */
+uint16_t as5047_model_with_parity(uint16_t frame);
+
+#endif /* __AS5047_MODEL_H__ */
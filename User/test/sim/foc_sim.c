@@ -0,0 +1,522 @@
+#ifdef FOC_SIM_HOST
+
+#include "foc_sim.h"
+#include <string.h>
+#include <math.h>
+#include "bsp/adc.h"
+#include "bsp/tim.h"
+#include "bsp/as5047.h"
+#include "bsp/usart.h"
+#include "utils/print.h"
+#include "utils/isr_prof.h"
+#include "utils/telemetry.h"
+#include "foc/svpwm.h"
+#include "motor/mode_manager.h"
+#include "as5047_model.h"
+
+#define SIM_TWO_PI 6.28318530718f
+
+/* 编码器默认读数延迟: CS 下降沿 (更新事件前 TIM1_ENCODER_CS_LEAD 个计数) 锁存 + 传感器传播延迟, 与硬件一致 */
+#define SIM_ENCODER_LATENCY ((float)TIM1_ENCODER_CS_LEAD / TIM1_CLK_FREQ + AS5047_SENSOR_DELAY_TS)
+#define SIM_VOFA_MAX_CH 32
+#define SIM_UART_RX_SIZE 256
+
+/* 仿真状态 */
+static struct
+{
+    pmsm_model_t plant;
+    uint32_t tick;
+
+    /* ADC 注入组 */
+    adc_injected_callback_p callback;
+    uint16_t adc_injected_buf[4];
+    adc_scale_t adc_scale;
+
+    /* TIM1 占空比: 预装载值 / 当前周期生效值 */
+    float duty_shadow[3];
+    float duty_active[3];
+
+    /* AS5047P: 传感器模型 + 周期采集状态 */
+    float encoder_offset;
+    float encoder_latency; /* 角度锁存时刻早于电流采样的时间 (s) */
+
+    /* 下桥电阻采样: 下桥导通时间短于该值的相采样无效 (s), 0 为理想采样 */
+    float adc_min_window;
+    uint32_t adc_invalid_count;
+
+    /* 单电阻采样: 预装载 / 当前周期 / 上一周期 (本次采样所在周期) 的移相结果, 窗口不足时保持的电流 */
+    uint8_t single_shunt;
+    svpwm_single_shunt_t ss_shadow;
+    svpwm_single_shunt_t ss_active;
+    svpwm_single_shunt_t ss_sampled;
+
+    /* 注入组换算结果: 每周期在中断中换算一次并传给控制回调, 单电阻窗口不足时保持上一次的电流 */
+    adc_values_t adc_values;
+
+    as5047_model_t encoder;
+    uint8_t encoder_running;
+    uint16_t encoder_tx;
+
+    /* printf_vofa 最近一帧 */
+    float vofa[SIM_VOFA_MAX_CH];
+    uint16_t vofa_num;
+
+    /* USART1 接收 FIFO */
+    uint8_t uart_rx[SIM_UART_RX_SIZE];
+    uint16_t uart_rx_head;
+    uint16_t uart_rx_tail;
+} sim;
+
+static void sim_adc_injected_convert(void);
+
+/* 12 位 ADC 量化 */
+static uint16_t sim_adc_quantize(float voltage)
+{
+    float code = voltage * 4096.0f / 3.3f;
+    if (code < 0.0f)
+        code = 0.0f;
+    if (code > 4095.0f)
+        code = 4095.0f;
+    return (uint16_t)lrintf(code);
+}
+
+/*
+ * 单电阻采样: 向下计数半周期 τ 时刻 (峰值后经过的时间 / 半周期) 的母线电流, τ < duty_down 的相上桥导通。
+ * 距上一次翻转不足最小窗口 (死区 + 振荡稳定), 或采样保持期间有翻转时, 读到零电流
+ */
+static float sim_single_shunt_current(const svpwm_single_shunt_t *ss, float tau, const float i_abc[3])
+{
+    /* 翻转时刻与采样点的比较值各自取整, 间隔可能差一到两个计数 (约 10ns), 不计为无效 */
+    const float settle = (sim.adc_min_window * TIM1_CLK_FREQ - 2.0f) / TIM1_PERIOD;
+    const float hold = (float)(TIM1_SS_SAMPLE - 2) / TIM1_PERIOD;
+    float prev_edge = -1.0f, next_edge = 1.0f, i_dc = 0.0f;
+
+    for (int i = 0; i < 3; i++)
+    {
+        float edge = ss->duty_down[i];
+        if (edge < 1.0f)
+        {
+            if (edge <= tau && edge > prev_edge)
+                prev_edge = edge;
+            if (edge > tau && edge < next_edge)
+                next_edge = edge;
+        }
+        if (tau < edge)
+            i_dc += i_abc[i];
+    }
+
+    if (tau - prev_edge < settle || next_edge - tau < hold)
+    {
+        sim.adc_invalid_count++;
+        return 0.0f;
+    }
+    return i_dc;
+}
+
+/* 采样: 相电流/母线电压 -> ADC 码值, 转子角度 -> 编码器码值 */
+static void sim_sample(void)
+{
+    pmsm_model_t *plant = &sim.plant;
+
+    float i_abc[3] = {plant->ia, plant->ib, plant->ic};
+    if (sim.single_shunt)
+    {
+        /* 两次采样都在上一个周期的向下计数半周期, 按该周期的移相结果计算母线电流 */
+        sim.adc_injected_buf[0] = sim_adc_quantize(
+            ADC_REF_VOLTAGE + sim_single_shunt_current(&sim.ss_sampled, sim.ss_sampled.sample[0], i_abc) / ADC_CURRENT_SCALE);
+        sim.adc_injected_buf[1] = sim_adc_quantize(
+            ADC_REF_VOLTAGE + sim_single_shunt_current(&sim.ss_sampled, sim.ss_sampled.sample[1], i_abc) / ADC_CURRENT_SCALE);
+        sim.adc_injected_buf[2] = sim_adc_quantize(ADC_REF_VOLTAGE);
+    }
+    else
+    {
+        /* 采样时刻下桥尚未导通 (或仍在开关振荡中) 的相, 采样电阻上没有相电流, 读到零电流 */
+        for (int i = 0; i < 3; i++)
+        {
+            if ((1.0f - sim.duty_active[i]) * MOTOR_PWM_TS < sim.adc_min_window)
+            {
+                i_abc[i] = 0.0f;
+                sim.adc_invalid_count++;
+            }
+        }
+
+        sim.adc_injected_buf[0] = sim_adc_quantize(ADC_REF_VOLTAGE + i_abc[0] / ADC_CURRENT_SCALE);
+        sim.adc_injected_buf[1] = sim_adc_quantize(ADC_REF_VOLTAGE + i_abc[1] / ADC_CURRENT_SCALE);
+        sim.adc_injected_buf[2] = sim_adc_quantize(ADC_REF_VOLTAGE + i_abc[2] / ADC_CURRENT_SCALE);
+    }
+    sim.adc_injected_buf[3] = sim_adc_quantize(plant->param.u_dc / ADC_UDC_SCALE);
+
+    /* 锁存时刻的机械角: 延迟只有几个周期以内, 按当前转速外推 */
+    float angle = fmodf(plant->theta_m - plant->omega_m * sim.encoder_latency + sim.encoder_offset, SIM_TWO_PI);
+    if (angle < 0.0f)
+        angle += SIM_TWO_PI;
+    sim.encoder.angle = (uint16_t)(angle / SIM_TWO_PI * AS5047_RESOLUTION) & (AS5047_RESOLUTION - 1);
+}
+
+/* AS5047P 传输接口: 阻塞帧与周期帧都经过传感器模型 */
+static void sim_as5047_init(void)
+{
+}
+
+static uint16_t sim_as5047_transfer(uint16_t tx)
+{
+    return as5047_model_transfer(&sim.encoder, tx);
+}
+
+static void sim_as5047_start(uint16_t tx)
+{
+    sim.encoder_tx = tx;
+    sim.encoder_running = 1;
+}
+
+/* 仿真中帧在控制回调之前完成 */
+static uint8_t sim_as5047_busy(void)
+{
+    return 0;
+}
+
+static const as5047_transport_t sim_as5047_transport = {
+    .init = sim_as5047_init,
+    .transfer = sim_as5047_transfer,
+    .start = sim_as5047_start,
+    .busy = sim_as5047_busy,
+};
+
+void foc_sim_init(const pmsm_param_t *param)
+{
+    pmsm_param_t default_param;
+
+    if (param == NULL)
+    {
+        pmsm_model_default_param(&default_param);
+        param = &default_param;
+    }
+
+    memset(&sim, 0, sizeof(sim));
+
+    /* 默认不统计中断耗时 (clock_gettime 开销较大), 需要时在用例中调用 isr_prof_init() */
+    isr_prof_stop();
+
+    pmsm_model_init(&sim.plant, param);
+
+    /* 仿真中零点偏移为 0 */
+    adc_offset_t offset = {0};
+    adc1_scale_init(&sim.adc_scale, &offset);
+
+    for (int i = 0; i < 3; i++)
+    {
+        sim.duty_shadow[i] = 0.5f;
+        sim.duty_active[i] = 0.5f;
+    }
+    foc_sim_set_single_shunt(ADC_SINGLE_SHUNT);
+
+    /* 真实的 bsp/as5047.c 驱动, 传输接口替换为传感器模型 */
+    sim.encoder_latency = SIM_ENCODER_LATENCY;
+    as5047_model_init(&sim.encoder, 0);
+    sim_sample();
+    as5047_set_transport(&sim_as5047_transport);
+    as5047_init();
+}
+
+pmsm_model_t *foc_sim_start(float udc)
+{
+    pmsm_param_t param;
+
+    pmsm_model_default_param(&param);
+    param.u_dc = udc;
+    foc_sim_init(&param);
+    mode_manager_init();
+    return &sim.plant;
+}
+
+void foc_sim_set_encoder_offset(float offset_rad)
+{
+    sim.encoder_offset = offset_rad;
+    sim_sample();
+}
+
+void foc_sim_step(void)
+{
+    /* TIM1 更新事件触发注入组转换, 转换完成进入中断 */
+    isr_prof_begin();
+    sim_sample();
+
+    /* 编码器帧 (TIM1 触发的 DMA) 在注入组转换期间完成 */
+    if (sim.encoder_running)
+    {
+        sim.encoder_tx = as5047_frame_isr(as5047_model_transfer(&sim.encoder, sim.encoder_tx));
+    }
+    sim_adc_injected_convert();
+    isr_prof_mark(ISR_PROF_ADC_READ);
+
+    if (sim.callback != NULL)
+    {
+        sim.callback(&sim.adc_values);
+    }
+    telemetry_sample();
+    isr_prof_end();
+
+    /* 本周期按上一次更新事件装载的占空比输出 */
+    pmsm_model_step(&sim.plant, sim.duty_active[0], sim.duty_active[1], sim.duty_active[2], FOC_SIM_TS);
+
+    /* 下一次更新事件: 预装载值生效 */
+    sim.duty_active[0] = sim.duty_shadow[0];
+    sim.duty_active[1] = sim.duty_shadow[1];
+    sim.duty_active[2] = sim.duty_shadow[2];
+    sim.ss_sampled = sim.ss_active;
+    sim.ss_active = sim.ss_shadow;
+
+    sim.tick++;
+}
+
+void foc_sim_run(float seconds)
+{
+    uint32_t ticks = (uint32_t)(seconds * FOC_SIM_TICKS_PER_SEC + 0.5f);
+
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        foc_sim_step();
+    }
+}
+
+void foc_sim_set_adc_window(float min_window_s)
+{
+    sim.adc_min_window = min_window_s;
+}
+
+uint32_t foc_sim_get_adc_invalid_count(void)
+{
+    return sim.adc_invalid_count;
+}
+
+void foc_sim_set_single_shunt(uint8_t enable)
+{
+    sim.single_shunt = enable;
+
+    /* 移相结果按当前占空比重新计算, 保持电流清零 */
+    memset(&sim.adc_values, 0, sizeof(sim.adc_values));
+    tim1_set_pwm_duty(sim.duty_shadow[0], sim.duty_shadow[1], sim.duty_shadow[2]);
+    sim.ss_active = sim.ss_shadow;
+    sim.ss_sampled = sim.ss_shadow;
+}
+
+void foc_sim_set_encoder_latency(float latency_s)
+{
+    sim.encoder_latency = latency_s;
+    sim_sample();
+}
+
+float foc_sim_get_encoder_latency(void)
+{
+    return sim.encoder_latency;
+}
+
+pmsm_model_t *foc_sim_get_plant(void)
+{
+    return &sim.plant;
+}
+
+uint32_t foc_sim_get_ticks(void)
+{
+    return sim.tick;
+}
+
+float foc_sim_get_time(void)
+{
+    return (float)sim.tick * FOC_SIM_TS;
+}
+
+void foc_sim_measure_iq_error(uint32_t ticks, foc_sim_iq_error_t *result)
+{
+    mode_manager_status_t status;
+    uint32_t invalid0 = sim.adc_invalid_count;
+    float rpm_sum = 0.0f;
+    float err_sq_sum = 0.0f;
+    float err_max = 0.0f;
+
+    for (uint32_t n = 0; n < ticks; n++)
+    {
+        foc_sim_step();
+        mode_manager_get_status(&status);
+        float e = status.i_q - sim.plant.iq;
+        rpm_sum += pmsm_model_get_speed_rpm(&sim.plant);
+        err_sq_sum += e * e;
+        err_max = fmaxf(err_max, fabsf(e));
+    }
+
+    result->rpm = rpm_sum / (float)ticks;
+    result->iq_err_rms = sqrtf(err_sq_sum / (float)ticks);
+    result->iq_err_max = err_max;
+    result->invalid = sim.adc_invalid_count - invalid0;
+}
+
+void foc_sim_get_duty(float *duty_a, float *duty_b, float *duty_c)
+{
+    *duty_a = sim.duty_active[0];
+    *duty_b = sim.duty_active[1];
+    *duty_c = sim.duty_active[2];
+}
+
+uint16_t foc_sim_get_vofa(float *data, uint16_t max_num)
+{
+    uint16_t num = (sim.vofa_num < max_num) ? sim.vofa_num : max_num;
+    memcpy(data, sim.vofa, num * sizeof(float));
+    return num;
+}
+
+void foc_sim_uart_rx(const char *data)
+{
+    while (*data != '\0')
+    {
+        uint16_t next = (sim.uart_rx_head + 1) % SIM_UART_RX_SIZE;
+        if (next == sim.uart_rx_tail)
+            break; /* 与固件 FIFO 相同, 满时丢弃 */
+        sim.uart_rx[sim.uart_rx_head] = (uint8_t)*data++;
+        sim.uart_rx_head = next;
+    }
+}
+
+/*----------------------------------------- HAL -----------------------------------------*/
+
+uint32_t HAL_GetTick(void)
+{
+    return sim.tick / (FOC_SIM_TICKS_PER_SEC / 1000U);
+}
+
+void HAL_Delay(uint32_t delay_ms)
+{
+    uint32_t ticks = delay_ms * (FOC_SIM_TICKS_PER_SEC / 1000U);
+
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        foc_sim_step();
+    }
+}
+
+/*----------------------------------------- TIM1 -----------------------------------------*/
+
+void tim1_init(void)
+{
+}
+
+/* 与硬件相同, 按 ARR 量化为比较值 */
+static float sim_duty_quantize(float duty)
+{
+    float compare = duty * TIM1_PERIOD;
+    if (compare < 0.0f)
+        compare = 0.0f;
+    if (compare > TIM1_PERIOD)
+        compare = TIM1_PERIOD;
+    return (float)(uint32_t)compare / TIM1_PERIOD;
+}
+
+void tim1_set_pwm_duty(float duty1, float duty2, float duty3)
+{
+    float duty[3] = {duty1, duty2, duty3};
+
+    if (!sim.single_shunt)
+    {
+        for (int i = 0; i < 3; i++)
+            sim.duty_shadow[i] = sim_duty_quantize(duty[i]);
+        return;
+    }
+
+    /* 单电阻采样: 与 bsp/tim.c 相同的移相, 前后半周期分别量化; 平均值模型使用两个半周期的平均占空比 */
+    svpwm_single_shunt_t *ss = &sim.ss_shadow;
+    svpwm_single_shunt(ss, duty1, duty2, duty3, (float)TIM1_SS_MIN_WINDOW / TIM1_PERIOD,
+                       (float)TIM1_SS_SAMPLE / TIM1_PERIOD);
+    for (int i = 0; i < 3; i++)
+    {
+        ss->duty_up[i] = sim_duty_quantize(ss->duty_up[i]);
+        ss->duty_down[i] = sim_duty_quantize(ss->duty_down[i]);
+        sim.duty_shadow[i] = 0.5f * (ss->duty_up[i] + ss->duty_down[i]);
+    }
+    ss->sample[0] = sim_duty_quantize(ss->sample[0]);
+    ss->sample[1] = sim_duty_quantize(ss->sample[1]);
+}
+
+uint8_t tim1_single_shunt_sampled(uint8_t *phase_min, uint8_t *phase_max)
+{
+    *phase_min = sim.ss_sampled.phase[0];
+    *phase_max = sim.ss_sampled.phase[1];
+    return sim.ss_sampled.valid;
+}
+
+void tim3_init(void)
+{
+}
+
+/*----------------------------------------- ADC1 -----------------------------------------*/
+
+void adc1_init(void)
+{
+}
+
+void adc1_get_offset(adc_offset_t *offsets)
+{
+    offsets->ia_offset = 0.0f;
+    offsets->ib_offset = 0.0f;
+    offsets->ic_offset = 0.0f;
+}
+
+/* 与 bsp/adc.c 的 adc1_injected_convert 相同的换算 */
+static void sim_adc_injected_convert(void)
+{
+    if (!sim.single_shunt)
+    {
+        adc1_scale_convert(&sim.adc_scale, sim.adc_injected_buf[0], sim.adc_injected_buf[1],
+                           sim.adc_injected_buf[2], sim.adc_injected_buf[3], &sim.adc_values);
+        return;
+    }
+
+    /* 单电阻采样: 窗口不足的周期保持上一次的电流 */
+    uint8_t phase_min, phase_max;
+    if (tim1_single_shunt_sampled(&phase_min, &phase_max))
+    {
+        adc1_single_shunt_convert(&sim.adc_scale, sim.adc_injected_buf[0], sim.adc_injected_buf[1], phase_min, phase_max,
+                                  &sim.adc_values);
+    }
+    sim.adc_values.udc = sim.adc_scale.udc_gain * (float)sim.adc_injected_buf[3];
+}
+
+/* 仿真中规则组与注入组采样相同 */
+void adc1_get_regular_values(adc_values_t *values)
+{
+    *values = sim.adc_values;
+}
+
+void adc1_get_injected_values(adc_values_t *values)
+{
+    *values = sim.adc_values;
+}
+
+void adc1_register_injected_callback(adc_injected_callback_p callback)
+{
+    sim.callback = callback;
+}
+
+/*----------------------------------------- USART1 -----------------------------------------*/
+
+uint16_t usart1_read_data(uint8_t *buf, uint16_t max_size)
+{
+    uint16_t i;
+    for (i = 0; i < max_size && sim.uart_rx_tail != sim.uart_rx_head; i++)
+    {
+        buf[i] = sim.uart_rx[sim.uart_rx_tail];
+        sim.uart_rx_tail = (sim.uart_rx_tail + 1) % SIM_UART_RX_SIZE;
+    }
+    return i;
+}
+
+/*----------------------------------------- print -----------------------------------------*/
+
+void printf_vofa(float *data, uint16_t num)
+{
+    if (num > SIM_VOFA_MAX_CH)
+        num = SIM_VOFA_MAX_CH;
+
+    memcpy(sim.vofa, data, num * sizeof(float));
+    sim.vofa_num = num;
+}
+
+#endif /* FOC_SIM_HOST */
@@ -0,0 +1,131 @@
+/**
+ * @file foc_sim.h
+ * @brief 主机端软件在环 (SIL) 仿真引擎
+ *
+ * 用被控对象模型 (pmsm_model) 替代真实的 TIM1 / ADC1 / AS5047P:
+ * - tim1_set_pwm_duty() 写入 CCR 预装载值, 在下一次更新事件生效 (与硬件一致, 一拍延迟)
+ * - 一步为一个更新事件间隔: 单更新为一个 PWM 周期, 双更新 (PWM_DOUBLE_UPDATE) 为半个周期 (谷底 -> 峰值或峰值 -> 谷底),
+ *   中心对齐 PWM 在任一半周期内的平均桥臂电压都是 duty · Udc, 平均值模型不变
+ * - 每个更新事件按 12 位 ADC 量化相电流和母线电压; 可设置下桥电阻采样的最小窗口 (foc_sim_set_adc_window),
+ *   下桥导通时间 (1 - duty) · Tpwm 不足的相读到零电流
+ * - 单电阻采样 (foc_sim_set_single_shunt, 默认 ADC_SINGLE_SHUNT): tim1_set_pwm_duty() 与 bsp/tim.c 相同地移相,
+ *   在上一个周期的向下计数半周期两个采样时刻按开关状态合成母线电流, 重构与 bsp/adc.c 相同;
+ *   此时采样窗口为翻转后的死区 + 振荡稳定时间, 不足或采样保持期间翻转的采样读到零电流
+ * - 编码器使用真实的 bsp/as5047.c 驱动, 传输接口替换为 AS5047P 传感器模型 (as5047_model),
+ *   每个周期完成一帧流水线读取, 与固件中 TIM1 触发的 DMA 采集一致;
+ *   角度取电流采样之前 encoder_latency 时刻的转子位置 (默认为 CS 提前量 + AS5047_SENSOR_DELAY_TS)
+ * - 随后调用 adc1_register_injected_callback() 注册的控制回调与 telemetry_sample(), 与注入组中断时序一致
+ * - usart1_read_data() 读取 foc_sim_uart_rx() 写入的数据, 模拟上位机经 USART1 发送的命令
+ * - HAL_Delay() 推进仿真时间, 因此 foc_alignment() 的对齐过程也在模型上真实发生
+ * - 每个周期以 isr_prof_begin() / isr_prof_end() 包围, 与固件 ADC1_2_IRQHandler 一致
+ *
+ * 仅在定义 FOC_SIM_HOST 时编译, 固件工程中这些源文件为空。
+ */
+
+#ifndef __FOC_SIM_H__
+#define __FOC_SIM_H__
+
+#include <stdint.h>
+#include "pmsm_model.h"
+#include "foc/motor_profile.h"
+
+/* 控制周期 (s), 与固件一致: 10kHz, 双更新 (PWM_DOUBLE_UPDATE) 时为半个 PWM 周期 */
+#define FOC_SIM_TS MOTOR_TS
+
+/* 每秒控制周期数 */
+#define FOC_SIM_TICKS_PER_SEC MOTOR_CTRL_FREQ
+
+/**
+ * @brief 复位仿真 (被控对象、BSP 桩状态、已注册回调、仿真时钟)
+ * @param param 电机参数, 传 NULL 使用 pmsm_model_default_param()
+ */
+void foc_sim_init(const pmsm_param_t *param);
+
+/**
+ * @brief 按指定母线电压复位仿真 (其余参数取 pmsm_model_default_param()) 并初始化模式管理器
+ * @param udc 母线电压 (V)
+ * @return 被控对象
+ */
+pmsm_model_t *foc_sim_start(float udc);
+
+/**
+ * @brief 设置编码器安装偏移 (机械角, rad), 需在 foc_sim_init() 之后调用
+ */
+void foc_sim_set_encoder_offset(float offset_rad);
+
+/**
+ * @brief 设置下桥电阻采样的最小窗口 (s, 死区 + 振荡稳定 + ADC 采样时间), 需在 foc_sim_init() 之后调用
+ * @note  默认 0 (理想采样); 用于验证两相电流重构 (foc_current_reconstruct)
+ */
+void foc_sim_set_adc_window(float min_window_s);
+
+/* 因采样窗口不足而无效的相采样次数 (单电阻采样时为母线电流采样次数) */
+uint32_t foc_sim_get_adc_invalid_count(void);
+
+/**
+ * @brief 选择单电阻 (直流母线电阻) 采样, 需在 foc_sim_init() 之后调用
+ * @note  固件中由编译选项 ADC_SINGLE_SHUNT 选择, 仿真中可运行时切换以便与三电阻采样对比
+ */
+void foc_sim_set_single_shunt(uint8_t enable);
+
+/**
+ * @brief 设置编码器读数延迟 (角度锁存时刻早于电流采样的时间, s), 需在 foc_sim_init() 之后调用
+ * @note  用于验证 foc_set_delay_comp 的编码器延迟补偿, 如模拟读 ANGLEUNC 时的传感器传播延迟
+ */
+void foc_sim_set_encoder_latency(float latency_s);
+float foc_sim_get_encoder_latency(void);
+
+/**
+ * @brief 推进一个控制周期 (更新事件间隔): 采样 -> 控制回调 -> 被控对象积分 -> 预装载占空比生效
+ */
+void foc_sim_step(void);
+
+/**
+ * @brief 连续运行指定时间
+ * @param seconds 仿真时间 (s)
+ */
+void foc_sim_run(float seconds);
+
+/* 被控对象状态 (可直接修改 param.load_torque 等参数) */
+pmsm_model_t *foc_sim_get_plant(void);
+
+/* 已运行的控制周期数 */
+uint32_t foc_sim_get_ticks(void);
+
+/* 已运行的仿真时间 (s) */
+float foc_sim_get_time(void);
+
+/* 稳态电流采样误差: 控制器看到的 Iq (mode_manager_get_status) 与被控对象 Iq 之差 */
+typedef struct
+{
+    float rpm;        /* 平均转速 (被控对象) */
+    float iq_err_rms; /* Iq 误差 RMS (A) */
+    float iq_err_max; /* Iq 误差绝对值最大值 (A) */
+    uint32_t invalid; /* 测量期间的无效采样次数 (foc_sim_get_adc_invalid_count 的增量) */
+} foc_sim_iq_error_t;
+
+/**
+ * @brief 继续运行 ticks 个控制周期, 统计 Iq 采样误差与平均转速
+ * @note  须已由 foc_sim_start() (或 foc_sim_init() + mode_manager_init()) 启动并进入稳态
+ */
+void foc_sim_measure_iq_error(uint32_t ticks, foc_sim_iq_error_t *result);
+
+/**
+ * @brief 读取当前生效的三相占空比
+ */
+void foc_sim_get_duty(float *duty_a, float *duty_b, float *duty_c);
+
+/**
+ * @brief 读取最近一次 printf_vofa() 发送的数据帧
+ * @param data    输出缓冲区
+ * @param max_num 缓冲区可容纳的通道数
+ * @return 实际通道数
+ */
+uint16_t foc_sim_get_vofa(float *data, uint16_t max_num);
+
+/**
+ * @brief 模拟上位机发送: 数据写入 USART1 接收 FIFO, 由 usart1_read_data() 读出
+ */
+void foc_sim_uart_rx(const char *data);
+
+#endif /* __FOC_SIM_H__ */
@@ -0,0 +1,11 @@
+/**
+ * @file stm32g431xx.h
+ * @brief 主机仿真用器件头文件桩（仅供 utils/delay.h 等头文件通过编译）
+ */
+
+#ifndef __STM32G431XX_H__
+#define __STM32G431XX_H__
+
+#include "stm32g4xx_hal.h"
+
+#endif /* __STM32G431XX_H__ */
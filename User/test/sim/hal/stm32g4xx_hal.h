@@ -0,0 +1,50 @@
+/**
+ * @file stm32g4xx_hal.h
+ * @brief 主机仿真用 HAL 桩头文件（仅在 PC 上编译 SIL 仿真时使用）
+ *
+ * 编译仿真时通过 -I test/sim/hal 放在包含路径最前面，替换真实的 HAL 头文件，
+ * 使 User/foc 与 User/motor 中的源码无需修改即可在 gcc/Linux 下编译。
+ * 这里只提供上层头文件中实际引用到的类型与函数声明，
+ * 外设句柄仅作占位，具体行为由 test/sim/foc_sim.c 实现。
+ */
+
+#ifndef __STM32G4XX_HAL_H__
+#define __STM32G4XX_HAL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+/* 外设句柄占位类型 (仿真中不访问其成员) */
+typedef struct
+{
+    uint32_t dummy;
+} ADC_HandleTypeDef;
+
+typedef struct
+{
+    uint32_t dummy;
+} DMA_HandleTypeDef;
+
+typedef struct
+{
+    uint32_t dummy;
+} TIM_HandleTypeDef;
+
+typedef struct
+{
+    uint32_t dummy;
+} SPI_HandleTypeDef;
+
+typedef struct
+{
+    uint32_t dummy;
+} UART_HandleTypeDef;
+
+/* 系统节拍 (由仿真时钟驱动, 1 tick = 1 ms) */
+uint32_t HAL_GetTick(void);
+
+/* 阻塞延时 (仿真中推进被控对象与控制中断) */
+void HAL_Delay(uint32_t delay_ms);
+
+#endif /* __STM32G4XX_HAL_H__ */
@@ -0,0 +1,192 @@
+#ifdef FOC_SIM_HOST
+
+#include "pmsm_model.h"
+#include "foc/motor_profile.h"
+
+#define PMSM_TWO_PI 6.28318530718f
+#define PMSM_SQRT3_BY_2 0.866025403784f
+#define PMSM_ONE_BY_SQRT3 0.577350269190f
+
+/* 角度归一化到 [0, 2π) */
+static float pmsm_wrap(float theta)
+{
+    theta = fmodf(theta, PMSM_TWO_PI);
+    if (theta < 0.0f)
+        theta += PMSM_TWO_PI;
+    return theta;
+}
+
+/* 限幅到 [-1, 1] */
+static float pmsm_sat(float x)
+{
+    if (x > 1.0f)
+        return 1.0f;
+    if (x < -1.0f)
+        return -1.0f;
+    return x;
+}
+
+void pmsm_model_default_param(pmsm_param_t *param)
+{
+    /* 电阻、电感、磁链、极对数取自当前电机配置 (foc/motor_profile.h); 转动惯量为小型外转子电机的估计值 */
+    param->rs = MOTOR_RS;
+    param->ld = MOTOR_LD;
+    param->lq = MOTOR_LQ;
+    param->flux = MOTOR_FLUX;
+    param->poles = (float)MOTOR_POLE_PAIRS;
+
+    param->j = 0.000002f;
+    param->b = 0.000005f;
+    param->load_torque = 0.0f;
+
+    param->u_dc = 12.0f;
+    param->t_dead = 0.0f;
+    param->t_pwm = MOTOR_PWM_TS;
+    param->v_drop = 0.0f;
+    param->dead_band = 0.2f;
+
+    param->theta_m0 = 1.0f;
+
+    param->substeps = 4;
+}
+
+void pmsm_model_init(pmsm_model_t *model, const pmsm_param_t *param)
+{
+    model->param = *param;
+
+    if (model->param.substeps == 0)
+        model->param.substeps = 1;
+
+    model->id = 0.0f;
+    model->iq = 0.0f;
+
+    model->ia = 0.0f;
+    model->ib = 0.0f;
+    model->ic = 0.0f;
+
+    model->va = 0.0f;
+    model->vb = 0.0f;
+    model->vc = 0.0f;
+
+    model->omega_m = 0.0f;
+    model->theta_m = pmsm_wrap(param->theta_m0);
+    model->theta_e = pmsm_wrap(param->theta_m0 * param->poles);
+    model->te = 0.0f;
+}
+
+void pmsm_model_step(pmsm_model_t *model, float duty_a, float duty_b, float duty_c, float dt)
+{
+    const pmsm_param_t *p = &model->param;
+    float h = dt / (float)p->substeps;
+
+    /* 平均值逆变器: 桥臂电压减去共模分量得到相电压 */
+    float v_common = (duty_a + duty_b + duty_c) * (1.0f / 3.0f);
+    model->va = (duty_a - v_common) * p->u_dc;
+    model->vb = (duty_b - v_common) * p->u_dc;
+    model->vc = (duty_c - v_common) * p->u_dc;
+
+    /* Clark 变换 (相电压之和为零) */
+    float v_alpha = model->va;
+    float v_beta = (model->vb - model->vc) * PMSM_ONE_BY_SQRT3;
+
+    /* 死区 + 导通压降: 每相桥臂电压损失 dv·sat(i / dead_band), 随相电流在每个子步更新;
+     * 占空比为 0 / 1 的桥臂 (DPWM 钳位相) 整个周期不开关, 没有死区误差, 只剩导通压降 */
+    float t_pwm = (p->t_pwm > 0.0f) ? p->t_pwm : dt;
+    float dv = p->t_dead / t_pwm * p->u_dc + p->v_drop;
+    float dv_a = (duty_a > 0.0f && duty_a < 1.0f) ? dv : p->v_drop;
+    float dv_b = (duty_b > 0.0f && duty_b < 1.0f) ? dv : p->v_drop;
+    float dv_c = (duty_c > 0.0f && duty_c < 1.0f) ? dv : p->v_drop;
+    uint8_t nonlinear = (dv > 0.0f);
+    float va_sum = 0.0f, vb_sum = 0.0f, vc_sum = 0.0f;
+
+    for (uint32_t i = 0; i < p->substeps; i++)
+    {
+        float sin_e = sinf(model->theta_e);
+        float cos_e = cosf(model->theta_e);
+        float omega_e = model->omega_m * p->poles;
+
+        if (nonlinear)
+        {
+            float i_a = model->id * cos_e - model->iq * sin_e;
+            float i_beta = model->id * sin_e + model->iq * cos_e;
+            float i_b = -0.5f * i_a + PMSM_SQRT3_BY_2 * i_beta;
+            float i_c = -i_a - i_b;
+
+            float ea = -dv_a * pmsm_sat(i_a / p->dead_band);
+            float eb = -dv_b * pmsm_sat(i_b / p->dead_band);
+            float ec = -dv_c * pmsm_sat(i_c / p->dead_band);
+            float e_common = (ea + eb + ec) * (1.0f / 3.0f);
+
+            float va = model->va + ea - e_common;
+            float vb = model->vb + eb - e_common;
+            float vc = model->vc + ec - e_common;
+            va_sum += va;
+            vb_sum += vb;
+            vc_sum += vc;
+
+            v_alpha = va;
+            v_beta = (vb - vc) * PMSM_ONE_BY_SQRT3;
+        }
+
+        /* Park 变换 */
+        float vd = v_alpha * cos_e + v_beta * sin_e;
+        float vq = -v_alpha * sin_e + v_beta * cos_e;
+
+        /* 电压方程 (dq 旋转坐标系) */
+        float did = (vd - p->rs * model->id + omega_e * p->lq * model->iq) / p->ld;
+        float diq = (vq - p->rs * model->iq - omega_e * (p->ld * model->id + p->flux)) / p->lq;
+
+        model->id += did * h;
+        model->iq += diq * h;
+
+        /* 电磁转矩 Te = 1.5 * p * (ψf * iq + (Ld - Lq) * id * iq) */
+        model->te = 1.5f * p->poles * (p->flux * model->iq + (p->ld - p->lq) * model->id * model->iq);
+
+        /* 机械方程, 负载转矩始终阻碍转动, 静止时需克服负载才能起转 */
+        float t_net = model->te - p->b * model->omega_m;
+        if (model->omega_m > 0.0f)
+            t_net -= p->load_torque;
+        else if (model->omega_m < 0.0f)
+            t_net += p->load_torque;
+        else if (fabsf(t_net) <= p->load_torque)
+            t_net = 0.0f;
+        else
+            t_net -= (t_net > 0.0f) ? p->load_torque : -p->load_torque;
+
+        float omega_next = model->omega_m + t_net / p->j * h;
+
+        /* 负载转矩作用下转速过零时停住, 避免数值抖动 */
+        if (p->load_torque > 0.0f && model->omega_m * omega_next < 0.0f)
+            omega_next = 0.0f;
+
+        model->omega_m = omega_next;
+        model->theta_m = pmsm_wrap(model->theta_m + model->omega_m * h);
+        model->theta_e = pmsm_wrap(model->theta_m * p->poles);
+    }
+
+    /* 含死区时输出子步平均的相电压 */
+    if (nonlinear)
+    {
+        float k = 1.0f / (float)p->substeps;
+        model->va = va_sum * k;
+        model->vb = vb_sum * k;
+        model->vc = vc_sum * k;
+    }
+
+    /* 反 Park + 反 Clark 得到三相电流 */
+    float sin_e = sinf(model->theta_e);
+    float cos_e = cosf(model->theta_e);
+    float i_alpha = model->id * cos_e - model->iq * sin_e;
+    float i_beta = model->id * sin_e + model->iq * cos_e;
+
+    model->ia = i_alpha;
+    model->ib = -0.5f * i_alpha + PMSM_SQRT3_BY_2 * i_beta;
+    model->ic = -model->ia - model->ib;
+}
+
+float pmsm_model_get_speed_rpm(const pmsm_model_t *model)
+{
+    return model->omega_m * 60.0f / PMSM_TWO_PI;
+}
+
+#endif /* FOC_SIM_HOST */
@@ -0,0 +1,86 @@
+#ifndef __PMSM_MODEL_H__
+#define __PMSM_MODEL_H__
+
+#include <math.h>
+#include <stdint.h>
+
+/* 被控对象参数 */
+typedef struct
+{
+    /* 电气参数 */
+    float rs;    /* 定子电阻 (Ω) */
+    float ld;    /* D轴电感 (H) */
+    float lq;    /* Q轴电感 (H) */
+    float flux;  /* 永磁体磁链 (Wb) */
+    float poles; /* 极对数 */
+
+    /* 机械参数 */
+    float j;           /* 转动惯量 (kg·m²) */
+    float b;           /* 粘滞摩擦系数 (N·m·s/rad) */
+    float load_torque; /* 负载转矩 (N·m), 始终阻碍转动 */
+
+    /* 逆变器 */
+    float u_dc;      /* 直流母线电压 (V) */
+    float t_dead;    /* 死区时间 (s), 0 为理想逆变器; 每相平均电压损失 t_dead / t_pwm · u_dc, 方向与相电流相反 */
+    float t_pwm;     /* PWM 周期 (s), 死区损失按整个周期平均; 0 时取步长 (双更新时步长为半个周期) */
+    float v_drop;    /* 开关管导通压降 (V), 方向与相电流相反 */
+    float dead_band; /* 死区效应的电流过渡区半宽 (A): 电流纹波使相电流在过零附近一个周期内换向, 损失线性减小 */
+
+    /* 初始状态 */
+    float theta_m0; /* 初始机械角度 (rad) */
+
+    /* 每个 PWM 周期内的积分子步数 */
+    uint32_t substeps;
+} pmsm_param_t;
+
+/* 被控对象状态 */
+typedef struct
+{
+    pmsm_param_t param;
+
+    float id; /* D轴电流 (A) */
+    float iq; /* Q轴电流 (A) */
+
+    float ia; /* 三相电流 (A) */
+    float ib;
+    float ic;
+
+    float va; /* 三相相电压 (相对电机中性点, V) */
+    float vb;
+    float vc;
+
+    float omega_m; /* 机械角速度 (rad/s) */
+    float theta_m; /* 机械角度 [0, 2π) */
+    float theta_e; /* 电角度 [0, 2π) */
+    float te;      /* 电磁转矩 (N·m) */
+} pmsm_model_t;
+
+/**
+ * @brief 填充默认电机参数 (与各运行模式中观测器参数一致: 0.12Ω, 30uH, 7对极)
+ * @param param 参数结构体
+ */
+void pmsm_model_default_param(pmsm_param_t *param);
+
+/**
+ * @brief 初始化被控对象
+ * @param model 被控对象句柄
+ * @param param 电机参数
+ */
+void pmsm_model_init(pmsm_model_t *model, const pmsm_param_t *param);
+
+/**
+ * @brief 在给定三相占空比下推进一个时间步 (平均值逆变器模型)
+ * @param model  被控对象句柄
+ * @param duty_a A相占空比 (0.0 ~ 1.0)
+ * @param duty_b B相占空比
+ * @param duty_c C相占空比
+ * @param dt     时间步长 (s), 内部再细分为 param.substeps 个子步
+ */
+void pmsm_model_step(pmsm_model_t *model, float duty_a, float duty_b, float duty_c, float dt);
+
+/**
+ * @brief 获取机械转速 (RPM)
+ */
+float pmsm_model_get_speed_rpm(const pmsm_model_t *model);
+
+#endif /* __PMSM_MODEL_H__ */
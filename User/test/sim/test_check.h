@@ -0,0 +1,47 @@
+#ifndef __TEST_CHECK_H__
+#define __TEST_CHECK_H__
+
+#include <stdio.h>
+#include <stdint.h>
+
+/**
+ * 主机端测试公用的断言、结果汇总与伪随机数
+ *
+ * 每个测试程序只有一个翻译单元包含本头文件, 失败计数与随机数状态在各测试程序内独立。
+ * - TEST_CHECK(cond, fmt, ...): 打印 [PASS] / [FAIL] 与说明, 失败时计数
+ * - test_summary(): main 末尾调用, 打印汇总并返回退出码 (任一失败返回 1)
+ * - test_rand_range(lo, hi): 固定种子的线性同余随机数, 保证各平台结果一致
+ */
+
+static int test_fail_count = 0;
+
+#define TEST_CHECK(cond, fmt, ...)                               \
+    do                                                           \
+    {                                                            \
+        if (cond)                                                \
+        {                                                        \
+            printf("  [PASS] " fmt "\n", ##__VA_ARGS__);         \
+        }                                                        \
+        else                                                     \
+        {                                                        \
+            printf("  [FAIL] " fmt "\n", ##__VA_ARGS__);         \
+            test_fail_count++;                                   \
+        }                                                        \
+    } while (0)
+
+static inline int test_summary(void)
+{
+    printf("\n%s (%d failed)\n", test_fail_count ? "FAILED" : "ALL PASSED", test_fail_count);
+    return test_fail_count ? 1 : 0;
+}
+
+/* [lo, hi) 内均匀分布, 序列只由调用次数决定 */
+static inline float test_rand_range(float lo, float hi)
+{
+    static uint32_t state = 12345u;
+
+    state = state * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (float)(state >> 8) * (1.0f / 16777216.0f);
+}
+
+#endif /* __TEST_CHECK_H__ */
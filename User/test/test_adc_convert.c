@@ -0,0 +1,111 @@
+/**
+ * @file test_adc_convert.c
+ * @brief ADC 注入组换算 (adc1_scale_init / adc1_scale_convert) 精度测试（主机端）
+ *
+ * 编译命令（在 User 目录下运行）：
+ *   gcc -DFOC_SIM_HOST -std=gnu11 -O2 -I test/sim/hal -I . test/test_adc_convert.c -lm -o test_adc_convert
+ *
+ * 运行：
+ *   ./test_adc_convert         (任一失败返回非零)
+ *
+ * 以双精度按原始公式 (码值 * 3.3 / 4096 - ADC_REF_VOLTAGE - offset) * ADC_CURRENT_SCALE 为基准,
+ * 遍历全部 4096 个码值与若干零点偏移, 比较预计算乘加与原单精度公式的误差。
+ */
+
+#ifdef FOC_SIM_HOST
+
+#include <stdio.h>
+#include <math.h>
+
+#include "bsp/adc.h"
+#include "test/sim/test_check.h"
+
+/* 允许误差: 电流 1e-5 A (约 1/3000 LSB), 母线电压 1e-4 V */
+#define CURRENT_TOL 1e-5
+#define UDC_TOL 1e-4
+
+/* 双精度基准 */
+static double ref_current(uint32_t raw, float offset)
+{
+    return ((double)raw * 3.3 / 4096.0 - (double)ADC_REF_VOLTAGE - (double)offset) * (double)ADC_CURRENT_SCALE;
+}
+
+static double ref_udc(uint32_t raw)
+{
+    return (double)raw * 3.3 / 4096.0 * (double)ADC_UDC_SCALE;
+}
+
+/* 原 adc1_value_convert() 的单精度公式 */
+static float old_current(uint32_t raw, float offset)
+{
+    float voltage = raw * 3.3f / 4096.0f - ADC_REF_VOLTAGE;
+    return ADC_CURRENT_SCALE * (voltage - offset);
+}
+
+static void test_offset(float offset_a, float offset_b, float offset_c)
+{
+    printf("offset = (%+.4f, %+.4f, %+.4f) V\n", offset_a, offset_b, offset_c);
+
+    adc_offset_t offset = {offset_a, offset_b, offset_c};
+    adc_scale_t scale;
+    adc1_scale_init(&scale, &offset);
+
+    double err_new = 0.0, err_old = 0.0, err_udc = 0.0;
+
+    for (uint32_t raw = 0; raw < 4096; raw++)
+    {
+        /* 三相使用不同码值, 检查通道之间没有串扰 */
+        uint32_t raw_b = 4095 - raw;
+        uint32_t raw_c = (raw * 7) & 4095;
+
+        adc_values_t values;
+        adc1_scale_convert(&scale, raw, raw_b, raw_c, raw, &values);
+
+        double e;
+        e = fabs(values.ia - ref_current(raw, offset_a));
+        err_new = (e > err_new) ? e : err_new;
+        e = fabs(values.ib - ref_current(raw_b, offset_b));
+        err_new = (e > err_new) ? e : err_new;
+        e = fabs(values.ic - ref_current(raw_c, offset_c));
+        err_new = (e > err_new) ? e : err_new;
+
+        e = fabs(old_current(raw, offset_a) - ref_current(raw, offset_a));
+        err_old = (e > err_old) ? e : err_old;
+
+        e = fabs(values.udc - ref_udc(raw));
+        err_udc = (e > err_udc) ? e : err_udc;
+    }
+
+    TEST_CHECK(err_new < CURRENT_TOL, "current max error = %.3g A (old formula %.3g A)", err_new, err_old);
+    TEST_CHECK(err_udc < UDC_TOL, "udc max error = %.3g V", err_udc);
+}
+
+/* 零点: 码值落在参考电压附近时电流应接近 0 */
+static void test_zero(void)
+{
+    printf("zero point\n");
+
+    adc_offset_t offset = {0.0f, 0.0f, 0.0f};
+    adc_scale_t scale;
+    adc1_scale_init(&scale, &offset);
+
+    adc_values_t values;
+    uint32_t raw_zero = (uint32_t)lrint(ADC_REF_VOLTAGE * 4096.0 / 3.3); /* 2048 */
+    adc1_scale_convert(&scale, raw_zero, raw_zero, raw_zero, 0, &values);
+
+    TEST_CHECK(fabsf(values.ia) < 1e-5f && fabsf(values.ib) < 1e-5f && fabsf(values.ic) < 1e-5f,
+               "raw %u -> ia = %.3g A", raw_zero, values.ia);
+    TEST_CHECK(values.udc == 0.0f, "raw 0 -> udc = %.3g V", values.udc);
+}
+
+int main(void)
+{
+    test_zero();
+    test_offset(0.0f, 0.0f, 0.0f);
+    test_offset(0.0123f, -0.0087f, 0.0311f);
+    test_offset(-0.05f, 0.05f, -0.02f);
+
+    return test_summary();
+}
+
+#endif /* FOC_SIM_HOST */
@@ -31,7 +31,7 @@ void test_as5047(void)
         last_tick = current_tick;
 
         /* 读取角度信息 */
-        /* uint16_t raw_angle = as5047_read_angle_raw();  <-- 现在是内部函数，无法外部调用 */
+        uint16_t raw_angle = as5047_get_angle_raw();
         float angle_rad = as5047_get_angle_rad();
 
         /* 读取速度信息 */
@@ -39,8 +39,7 @@ void test_as5047(void)
         uint16_t error = as5047_get_error();
 
         /* 打印角度数据 */
-        /* printf("Angle Raw: %5u | Rad: %.4f\r\n", raw_angle, angle_rad); */
-        printf("Angle Rad: %.4f\r\n", angle_rad);
+        printf("Angle Raw: %5u | Rad: %.4f\r\n", raw_angle, angle_rad);
 
         /* 打印速度数据 */
         printf("Speed: %.1f RPM\r\n",
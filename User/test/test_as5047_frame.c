@@ -0,0 +1,268 @@
+/**
+ * @file test_as5047_frame.c
+ * @brief AS5047P 驱动帧流水线与奇偶校验测试（主机端）
+ *
+ * 编译命令（在 User 目录下运行）：
+ *   gcc -DFOC_SIM_HOST -std=gnu11 -O2 -I test/sim/hal -I . test/test_as5047_frame.c \
+ *       bsp/as5047.c test/sim/as5047_model.c -lm -o test_as5047_frame
+ *
+ * 运行：
+ *   ./test_as5047_frame        (任一失败返回非零)
+ *
+ * 用 AS5047P 从机模型 (test/sim/as5047_model) 替换传输接口, 每调用一次 mock_period()
+ * 相当于一个 PWM 周期: TIM1 触发一帧, 帧结束调用 as5047_frame_isr()。
+ */
+
+#ifdef FOC_SIM_HOST
+
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "bsp/as5047.h"
+#include "test/sim/as5047_model.h"
+#include "test/sim/test_check.h"
+
+/* ------------------------------------------------------------------ */
+/*  模拟传输接口                                                        */
+/* ------------------------------------------------------------------ */
+static struct
+{
+    as5047_model_t sensor;
+    uint16_t tx;               /* 下一帧命令 */
+    uint8_t running;
+    uint8_t busy;              /* 置 1 模拟帧一直未完成 */
+    uint32_t blocking_count;   /* 阻塞帧数 */
+} mock;
+
+static void mock_init(void)
+{
+}
+
+static uint16_t mock_transfer(uint16_t tx)
+{
+    mock.blocking_count++;
+    return as5047_model_transfer(&mock.sensor, tx);
+}
+
+static void mock_start(uint16_t tx)
+{
+    mock.tx = tx;
+    mock.running = 1;
+}
+
+static uint8_t mock_busy(void)
+{
+    return mock.busy;
+}
+
+static const as5047_transport_t mock_transport = {
+    .init = mock_init,
+    .transfer = mock_transfer,
+    .start = mock_start,
+    .busy = mock_busy,
+};
+
+/**
+ * @brief 一个 PWM 周期的帧
+ * @param rx_flip 响应帧翻转位 (模拟 MISO 干扰)
+ * @param tx_flip 命令帧翻转位 (模拟 MOSI 干扰)
+ */
+static void mock_period(uint16_t rx_flip, uint16_t tx_flip)
+{
+    uint16_t rx = as5047_model_transfer(&mock.sensor, mock.tx ^ tx_flip);
+    mock.tx = as5047_frame_isr(rx ^ rx_flip);
+}
+
+static void mock_reset(uint16_t angle)
+{
+    as5047_model_init(&mock.sensor, angle);
+    mock.running = 0;
+    mock.busy = 0;
+    mock.blocking_count = 0;
+    as5047_set_transport(&mock_transport);
+    as5047_init();
+}
+
+/* ------------------------------------------------------------------ */
+/*  用例                                                                */
+/* ------------------------------------------------------------------ */
+
+/* 初始化: 阻塞帧填充流水线, 启动后立即有有效角度 */
+static void test_init(void)
+{
+    printf("init\n");
+
+    mock_reset(1234);
+
+    TEST_CHECK(mock.running && mock.blocking_count == 3, "started after %u blocking frames", mock.blocking_count);
+    TEST_CHECK(as5047_get_angle_raw() == 1234, "initial angle = %u", as5047_get_angle_raw());
+    TEST_CHECK(mock.sensor.cmd_parity_error == 0, "command parity errors = %u", mock.sensor.cmd_parity_error);
+}
+
+/* 流水线: 每周期一帧, 得到该帧 CS 下降沿时刻的角度; 多个使用者共享同一采样 */
+static void test_pipeline(void)
+{
+    printf("pipeline\n");
+
+    mock_reset(0);
+    srand(1);
+
+    uint32_t mismatch = 0;
+    uint32_t frames_before = mock.sensor.frame_count;
+    uint32_t n = 10000;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint16_t angle = (uint16_t)(rand() & (AS5047_RESOLUTION - 1));
+        mock.sensor.angle = angle;
+        mock_period(0, 0);
+
+        /* 同一周期内多次读取 (角度 + 速度) 不产生额外的帧 */
+        angle_t angle_el = as5047_get_angle_el();
+        float rad = as5047_get_angle_rad();
+        as5047_update_speed();
+        uint16_t raw = as5047_get_angle_raw();
+
+        /* 电角度 = 机械角 × 极对数, 回绕到一圈内 */
+        uint32_t expect_el = (uint32_t)(((uint64_t)angle * AS5047_MOTOR_POLE_PAIR << 18) & 0xFFFFFFFFu);
+        float expect = fmodf((float)angle / AS5047_RESOLUTION * AS5047_MOTOR_POLE_PAIR, 1.0f) * 2.0f * (float)M_PI;
+        if (raw != angle || angle_el != expect_el || fabsf(rad - expect) > 1e-4f)
+            mismatch++;
+    }
+
+    as5047_diag_t diag;
+    as5047_get_diag(&diag);
+
+    TEST_CHECK(mismatch == 0, "angle matches sensor on %u/%u frames", n - mismatch, n);
+    TEST_CHECK(mock.sensor.frame_count - frames_before == n, "frames = %u for %u periods",
+               mock.sensor.frame_count - frames_before, n);
+    TEST_CHECK(diag.angle_count == n + 1 && diag.parity_error == 0 && diag.flag_error == 0,
+               "angle frames = %u, parity errors = %u, EF = %u", diag.angle_count, diag.parity_error, diag.flag_error);
+    TEST_CHECK(mock.sensor.cmd_parity_error == 0, "command parity errors = %u", mock.sensor.cmd_parity_error);
+}
+
+/* 响应帧校验错误: 丢弃该帧, 沿用上一次的角度 */
+static void test_response_parity(void)
+{
+    printf("response parity\n");
+
+    mock_reset(100);
+
+    mock.sensor.angle = 200;
+    mock_period(0, 0);
+
+    mock.sensor.angle = 300;
+    mock_period(0x0001, 0); /* 单比特翻转 */
+
+    as5047_diag_t diag;
+    as5047_get_diag(&diag);
+    TEST_CHECK(diag.parity_error == 1, "parity errors = %u", diag.parity_error);
+    TEST_CHECK(as5047_get_angle_raw() == 200, "angle held at %u", as5047_get_angle_raw());
+
+    mock.sensor.angle = 400;
+    mock_period(0, 0);
+    TEST_CHECK(as5047_get_angle_raw() == 400, "angle recovered to %u", as5047_get_angle_raw());
+
+    /* 双比特翻转无法被偶校验发现 (校验能力的边界) */
+    mock.sensor.angle = 500;
+    mock_period(0x0003, 0);
+    as5047_get_diag(&diag);
+    TEST_CHECK(diag.parity_error == 1 && as5047_get_angle_raw() == (500 ^ 0x0003),
+               "double-bit error passes parity (angle = %u)", as5047_get_angle_raw());
+}
+
+/* 命令帧校验错误: 传感器置位 EF 与 ERRFL.PARERR; ERRFL 读取插入流水线 */
+static void test_command_error(void)
+{
+    printf("command error + ERRFL\n");
+
+    mock_reset(1000);
+
+    /* 本帧命令被干扰, 下一帧响应 EF 置位 */
+    mock.sensor.angle = 1100;
+    mock_period(0, 0x0001);
+    mock.sensor.angle = 1200;
+    mock_period(0, 0);
+
+    as5047_diag_t diag;
+    as5047_get_diag(&diag);
+    TEST_CHECK(diag.flag_error == 1, "EF frames = %u", diag.flag_error);
+    TEST_CHECK(as5047_get_angle_raw() == 1100, "angle held at %u", as5047_get_angle_raw());
+
+    /* 请求 ERRFL: 本周期帧结束时排入下一帧命令, 再下一帧得到结果 */
+    TEST_CHECK(as5047_get_error() == 0, "ERRFL before read = 0");
+
+    mock.sensor.angle = 1300;
+    mock_period(0, 0); /* 决定下一帧发送 ERRFL */
+    mock.sensor.angle = 1400;
+    mock_period(0, 0); /* 发送 ERRFL 命令, 收到 1300 的下一次角度 */
+    TEST_CHECK(as5047_get_angle_raw() == 1400, "angle = %u while ERRFL in flight", as5047_get_angle_raw());
+
+    mock.sensor.angle = 1500;
+    mock_period(0, 0); /* 收到 ERRFL, 本周期角度沿用上一帧 */
+    TEST_CHECK(as5047_get_angle_raw() == 1400, "angle held at %u during ERRFL slot", as5047_get_angle_raw());
+
+    uint16_t errfl = as5047_get_error();
+    TEST_CHECK(errfl == AS5047_MODEL_ERR_PARERR, "ERRFL = 0x%04X (PARERR)", errfl);
+
+    /* 上面的 as5047_get_error() 又请求了一次, 三个周期后完成, ERRFL 读后清零 */
+    mock_period(0, 0);
+    mock_period(0, 0);
+    mock_period(0, 0);
+    mock.sensor.angle = 1600;
+    mock_period(0, 0);
+    TEST_CHECK(as5047_get_angle_raw() == 1600, "angle resumed at %u", as5047_get_angle_raw());
+    TEST_CHECK(as5047_get_error() == 0, "ERRFL cleared after read");
+}
+
+/* 帧未完成: 有界等待后返回缓存值 */
+static void test_wait_timeout(void)
+{
+    printf("wait timeout\n");
+
+    mock_reset(2000);
+    mock.busy = 1;
+
+    uint16_t raw = as5047_get_angle_raw();
+
+    as5047_diag_t diag;
+    as5047_get_diag(&diag);
+    TEST_CHECK(raw == 2000 && diag.wait_timeout == 1, "angle = %u, timeouts = %u", raw, diag.wait_timeout);
+}
+
+/* 速度: 匀速旋转 (跨越零点) */
+static void test_speed(void)
+{
+    printf("speed\n");
+
+    mock_reset(16000);
+
+    /* 每周期 +41 个码值: 41 / 16384 * 60 / 0.0001 = 1501.5 rpm */
+    uint16_t angle = 16000;
+    for (int i = 0; i < 1000; i++)
+    {
+        angle = (angle + 41) & (AS5047_RESOLUTION - 1);
+        mock.sensor.angle = angle;
+        mock_period(0, 0);
+        as5047_update_speed();
+    }
+
+    float expect = 41.0f / AS5047_RESOLUTION * 60.0f / (AS5047_SPEED_SAMPLE_TIME / AS5047_SPEED_CALC_DIV);
+    TEST_CHECK(fabsf(as5047_get_speed_rpm() - expect) < 0.1f, "speed = %.1f rpm (expect %.1f)",
+               as5047_get_speed_rpm(), expect);
+}
+
+int main(void)
+{
+    test_init();
+    test_pipeline();
+    test_response_parity();
+    test_command_error();
+    test_wait_timeout();
+    test_speed();
+
+    return test_summary();
+}
+
+#endif /* FOC_SIM_HOST */
@@ -0,0 +1,210 @@
+/**
+ * @file test_bus_voltage.c
+ * @brief 母线电压前馈测试（主机端）
+ *
+ * 编译命令（在 User 目录下运行）：
+ *   gcc -DFOC_SIM_HOST -std=gnu11 -O2 -I test/sim/hal -I . test/test_bus_voltage.c \
+ *       $(find test/sim foc motor -name '*.c') bsp/as5047.c utils/ramp.c utils/isr_prof.c utils/telemetry.c -lm -o test_bus_voltage
+ *
+ * 运行：
+ *   ./test_bus_voltage         (任一失败返回非零)
+ *
+ * 1. bus_voltage: 滤波阶跃响应、1/Udc 精度、欠压限幅
+ * 2. svpwm_update_udc: 任意母线电压下占空比 × Udc 还原出的线电压等于指令电压
+ * 3. SIL (mode_manager): 母线 8V 与 12V 下 Id 阶跃响应时间一致 (电流环带宽不随母线跌落);
+ *    母线 100Hz ±1V 纹波 + 3V 跌落下速度闭环带载运行, 被控对象 Iq 与转速波动在限值内
+ *    (不做前馈时 Iq 标准差约 0.63A, 转速峰峰值约 260 RPM)
+ */
+
+#ifdef FOC_SIM_HOST
+
+#include <stdio.h>
+#include <math.h>
+
+#include "foc/bus_voltage.h"
+#include "foc/svpwm.h"
+#include "test/sim/foc_sim.h"
+#include "motor/mode_manager.h"
+#include "test/sim/test_check.h"
+
+#define TS FOC_SIM_TS
+#define TWO_PI 6.28318530718f
+
+/* 母线纹波 + 跌落时的限值 */
+#define BUS_MAX_IQ_STD 0.1f  /* 被控对象 Iq 标准差 (A) */
+#define BUS_MAX_RPM_PP 40.0f /* 转速峰峰值 (RPM) */
+
+/* ------------------------------------------------------------------ */
+/*  bus_voltage                                                        */
+/* ------------------------------------------------------------------ */
+static void test_estimator(void)
+{
+    printf("\n--- bus_voltage: 阶跃 12V -> 9V, 欠压限幅 ---\n");
+
+    bus_voltage_t bus;
+    bus_voltage_init(&bus, TS, BUS_VOLTAGE_FILTER_FC, 12.0f, 6.0f, 24.0f);
+    TEST_CHECK(bus.udc == 12.0f && bus.inv_udc == 1.0f / 12.0f && bus.ratio == 1.0f, "starts at nominal");
+
+    /* 默认 2kHz 截止: 63% 与 99% 分别在 4 个与 10 个周期内 */
+    uint32_t n63 = 0, n99 = 0;
+    for (uint32_t n = 1; n <= 50; n++)
+    {
+        bus_voltage_update(&bus, 9.0f);
+        if (!n63 && bus.udc < 12.0f - 0.632f * 3.0f)
+            n63 = n;
+        if (!n99 && bus.udc < 9.0f + 0.03f)
+            n99 = n;
+    }
+    TEST_CHECK(n63 >= 1 && n63 <= 4, "63%% after %u ticks", n63);
+    TEST_CHECK(n99 > 0 && n99 <= 10, "99%% after %u ticks", n99);
+
+    float max_err = 0.0f;
+    for (int i = 0; i < 1000; i++)
+    {
+        bus_voltage_update(&bus, test_rand_range(7.0f, 20.0f));
+        max_err = fmaxf(max_err, fabsf(bus.udc * bus.inv_udc - 1.0f));
+        max_err = fmaxf(max_err, fabsf(bus.ratio - bus.udc / 12.0f));
+    }
+    TEST_CHECK(max_err < 1e-6f, "udc·(1/udc) and ratio error = %.2e", max_err);
+
+    for (int i = 0; i < 100; i++)
+        bus_voltage_update(&bus, 0.0f);
+    TEST_CHECK(bus.udc == 6.0f && bus.inv_udc == 1.0f / 6.0f, "0V input clamps to udc_min = %.2f V", bus.udc);
+}
+
+/* ------------------------------------------------------------------ */
+/*  svpwm_update_udc                                                   */
+/* ------------------------------------------------------------------ */
+static void test_svpwm_udc(void)
+{
+    printf("\n--- svpwm_update_udc: 线电压还原 ---\n");
+
+    float max_err = 0.0f;
+    for (int i = 0; i < 20000; i++)
+    {
+        float udc = test_rand_range(6.0f, 24.0f);
+        float mag = test_rand_range(0.0f, 0.99f) * udc * 0.57735f; /* 线性区 */
+        float theta = test_rand_range(0.0f, TWO_PI);
+        alphabeta_t u = {mag * cosf(theta), mag * sinf(theta)};
+
+        abc_t duty = svpwm_update_udc(u, 1.0f / udc);
+
+        /* 线电压 uab = (da - db)·Udc = 3/2·uα - √3/2·uβ 的等价形式 */
+        float uab = (duty.a - duty.b) * udc;
+        float ubc = (duty.b - duty.c) * udc;
+        float uab_ref = 1.5f * u.alpha - 0.866025f * u.beta;
+        float ubc_ref = 1.732051f * u.beta;
+        max_err = fmaxf(max_err, fmaxf(fabsf(uab - uab_ref), fabsf(ubc - ubc_ref)));
+    }
+    TEST_CHECK(max_err < 1e-4f * 24.0f, "max line voltage error = %.2e V", max_err);
+
+    /* 额定电压下与 svpwm_update 逐位一致 */
+    int mismatch = 0;
+    for (int i = 0; i < 1000; i++)
+    {
+        alphabeta_t u = {test_rand_range(-8.0f, 8.0f), test_rand_range(-8.0f, 8.0f)};
+        abc_t a = svpwm_update(u);
+        abc_t b = svpwm_update_udc(u, SVPWM_INV_UDC);
+        mismatch += (a.a != b.a) || (a.b != b.b) || (a.c != b.c);
+    }
+    TEST_CHECK(mismatch == 0, "bit-identical to svpwm_update at U_DC (%d mismatches)", mismatch);
+}
+
+/* ------------------------------------------------------------------ */
+/*  SIL                                                                */
+/* ------------------------------------------------------------------ */
+/* Id 阶跃 0 -> 2A (无转矩, 转子保持对齐位置), 返回到达 90% 的周期数 */
+static uint32_t id_step_ticks(float udc, float *overshoot)
+{
+    pmsm_model_t *p = foc_sim_start(udc);
+    mode_manager_current(0.0f, 0.0f);
+    foc_sim_run(1.2f); /* 对齐 + 稳定 */
+
+    mode_manager_current(2.0f, 0.0f);
+
+    uint32_t n90 = 0;
+    float peak = 0.0f;
+    for (uint32_t n = 1; n <= 200 * MOTOR_CTRL_PER_PWM; n++)
+    {
+        foc_sim_step();
+        peak = fmaxf(peak, p->id);
+        if (!n90 && p->id > 1.8f)
+            n90 = n;
+    }
+    *overshoot = peak / 2.0f - 1.0f;
+    return n90;
+}
+
+static void test_current_bandwidth(void)
+{
+    printf("\n--- SIL: Id 阶跃, 母线 12V / 8V ---\n");
+
+    float os12, os8;
+    uint32_t n12 = id_step_ticks(12.0f, &os12);
+    uint32_t n8 = id_step_ticks(8.0f, &os8);
+
+    TEST_CHECK(n12 > 0 && n8 > 0 && (n8 > n12 ? n8 - n12 : n12 - n8) <= 1,
+               "rise to 90%%: %u ticks @12V, %u ticks @8V", n12, n8);
+    TEST_CHECK(fabsf(os8 - os12) < 0.03f, "overshoot %.1f%% @12V, %.1f%% @8V", os12 * 100.0f, os8 * 100.0f);
+}
+
+/* 速度闭环带载运行, 统计被控对象 Iq 标准差与转速峰峰值; ripple = 母线纹波幅值 (V) */
+static void run_speed_loaded(float ripple, float sag, float *iq_std, float *rpm_pp)
+{
+    pmsm_model_t *p = foc_sim_start(12.0f);
+    p->param.load_torque = 0.005f;
+
+    mode_manager_speed(1000.0f);
+    foc_sim_run(3.0f);
+
+    float sum = 0.0f, sum2 = 0.0f, rpm_min = 1e9f, rpm_max = -1e9f;
+    const uint32_t ticks = 5000;
+    for (uint32_t n = 0; n < ticks; n++)
+    {
+        float t = n * TS;
+        /* 100Hz 整流纹波 + 0.2s 起 20ms 内母线跌落 sag (母线电容放电) */
+        float k_sag = fminf(fmaxf((t - 0.2f) / 0.02f, 0.0f), 1.0f);
+        p->param.u_dc = 12.0f + ripple * sinf(TWO_PI * 100.0f * t) - sag * k_sag;
+
+        foc_sim_step();
+
+        sum += p->iq;
+        sum2 += p->iq * p->iq;
+        float rpm = pmsm_model_get_speed_rpm(p);
+        rpm_min = fminf(rpm_min, rpm);
+        rpm_max = fmaxf(rpm_max, rpm);
+    }
+
+    float mean = sum / ticks;
+    *iq_std = sqrtf(fmaxf(sum2 / ticks - mean * mean, 0.0f));
+    *rpm_pp = rpm_max - rpm_min;
+}
+
+static void test_ripple(void)
+{
+    printf("\n--- SIL: 速度闭环 1000 RPM 带载, 母线 100Hz ±1V 纹波 + 3V 跌落 ---\n");
+
+    float iq_std_ref, rpm_pp_ref, iq_std, rpm_pp;
+    run_speed_loaded(0.0f, 0.0f, &iq_std_ref, &rpm_pp_ref);
+    run_speed_loaded(1.0f, 3.0f, &iq_std, &rpm_pp);
+
+    printf("  constant bus: iq std %.4f A, speed p-p %.1f rpm\n", iq_std_ref, rpm_pp_ref);
+    printf("  rippling bus: iq std %.4f A, speed p-p %.1f rpm\n", iq_std, rpm_pp);
+
+    TEST_CHECK(iq_std < BUS_MAX_IQ_STD, "iq ripple %.4f A (constant bus %.4f A)", iq_std, iq_std_ref);
+    TEST_CHECK(rpm_pp < BUS_MAX_RPM_PP, "speed ripple %.1f rpm (constant bus %.1f rpm)", rpm_pp, rpm_pp_ref);
+}
+
+int main(void)
+{
+    printf("=== bus voltage feedforward ===\n");
+
+    test_estimator();
+    test_svpwm_udc();
+    test_current_bandwidth();
+    test_ripple();
+
+    return test_summary();
+}
+
+#endif /* FOC_SIM_HOST */
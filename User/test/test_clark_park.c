@@ -16,7 +16,7 @@ void test_clark_park(void)
         uvw_voltages.c = 20.0f*fast_cos(2 * 3.14 * 50 * t + 2.09 + 3.1415926/3.0f);
 
         alpha_beta_voltages = clark_transform(uvw_voltages);
-        dq_voltages = park_transform(alpha_beta_voltages, theta);
+        dq_voltages = park_transform(alpha_beta_voltages, angle_from_rad(theta));
 
         printf("%.3f, %.3f, %.3f, %.3f, %.3f, %.3f, %.3f\r\n",uvw_voltages.a, uvw_voltages.b, uvw_voltages.c,
              alpha_beta_voltages.alpha, alpha_beta_voltages.beta, dq_voltages.d, dq_voltages.q);
@@ -0,0 +1,241 @@
+/**
+ * @file test_current_recon.c
+ * @brief 按占空比选择的两相电流重构测试（主机端）
+ *
+ * 编译命令（在 User 目录下运行）：
+ *   gcc -DFOC_SIM_HOST -std=gnu11 -O2 -I test/sim/hal -I . test/test_current_recon.c \
+ *       $(find test/sim foc motor -name '*.c') bsp/as5047.c utils/ramp.c utils/isr_prof.c utils/telemetry.c -lm -o test_current_recon
+ *
+ * 运行：
+ *   ./test_current_recon       (任一失败返回非零)
+ *
+ * 1. 扇区选相: 各调制方式 (含过调制) 下 svpwm_modulator_max_phase 给出的相都是占空比最高的一相
+ * 2. 合成波形: 三相正弦电流, 下桥导通时间不足最小窗口的相采样值替换为开关振荡 (大幅值尖峰),
+ *    直接使用三相采样时 dq 电流出现尖峰, 重构后与真实电流一致; SVPWM 线性区内参与计算的两相下桥导通时间
+ *    不小于 1 - (1 + √3/2)/2 ≈ 6.7% 周期
+ * 3. SIL: 母线 6V、3200 RPM 弱磁速度闭环 + 过调制, 仿真下桥电阻采样窗口 3us, 比较 "rec 0" / "rec 1" 时
+ *    控制器得到的 Iq 与被控对象实际 Iq 之差
+ */
+
+#ifdef FOC_SIM_HOST
+
+#include <stdio.h>
+#include <math.h>
+
+#include "test/sim/foc_sim.h"
+#include "motor/mode_manager.h"
+#include "test/sim/test_check.h"
+
+#define TWO_PI 6.28318530718f
+#define DEG_TO_RAD 0.0174532925f
+
+/* 合成波形: 采样窗口 (PWM 周期的比例) 与振荡尖峰幅值 (A) */
+#define SYN_MIN_WINDOW 0.03f
+#define SYN_SPIKE 5.0f
+
+static float duty_of(abc_t d, uint8_t phase)
+{
+    return phase == 0 ? d.a : (phase == 1 ? d.b : d.c);
+}
+
+/* 调制比 m 的电压矢量 (|u| = m · Udc / √3) */
+static alphabeta_t vector_of(float m, float theta)
+{
+    float r = m * U_DC * 0.577350269f;
+    return (alphabeta_t){r * cosf(theta), r * sinf(theta)};
+}
+
+/* ------------------------------------------------------------------ */
+/*  扇区选相                                                           */
+/* ------------------------------------------------------------------ */
+static void test_max_phase(void)
+{
+    printf("\n--- 扇区选相: 丢弃的相为占空比最高的一相 ---\n");
+
+    static const float m_list[] = {0.05f, 0.5f, 0.9f, 1.0f, 1.03f, 1.08f, 1.2f};
+    svpwm_modulator_t mod;
+
+    for (int mode = SVPWM_MODE_SVPWM; mode < SVPWM_MODE_NUM; mode++)
+    {
+        for (uint8_t overmod = 0; overmod <= 1; overmod++)
+        {
+            uint32_t wrong = 0, total = 0;
+            svpwm_modulator_init(&mod, (svpwm_mode_t)mode);
+            svpwm_modulator_set_overmod(&mod, overmod);
+
+            for (unsigned mi = 0; mi < sizeof(m_list) / sizeof(m_list[0]); mi++)
+            {
+                for (int k = 0; k < 720; k++)
+                {
+                    abc_t d = svpwm_modulate(&mod, vector_of(m_list[mi], k * 0.5f * DEG_TO_RAD + 0.001f), 1.0f / U_DC);
+                    float d_max = fmaxf(d.a, fmaxf(d.b, d.c));
+                    uint8_t phase = svpwm_modulator_max_phase(&mod);
+                    wrong += (phase > 2U || duty_of(d, phase) < d_max - 1e-6f);
+                    total++;
+                }
+            }
+            TEST_CHECK(wrong == 0, "mode %d overmod %u: %u / %u ticks drop a lower-duty phase", mode, overmod, wrong, total);
+        }
+    }
+
+    svpwm_modulator_init(&mod, SVPWM_MODE_SVPWM);
+    svpwm_modulate(&mod, (alphabeta_t){0.0f, 0.0f}, 1.0f / U_DC);
+    TEST_CHECK(svpwm_modulator_max_phase(&mod) == SVPWM_PHASE_NONE, "zero vector keeps all three phases");
+}
+
+/* ------------------------------------------------------------------ */
+/*  合成波形                                                           */
+/* ------------------------------------------------------------------ */
+typedef struct
+{
+    float err_raw;     /* 直接使用三相采样的最大 dq 电流误差 (A) */
+    float err_recon;   /* 重构后的最大误差 (A) */
+    float min_window;  /* 参与计算的两相中最短的下桥导通时间 (周期比例) */
+    uint32_t invalid;  /* 无效采样次数 */
+} syn_result_t;
+
+/**
+ * @brief 一个电周期的合成波形: 电压矢量角 θ, 电流滞后 φ, 占空比与电流同一时刻
+ */
+static syn_result_t run_synthetic(svpwm_mode_t mode, uint8_t overmod, float m)
+{
+    svpwm_modulator_t mod;
+    svpwm_modulator_init(&mod, mode);
+    svpwm_modulator_set_overmod(&mod, overmod);
+
+    syn_result_t r = {0.0f, 0.0f, 1.0f, 0};
+    const float i_peak = 2.0f, phi = 20.0f * DEG_TO_RAD;
+
+    for (int k = 0; k < 3600; k++)
+    {
+        float theta = k * 0.1f * DEG_TO_RAD;
+        abc_t d = svpwm_modulate(&mod, vector_of(m, theta), 1.0f / U_DC);
+
+        abc_t i_true = {i_peak * cosf(theta - phi), i_peak * cosf(theta - phi - TWO_PI / 3.0f),
+                        i_peak * cosf(theta - phi + TWO_PI / 3.0f)};
+
+        /* 下桥导通时间不足的相: 采样落在开关振荡中 */
+        float duty[3] = {d.a, d.b, d.c};
+        float i_meas[3] = {i_true.a, i_true.b, i_true.c};
+        for (int p = 0; p < 3; p++)
+        {
+            if (1.0f - duty[p] < SYN_MIN_WINDOW)
+            {
+                i_meas[p] += (k & 1) ? SYN_SPIKE : -SYN_SPIKE;
+                r.invalid++;
+            }
+        }
+
+        adc_values_t adc = {i_meas[0], i_meas[1], i_meas[2], U_DC};
+        alphabeta_t ref = clark_transform(i_true);
+        alphabeta_t raw = clark_transform((abc_t){adc.ia, adc.ib, adc.ic});
+
+        uint8_t drop = svpwm_modulator_max_phase(&mod);
+        adc1_current_reconstruct(&adc, drop);
+        alphabeta_t rec = clark_transform((abc_t){adc.ia, adc.ib, adc.ic});
+
+        r.err_raw = fmaxf(r.err_raw, hypotf(raw.alpha - ref.alpha, raw.beta - ref.beta));
+        r.err_recon = fmaxf(r.err_recon, hypotf(rec.alpha - ref.alpha, rec.beta - ref.beta));
+        for (uint8_t p = 0; p < 3; p++)
+        {
+            if (p != drop)
+                r.min_window = fminf(r.min_window, 1.0f - duty[p]);
+        }
+    }
+    return r;
+}
+
+static void test_synthetic(void)
+{
+    printf("\n--- 合成波形: 窗口 < %.0f%% 周期的相叠加 ±%.0fA 尖峰 ---\n", SYN_MIN_WINDOW * 100.0f, SYN_SPIKE);
+    printf("  %-14s %5s | %8s | %8s | %10s | %s\n", "mode", "m", "raw err", "rec err", "min window", "invalid");
+
+    static const struct
+    {
+        const char *name;
+        svpwm_mode_t mode;
+        uint8_t overmod;
+        float m;
+    } cases[] = {
+        {"SVPWM", SVPWM_MODE_SVPWM, 0, 0.5f},
+        {"SVPWM", SVPWM_MODE_SVPWM, 0, 0.95f},
+        {"SVPWM", SVPWM_MODE_SVPWM, 0, 1.0f},
+        {"DPWM1", SVPWM_MODE_DPWM1, 0, 0.95f},
+        {"DPWMMIN", SVPWM_MODE_DPWMMIN, 0, 0.95f},
+        {"SVPWM+OM I", SVPWM_MODE_SVPWM, 1, 1.03f},
+    };
+
+    float worst_recon = 0.0f, linear_window = 1.0f, worst_raw_high = 0.0f;
+
+    for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        syn_result_t r = run_synthetic(cases[i].mode, cases[i].overmod, cases[i].m);
+        printf("  %-14s %5.2f | %6.3f A | %6.4f A | %8.1f %% | %u\n", cases[i].name, cases[i].m, r.err_raw, r.err_recon,
+               r.min_window * 100.0f, r.invalid);
+
+        worst_recon = fmaxf(worst_recon, r.err_recon);
+        if (cases[i].m >= 0.95f)
+            worst_raw_high = fmaxf(worst_raw_high, r.err_raw);
+        if (cases[i].mode == SVPWM_MODE_SVPWM && !cases[i].overmod)
+            linear_window = fminf(linear_window, r.min_window);
+    }
+
+    TEST_CHECK(worst_raw_high > 1.0f, "three-phase sampling picks up the spikes at high modulation (%.2f A)", worst_raw_high);
+    TEST_CHECK(worst_recon < 1e-5f, "reconstruction matches the true current (max error %.2e A)", worst_recon);
+    TEST_CHECK(linear_window > 0.066f, "SVPWM linear region: used phases keep >= 6.6%% low-side window (min %.2f%%)",
+               linear_window * 100.0f);
+}
+
+/* ------------------------------------------------------------------ */
+/*  SIL                                                                */
+/* ------------------------------------------------------------------ */
+static foc_sim_iq_error_t run_sil(uint8_t recon, float rpm_ref)
+{
+    foc_sim_start(6.0f);
+    foc_sim_set_adc_window(3e-6f);
+    mode_manager_set_overmodulation(1);
+    mode_manager_set_current_recon(recon);
+
+    mode_manager_flux_weak(rpm_ref);
+    foc_sim_run(5.0f);
+
+    foc_sim_iq_error_t r;
+    foc_sim_measure_iq_error(5000, &r);
+    return r;
+}
+
+static void test_sil(void)
+{
+    printf("\n--- SIL: 母线 6V 弱磁速度闭环 + 过调制, 采样窗口 3us ---\n");
+
+    const float rpm_ref = 3200.0f; /* 过调制区域 I, 每个周期最多一相没有采样窗口 */
+    foc_sim_iq_error_t off = run_sil(0, rpm_ref);
+    foc_sim_iq_error_t on = run_sil(1, rpm_ref);
+
+    printf("  rec 0: %7.1f rpm, Iq meas err rms %.3f A peak %.3f A, invalid samples %u\n", off.rpm, off.iq_err_rms, off.iq_err_max,
+           off.invalid);
+    printf("  rec 1: %7.1f rpm, Iq meas err rms %.3f A peak %.3f A, invalid samples %u\n", on.rpm, on.iq_err_rms, on.iq_err_max,
+           on.invalid);
+
+    TEST_CHECK(off.invalid > 0 && on.invalid > 0, "high modulation leaves some phases without a sampling window");
+    TEST_CHECK(off.iq_err_max > 0.5f, "three-phase sampling: Iq measurement spikes (%.3f A)", off.iq_err_max);
+    TEST_CHECK(on.iq_err_max < 0.02f, "reconstruction: Iq measurement error < 0.02 A (peak %.3f A)", on.iq_err_max);
+    TEST_CHECK(fabsf(on.rpm - rpm_ref) < 5.0f, "reconstruction: speed held at %.1f rpm", on.rpm);
+
+    /* 串口命令 */
+    TEST_CHECK(mode_manager_command("rec 0") == 0 && mode_manager_command("rec 1") == 0 && mode_manager_command("rec 2") != 0,
+               "\"rec\" command accepts 0 / 1");
+}
+
+int main(void)
+{
+    printf("========== Two-phase current reconstruction test ==========\n");
+
+    test_max_phase();
+    test_synthetic();
+    test_sil();
+
+    return test_summary();
+}
+
+#endif /* FOC_SIM_HOST */
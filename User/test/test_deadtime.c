@@ -0,0 +1,200 @@
+/**
+ * @file test_deadtime.c
+ * @brief 死区补偿测试（主机端）
+ *
+ * 编译命令（在 User 目录下运行）：
+ *   gcc -DFOC_SIM_HOST -std=gnu11 -O2 -I test/sim/hal -I . test/test_deadtime.c \
+ *       $(find test/sim foc motor -name '*.c') bsp/as5047.c utils/ramp.c utils/isr_prof.c utils/telemetry.c -lm -o test_deadtime
+ *
+ * 运行：
+ *   ./test_deadtime            (任一失败返回非零)
+ *
+ * 1. deadtime_comp_update: 大电流时每相 ±Δv, 过渡区内线性、连续, 关闭时输出 0
+ * 2. 被控对象死区模型: 固定占空比堵转时稳态电流按 Δv 减小
+ * 3. SIL (mode_manager 电流闭环, 转子外部拖动 200 / 500 RPM, Iq = 1A, 被控对象死区 1.25us):
+ *    补偿关闭 / 打开时的 Iq 波动、Id 有效值与 Luenberger 观测角误差波动, 并与理想逆变器对比
+ */
+
+#ifdef FOC_SIM_HOST
+
+#include <stdio.h>
+#include <math.h>
+
+#include "foc/deadtime_comp.h"
+#include "test/sim/foc_sim.h"
+#include "motor/mode_manager.h"
+#include "test/sim/test_check.h"
+
+#define TS FOC_SIM_TS
+#define TWO_PI 6.28318530718f
+
+/* ------------------------------------------------------------------ */
+/*  deadtime_comp_update                                               */
+/* ------------------------------------------------------------------ */
+static void test_comp(void)
+{
+    printf("\n--- deadtime_comp_update ---\n");
+
+    deadtime_comp_t dtc;
+    deadtime_comp_init(&dtc, DEADTIME_COMP_T_DEAD, MOTOR_PWM_TS, 0.3f, 0.2f);
+    const float dv = DEADTIME_COMP_T_DEAD / MOTOR_PWM_TS * 12.0f + 0.3f;
+
+    /* iα = 5A: ia > 0, ib / ic < 0, Δabc = (+dv, -dv, -dv) -> Δα = 4/3·dv */
+    alphabeta_t v = deadtime_comp_update(&dtc, (alphabeta_t){5.0f, 0.0f}, 12.0f);
+    TEST_CHECK(fabsf(v.alpha - 4.0f / 3.0f * dv) < 1e-5f && fabsf(v.beta) < 1e-5f,
+               "saturated: v = (%.4f, %.4f) V, expected (%.4f, 0)", v.alpha, v.beta, 4.0f / 3.0f * dv);
+
+    /* 过渡区内三相都不饱和: 补偿 = dv / i_band · i (线性) */
+    v = deadtime_comp_update(&dtc, (alphabeta_t){0.05f, -0.08f}, 12.0f);
+    float k = dv / 0.2f;
+    TEST_CHECK(fabsf(v.alpha - k * 0.05f) < 1e-5f && fabsf(v.beta + k * 0.08f) < 1e-5f,
+               "inside band: linear, v = (%.4f, %.4f) V", v.alpha, v.beta);
+
+    /* 电流矢量缓慢旋转并穿过零点: 补偿电压连续, 幅值不超过 4/3·dv */
+    float max_jump = 0.0f, max_mag = 0.0f;
+    alphabeta_t prev = deadtime_comp_update(&dtc, (alphabeta_t){0.0f, 0.0f}, 12.0f);
+    for (int n = 1; n <= 20000; n++)
+    {
+        float th = TWO_PI * n / 20000.0f;
+        float mag = 1.0f * fabsf(sinf(th * 0.5f)); /* 幅值 0 -> 1A -> 0 */
+        v = deadtime_comp_update(&dtc, (alphabeta_t){mag * cosf(3.0f * th), mag * sinf(3.0f * th)}, 12.0f);
+        max_jump = fmaxf(max_jump, hypotf(v.alpha - prev.alpha, v.beta - prev.beta));
+        max_mag = fmaxf(max_mag, hypotf(v.alpha, v.beta));
+        prev = v;
+    }
+    TEST_CHECK(max_jump < 0.01f * dv, "continuous: max step %.2e V per sample", max_jump);
+    TEST_CHECK(max_mag <= 4.0f / 3.0f * dv * 1.0001f, "|v| <= 4/3·dv: %.4f V", max_mag);
+
+    dtc.enable = 0;
+    v = deadtime_comp_update(&dtc, (alphabeta_t){5.0f, 0.0f}, 12.0f);
+    TEST_CHECK(v.alpha == 0.0f && v.beta == 0.0f, "disabled: zero output");
+}
+
+/* ------------------------------------------------------------------ */
+/*  被控对象死区模型                                                   */
+/* ------------------------------------------------------------------ */
+static void test_plant(void)
+{
+    printf("\n--- pmsm_model: 死区 1.25us, 堵转固定占空比 ---\n");
+
+    /* A 相 +Δd, B / C 相 -Δd/2: 理想稳态 iα = 1.5·Δd·Udc / Rs */
+    const float d = 0.05f;
+    float ia[2];
+    for (int dead = 0; dead < 2; dead++)
+    {
+        pmsm_param_t param;
+        pmsm_model_default_param(&param);
+        param.t_dead = dead ? DEADTIME_COMP_T_DEAD : 0.0f;
+        param.j = 1e3f;
+        param.theta_m0 = 0.0f;
+
+        pmsm_model_t model;
+        pmsm_model_init(&model, &param);
+        for (int n = 0; n < 2000; n++)
+            pmsm_model_step(&model, 0.5f + d, 0.5f - 0.5f * d, 0.5f - 0.5f * d, TS);
+        ia[dead] = model.ia;
+    }
+
+    /* 三相电流都在过渡区外: 每相损失 Δv, α 轴损失 4/3·Δv -> iα 减少 (4/3·Δv) / Rs */
+    const float dv = DEADTIME_COMP_T_DEAD / MOTOR_PWM_TS * 12.0f;
+    float expected = ia[0] - (4.0f / 3.0f * dv) / 0.12f;
+    TEST_CHECK(fabsf(ia[1] - expected) < 0.02f * ia[0], "ia = %.3f A (ideal %.3f A, expected %.3f A)", ia[1], ia[0], expected);
+}
+
+/* ------------------------------------------------------------------ */
+/*  SIL                                                                */
+/* ------------------------------------------------------------------ */
+typedef struct
+{
+    float iq_std;    /* Iq 标准差 (A) */
+    float id_rms;    /* Id 有效值 (A) */
+    float angle_std; /* 观测角误差标准差 (deg, 去掉观测器固有的平均滞后) */
+} dt_result_t;
+
+static float wrap_pi(float x)
+{
+    while (x > 3.14159265f)
+        x -= TWO_PI;
+    while (x < -3.14159265f)
+        x += TWO_PI;
+    return x;
+}
+
+static dt_result_t run_current(float t_dead, uint8_t comp, float rpm)
+{
+    pmsm_param_t param;
+    pmsm_model_default_param(&param);
+    param.t_dead = t_dead;
+    foc_sim_init(&param);
+    mode_manager_init();
+    mode_manager_set_deadtime_comp(comp);
+
+    mode_manager_current(0.0f, 0.0f);
+    foc_sim_run(1.2f);
+
+    pmsm_model_t *p = foc_sim_get_plant();
+    p->param.j = 1e3f;
+    p->param.b = 0.0f;
+    p->omega_m = rpm * TWO_PI / 60.0f;
+    mode_manager_current(0.0f, 1.0f);
+    foc_sim_run(0.3f);
+
+    double iq_sum = 0.0, iq_sum2 = 0.0, id_sum2 = 0.0, e_sum = 0.0, e_sum2 = 0.0;
+    const int ticks = 10000;
+    for (int n = 0; n < ticks; n++)
+    {
+        foc_sim_step();
+
+        mode_manager_status_t st;
+        mode_manager_get_status(&st);
+        float e = wrap_pi(st.angle_el_observer - st.angle_el_encoder);
+
+        iq_sum += p->iq;
+        iq_sum2 += p->iq * p->iq;
+        id_sum2 += p->id * p->id;
+        e_sum += e;
+        e_sum2 += e * e;
+    }
+
+    double iq_mean = iq_sum / ticks, e_mean = e_sum / ticks;
+    dt_result_t r;
+    r.iq_std = (float)sqrt(fmax(iq_sum2 / ticks - iq_mean * iq_mean, 0.0));
+    r.id_rms = (float)sqrt(id_sum2 / ticks);
+    r.angle_std = (float)sqrt(fmax(e_sum2 / ticks - e_mean * e_mean, 0.0)) * 57.29578f;
+    return r;
+}
+
+static void test_sil(void)
+{
+    static const float speeds[] = {200.0f, 500.0f};
+
+    for (int i = 0; i < 2; i++)
+    {
+        printf("\n--- SIL: 电流闭环 Iq = 1A @%.0f RPM, 死区 1.25us ---\n", speeds[i]);
+
+        dt_result_t ideal = run_current(0.0f, 0, speeds[i]);
+        dt_result_t off = run_current(DEADTIME_COMP_T_DEAD, 0, speeds[i]);
+        dt_result_t on = run_current(DEADTIME_COMP_T_DEAD, 1, speeds[i]);
+
+        printf("  %-14s iq std %.4f A, id rms %.4f A, observer angle std %.2f deg\n", "ideal inverter", ideal.iq_std, ideal.id_rms, ideal.angle_std);
+        printf("  %-14s iq std %.4f A, id rms %.4f A, observer angle std %.2f deg\n", "comp off", off.iq_std, off.id_rms, off.angle_std);
+        printf("  %-14s iq std %.4f A, id rms %.4f A, observer angle std %.2f deg\n", "comp on", on.iq_std, on.id_rms, on.angle_std);
+
+        TEST_CHECK(on.iq_std < 0.2f * off.iq_std, "iq ripple %.4f A (off %.4f A)", on.iq_std, off.iq_std);
+        TEST_CHECK(on.id_rms < 0.5f * off.id_rms, "id rms %.4f A (off %.4f A)", on.id_rms, off.id_rms);
+        TEST_CHECK(on.angle_std < 0.5f * off.angle_std, "observer angle error ripple %.2f deg (off %.2f deg)", on.angle_std, off.angle_std);
+    }
+}
+
+int main(void)
+{
+    printf("=== dead-time compensation ===\n");
+
+    test_comp();
+    test_plant();
+    test_sil();
+
+    return test_summary();
+}
+
+#endif /* FOC_SIM_HOST */
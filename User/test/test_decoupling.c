@@ -0,0 +1,155 @@
+/**
+ * @file test_decoupling.c
+ * @brief dq 电流环解耦 + 反电势前馈测试（主机端）
+ *
+ * 编译命令（在 User 目录下运行）：
+ *   gcc -DFOC_SIM_HOST -std=gnu11 -O2 -I test/sim/hal -I . test/test_decoupling.c \
+ *       $(find test/sim foc motor -name '*.c') bsp/as5047.c utils/ramp.c utils/isr_prof.c utils/telemetry.c -lm -o test_decoupling
+ *
+ * 运行：
+ *   ./test_decoupling          (任一失败返回非零)
+ *
+ * 被控对象转动惯量置为很大, 转速由测试直接给定 (外部拖动), mode_manager 运行电流闭环:
+ * 1. 0 / 500 / 1000 / 1500 RPM 下 Iq 阶跃 0 -> 1.5A: 解耦后上升时间、超调基本不随转速变化,
+ *    交叉耦合引起的 Id 偏差与解耦关闭时对比
+ *    (剩余的转速相关性来自占空比滞后一个 PWM 周期: 期间转子转过 ωe·Ts, 1500 RPM 时约 6°, 不属于解耦)
+ * 2. 转速 0 -> 3000 RPM 斜坡 (10000 RPM/s) 中保持 Iq = 1A: 反电势前馈后积分项不再追赶 ωψf,
+ *    Iq 跟踪误差与解耦关闭时对比
+ */
+
+#ifdef FOC_SIM_HOST
+
+#include <stdio.h>
+#include <math.h>
+
+#include "test/sim/foc_sim.h"
+#include "motor/mode_manager.h"
+#include "test/sim/test_check.h"
+
+#define TS FOC_SIM_TS
+#define RPM_TO_RAD_S (6.28318531f / 60.0f)
+
+/* 启动仿真: 对齐后进入电流闭环, 转子由外部拖动 (转速只由测试给定) */
+static pmsm_model_t *sim_start(uint8_t decoupling)
+{
+    pmsm_param_t param;
+    pmsm_model_default_param(&param);
+    foc_sim_init(&param);
+    mode_manager_init();
+    mode_manager_set_decoupling(decoupling);
+
+    mode_manager_current(0.0f, 0.0f);
+    foc_sim_run(1.2f);
+
+    pmsm_model_t *p = foc_sim_get_plant();
+    p->param.j = 1e3f;
+    p->param.b = 0.0f;
+    p->param.load_torque = 0.0f;
+    return p;
+}
+
+typedef struct
+{
+    uint32_t rise;   /* 到达 90% 的周期数 */
+    float overshoot; /* 超调 (相对值) */
+    float id_dev;    /* Id 最大偏差 (A) */
+} step_result_t;
+
+static step_result_t iq_step(uint8_t decoupling, float rpm)
+{
+    pmsm_model_t *p = sim_start(decoupling);
+    p->omega_m = rpm * RPM_TO_RAD_S;
+    foc_sim_run(0.05f); /* 编码器测速与积分项稳定 */
+
+    const float iq_ref = 1.5f;
+    mode_manager_current(0.0f, iq_ref);
+
+    step_result_t r = {0, 0.0f, 0.0f};
+    float peak = 0.0f;
+    for (uint32_t n = 1; n <= 300; n++)
+    {
+        foc_sim_step();
+        peak = fmaxf(peak, p->iq);
+        r.id_dev = fmaxf(r.id_dev, fabsf(p->id));
+        if (!r.rise && p->iq > 0.9f * iq_ref)
+            r.rise = n;
+    }
+    r.overshoot = peak / iq_ref - 1.0f;
+    return r;
+}
+
+static void test_step(void)
+{
+    static const float speeds[] = {0.0f, 500.0f, 1000.0f, 1500.0f};
+    const int num = sizeof(speeds) / sizeof(speeds[0]);
+
+    printf("\n--- Iq 阶跃 0 -> 1.5A, 转速 0 / 500 / 1000 / 1500 RPM ---\n");
+    printf("  %8s | %-26s | %-26s\n", "rpm", "decoupled (rise/os/id)", "coupled (rise/os/id)");
+
+    step_result_t dec[4], cpl[4];
+    for (int i = 0; i < num; i++)
+    {
+        dec[i] = iq_step(1, speeds[i]);
+        cpl[i] = iq_step(0, speeds[i]);
+        printf("  %8.0f | %3u ticks %5.1f%% %6.3fA | %3u ticks %5.1f%% %6.3fA\n", speeds[i],
+               dec[i].rise, dec[i].overshoot * 100.0f, dec[i].id_dev,
+               cpl[i].rise, cpl[i].overshoot * 100.0f, cpl[i].id_dev);
+    }
+
+    uint32_t rise_min = dec[0].rise, rise_max = dec[0].rise;
+    float os_min = dec[0].overshoot, os_max = dec[0].overshoot, id_dev = 0.0f, id_dev_cpl = 0.0f;
+    for (int i = 0; i < num; i++)
+    {
+        rise_min = (dec[i].rise < rise_min) ? dec[i].rise : rise_min;
+        rise_max = (dec[i].rise > rise_max) ? dec[i].rise : rise_max;
+        os_min = fminf(os_min, dec[i].overshoot);
+        os_max = fmaxf(os_max, dec[i].overshoot);
+        id_dev = fmaxf(id_dev, dec[i].id_dev);
+        id_dev_cpl = fmaxf(id_dev_cpl, cpl[i].id_dev);
+    }
+
+    TEST_CHECK(rise_min > 0 && rise_max - rise_min <= rise_min / 10, "rise time: %u..%u ticks", rise_min, rise_max);
+    TEST_CHECK(os_max < 0.03f, "overshoot: %.1f%%..%.1f%%", os_min * 100.0f, os_max * 100.0f);
+    TEST_CHECK(id_dev < 0.5f * id_dev_cpl, "cross-coupling on Id: %.3f A (coupled %.3f A)", id_dev, id_dev_cpl);
+}
+
+/* 转速斜坡中保持 Iq, 返回斜坡期间 Iq 误差最大值 */
+static float iq_ramp_error(uint8_t decoupling)
+{
+    pmsm_model_t *p = sim_start(decoupling);
+    mode_manager_current(0.0f, 1.0f);
+    foc_sim_run(0.05f);
+
+    const float rate = 10000.0f * RPM_TO_RAD_S; /* rad/s² */
+    float err = 0.0f;
+    for (uint32_t n = 0; n < 3000; n++)
+    {
+        p->omega_m = rate * n * TS;
+        foc_sim_step();
+        if (n > 100)
+            err = fmaxf(err, fabsf(p->iq - 1.0f));
+    }
+    return err;
+}
+
+static void test_ramp(void)
+{
+    printf("\n--- 转速 0 -> 3000 RPM 斜坡, Iq = 1A ---\n");
+
+    float err_dec = iq_ramp_error(1);
+    float err_cpl = iq_ramp_error(0);
+
+    TEST_CHECK(err_dec < 0.1f && err_dec < 0.3f * err_cpl, "iq error during ramp: %.3f A (coupled %.3f A)", err_dec, err_cpl);
+}
+
+int main(void)
+{
+    printf("=== dq decoupling feedforward ===\n");
+
+    test_step();
+    test_ramp();
+
+    return test_summary();
+}
+
+#endif /* FOC_SIM_HOST */
@@ -0,0 +1,360 @@
+/**
+ * @file test_dpwm.c
+ * @brief 不连续调制 (DPWM0/1/2/MAX/MIN + 混合方式) 测试（主机端）
+ *
+ * 编译命令（在 User 目录下运行）：
+ *   gcc -DFOC_SIM_HOST -std=gnu11 -O2 -I test/sim/hal -I . test/test_dpwm.c \
+ *       $(find test/sim foc motor -name '*.c') bsp/as5047.c utils/ramp.c utils/isr_prof.c utils/telemetry.c -lm -o test_dpwm
+ *
+ * 运行：
+ *   ./test_dpwm                (任一失败返回非零)
+ *
+ * 1. 基波等效: 线性区与过调制区内各方式的线电压与扇区法 SVPWM 相同, 占空比在 [0, 1] 内, 一相恰好钳位
+ * 2. 钳位区间: 每相钳位 1/3 周期, DPWM0 / DPWM1 / DPWM2 的正端钳位区间中心分别在 -30° / 0° / +30°
+ * 3. 连续性: 占空比只在钳位相切换处 (每 60°) 跳变, 其余位置连续; DPWMMAX / DPWMMIN 全程连续
+ * 4. 开关损耗: 开关次数为 SVPWM 的 2/3, 按开关电流加权的损耗在电流相位匹配时约为一半
+ * 5. 混合方式: 调制比阈值与滞环, 阈值附近不来回切换
+ * 6. SIL (mode_manager): 速度闭环下各方式转速 / Iq 与 SVPWM 一致, 运行中切换方式无扰动
+ */
+
+#ifdef FOC_SIM_HOST
+
+#include <stdio.h>
+#include <math.h>
+
+#include "foc/svpwm.h"
+#include "test/sim/foc_sim.h"
+#include "motor/mode_manager.h"
+#include "test/sim/test_check.h"
+
+#define TWO_PI 6.28318530718f
+#define DEG (3.14159265f / 180.0f)
+
+static const svpwm_mode_t dpwm_modes[] = {SVPWM_MODE_DPWM0, SVPWM_MODE_DPWM1, SVPWM_MODE_DPWM2,
+                                          SVPWM_MODE_DPWMMAX, SVPWM_MODE_DPWMMIN};
+static const char *dpwm_names[] = {"DPWM0", "DPWM1", "DPWM2", "DPWMMAX", "DPWMMIN"};
+#define DPWM_NUM 5
+
+/* 调制比 m (|u|·√3 / Udc) 与角度对应的 αβ 电压 */
+static alphabeta_t u_vector(float m, float theta, float udc)
+{
+    float mag = m * udc * 0.57735027f;
+    return (alphabeta_t){mag * cosf(theta), mag * sinf(theta)};
+}
+
+static uint8_t clamped(abc_t d)
+{
+    return d.a == 0.0f || d.a == 1.0f || d.b == 0.0f || d.b == 1.0f || d.c == 0.0f || d.c == 1.0f;
+}
+
+/* ------------------------------------------------------------------ */
+/*  基波等效                                                           */
+/* ------------------------------------------------------------------ */
+static void test_equivalence(void)
+{
+    printf("\n--- 基波等效: 线电压与扇区法 SVPWM 相同 ---\n");
+
+    for (int k = 0; k < DPWM_NUM; k++)
+    {
+        float max_err = 0.0f, max_err_om = 0.0f;
+        int range_err = 0, no_clamp = 0;
+        for (int i = 0; i < 20000; i++)
+        {
+            float udc = test_rand_range(6.0f, 24.0f);
+            /* 前一半线性区 (m ≤ 1), 后一半过调制 (m 到 1.3) */
+            float m = (i < 10000) ? test_rand_range(0.0f, 1.0f) : test_rand_range(1.0f, 1.3f);
+            alphabeta_t u = u_vector(m, test_rand_range(0.0f, TWO_PI), udc);
+
+            abc_t ref = svpwm_sector2(u, 1.0f / udc);
+            abc_t d = svpwm_dpwm(u, 1.0f / udc, dpwm_modes[k]);
+
+            float err = fmaxf(fabsf((d.a - d.b) - (ref.a - ref.b)), fabsf((d.b - d.c) - (ref.b - ref.c))) * udc;
+            if (i < 10000)
+                max_err = fmaxf(max_err, err);
+            else
+                max_err_om = fmaxf(max_err_om, err);
+
+            range_err += d.a < 0.0f || d.a > 1.0f || d.b < 0.0f || d.b > 1.0f || d.c < 0.0f || d.c > 1.0f;
+            no_clamp += !clamped(d);
+        }
+        TEST_CHECK(max_err < 1e-4f * 24.0f && max_err_om < 1e-4f * 24.0f && range_err == 0 && no_clamp == 0,
+                   "%-7s line voltage error %.1e V (overmod %.1e V), out of range %d, unclamped %d",
+                   dpwm_names[k], max_err, max_err_om, range_err, no_clamp);
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  钳位区间 + 连续性                                                  */
+/* ------------------------------------------------------------------ */
+#define SWEEP_N 3600
+
+static void test_clamp_and_continuity(void)
+{
+    printf("\n--- 钳位区间与占空比连续性 (m = 0.8, 一个电周期 %d 点) ---\n", SWEEP_N);
+
+    /* A 相正端钳位区间中心 (deg), 跳变位置相对 60° 栅格的偏移 (deg), 每周期跳变次数 */
+    static const float top_center[] = {-30.0f, 0.0f, 30.0f, 0.0f, NAN};
+    static const float jump_phase[] = {0.0f, 30.0f, 0.0f, 0.0f, 0.0f};
+    static const int jump_count[] = {6, 6, 6, 0, 0};
+
+    for (int k = 0; k < DPWM_NUM; k++)
+    {
+        int top_n = 0, bottom_n = 0, jumps = 0, jump_misplaced = 0;
+        float top_sin = 0.0f, top_cos = 0.0f, max_step = 0.0f;
+        abc_t prev = svpwm_dpwm(u_vector(0.8f, -TWO_PI / SWEEP_N, 12.0f), 1.0f / 12.0f, dpwm_modes[k]);
+
+        for (int n = 0; n < SWEEP_N; n++)
+        {
+            /* 避开恰好位于边界上的角度 */
+            float theta = TWO_PI * (n + 0.5f) / SWEEP_N;
+            abc_t d = svpwm_dpwm(u_vector(0.8f, theta, 12.0f), 1.0f / 12.0f, dpwm_modes[k]);
+
+            if (d.a == 1.0f)
+            {
+                top_n++;
+                top_sin += sinf(theta);
+                top_cos += cosf(theta);
+            }
+            else if (d.a == 0.0f)
+            {
+                bottom_n++;
+            }
+
+            /* 相邻点占空比变化: 连续部分 < 0.01, 跳变 (零序切换) 远大于此 */
+            float step = fabsf(d.a - prev.a);
+            if (step > 0.01f)
+            {
+                jumps++;
+                float deg = theta / DEG - jump_phase[k];
+                float off = fabsf(deg - 60.0f * roundf(deg / 60.0f));
+                jump_misplaced += (off > 0.2f);
+            }
+            else
+            {
+                max_step = fmaxf(max_step, step);
+            }
+            prev = d;
+        }
+
+        float frac = (float)(top_n + bottom_n) / SWEEP_N;
+        TEST_CHECK(fabsf(frac - 1.0f / 3.0f) < 0.002f, "%-7s phase A clamped %.1f%% of the period", dpwm_names[k], frac * 100.0f);
+        if (!isnan(top_center[k]))
+        {
+            float center = atan2f(top_sin, top_cos) / DEG;
+            TEST_CHECK(fabsf(center - top_center[k]) < 0.5f, "%-7s top clamp centered at %.1f deg (expected %.0f)",
+                       dpwm_names[k], center, top_center[k]);
+        }
+        TEST_CHECK(jumps == jump_count[k] && jump_misplaced == 0 && max_step < 0.002f,
+                   "%-7s %d jumps per period (%d off the 60 deg grid), max continuous step %.4f",
+                   dpwm_names[k], jumps, jump_misplaced, max_step);
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  开关损耗                                                           */
+/* ------------------------------------------------------------------ */
+static void test_switching_loss(void)
+{
+    printf("\n--- 开关损耗: 开关次数与按 |i| 加权的开关损耗 (相对 SVPWM) ---\n");
+
+    /* 损耗 ∝ Σ 开关相的 |i|; 电流幅值 1, 相对电压滞后 phi */
+    static const float phi_deg[] = {-30.0f, 0.0f, 30.0f};
+    float ratio[DPWM_NUM][3];
+    float count_ratio[DPWM_NUM];
+
+    for (int k = 0; k < DPWM_NUM; k++)
+    {
+        for (int p = 0; p < 3; p++)
+        {
+            float loss = 0.0f, loss_ref = 0.0f;
+            int switched = 0;
+            for (int n = 0; n < SWEEP_N; n++)
+            {
+                float theta = TWO_PI * (n + 0.5f) / SWEEP_N;
+                abc_t d = svpwm_dpwm(u_vector(0.9f, theta, 12.0f), 1.0f / 12.0f, dpwm_modes[k]);
+                float th_i = theta - phi_deg[p] * DEG;
+                float i_abc[3] = {cosf(th_i), cosf(th_i - TWO_PI / 3.0f), cosf(th_i + TWO_PI / 3.0f)};
+                float duty[3] = {d.a, d.b, d.c};
+                for (int x = 0; x < 3; x++)
+                {
+                    loss_ref += fabsf(i_abc[x]);
+                    if (duty[x] > 0.0f && duty[x] < 1.0f)
+                    {
+                        loss += fabsf(i_abc[x]);
+                        switched++;
+                    }
+                }
+            }
+            ratio[k][p] = loss / loss_ref;
+            count_ratio[k] = (float)switched / (3.0f * SWEEP_N);
+        }
+        printf("  %-7s switchings %.3f, loss @ phi -30/0/+30 deg: %.3f %.3f %.3f\n",
+               dpwm_names[k], count_ratio[k], ratio[k][0], ratio[k][1], ratio[k][2]);
+    }
+
+    float count_err = 0.0f;
+    for (int k = 0; k < DPWM_NUM; k++)
+        count_err = fmaxf(count_err, fabsf(count_ratio[k] - 2.0f / 3.0f));
+    TEST_CHECK(count_err < 0.002f, "every DPWM switches 2/3 as often as SVPWM");
+
+    /* 钳位区间与电流峰值对齐时: DPWM0 对应电流超前 30°, DPWM1 同相, DPWM2 滞后 30° */
+    TEST_CHECK(ratio[0][0] < 0.52f && ratio[1][1] < 0.52f && ratio[2][2] < 0.52f,
+               "matched current phase: loss %.3f / %.3f / %.3f of SVPWM", ratio[0][0], ratio[1][1], ratio[2][2]);
+    TEST_CHECK(ratio[1][1] < ratio[3][1] && ratio[1][1] < ratio[4][1],
+               "unity power factor: DPWM1 %.3f < DPWMMAX %.3f, DPWMMIN %.3f", ratio[1][1], ratio[3][1], ratio[4][1]);
+}
+
+/* ------------------------------------------------------------------ */
+/*  调制器: 混合方式 + 运行时切换                                      */
+/* ------------------------------------------------------------------ */
+static void test_modulator(void)
+{
+    printf("\n--- 调制器: 混合方式滞环, 运行时切换 ---\n");
+
+    svpwm_modulator_t mod;
+    svpwm_modulator_init(&mod, SVPWM_MODE_SVPWM);
+
+    /* SVPWM 方式与 svpwm_update_udc 逐位一致 */
+    int mismatch = 0;
+    for (int i = 0; i < 1000; i++)
+    {
+        alphabeta_t u = {test_rand_range(-8.0f, 8.0f), test_rand_range(-8.0f, 8.0f)};
+        abc_t a = svpwm_update_udc(u, SVPWM_INV_UDC);
+        abc_t b = svpwm_modulate(&mod, u, SVPWM_INV_UDC);
+        mismatch += (a.a != b.a) || (a.b != b.b) || (a.c != b.c);
+    }
+    TEST_CHECK(mismatch == 0, "SVPWM mode bit-identical to svpwm_update_udc (%d mismatches)", mismatch);
+
+    /* 调制比 0 -> 0.8 -> 0 三角波, 叠加 ±0.03 噪声, 矢量同时旋转 */
+    svpwm_modulator_set_mode(&mod, SVPWM_MODE_HYBRID);
+    int switches = 0, wrong = 0;
+    uint8_t last = 0;
+    float m_on = 0.0f, m_off = 0.0f;
+    for (int n = 0; n < 20000; n++)
+    {
+        float m = 0.8f * (1.0f - fabsf(n - 10000.0f) / 10000.0f) + test_rand_range(-0.03f, 0.03f);
+        m = fmaxf(m, 0.0f);
+        abc_t d = svpwm_modulate(&mod, u_vector(m, n * 0.01f, 12.0f), 1.0f / 12.0f);
+        uint8_t active = clamped(d) && m > 0.05f;
+
+        if (active != last)
+        {
+            switches++;
+            if (active)
+                m_on = m;
+            else
+                m_off = m;
+        }
+        last = active;
+        wrong += (m > SVPWM_HYBRID_M_ON && !active) || (m < SVPWM_HYBRID_M_OFF && active);
+    }
+    TEST_CHECK(switches == 2 && wrong == 0, "%d switches (DPWM on at m = %.3f, off at m = %.3f), %d wrong",
+               switches, m_on, m_off, wrong);
+
+    /* 运行中切换: 下一次调制即使用新方式 */
+    alphabeta_t u = u_vector(0.8f, 0.3f, 12.0f);
+    svpwm_modulator_set_mode(&mod, SVPWM_MODE_DPWMMIN);
+    abc_t d = svpwm_modulate(&mod, u, 1.0f / 12.0f);
+    uint8_t ok = fminf(d.a, fminf(d.b, d.c)) == 0.0f;
+    svpwm_modulator_set_mode(&mod, SVPWM_MODE_NUM); /* 无效值被忽略 */
+    d = svpwm_modulate(&mod, u, 1.0f / 12.0f);
+    ok = ok && mod.mode == SVPWM_MODE_DPWMMIN && fminf(d.a, fminf(d.b, d.c)) == 0.0f;
+    svpwm_modulator_set_mode(&mod, SVPWM_MODE_SVPWM);
+    d = svpwm_modulate(&mod, u, 1.0f / 12.0f);
+    ok = ok && !clamped(d);
+    TEST_CHECK(ok, "mode change applies on the next call, invalid mode ignored");
+}
+
+/* ------------------------------------------------------------------ */
+/*  SIL                                                                */
+/* ------------------------------------------------------------------ */
+typedef struct
+{
+    float rpm_mean;   /* 转速平均值 */
+    float iq_std;     /* 被控对象 Iq 标准差 (A) */
+    float clamp_frac; /* 有钳位相的周期比例 */
+} sil_result_t;
+
+/* 母线 8V, 速度闭环 2500 RPM 带载 (调制比约 0.65), 先以 SVPWM 稳定后切换到 mode 再统计 */
+static sil_result_t run_speed(svpwm_mode_t mode)
+{
+    pmsm_param_t param;
+    pmsm_model_default_param(&param);
+    param.u_dc = 8.0f;
+    foc_sim_init(&param);
+    mode_manager_init();
+
+    pmsm_model_t *p = foc_sim_get_plant();
+    p->param.load_torque = 0.005f;
+
+    mode_manager_speed(2500.0f);
+    foc_sim_run(4.0f);
+
+    mode_manager_set_pwm_mode(mode);
+
+    double rpm_sum = 0.0, iq_sum = 0.0, iq_sum2 = 0.0;
+    int clamp_n = 0;
+    const int ticks = 5000;
+    for (int n = 0; n < ticks; n++)
+    {
+        foc_sim_step();
+
+        float da, db, dc;
+        foc_sim_get_duty(&da, &db, &dc);
+        clamp_n += clamped((abc_t){da, db, dc});
+
+        rpm_sum += pmsm_model_get_speed_rpm(p);
+        iq_sum += p->iq;
+        iq_sum2 += p->iq * p->iq;
+    }
+
+    sil_result_t r;
+    r.rpm_mean = (float)(rpm_sum / ticks);
+    double iq_mean = iq_sum / ticks;
+    r.iq_std = (float)sqrt(fmax(iq_sum2 / ticks - iq_mean * iq_mean, 0.0));
+    r.clamp_frac = (float)clamp_n / ticks;
+    return r;
+}
+
+static void test_sil(void)
+{
+    printf("\n--- SIL: 速度闭环 2500 RPM 带载, 母线 8V, 运行中切换调制方式 ---\n");
+
+    static const svpwm_mode_t modes[] = {SVPWM_MODE_SVPWM, SVPWM_MODE_DPWM1, SVPWM_MODE_DPWMMIN, SVPWM_MODE_HYBRID};
+    static const char *names[] = {"SVPWM", "DPWM1", "DPWMMIN", "HYBRID"};
+    sil_result_t r[4];
+
+    for (int i = 0; i < 4; i++)
+    {
+        r[i] = run_speed(modes[i]);
+        printf("  %-8s speed %.1f rpm, iq std %.4f A, clamped %.1f%% of periods\n",
+               names[i], r[i].rpm_mean, r[i].iq_std, r[i].clamp_frac * 100.0f);
+    }
+
+    TEST_CHECK(fabsf(r[0].rpm_mean - 2500.0f) < 10.0f && r[0].clamp_frac == 0.0f, "SVPWM reference: %.1f rpm", r[0].rpm_mean);
+    for (int i = 1; i < 4; i++)
+    {
+        TEST_CHECK(fabsf(r[i].rpm_mean - r[0].rpm_mean) < 5.0f && r[i].iq_std < 1.5f * r[0].iq_std + 0.01f &&
+                       r[i].clamp_frac == 1.0f,
+                   "%-8s same operating point as SVPWM, clamped every period", names[i]);
+    }
+
+    TEST_CHECK(mode_manager_command("pwm 2") == 0 && mode_manager_command("pwm 7") == -1 &&
+                   mode_manager_command("pwm 1.5") == -1,
+               "pwm command accepts 0..6 only");
+}
+
+int main(void)
+{
+    printf("=== discontinuous PWM ===\n");
+
+    test_equivalence();
+    test_clamp_and_continuity();
+    test_switching_loss();
+    test_modulator();
+    test_sil();
+
+    return test_summary();
+}
+
+#endif /* FOC_SIM_HOST */
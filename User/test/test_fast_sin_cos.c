@@ -3,13 +3,22 @@
  * @brief fast_sin_cos 精度与性能测试（GCC 独立编译）
  *
  * 编译命令（在 User/test 目录下运行）：
- *   gcc test_fast_sin_cos.c -o test_fast_sin_cos -lm -O2 -march=native -I../../
+ *   gcc -DFOC_SIM_HOST test_fast_sin_cos.c -o test_fast_sin_cos -lm -O2 -march=native -I../../
+ *
+ *   查表长度可用 -DFAST_SIN_LUT_BITS=6/7/8 选择
  *
  * 运行：
- *   ./test_fast_sin_cos        (Linux/MinGW)
+ *   ./test_fast_sin_cos        (Linux/MinGW, 整数角度后端误差超限返回非零)
  *   test_fast_sin_cos.exe      (Windows)
+ *
+ * 1. fast_sin / fast_cos / fast_sin_cos 与 sinf / cosf 的精度与耗时
+ * 2. 整数角度 sin/cos 各后端 (多项式、minimax、查表线性 / 二次插值) 在整圈上的最大误差与耗时,
+ *    用于按使用位置 (Park、PLL) 在精度与周期数之间取舍
+ * 3. fast_atan_u32 (SMO 相位滞后补偿) 与 atanf 的误差与耗时
  */
 
+#ifdef FOC_SIM_HOST
+
 #include <stdio.h>
 #include <math.h>
 #include <time.h>
@@ -25,6 +34,8 @@
 #define BENCH_N       100000000    /* 性能测试循环次数 */
 #define ACCURACY_N    1000       /* 精度测试采样数   */
 #define PRINT_ROWS    20         /* 精度表格打印行数 */
+#define BACKEND_BENCH_N 20000000   /* 整数角度后端耗时测试循环次数 */
+#define BACKEND_ACCURACY_SHIFT 10  /* 整数角度后端精度扫描步长 2^10 (整圈 2^22 点) */
 
 /* ------------------------------------------------------------------ */
 /*  防止编译器优化掉计算结果                                            */
@@ -169,12 +180,128 @@ static void benchmark(void)
     BENCH_PRINT("sinf + cosf", "fast_sin_cos", dt_ref, dt_fast);
 }
 
+/* ------------------------------------------------------------------ */
+/*  整数角度后端: 精度与耗时                                            */
+/* ------------------------------------------------------------------ */
+typedef void (*sin_cos_u32_fn)(uint32_t angle, float *sin_x, float *cos_x);
+
+static int backend_fail = 0;
+
+/* 整圈等间隔扫描, 参考值用双精度; 超过 max_err 记为失败 */
+static void backend_accuracy(const char *name, sin_cos_u32_fn fn, double max_err, double ns_per_call)
+{
+    double sin_err = 0.0, cos_err = 0.0;
+    for (uint64_t a = 0; a < (1ULL << 32); a += 1ULL << BACKEND_ACCURACY_SHIFT)
+    {
+        float s, c;
+        double th = (double)a * (2.0 * M_PI / 4294967296.0);
+        fn((uint32_t)a, &s, &c);
+        sin_err = fmax(sin_err, fabs(s - sin(th)));
+        cos_err = fmax(cos_err, fabs(c - cos(th)));
+    }
+
+    int ok = sin_err <= max_err && cos_err <= max_err;
+    if (!ok)
+        backend_fail++;
+    printf("%-16s  %-12.3e  %-12.3e  %-10.2f  %s (limit %.1e)\n", name, sin_err, cos_err, ns_per_call,
+           ok ? "PASS" : "FAIL", max_err);
+}
+
+/* 耗时: 直接调用使后端内联; 角度步长取与 2^32 互质的奇数, 遍历各象限与表项 */
+#define BACKEND_BENCH(fn, ns_per_call)                      \
+    do {                                                    \
+        double t0_ = get_ms();                              \
+        uint32_t angle_ = 0;                                \
+        for (int i_ = 0; i_ < BACKEND_BENCH_N; i_++)        \
+        {                                                   \
+            float s_, c_;                                   \
+            fn(angle_, &s_, &c_);                           \
+            sink = s_ + c_;                                 \
+            angle_ += 0x9E3779B9u;                          \
+        }                                                   \
+        (ns_per_call) = (get_ms() - t0_) * 1e6 / BACKEND_BENCH_N; \
+    } while(0)
+
+static void backend_test(void)
+{
+    /* 误差上限: 理论截断误差 + float 舍入余量 */
+    const double h = 0.5 * M_PI / (double)SIN_LUT_N;
+    double ns;
+
+    printf("=== Integer-angle backends  (N = %d, LUT %lu intervals / quarter) ===\n\n",
+           BACKEND_BENCH_N, (unsigned long)SIN_LUT_N);
+    printf("%-16s  %-12s  %-12s  %-10s  %s\n", "backend", "sin_max_err", "cos_max_err", "ns/call", "result");
+    printf("%-16s  %-12s  %-12s  %-10s  %s\n", "--------------", "----------", "----------", "-------", "------");
+
+    BACKEND_BENCH(fast_sin_cos_u32, ns);
+    backend_accuracy("poly (11/12)", fast_sin_cos_u32, 3e-7, ns);
+
+    BACKEND_BENCH(fast_sin_cos_u32_minimax, ns);
+    backend_accuracy("minimax (5/4)", fast_sin_cos_u32_minimax, 1.3e-5, ns);
+
+    BACKEND_BENCH(fast_sin_cos_u32_lut, ns);
+    backend_accuracy("lut linear", fast_sin_cos_u32_lut, h * h / 8.0 + 3e-7, ns);
+
+    BACKEND_BENCH(fast_sin_cos_u32_lut_quad, ns);
+    backend_accuracy("lut quadratic", fast_sin_cos_u32_lut_quad, h * h * h / 16.0 + 3e-7, ns);
+
+    printf("\n");
+}
+
+/* ------------------------------------------------------------------ */
+/*  反正切 (整数角度输出)                                               */
+/* ------------------------------------------------------------------ */
+static void atan_test(void)
+{
+    const double max_err = 1.2e-5;
+    static const float edge[] = {1.0f, 1.00001f, 1e6f, INFINITY};
+
+    /* [-16, 16] 等间隔扫描 (覆盖 |x| <= 1 与 |x| > 1 两个分支) 加分支边界与极大值 */
+    double err = 0.0;
+    for (int i = -1600000; i <= 1600000; i++)
+    {
+        float x = (float)i * 1e-5f;
+        err = fmax(err, fabs((double)(int32_t)fast_atan_u32(x) * (2.0 * M_PI / 4294967296.0) - atan((double)x)));
+    }
+    for (unsigned i = 0; i < sizeof(edge) / sizeof(edge[0]); i++)
+    {
+        for (int s = -1; s <= 1; s += 2)
+        {
+            float x = (float)s * edge[i];
+            err = fmax(err, fabs((double)(int32_t)fast_atan_u32(x) * (2.0 * M_PI / 4294967296.0) - atan((double)x)));
+        }
+    }
+
+    double t0 = get_ms();
+    for (int i = 0; i < BACKEND_BENCH_N; i++)
+        sink = atanf((float)(i & 0xFFFF) * 3e-5f);
+    double ns_ref = (get_ms() - t0) * 1e6 / BACKEND_BENCH_N;
+
+    t0 = get_ms();
+    for (int i = 0; i < BACKEND_BENCH_N; i++)
+        sink = (float)(int32_t)fast_atan_u32((float)(i & 0xFFFF) * 3e-5f);
+    double ns_fast = (get_ms() - t0) * 1e6 / BACKEND_BENCH_N;
+
+    int ok = err <= max_err;
+    if (!ok)
+        backend_fail++;
+    printf("=== fast_atan_u32 ===\n\n");
+    printf("max_err %.3e rad (limit %.1e) %s, atanf %.2f ns, fast_atan_u32 %.2f ns\n\n", err, max_err, ok ? "PASS" : "FAIL",
+           ns_ref, ns_fast);
+}
+
 /* ------------------------------------------------------------------ */
 /*  main                                                                */
 /* ------------------------------------------------------------------ */
-// int main(void)
-// {
-//     accuracy_test();
-//     benchmark();
-//     return 0;
-// }
+int main(void)
+{
+    accuracy_test();
+    benchmark();
+    backend_test();
+    atan_test();
+
+    printf("%s (%d failed)\n", backend_fail ? "FAILED" : "ALL PASSED", backend_fail);
+    return backend_fail ? 1 : 0;
+}
+
+#endif /* FOC_SIM_HOST */
@@ -0,0 +1,389 @@
+/**
+ * @file test_fixed_point.c
+ * @brief Q15 定点后端与浮点后端的精度 / 性能对比（主机端）
+ *
+ * 编译命令（在 User 目录下运行）：
+ *   gcc -DFOC_SIM_HOST -std=gnu11 -O2 -I test/sim/hal -I . test/test_fixed_point.c \
+ *       foc/clark_park.c foc/clark_park_q15.c foc/svpwm.c foc/svpwm_q15.c foc/pid.c foc/pid_q15.c \
+ *       foc/smo.c foc/smo_q15.c foc/luenberger.c foc/luenberger_q15.c -lm -o test_fixed_point
+ *
+ * 运行：
+ *   ./test_fixed_point         (任一失败返回非零)
+ *
+ * 精度: 以双精度 / 浮点实现的结果按相同标幺基准量化为 Q15 作为参考, 统计定点实现的最大 LSB 误差;
+ *       观测器用理想 PMSM 稳态信号驱动, 比较两种后端的角度与速度。
+ * 性能: 每个函数循环调用取 ns/call。主机端结果只反映相对开销, 目标板数据用 isr_prof (DWT) 测量。
+ */
+
+#ifdef FOC_SIM_HOST
+
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "foc/foc_math.h"
+#include "test/sim/test_check.h"
+
+#define TWO_PI 6.28318530718
+
+/* 与 motor/ 下的参数一致 */
+#define MOTOR_RS 0.12f
+#define MOTOR_LS 0.00003f
+#define MOTOR_PSI 0.0015f
+#define MOTOR_POLES 7.0f
+#define MOTOR_TS 0.0001f
+
+#define ACCURACY_N 200000
+#define BENCH_N 2000000
+
+static double rand_unit(void)
+{
+    return (double)rand() / RAND_MAX * 2.0 - 1.0;
+}
+
+/* 定点结果相对参考值 (Q15 浮点表示) 的 LSB 误差 */
+static double lsb_error(q15_t q, double ref)
+{
+    if (ref > 32767.0 / 32768.0)
+        ref = 32767.0 / 32768.0;
+    if (ref < -1.0)
+        ref = -1.0;
+    return fabs((double)q - ref * 32768.0);
+}
+
+static void update_max(double *max, double value)
+{
+    if (value > *max)
+        *max = value;
+}
+
+/* ------------------------------------------------------------------ */
+/*  坐标变换                                                            */
+/* ------------------------------------------------------------------ */
+static void test_transforms(void)
+{
+    printf("clark / park (%d samples)\n", ACCURACY_N);
+
+    double err_clark = 0.0, err_iclark = 0.0, err_park = 0.0, err_ipark = 0.0;
+    srand(1);
+
+    for (int i = 0; i < ACCURACY_N; i++)
+    {
+        /* 平衡三相 (ia + ib + ic = 0) */
+        double a = rand_unit() * 0.5, b = rand_unit() * 0.5;
+        abc_q15_t abc = {Q15(a), Q15(b), Q15(-a - b)};
+
+        alphabeta_q15_t ab = foc_clark(abc);
+        double alpha = abc.a / 32768.0, beta = (abc.a / 32768.0 + 2.0 * abc.b / 32768.0) / sqrt(3.0);
+        update_max(&err_clark, lsb_error(ab.alpha, alpha));
+        update_max(&err_clark, lsb_error(ab.beta, beta));
+
+        alphabeta_q15_t ab_in = {Q15(rand_unit() * 0.9), Q15(rand_unit() * 0.9)};
+        abc_q15_t abc_out = foc_iclark(ab_in);
+        double ia = ab_in.alpha / 32768.0;
+        double ib = -0.5 * ia + sqrt(3.0) / 2.0 * ab_in.beta / 32768.0;
+        update_max(&err_iclark, lsb_error(abc_out.a, ia));
+        update_max(&err_iclark, lsb_error(abc_out.b, ib));
+        update_max(&err_iclark, lsb_error(abc_out.c, -ia - ib));
+
+        uint16_t theta = (uint16_t)rand();
+        double th = theta * TWO_PI / 65536.0;
+        dq_q15_t dq = foc_park(ab_in, theta);
+        double al = ab_in.alpha / 32768.0, be = ab_in.beta / 32768.0;
+        update_max(&err_park, lsb_error(dq.d, al * cos(th) + be * sin(th)));
+        update_max(&err_park, lsb_error(dq.q, -al * sin(th) + be * cos(th)));
+
+        dq_q15_t dq_in = {Q15(rand_unit() * 0.7), Q15(rand_unit() * 0.7)};
+        alphabeta_q15_t ab_out = foc_ipark(dq_in, theta);
+        double d = dq_in.d / 32768.0, q = dq_in.q / 32768.0;
+        update_max(&err_ipark, lsb_error(ab_out.alpha, d * cos(th) - q * sin(th)));
+        update_max(&err_ipark, lsb_error(ab_out.beta, d * sin(th) + q * cos(th)));
+    }
+
+    /* clark 只有舍入误差; park 另含 sin/cos 多项式误差 (不超过 7 LSB) */
+    TEST_CHECK(err_clark <= 1.0, "clark  max error = %.2f LSB", err_clark);
+    TEST_CHECK(err_iclark <= 1.5, "iclark max error = %.2f LSB", err_iclark);
+    TEST_CHECK(err_park <= 10.0, "park   max error = %.2f LSB", err_park);
+    TEST_CHECK(err_ipark <= 10.0, "ipark  max error = %.2f LSB", err_ipark);
+}
+
+/* ------------------------------------------------------------------ */
+/*  SVPWM                                                               */
+/* ------------------------------------------------------------------ */
+static void test_svpwm(void)
+{
+    printf("svpwm (%d samples)\n", ACCURACY_N);
+
+    double err_linear = 0.0, err_over = 0.0;
+    srand(2);
+
+    for (int i = 0; i < ACCURACY_N; i++)
+    {
+        /* 幅值覆盖线性区 (≤ U_DC/√3) 与过调制区 */
+        double mag = (double)rand() / RAND_MAX * 0.75;
+        double angle = (double)rand() / RAND_MAX * TWO_PI;
+        alphabeta_q15_t u_q = {Q15(mag * cos(angle)), Q15(mag * sin(angle))};
+
+        /* 浮点参考使用同一组量化后的电压 */
+        alphabeta_t u_f = {u_q.alpha / 32768.0f * U_DC, u_q.beta / 32768.0f * U_DC};
+        abc_t duty_f = foc_svpwm(u_f);
+        abc_q15_t duty_q = foc_svpwm(u_q);
+
+        double err = 0.0;
+        update_max(&err, lsb_error(duty_q.a, duty_f.a));
+        update_max(&err, lsb_error(duty_q.b, duty_f.b));
+        update_max(&err, lsb_error(duty_q.c, duty_f.c));
+
+        if (mag < 0.57)
+            update_max(&err_linear, err);
+        else
+            update_max(&err_over, err);
+    }
+
+    TEST_CHECK(err_linear <= 3.0, "linear region    max error = %.2f LSB", err_linear);
+    TEST_CHECK(err_over <= 4.0, "overmodulation   max error = %.2f LSB", err_over);
+}
+
+/* ------------------------------------------------------------------ */
+/*  PI 控制器                                                           */
+/* ------------------------------------------------------------------ */
+static void test_pid(void)
+{
+    printf("pid (current loop gains, %d steps)\n", ACCURACY_N);
+
+    /* 电流环参数: 输入电流, 输出电压 */
+    const float kp = 0.017f, ki = 0.002826f, out_max = U_DC / 3.0f;
+
+    pid_controller_t pid_f;
+    pid_q15_t pid_q;
+    foc_pid_init(&pid_f, kp, ki, -out_max, out_max, 0, 0);
+    pid_q15_init(&pid_q, PID_Q15_GAIN(kp, FOC_Q15_I_BASE, FOC_Q15_U_BASE),
+                 PID_Q15_GAIN(ki, FOC_Q15_I_BASE, FOC_Q15_U_BASE),
+                 FOC_Q15_VOLTAGE(-out_max), FOC_Q15_VOLTAGE(out_max));
+
+    double err_max = 0.0;
+    int saturated = 0;
+    srand(3);
+
+    q15_t setpoint = 0;
+    int32_t bias = 0;
+    for (int i = 0; i < ACCURACY_N; i++)
+    {
+        /* 阶跃设定 + 带偏置的随机反馈, 覆盖饱和与退饱和 */
+        if (i % 2000 == 0)
+        {
+            setpoint = FOC_Q15_CURRENT(rand_unit() * 8.0);
+            bias = (int32_t)(rand_unit() * 2000.0);
+        }
+        q15_t feedback = q15_sat(setpoint + bias + (int32_t)(rand_unit() * 600.0));
+
+        float out_f = foc_pid_calculate(&pid_f, setpoint * FOC_Q15_I_BASE / 32768.0f,
+                                        feedback * FOC_Q15_I_BASE / 32768.0f);
+        q15_t out_q = foc_pid_calculate(&pid_q, setpoint, feedback);
+
+        if (fabsf(out_f) >= out_max)
+            saturated++;
+        update_max(&err_max, lsb_error(out_q, out_f / FOC_Q15_U_BASE));
+    }
+
+    /*
+     * 未饱和时只有舍入误差 (约 1 LSB); 进出饱和的那一拍两种实现的抗饱和判断可能相差一步,
+     * 积分相差一次增量 ki * error (此处最大约 10 LSB), 故容差取 12 LSB
+     */
+    TEST_CHECK(err_max <= 12.0, "max error = %.2f LSB (%d saturated steps)", err_max, saturated);
+}
+
+/* ------------------------------------------------------------------ */
+/*  观测器: 理想 PMSM 稳态信号 (id = 0)                                  */
+/* ------------------------------------------------------------------ */
+typedef struct
+{
+    double theta;
+    double i_alpha, i_beta;
+    double u_alpha, u_beta;
+} motor_signal_t;
+
+static void motor_signal(motor_signal_t *s, double we, double iq, double t)
+{
+    double th = fmod(we * t, TWO_PI);
+    double sn = sin(th), cs = cos(th);
+
+    /* i = iq·(-sinθ, cosθ), u = Rs·i + Ls·di/dt + ωψ·(-sinθ, cosθ) */
+    s->theta = th;
+    s->i_alpha = -iq * sn;
+    s->i_beta = iq * cs;
+    s->u_alpha = MOTOR_RS * s->i_alpha - MOTOR_LS * we * iq * cs - we * MOTOR_PSI * sn;
+    s->u_beta = MOTOR_RS * s->i_beta - MOTOR_LS * we * iq * sn + we * MOTOR_PSI * cs;
+}
+
+/* 角度差 (度, 电角度), 折算到 [-180, 180) */
+static double angle_diff_deg(double a, double b)
+{
+    double d = fmod(a - b, TWO_PI);
+    if (d >= TWO_PI / 2)
+        d -= TWO_PI;
+    if (d < -TWO_PI / 2)
+        d += TWO_PI;
+    return d * 360.0 / TWO_PI;
+}
+
+static void test_observers(float rpm)
+{
+    printf("observers @ %.0f rpm\n", rpm);
+
+    double we = rpm * MOTOR_POLES * TWO_PI / 60.0;
+
+    smo_t smo_f;
+    smo_q15_t smo_q;
+    luenberger_t lb_f;
+    luenberger_q15_t lb_q;
+
+    foc_smo_init(&smo_f, MOTOR_RS, MOTOR_LS, MOTOR_POLES, MOTOR_TS, 1.4f, 0.3f, 3.0f, 50.0f, 0.02f);
+    smo_q15_init(&smo_q, MOTOR_RS, MOTOR_LS, MOTOR_POLES, MOTOR_TS, 1.4f, 0.3f, 3.0f, 50.0f, 0.02f);
+    foc_luenberger_init(&lb_f, MOTOR_RS, MOTOR_LS, MOTOR_POLES, MOTOR_TS, -13000.0f, 2200.0f, 50.0f, 0.05f);
+    luenberger_q15_init(&lb_q, MOTOR_RS, MOTOR_LS, MOTOR_POLES, MOTOR_TS, -13000.0f, 2200.0f, 50.0f, 0.05f);
+
+    double smo_diff = 0.0, lb_diff = 0.0, smo_err_f = 0.0, smo_err_q = 0.0, lb_err_f = 0.0, lb_err_q = 0.0;
+    int steps = 5000, tail = 1000;
+
+    for (int k = 0; k < steps; k++)
+    {
+        motor_signal_t s;
+        motor_signal(&s, we, 2.0, k * MOTOR_TS);
+
+        q15_t ia = FOC_Q15_CURRENT(s.i_alpha), ib = FOC_Q15_CURRENT(s.i_beta);
+        q15_t ua = FOC_Q15_VOLTAGE(s.u_alpha), ub = FOC_Q15_VOLTAGE(s.u_beta);
+
+        /* 浮点观测器使用同一组量化后的输入 */
+        smo_f.i_alpha = lb_f.i_alpha = Q15_TO_FLOAT(ia) * FOC_Q15_I_BASE;
+        smo_f.i_beta = lb_f.i_beta = Q15_TO_FLOAT(ib) * FOC_Q15_I_BASE;
+        smo_f.u_alpha = lb_f.u_alpha = Q15_TO_FLOAT(ua) * FOC_Q15_U_BASE;
+        smo_f.u_beta = lb_f.u_beta = Q15_TO_FLOAT(ub) * FOC_Q15_U_BASE;
+        smo_q.i_alpha = lb_q.i_alpha = ia;
+        smo_q.i_beta = lb_q.i_beta = ib;
+        smo_q.u_alpha = lb_q.u_alpha = ua;
+        smo_q.u_beta = lb_q.u_beta = ub;
+
+        foc_smo_estimate(&smo_f);
+        foc_smo_estimate(&smo_q);
+        foc_luenberger_estimate(&lb_f);
+        foc_luenberger_estimate(&lb_q);
+
+        if (k >= steps - tail)
+        {
+            /* 观测器在本周期末给出下一时刻的角度 */
+            double th_next = s.theta + we * MOTOR_TS;
+            double a_sf = FOC_ANGLE_TO_FLOAT(foc_smo_get_angle(&smo_f)), a_sq = QANGLE_TO_RAD(foc_smo_get_angle(&smo_q));
+            double a_lf = FOC_ANGLE_TO_FLOAT(foc_luenberger_get_angle(&lb_f)), a_lq = QANGLE_TO_RAD(foc_luenberger_get_angle(&lb_q));
+
+            update_max(&smo_diff, fabs(angle_diff_deg(a_sq, a_sf)));
+            update_max(&lb_diff, fabs(angle_diff_deg(a_lq, a_lf)));
+            update_max(&smo_err_f, fabs(angle_diff_deg(a_sf, th_next)));
+            update_max(&smo_err_q, fabs(angle_diff_deg(a_sq, th_next)));
+            update_max(&lb_err_f, fabs(angle_diff_deg(a_lf, th_next)));
+            update_max(&lb_err_q, fabs(angle_diff_deg(a_lq, th_next)));
+        }
+    }
+
+    double smo_rpm_q = Q15_TO_FLOAT(smo_q15_get_speed(&smo_q)) * FOC_Q15_W_BASE * 60.0 / (TWO_PI * MOTOR_POLES);
+    double lb_rpm_q = Q15_TO_FLOAT(luenberger_q15_get_speed(&lb_q)) * FOC_Q15_W_BASE * 60.0 / (TWO_PI * MOTOR_POLES);
+
+    TEST_CHECK(smo_diff < 1.0, "SMO        q15 vs float = %.3f deg (error to rotor: float %.2f, q15 %.2f deg)",
+               smo_diff, smo_err_f, smo_err_q);
+    TEST_CHECK(fabs(smo_rpm_q - smo_get_speed_rpm(&smo_f)) < 0.005 * rpm, "SMO        speed q15 %.1f / float %.1f rpm",
+               smo_rpm_q, smo_get_speed_rpm(&smo_f));
+    TEST_CHECK(lb_diff < 1.0, "Luenberger q15 vs float = %.3f deg (error to rotor: float %.2f, q15 %.2f deg)",
+               lb_diff, lb_err_f, lb_err_q);
+    TEST_CHECK(fabs(lb_rpm_q - luenberger_get_speed_rpm(&lb_f)) < 0.005 * rpm,
+               "Luenberger speed q15 %.1f / float %.1f rpm", lb_rpm_q, luenberger_get_speed_rpm(&lb_f));
+}
+
+/* ------------------------------------------------------------------ */
+/*  性能                                                                */
+/* ------------------------------------------------------------------ */
+static volatile int32_t sink_i;
+static volatile float sink_f;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+#define BENCH(name_f, body_f, name_q, body_q)                              \
+    do                                                                     \
+    {                                                                      \
+        double t0 = now_ns();                                              \
+        for (int i = 0; i < BENCH_N; i++)                                  \
+        {                                                                  \
+            body_f;                                                        \
+        }                                                                  \
+        double t1 = now_ns();                                              \
+        for (int i = 0; i < BENCH_N; i++)                                  \
+        {                                                                  \
+            body_q;                                                        \
+        }                                                                  \
+        double t2 = now_ns();                                              \
+        printf("  %-22s %7.2f ns   %-24s %7.2f ns\n", name_f, (t1 - t0) / BENCH_N, name_q, \
+               (t2 - t1) / BENCH_N);                                       \
+    } while (0)
+
+static void bench(void)
+{
+    printf("throughput (host, %d calls each)\n", BENCH_N);
+
+    abc_t abc_f = {1.0f, -0.5f, -0.5f};
+    abc_q15_t abc_q = {Q15(0.06), Q15(-0.03), Q15(-0.03)};
+    alphabeta_t ab_f = {1.0f, 0.5f};
+    alphabeta_q15_t ab_q = {Q15(0.06), Q15(0.03)};
+    dq_t dq_f = {0.2f, 1.0f};
+    dq_q15_t dq_q = {Q15(0.02), Q15(0.06)};
+
+    BENCH("clark_transform", abc_f.a += 1e-7f; sink_f = clark_transform(abc_f).beta,
+          "clark_transform_q15", abc_q.a ^= 1; sink_i = clark_transform_q15(abc_q).beta);
+    BENCH("park_transform", sink_f = park_transform(ab_f, (angle_t)(i * 7) << 16).q,
+          "park_transform_q15", sink_i = park_transform_q15(ab_q, (uint16_t)(i * 7)).q);
+    BENCH("ipark_transform", sink_f = ipark_transform(dq_f, (angle_t)(i * 7) << 16).beta,
+          "ipark_transform_q15", sink_i = ipark_transform_q15(dq_q, (uint16_t)(i * 7)).beta);
+
+    BENCH("svpwm_update", ab_f.alpha = (float)(i & 1023) * 0.004f - 2.0f; sink_f = svpwm_update(ab_f).a,
+          "svpwm_update_q15", ab_q.alpha = (q15_t)((i & 1023) * 11 - 5632); sink_i = svpwm_update_q15(ab_q).a);
+
+    pid_controller_t pid_f;
+    pid_q15_t pid_q;
+    pid_init(&pid_f, 0.017f, 0.002826f, -4.0f, 4.0f);
+    pid_q15_init(&pid_q, 0.0227f, 0.00377f, FOC_Q15_VOLTAGE(-4.0f), FOC_Q15_VOLTAGE(4.0f));
+    BENCH("pid_calculate", sink_f = pid_calculate(&pid_f, (float)(i & 255) * 0.01f, 1.0f),
+          "pid_q15_calculate", sink_i = pid_q15_calculate(&pid_q, (q15_t)((i & 255) * 20), 2048));
+
+    smo_t smo_f;
+    smo_q15_t smo_q;
+    smo_init(&smo_f, MOTOR_RS, MOTOR_LS, MOTOR_POLES, MOTOR_TS, 1.4f, 0.3f, 3.0f, 50.0f, 0.02f);
+    smo_q15_init(&smo_q, MOTOR_RS, MOTOR_LS, MOTOR_POLES, MOTOR_TS, 1.4f, 0.3f, 3.0f, 50.0f, 0.02f);
+    BENCH("smo_estimate", smo_f.i_alpha = (float)(i & 255) * 0.01f; smo_estimate(&smo_f); sink_f = smo_f.theta_comp,
+          "smo_q15_estimate", smo_q.i_alpha = (q15_t)((i & 255) * 20); smo_q15_estimate(&smo_q); sink_i = smo_q.theta_comp);
+
+    luenberger_t lb_f;
+    luenberger_q15_t lb_q;
+    luenberger_init(&lb_f, MOTOR_RS, MOTOR_LS, MOTOR_POLES, MOTOR_TS, -13000.0f, 2200.0f, 50.0f, 0.05f);
+    luenberger_q15_init(&lb_q, MOTOR_RS, MOTOR_LS, MOTOR_POLES, MOTOR_TS, -13000.0f, 2200.0f, 50.0f, 0.05f);
+    BENCH("luenberger_estimate", lb_f.i_alpha = (float)(i & 255) * 0.01f; luenberger_estimate(&lb_f); sink_f = lb_f.theta_est,
+          "luenberger_q15_estimate", lb_q.i_alpha = (q15_t)((i & 255) * 20); luenberger_q15_estimate(&lb_q); sink_i = lb_q.theta_est);
+}
+
+int main(void)
+{
+    test_transforms();
+    test_svpwm();
+    test_pid();
+    test_observers(1000.0f);
+    test_observers(3000.0f);
+    test_observers(4500.0f);
+    bench();
+
+    return test_summary();
+}
+
+#endif /* FOC_SIM_HOST */
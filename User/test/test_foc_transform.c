@@ -0,0 +1,267 @@
+/**
+ * @file test_foc_transform.c
+ * @brief 单周期坐标变换上下文 (foc_transform) 与独立变换函数的一致性测试（主机端）
+ *
+ * 编译命令（在 User 目录下运行）：
+ *   gcc -DFOC_SIM_HOST -std=gnu11 -O2 -I test/sim/hal -I . test/test_foc_transform.c \
+ *       foc/foc_transform.c foc/clark_park.c foc/svpwm.c -lm -o test_foc_transform
+ *
+ * 运行：
+ *   ./test_foc_transform       (任一失败返回非零)
+ *
+ * 以 park_transform() / ipark_transform() / svpwm_update() 为基准, 在随机角度与输入上比较
+ * 上下文版本的 Park、反 Park、调制输出及保存的 αβ 电压, 要求误差不超过 TRANSFORM_MAX_ULP
+ * (两者公式相同, 默认编译选项下逐位一致; 若开启 -ffp-contract=fast 等跨函数乘加融合, 可能相差 1 ULP)。
+ * 另验证角度缓存的命中 / 失效、小角度超前 (foc_transform_advance) 的精度, 并对比一个控制周期内分离调用与上下文调用的耗时。
+ */
+
+#ifdef FOC_SIM_HOST
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "foc/foc_transform.h"
+#include "test/sim/test_check.h"
+
+#define TRANSFORM_MAX_ULP 0 /* 允许误差 (ULP) */
+#define TEST_NUM 200000     /* 随机样本数 */
+#define BENCH_NUM 2000000   /* 耗时对比的周期数 */
+
+/* 两个单精度数之间相差的 ULP 数 (同号按位序距离, 异号经过 0) */
+static uint32_t ulp_diff(float a, float b)
+{
+    int32_t ia, ib;
+    memcpy(&ia, &a, sizeof(ia));
+    memcpy(&ib, &b, sizeof(ib));
+
+    /* 映射为单调整数序 */
+    if (ia < 0)
+        ia = (int32_t)0x80000000 - ia;
+    if (ib < 0)
+        ib = (int32_t)0x80000000 - ib;
+
+    int64_t d = (int64_t)ia - ib;
+    return (uint32_t)(d < 0 ? -d : d);
+}
+
+static uint32_t max_u32(uint32_t a, uint32_t b)
+{
+    return a > b ? a : b;
+}
+
+static void test_park_ipark(void)
+{
+    printf("\n--- Park / 反 Park ---\n");
+
+    foc_transform_t ctx;
+    foc_transform_init(&ctx);
+
+    uint32_t park_ulp = 0, ipark_ulp = 0;
+
+    for (int n = 0; n < TEST_NUM; n++)
+    {
+        /* 角度覆盖多圈及负角度 (编码器角度减零点偏移后可能为负) */
+        angle_t theta = angle_from_rad(test_rand_range(-20.0f, 20.0f));
+        alphabeta_t i_ab = {test_rand_range(-10.0f, 10.0f), test_rand_range(-10.0f, 10.0f)};
+        dq_t v_dq = {test_rand_range(-6.0f, 6.0f), test_rand_range(-6.0f, 6.0f)};
+
+        foc_transform_set_angle(&ctx, theta);
+
+        dq_t ref_dq = park_transform(i_ab, theta);
+        dq_t ctx_dq = foc_transform_park(&ctx, i_ab);
+        park_ulp = max_u32(park_ulp, max_u32(ulp_diff(ref_dq.d, ctx_dq.d), ulp_diff(ref_dq.q, ctx_dq.q)));
+
+        alphabeta_t ref_ab = ipark_transform(v_dq, theta);
+        alphabeta_t ctx_ab = foc_transform_ipark(&ctx, v_dq);
+        ipark_ulp = max_u32(ipark_ulp, max_u32(ulp_diff(ref_ab.alpha, ctx_ab.alpha), ulp_diff(ref_ab.beta, ctx_ab.beta)));
+    }
+
+    TEST_CHECK(park_ulp <= TRANSFORM_MAX_ULP, "Park max error = %u ULP", park_ulp);
+    TEST_CHECK(ipark_ulp <= TRANSFORM_MAX_ULP, "反 Park max error = %u ULP", ipark_ulp);
+}
+
+static void test_modulate(void)
+{
+    printf("\n--- 反 Park + SVPWM ---\n");
+
+    foc_transform_t ctx;
+    foc_transform_init(&ctx);
+
+    uint32_t duty_ulp = 0, v_ulp = 0;
+
+    for (int n = 0; n < TEST_NUM; n++)
+    {
+        angle_t theta = angle_from_rad(test_rand_range(-20.0f, 20.0f));
+
+        /* 幅值覆盖线性区与过调制区 (U_DC/√3 ≈ 6.93 V) */
+        dq_t v_dq = {test_rand_range(-8.0f, 8.0f), test_rand_range(-8.0f, 8.0f)};
+
+        foc_transform_set_angle(&ctx, theta);
+        abc_t ctx_duty = foc_transform_modulate(&ctx, v_dq);
+        alphabeta_t ctx_v = foc_transform_get_v_alphabeta(&ctx);
+
+        alphabeta_t ref_v = ipark_transform(v_dq, theta);
+        abc_t ref_duty = svpwm_update(ref_v);
+
+        duty_ulp = max_u32(duty_ulp, ulp_diff(ref_duty.a, ctx_duty.a));
+        duty_ulp = max_u32(duty_ulp, ulp_diff(ref_duty.b, ctx_duty.b));
+        duty_ulp = max_u32(duty_ulp, ulp_diff(ref_duty.c, ctx_duty.c));
+        v_ulp = max_u32(v_ulp, max_u32(ulp_diff(ref_v.alpha, ctx_v.alpha), ulp_diff(ref_v.beta, ctx_v.beta)));
+    }
+
+    TEST_CHECK(duty_ulp <= TRANSFORM_MAX_ULP, "duty max error = %u ULP", duty_ulp);
+    TEST_CHECK(v_ulp <= TRANSFORM_MAX_ULP, "saved v_alphabeta max error = %u ULP", v_ulp);
+}
+
+static void test_angle_cache(void)
+{
+    printf("\n--- 角度缓存 ---\n");
+
+    foc_transform_t ctx;
+    foc_transform_init(&ctx);
+
+    float s, c;
+
+    /* 初始化后缓存无效, 即使角度恰为 0 也必须计算 */
+    ctx.sin_theta = 99.0f;
+    foc_transform_set_angle(&ctx, 0);
+    angle_sin_cos(0, &s, &c);
+    TEST_CHECK(ctx.sin_theta == s && ctx.cos_theta == c, "first set_angle computes sin/cos");
+
+    /* 相同角度命中缓存: 人为改写缓存值后不应被覆盖 */
+    foc_transform_set_angle(&ctx, angle_from_rad(1.25f));
+    ctx.sin_theta = 99.0f;
+    foc_transform_set_angle(&ctx, angle_from_rad(1.25f));
+    TEST_CHECK(ctx.sin_theta == 99.0f, "same angle reuses cached sin/cos");
+
+    /* 角度变化后重新计算 */
+    foc_transform_set_angle(&ctx, angle_from_rad(1.5f));
+    angle_sin_cos(angle_from_rad(1.5f), &s, &c);
+    TEST_CHECK(ctx.sin_theta == s && ctx.cos_theta == c, "new angle recomputes sin/cos");
+
+    /* 重新初始化使缓存失效 */
+    foc_transform_init(&ctx);
+    foc_transform_set_angle(&ctx, angle_from_rad(1.5f));
+    TEST_CHECK(ctx.sin_theta == s && ctx.cos_theta == c, "init invalidates cache");
+}
+
+/* ------------------------------------------------------------------ */
+/*  小角度超前: 旋转缓存的 sinθ / cosθ                                   */
+/* ------------------------------------------------------------------ */
+static void test_advance(void)
+{
+    printf("\n--- 小角度超前 (foc_transform_advance) ---\n");
+
+    foc_transform_t ctx;
+    float angle_err = 0.0f, mag_err = 0.0f;
+    uint32_t extra = 0;
+
+    for (int n = 0; n < TEST_NUM; n++)
+    {
+        angle_t theta = angle_from_rad(test_rand_range(-20.0f, 20.0f));
+        angle_t delta = angle_delta_from_rad(test_rand_range(-0.5f, 0.5f));
+
+        foc_transform_init(&ctx);
+        foc_transform_set_angle(&ctx, theta);
+        uint32_t count = ctx.sin_cos_count;
+        foc_transform_advance(&ctx, delta);
+        extra += ctx.sin_cos_count - count;
+
+        float s, c;
+        angle_sin_cos(theta + delta, &s, &c);
+        angle_err = fmaxf(angle_err, fabsf(atan2f(ctx.sin_theta * c - ctx.cos_theta * s, ctx.cos_theta * c + ctx.sin_theta * s)));
+        mag_err = fmaxf(mag_err, fabsf(sqrtf(ctx.sin_theta * ctx.sin_theta + ctx.cos_theta * ctx.cos_theta) - 1.0f));
+        if (ctx.theta != theta + delta)
+            extra++;
+    }
+
+    TEST_CHECK(angle_err < 0.02f / 57.2957795f, "|Δ| <= 0.5 rad: angle error %.2e deg", angle_err * 57.2957795f);
+    TEST_CHECK(mag_err < 2e-4f, "|Δ| <= 0.5 rad: magnitude error %.2e", mag_err);
+    TEST_CHECK(extra == 0, "advance updates theta without calling sin/cos");
+
+    /* Δ = 0 (静止) 保持缓存不变 */
+    foc_transform_init(&ctx);
+    foc_transform_set_angle(&ctx, angle_from_rad(0.7f));
+    float s0 = ctx.sin_theta, c0 = ctx.cos_theta;
+    foc_transform_advance(&ctx, 0);
+    TEST_CHECK(ctx.sin_theta == s0 && ctx.cos_theta == c0, "zero advance keeps the cached sin/cos bit-exact");
+}
+
+/* ------------------------------------------------------------------ */
+/*  一个控制周期的耗时对比: 原回调的调用序列 vs 上下文                   */
+/* ------------------------------------------------------------------ */
+static volatile float sink;
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec * 1e-6;
+}
+
+static void test_tick_cost(void)
+{
+    printf("\n--- 单周期耗时 (Park + 反 Park + SVPWM + 观测器电压) ---\n");
+
+    /* 两者使用同一个调制器, 差别只在 sin/cos 的次数 */
+    svpwm_modulator_t mod;
+    svpwm_modulator_init(&mod, SVPWM_MODE_SVPWM);
+
+    float acc = 0.0f;
+    double t0 = now_ms();
+    for (int n = 0; n < BENCH_NUM; n++)
+    {
+        angle_t theta = (angle_t)(n & 1023) << 22; /* 一圈 1024 点 */
+        alphabeta_t i_ab = {0.3f, -0.2f};
+
+        /* 分离调用: Park、控制输出反 Park、观测器再次反 Park, 共三次 sin/cos */
+        dq_t i_dq = park_transform(i_ab, theta);
+        dq_t v_dq = {i_dq.d * 2.0f, i_dq.q * 2.0f + 1.0f};
+        abc_t duty = svpwm_modulate(&mod, ipark_transform(v_dq, theta), SVPWM_INV_UDC);
+        alphabeta_t v_ab = ipark_transform(v_dq, theta);
+        acc += duty.a + v_ab.alpha;
+    }
+    double t_separate = now_ms() - t0;
+
+    foc_transform_t ctx;
+    foc_transform_init(&ctx);
+
+    t0 = now_ms();
+    for (int n = 0; n < BENCH_NUM; n++)
+    {
+        angle_t theta = (angle_t)(n & 1023) << 22; /* 一圈 1024 点 */
+        alphabeta_t i_ab = {0.3f, -0.2f};
+
+        /* 上下文: 一次 sin/cos */
+        foc_transform_set_angle(&ctx, theta);
+        dq_t i_dq = foc_transform_park(&ctx, i_ab);
+        dq_t v_dq = {i_dq.d * 2.0f, i_dq.q * 2.0f + 1.0f};
+        abc_t duty = foc_transform_modulate(&ctx, v_dq);
+        alphabeta_t v_ab = foc_transform_get_v_alphabeta(&ctx);
+        acc += duty.a + v_ab.alpha;
+    }
+    double t_fused = now_ms() - t0;
+    sink = acc;
+
+    printf("  separate: %.2f ns/tick\n", t_separate * 1e6 / BENCH_NUM);
+    printf("  context : %.2f ns/tick\n", t_fused * 1e6 / BENCH_NUM);
+    printf("  speedup : %.2fx\n", t_separate / t_fused);
+}
+
+int main(void)
+{
+    printf("=== foc_transform vs separate transforms ===\n");
+
+    test_park_ipark();
+    test_modulate();
+    test_angle_cache();
+    test_advance();
+    test_tick_cost();
+
+    return test_summary();
+}
+
+#endif /* FOC_SIM_HOST */
@@ -0,0 +1,213 @@
+/**
+ * @file test_handover.c
+ * @brief I/F -> 观测器无扰切换 (if_handover) 测试（主机端）
+ *
+ * 编译命令（在 User 目录下运行）：
+ *   gcc -DFOC_SIM_HOST -std=gnu11 -O2 -I test/sim/hal -I . test/test_handover.c \
+ *       $(find test/sim foc motor -name '*.c') bsp/as5047.c utils/ramp.c utils/isr_prof.c utils/telemetry.c -lm -o test_handover
+ *
+ * 运行：
+ *   ./test_handover            (任一失败返回非零)
+ *
+ * 1. 合成信号: 观测角 = 开环角 + 负载角 (+ 噪声), 验证收敛判据、切换瞬间角度连续、偏差按设定速率归零
+ * 2. SIL: sensorless_smo / sensorless_luenberger 从静止启动, 统计进入闭环的时间、切换前后
+ *    被控对象电流峰值与 dq 电流跳变, 判据均基于被控对象真实状态
+ */
+
+#ifdef FOC_SIM_HOST
+
+#include <stdio.h>
+#include <math.h>
+
+#include "foc/if_handover.h"
+#include "test/sim/foc_sim.h"
+#include "motor/sensorless_smo.h"
+#include "motor/sensorless_luenberger.h"
+#include "test/sim/test_check.h"
+
+#define TS FOC_SIM_TS
+#define TWO_PI 6.28318530718f
+
+/* SIL 判据 */
+#define HANDOVER_MAX_SWITCH_TIME 0.5f /* 静止到切换 (s) */
+#define HANDOVER_IF_IQ 0.5f           /* 两种模式的 I/F 电流 (A) */
+#define HANDOVER_MAX_PEAK_RATIO 1.3f  /* 切换窗口内电流峰值 / I/F 电流 */
+#define HANDOVER_MAX_STEP 0.1f        /* 切换窗口内相邻周期 |i_dq| 最大跳变 (A) */
+#define HANDOVER_WINDOW 0.1f          /* 切换后统计窗口 (s) */
+
+/* ------------------------------------------------------------------ */
+/*  合成信号                                                            */
+/* ------------------------------------------------------------------ */
+static void test_synthetic(void)
+{
+    printf("\n--- 合成信号: 负载角 -0.6 rad, 200 RPM ---\n");
+
+    if_handover_t h;
+    if_handover_init(&h, TS, 100.0f, 30.0f, 0.1f, 0.02f, 20.0f);
+
+    const float speed = 200.0f;
+    const float omega = speed / 60.0f * TWO_PI * 7.0f;
+    const float load_angle = -0.6f;
+    const angle_t step = angle_delta_from_rad(omega * TS);
+    angle_t if_angle = 0;
+    angle_t out = 0;
+    uint32_t n = 0;
+
+    /* 前 50ms 观测器未锁定 (角度随机), 之后锁定到 开环角 + 负载角 */
+    for (n = 0; n < 10000 && h.state == IF_HANDOVER_IF; n++)
+    {
+        if_angle += step;
+        angle_t obs_angle = (n < 500) ? angle_from_rad(test_rand_range(-3.0f, 3.0f))
+                                      : if_angle + angle_delta_from_rad(load_angle + test_rand_range(-0.02f, 0.02f));
+        float obs_speed = (n < 500) ? test_rand_range(0.0f, 400.0f) : speed;
+        out = if_handover_update(&h, if_angle, speed, obs_angle, obs_speed);
+    }
+
+    float t_switch = n * TS;
+    TEST_CHECK(h.state == IF_HANDOVER_BLEND && t_switch > 0.05f + 0.02f && t_switch < 0.05f + 0.1f,
+               "switched at %.3f s (observer locks at 0.050 s)", t_switch);
+    TEST_CHECK(out == if_angle, "control angle = I/F angle at switch");
+    TEST_CHECK(fabsf(angle_to_rad(h.offset) - load_angle) < 0.05f, "offset = %.3f rad (load angle %.3f)",
+               angle_to_rad(h.offset), load_angle);
+
+    /* 过渡: 控制角与观测角之差每周期变化不超过 blend_rate·ts, 最终为 0 */
+    float max_step = 0.0f;
+    float prev_diff = -angle_to_rad(h.offset); /* 切换周期: 控制角 - 观测角 = -offset */
+    uint32_t blend_ticks = 0;
+    while (h.state != IF_HANDOVER_DONE && blend_ticks < 10000)
+    {
+        if_angle += step;
+        angle_t obs_angle = if_angle + angle_delta_from_rad(load_angle);
+        out = if_handover_update(&h, if_angle, speed, obs_angle, speed);
+        float diff = angle_diff_rad(out, obs_angle);
+        max_step = fmaxf(max_step, fabsf(diff - prev_diff));
+        prev_diff = diff;
+        blend_ticks++;
+    }
+
+    float expect = fabsf(load_angle) / 20.0f;
+    TEST_CHECK(h.state == IF_HANDOVER_DONE && fabsf(blend_ticks * TS - expect) < 0.002f,
+               "blend took %.4f s (expect %.4f s)", blend_ticks * TS, expect);
+    TEST_CHECK(max_step <= 20.0f * TS * 1.001f, "max angle step = %.5f rad/tick", max_step);
+    TEST_CHECK(fabsf(prev_diff) < 1e-6f, "final control angle = observer angle");
+
+    float iq = if_handover_iq_preload(&h, 0.5f);
+    TEST_CHECK(fabsf(iq - 0.5f) < 1e-6f, "preload after blend = %.3f A", iq);
+
+    printf("\n--- 合成信号: 观测角持续抖动, 不应切换 ---\n");
+    if_handover_init(&h, TS, 100.0f, 30.0f, 0.1f, 0.02f, 20.0f);
+    if_angle = 0;
+    for (n = 0; n < 20000; n++)
+    {
+        if_angle += step;
+        if_handover_update(&h, if_angle, speed, if_angle + angle_delta_from_rad(-0.5f + test_rand_range(-0.5f, 0.5f)), speed);
+    }
+    TEST_CHECK(h.state == IF_HANDOVER_IF, "no switch with ±0.5 rad angle noise (dev = %.3f rad)", h.angle_err_dev);
+
+    printf("\n--- 合成信号: 负载角跨越 ±π ---\n");
+    if_handover_init(&h, TS, 100.0f, 30.0f, 0.1f, 0.02f, 20.0f);
+    if_angle = 0;
+    for (n = 0; n < 10000 && h.state == IF_HANDOVER_IF; n++)
+    {
+        if_angle += step;
+        if_handover_update(&h, if_angle, speed, if_angle + angle_from_rad(3.1f + test_rand_range(-0.1f, 0.1f)), speed);
+    }
+    TEST_CHECK(h.state == IF_HANDOVER_BLEND && fabsf(angle_diff_rad(h.offset, angle_from_rad(3.1f))) < 0.1f,
+               "switched with offset = %.3f rad", angle_to_rad(h.offset));
+
+    /* 偏差接近 ±π 时同样斜坡归零 */
+    angle_t obs_angle = 0;
+    for (n = 0; n < 10000 && h.state != IF_HANDOVER_DONE; n++)
+    {
+        if_angle += step;
+        obs_angle = if_angle + angle_from_rad(3.1f);
+        out = if_handover_update(&h, if_angle, speed, obs_angle, speed);
+    }
+    TEST_CHECK(h.state == IF_HANDOVER_DONE && out == obs_angle, "offset near ±π blended to 0 in %.4f s", n * TS);
+}
+
+/* ------------------------------------------------------------------ */
+/*  SIL                                                                 */
+/* ------------------------------------------------------------------ */
+static float plant_current(void)
+{
+    pmsm_model_t *p = foc_sim_get_plant();
+    return sqrtf(p->id * p->id + p->iq * p->iq);
+}
+
+static void test_sil(const char *name, void (*init)(float), int (*get_state)(void))
+{
+    printf("\n--- %s: 静止启动到 1000 RPM ---\n", name);
+
+    foc_sim_init(NULL);
+    init(1000.0f); /* 含 1s 对齐 */
+    uint32_t t0 = foc_sim_get_ticks();
+
+    /* I/F 阶段 */
+    float peak_if = 0.0f;
+    while (get_state() == 0 && foc_sim_get_ticks() - t0 < 3 * FOC_SIM_TICKS_PER_SEC)
+    {
+        foc_sim_step();
+        if (foc_sim_get_ticks() - t0 > FOC_SIM_TICKS_PER_SEC / 10)
+            peak_if = fmaxf(peak_if, plant_current());
+    }
+    float t_switch = (foc_sim_get_ticks() - t0) * FOC_SIM_TS;
+    TEST_CHECK(t_switch < HANDOVER_MAX_SWITCH_TIME, "time to closed loop = %.3f s", t_switch);
+
+    /* 切换窗口: 电流峰值与相邻周期 dq 电流跳变 */
+    pmsm_model_t *p = foc_sim_get_plant();
+    float peak = 0.0f, max_step = 0.0f;
+    float id_prev = p->id, iq_prev = p->iq;
+    float t_blend = -1.0f;
+    uint32_t window = (uint32_t)(HANDOVER_WINDOW * FOC_SIM_TICKS_PER_SEC);
+    for (uint32_t i = 0; i < window; i++)
+    {
+        foc_sim_step();
+        peak = fmaxf(peak, plant_current());
+        max_step = fmaxf(max_step, hypotf(p->id - id_prev, p->iq - iq_prev));
+        id_prev = p->id;
+        iq_prev = p->iq;
+        if (t_blend < 0.0f && get_state() == 2)
+            t_blend = (i + 1) * FOC_SIM_TS;
+    }
+
+    TEST_CHECK(t_blend > 0.0f, "angle blend finished %.4f s after switch", t_blend);
+    TEST_CHECK(peak < HANDOVER_MAX_PEAK_RATIO * HANDOVER_IF_IQ, "peak current around switch = %.3f A (I/F %.3f A)",
+               peak, peak_if);
+    TEST_CHECK(max_step < HANDOVER_MAX_STEP, "max dq current step = %.3f A/tick", max_step);
+
+    foc_sim_run(2.0f);
+    float sum = 0.0f;
+    for (int i = 0; i < 5000; i++)
+    {
+        foc_sim_step();
+        sum += pmsm_model_get_speed_rpm(p);
+    }
+    TEST_CHECK(fabsf(sum / 5000.0f - 1000.0f) < 50.0f, "final speed = %.1f rpm", sum / 5000.0f);
+}
+
+/* 状态: 0 = I/F, 1 = 过渡, 2 = 观测器闭环 */
+static int smo_state(void)
+{
+    sensorless_state_t s = sensorless_smo_get_state();
+    return (s == STATE_IF_STARTUP) ? 0 : (s == STATE_HANDOVER) ? 1 : 2;
+}
+
+static int luenberger_state(void)
+{
+    luenberger_state_t s = sensorless_luenberger_get_state();
+    return (s == LUENBERGER_STATE_IF_STARTUP) ? 0 : (s == LUENBERGER_STATE_HANDOVER) ? 1 : 2;
+}
+
+int main(void)
+{
+    printf("=== I/F -> observer handover ===\n");
+
+    test_synthetic();
+    test_sil("sensorless_smo", sensorless_smo_init, smo_state);
+    test_sil("sensorless_luenberger", sensorless_luenberger_init, luenberger_state);
+
+    return test_summary();
+}
+
+#endif /* FOC_SIM_HOST */
@@ -0,0 +1,384 @@
+/**
+ * @file test_mode_manager.c
+ * @brief 运行模式管理 (mode_manager) 的 SIL 测试: 串口命令驱动模式切换, 判据基于被控对象真实状态
+ *
+ * 编译命令（在 User 目录下运行）：
+ *   gcc -DFOC_SIM_HOST -std=gnu11 -O2 -I test/sim/hal -I . test/test_mode_manager.c \
+ *       $(find test/sim foc motor -name '*.c') bsp/as5047.c utils/ramp.c utils/isr_prof.c utils/telemetry.c -lm -o test_mode_manager
+ *
+ * 运行：
+ *   ./test_mode_manager        (任一失败返回非零)
+ *
+ * 所有用例在同一次上电 (一次 mode_manager_init) 中连续进行, 验证运行中切换不需要重新初始化:
+ * 首次进入编码器模式自动对齐且只对齐一次, 停机后再启动立即进入闭环, 闭环之间切换转速不跌落,
+ * 转动中切到无感直接使用观测器, 静止时无感经 I/F 启动, 以及命令解析 (分段到达、非法参数、强制重新对齐)。
+ * 另逐周期检查多速率调度: 速度环 / 弱磁环 / 遥测按各自分频执行、互不同拍, 速度环与编码器转速刷新同相。
+ */
+
+#ifdef FOC_SIM_HOST
+
+#include <stdio.h>
+#include <math.h>
+
+#include "test/sim/foc_sim.h"
+#include "motor/mode_manager.h"
+#include "utils/isr_prof.h"
+#include "test/sim/test_check.h"
+
+#define TWO_PI 6.28318530718f
+
+static mode_manager_status_t status;
+
+/* 上位机发送一条命令, 主循环读取并执行 */
+static void send(const char *cmd)
+{
+    foc_sim_uart_rx(cmd);
+    mode_manager_poll();
+}
+
+static float plant_rpm(void)
+{
+    return pmsm_model_get_speed_rpm(foc_sim_get_plant());
+}
+
+/* 一段时间内被控对象转速的均值 / 最小值 / 最大值 */
+static void run_measure(float seconds, float *mean, float *min, float *max)
+{
+    uint32_t ticks = (uint32_t)(seconds * FOC_SIM_TICKS_PER_SEC);
+    float sum = 0.0f;
+    *min = 1e9f;
+    *max = -1e9f;
+
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        foc_sim_step();
+        float rpm = plant_rpm();
+        sum += rpm;
+        *min = (rpm < *min) ? rpm : *min;
+        *max = (rpm > *max) ? rpm : *max;
+    }
+    *mean = sum / (float)ticks;
+}
+
+/* 运行直到模式变为 mode, 返回用时 (s), 超时返回负数 */
+static float run_until_mode(motor_mode_t mode, float timeout)
+{
+    uint32_t ticks = (uint32_t)(timeout * FOC_SIM_TICKS_PER_SEC);
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        foc_sim_step();
+        mode_manager_get_status(&status);
+        if (status.mode == mode)
+            return (float)(i + 1) * FOC_SIM_TS;
+    }
+    return -1.0f;
+}
+
+/* 观测角与被控对象真实电角度之差 (deg) */
+static float observer_angle_error_deg(void)
+{
+    mode_manager_get_status(&status);
+    float err = fmodf(status.angle_el_observer - foc_sim_get_plant()->theta_e, TWO_PI);
+    if (err > TWO_PI * 0.5f)
+        err -= TWO_PI;
+    if (err < -TWO_PI * 0.5f)
+        err += TWO_PI;
+    return err * 360.0f / TWO_PI;
+}
+
+static void test_boot(void)
+{
+    printf("\n--- 上电 ---\n");
+    mode_manager_get_status(&status);
+    TEST_CHECK(status.mode == MOTOR_MODE_STOP, "boot mode = %s", mode_manager_mode_name(status.mode));
+    TEST_CHECK(!status.aligned && status.align_count == 0, "not aligned at boot");
+
+    foc_sim_run(0.01f);
+    float a, b, c;
+    foc_sim_get_duty(&a, &b, &c);
+    TEST_CHECK(a == 0.5f && b == 0.5f && c == 0.5f, "stop duty = %.3f %.3f %.3f", a, b, c);
+}
+
+static void test_first_speed(void)
+{
+    printf("\n--- spd 1000: 自动对齐 + 速度闭环 ---\n");
+    send("spd 1000\n");
+
+    foc_sim_step();
+    mode_manager_get_status(&status);
+    TEST_CHECK(status.mode == MOTOR_MODE_ALIGN && status.align_next == MOTOR_MODE_SPEED, "aligning before speed loop");
+
+    float t = run_until_mode(MOTOR_MODE_SPEED, 1.5f);
+    TEST_CHECK(fabsf(t - MODE_MANAGER_ALIGN_MS * 0.001f) < 0.01f, "alignment took %.3f s", t);
+
+    mode_manager_get_status(&status);
+    TEST_CHECK(status.aligned && status.align_count == 1, "aligned, count = %u", status.align_count);
+
+    foc_sim_run(2.0f);
+    float mean, min, max;
+    run_measure(0.5f, &mean, &min, &max);
+    TEST_CHECK(fabsf(mean - 1000.0f) < 30.0f, "speed = %.1f rpm (ripple %.1f)", mean, max - min);
+}
+
+static void test_restart_without_align(void)
+{
+    printf("\n--- stop -> spd 800: 复用对齐结果 ---\n");
+    send("stop\n");
+    foc_sim_run(1.5f);
+    TEST_CHECK(fabsf(plant_rpm()) < 50.0f, "stopped, speed = %.1f rpm", plant_rpm());
+
+    send("spd 800\n");
+    float t = run_until_mode(MOTOR_MODE_SPEED, 0.01f);
+    TEST_CHECK(t > 0.0f && t <= 0.0002f, "speed loop entered after %.4f s", t);
+
+    foc_sim_run(1.5f);
+    float mean, min, max;
+    run_measure(0.5f, &mean, &min, &max);
+    mode_manager_get_status(&status);
+    TEST_CHECK(status.align_count == 1, "no re-alignment (count = %u)", status.align_count);
+    TEST_CHECK(fabsf(mean - 800.0f) < 30.0f, "speed = %.1f rpm", mean);
+}
+
+static void test_speed_to_flux_weak(void)
+{
+    printf("\n--- spd 800 -> fw 1500: 闭环之间切换 ---\n");
+    send("fw 1500\n");
+
+    float mean, min, max;
+    run_measure(0.2f, &mean, &min, &max);
+    TEST_CHECK(min > 760.0f, "no speed dip at switch: min = %.1f rpm", min);
+
+    foc_sim_run(2.5f);
+    run_measure(0.5f, &mean, &min, &max);
+    mode_manager_get_status(&status);
+    TEST_CHECK(status.mode == MOTOR_MODE_FLUX_WEAK, "mode = %s", mode_manager_mode_name(status.mode));
+    TEST_CHECK(fabsf(mean - 1500.0f) < 50.0f, "speed = %.1f rpm", mean);
+}
+
+static void test_multirate(void)
+{
+    printf("\n--- 多速率调度: 慢速任务分拍执行 ---\n");
+
+    const uint32_t n = 100 * MODE_MANAGER_FW_DIV;
+    uint32_t runs_speed = 0, runs_fw = 0, runs_telemetry = 0;
+    uint32_t overlap = 0, irregular = 0, stale = 0;
+    uint32_t last_speed = 0, fw_offset = 0;
+
+    mode_manager_get_status(&status);
+    float enc_prev = status.speed_rpm_encoder;
+
+    for (uint32_t i = 1; i <= n; i++)
+    {
+        foc_sim_step();
+        mode_manager_get_status(&status);
+        uint8_t tasks = status.slow_tasks;
+
+        if ((tasks & (tasks - 1U)) != 0)
+            overlap++;
+
+        if (tasks & MODE_MANAGER_TASK_SPEED)
+        {
+            if (runs_speed > 0 && i - last_speed != MODE_MANAGER_SPEED_DIV)
+                irregular++;
+            last_speed = i;
+            runs_speed++;
+        }
+        if (tasks & MODE_MANAGER_TASK_FLUX_WEAK)
+        {
+            fw_offset = i - last_speed;
+            runs_fw++;
+        }
+        if (tasks & MODE_MANAGER_TASK_TELEMETRY)
+            runs_telemetry++;
+
+        /* 编码器转速只应在速度环执行的周期刷新 */
+        if (status.speed_rpm_encoder != enc_prev && !(tasks & MODE_MANAGER_TASK_SPEED))
+            stale++;
+        enc_prev = status.speed_rpm_encoder;
+    }
+
+    TEST_CHECK(runs_speed == n / MODE_MANAGER_SPEED_DIV && irregular == 0, "speed loop ran %u times in %u ticks, every %u ticks",
+               runs_speed, n, MODE_MANAGER_SPEED_DIV);
+    TEST_CHECK(runs_fw == n / MODE_MANAGER_FW_DIV && fw_offset == MODE_MANAGER_SPEED_DIV / 2,
+               "flux weakening ran %u times, %u ticks after the speed loop", runs_fw, fw_offset);
+    TEST_CHECK(runs_telemetry == n / MODE_MANAGER_SPEED_DIV, "telemetry slot %u times", runs_telemetry);
+    TEST_CHECK(overlap == 0, "no tick runs two slow tasks (%u overlaps)", overlap);
+    TEST_CHECK(stale == 0, "encoder speed refreshes only on speed-loop ticks (%u mismatches)", stale);
+}
+
+static void test_running_to_sensorless(void)
+{
+    printf("\n--- fw 1500 -> sl 1000: 转动中直接切换到观测器 ---\n");
+    send("sl 1000\n");
+    foc_sim_step();
+
+    mode_manager_get_status(&status);
+    TEST_CHECK(status.mode == MOTOR_MODE_SENSORLESS && status.sensorless_locked, "observer locked immediately");
+
+    float mean, min, max;
+    run_measure(0.2f, &mean, &min, &max);
+    TEST_CHECK(min > 1300.0f, "no speed dip at switch: min = %.1f rpm", min);
+
+    foc_sim_run(1.5f);
+    run_measure(0.5f, &mean, &min, &max);
+    TEST_CHECK(fabsf(mean - 1000.0f) < 50.0f, "speed = %.1f rpm", mean);
+    float err = observer_angle_error_deg();
+    TEST_CHECK(fabsf(err) < 30.0f, "observer angle error = %.1f deg", err);
+}
+
+static void test_sensorless_from_standstill(void)
+{
+    printf("\n--- stop -> sl 1000: I/F 启动 -> 观测器 ---\n");
+    send("stop\n");
+    foc_sim_run(2.0f);
+
+    send("sl 1000\n");
+    foc_sim_step();
+    mode_manager_get_status(&status);
+    TEST_CHECK(status.mode == MOTOR_MODE_SENSORLESS && !status.sensorless_locked, "I/F startup");
+
+    uint32_t ticks = 0;
+    while (!status.sensorless_locked && ticks < 3 * FOC_SIM_TICKS_PER_SEC)
+    {
+        foc_sim_step();
+        mode_manager_get_status(&status);
+        ticks++;
+    }
+    TEST_CHECK(status.sensorless_locked, "observer locked after %.2f s", ticks * FOC_SIM_TS);
+
+    foc_sim_run(2.0f);
+    float mean, min, max;
+    run_measure(0.5f, &mean, &min, &max);
+    TEST_CHECK(fabsf(mean - 1000.0f) < 50.0f, "speed = %.1f rpm", mean);
+
+    mode_manager_get_status(&status);
+    TEST_CHECK(status.align_count == 1, "still no re-alignment (count = %u)", status.align_count);
+}
+
+static void test_current(void)
+{
+    printf("\n--- cur 0 0.3: 电流闭环 ---\n");
+    send("stop\n");
+    foc_sim_run(2.0f);
+    foc_sim_get_plant()->param.load_torque = 0.02f;
+
+    send("cur 0 0.3\n");
+    foc_sim_run(0.05f);
+
+    float id_sum = 0.0f, iq_sum = 0.0f;
+    uint32_t n = 500;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        foc_sim_step();
+        id_sum += foc_sim_get_plant()->id;
+        iq_sum += foc_sim_get_plant()->iq;
+    }
+    TEST_CHECK(fabsf(id_sum / n) < 0.05f, "id = %.3f A", id_sum / n);
+    TEST_CHECK(fabsf(iq_sum / n - 0.3f) < 0.05f, "iq = %.3f A", iq_sum / n);
+
+    /* 同一模式只改目标 */
+    mode_manager_get_status(&status);
+    uint32_t switches = status.switch_count;
+    send("cur 0 0.2\n");
+    foc_sim_run(0.05f);
+    mode_manager_get_status(&status);
+    TEST_CHECK(status.switch_count == switches, "target update without mode switch");
+    TEST_CHECK(fabsf(foc_sim_get_plant()->iq - 0.2f) < 0.05f, "iq = %.3f A", foc_sim_get_plant()->iq);
+
+    send("stop\n");
+    foc_sim_run(0.01f);
+    foc_sim_get_plant()->param.load_torque = 0.0f;
+}
+
+static void test_parser(void)
+{
+    printf("\n--- 命令解析 ---\n");
+
+    TEST_CHECK(mode_manager_command("spd") == -1, "missing argument rejected");
+    TEST_CHECK(mode_manager_command("spd 1000 5") == -1, "extra argument rejected");
+    TEST_CHECK(mode_manager_command("spd abc") == -1, "non-numeric argument rejected");
+    TEST_CHECK(mode_manager_command("spd 99999") == -1, "speed out of range rejected");
+    TEST_CHECK(mode_manager_command("cur 0 10") == -1, "current out of range rejected");
+    TEST_CHECK(mode_manager_command("spdx 100") == -1, "unknown command rejected");
+    TEST_CHECK(mode_manager_command("  stop  ") == 0, "surrounding whitespace accepted");
+    foc_sim_step();
+
+    /* 中断耗时统计经串口导出 / 清零 */
+    static isr_prof_stat_t stat[ISR_PROF_NUM];
+    isr_prof_worst_t worst;
+    isr_prof_init();
+    foc_sim_run(0.01f);
+    TEST_CHECK(mode_manager_command("prof") == 0 && mode_manager_command("prof x") == -1, "\"prof\" prints the ISR profile");
+    TEST_CHECK(mode_manager_command("prof reset") == 0, "\"prof reset\" accepted");
+    for (int i = 0; i < 10; i++)
+        foc_sim_step();
+    isr_prof_snapshot(stat, &worst);
+    TEST_CHECK(stat[ISR_PROF_TOTAL].count > 0 && stat[ISR_PROF_TOTAL].count <= 10,
+               "profile restarted after reset (%lu samples in 10 ticks)", (unsigned long)stat[ISR_PROF_TOTAL].count);
+    isr_prof_stop();
+
+    /* 分段到达 + CRLF: 只有完整的一行才执行 */
+    foc_sim_uart_rx("if 3");
+    mode_manager_poll();
+    foc_sim_step();
+    mode_manager_get_status(&status);
+    TEST_CHECK(status.mode == MOTOR_MODE_STOP, "partial line not executed");
+
+    send("00 0.4\r\n");
+    foc_sim_run(0.5f);
+    mode_manager_get_status(&status);
+    TEST_CHECK(status.mode == MOTOR_MODE_IF && fabsf(status.speed_rpm_ref - 300.0f) < 1.0f,
+               "fragmented line executed: %s, ref = %.1f rpm", mode_manager_mode_name(status.mode), status.speed_rpm_ref);
+
+    /* 超长行整体丢弃 */
+    send("spd 1000 000000000000000000000000000000000000\n");
+    foc_sim_step();
+    mode_manager_get_status(&status);
+    TEST_CHECK(status.mode == MOTOR_MODE_IF, "overlong line rejected");
+}
+
+static void test_realign(void)
+{
+    printf("\n--- align: 强制重新对齐 ---\n");
+    send("stop\n");
+    foc_sim_run(2.0f);
+
+    send("align\n");
+    float t = run_until_mode(MOTOR_MODE_STOP, 1.5f);
+    mode_manager_get_status(&status);
+    TEST_CHECK(t > 0.9f && status.align_count == 2 && status.aligned, "re-aligned in %.3f s, count = %u", t, status.align_count);
+
+    /* 零点与真实转子位置一致: 对齐后用编码器角度做电流闭环, 转矩方向正确 */
+    send("spd 500\n");
+    foc_sim_run(2.0f);
+    float mean, min, max;
+    run_measure(0.5f, &mean, &min, &max);
+    TEST_CHECK(fabsf(mean - 500.0f) < 30.0f, "speed after re-align = %.1f rpm", mean);
+
+    send("stop\n");
+    foc_sim_run(0.01f);
+}
+
+int main(void)
+{
+    printf("=== mode_manager (SIL) ===\n");
+
+    foc_sim_init(NULL);
+    foc_sim_set_encoder_offset(0.4f);
+    mode_manager_init();
+
+    test_boot();
+    test_first_speed();
+    test_restart_without_align();
+    test_speed_to_flux_weak();
+    test_multirate();
+    test_running_to_sensorless();
+    test_sensorless_from_standstill();
+    test_current();
+    test_parser();
+    test_realign();
+
+    return test_summary();
+}
+
+#endif /* FOC_SIM_HOST */
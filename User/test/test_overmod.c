@@ -0,0 +1,303 @@
+/**
+ * @file test_overmod.c
+ * @brief 过调制 (区域 I / II + 六拍) 测试（主机端）
+ *
+ * 编译命令（在 User 目录下运行）：
+ *   gcc -DFOC_SIM_HOST -std=gnu11 -O2 -I test/sim/hal -I . test/test_overmod.c \
+ *       $(find test/sim foc motor -name '*.c') bsp/as5047.c utils/ramp.c utils/isr_prof.c utils/telemetry.c -lm -o test_overmod
+ *
+ * 运行：
+ *   ./test_overmod             (任一失败返回非零)
+ *
+ * 1. 调制器: 指令矢量旋转一周, 相电压 (占空比减共模 × Udc) 做 FFT, 调制比 0.9 ~ 六拍范围内基波幅值等于指令,
+ *    未使能过调制时截到六边形、基波小于指令; 六拍时 5 / 7 次谐波为基波的 1/5 / 1/7; 各区域分界处基波连续
+ * 2. 被控对象: 转子外部拖动, 电流闭环输出过调制区电压, 对被控对象相电压做 FFT, 基波与指令电压一致
+ * 3. SIL (mode_manager 弱磁速度闭环, 母线 6V): 使能过调制后可达转速提高, 同一转速下所需负 Id 更小
+ */
+
+#ifdef FOC_SIM_HOST
+
+#include <stdio.h>
+#include <math.h>
+
+#include "foc/svpwm.h"
+#include "test/sim/foc_sim.h"
+#include "motor/mode_manager.h"
+#include "test/sim/test_check.h"
+
+#define TS FOC_SIM_TS
+#define PI_D 3.14159265358979323846
+#define FFT_N 4096
+
+/* ------------------------------------------------------------------ */
+/*  FFT (基 2, 原位)                                                   */
+/* ------------------------------------------------------------------ */
+static void fft(double *re, double *im, int n)
+{
+    for (int i = 1, j = 0; i < n; i++)
+    {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+        {
+            double t = re[i];
+            re[i] = re[j];
+            re[j] = t;
+            t = im[i];
+            im[i] = im[j];
+            im[j] = t;
+        }
+    }
+    for (int len = 2; len <= n; len <<= 1)
+    {
+        double ang = -2.0 * PI_D / len;
+        for (int i = 0; i < n; i += len)
+        {
+            for (int k = 0; k < len / 2; k++)
+            {
+                double wr = cos(ang * k), wi = sin(ang * k);
+                double ur = re[i + k], ui = im[i + k];
+                double vr = re[i + k + len / 2] * wr - im[i + k + len / 2] * wi;
+                double vi = re[i + k + len / 2] * wi + im[i + k + len / 2] * wr;
+                re[i + k] = ur + vr;
+                im[i + k] = ui + vi;
+                re[i + k + len / 2] = ur - vr;
+                im[i + k + len / 2] = ui - vi;
+            }
+        }
+    }
+}
+
+/* 对 x 做 FFT, 返回第 bin 个频点的幅值 (峰值) */
+static double spectrum(const double *x, int bin, double *harm, int harm_num, int harm_step)
+{
+    static double re[FFT_N], im[FFT_N];
+    for (int i = 0; i < FFT_N; i++)
+    {
+        re[i] = x[i];
+        im[i] = 0.0;
+    }
+    fft(re, im, FFT_N);
+    for (int h = 0; h < harm_num; h++)
+    {
+        int b = bin * (1 + h * harm_step);
+        harm[h] = 2.0 * hypot(re[b], im[b]) / FFT_N;
+    }
+    return 2.0 * hypot(re[bin], im[bin]) / FFT_N;
+}
+
+/* ------------------------------------------------------------------ */
+/*  调制器: 相电压 FFT                                                 */
+/* ------------------------------------------------------------------ */
+typedef struct
+{
+    double m1;     /* 基波调制比 (幅值 · √3 / Udc) */
+    double h5, h7; /* 5 / 7 次谐波 / 基波 */
+    uint8_t region;
+} om_spec_t;
+
+/* 指令矢量 (调制比 m) 旋转一周 FFT_N 点, A 相相电压的频谱 */
+static om_spec_t modulate_cycle(float m, uint8_t overmod, svpwm_mode_t mode)
+{
+    static double va[FFT_N];
+    const float udc = 12.0f;
+    svpwm_modulator_t mod;
+    svpwm_modulator_init(&mod, mode);
+    svpwm_modulator_set_overmod(&mod, overmod);
+
+    om_spec_t r = {0.0, 0.0, 0.0, 0};
+    for (int n = 0; n < FFT_N; n++)
+    {
+        /* 半个采样点的相位偏移, 避开扇区边界上的采样点 */
+        double th = 2.0 * PI_D * (n + 0.5) / FFT_N;
+        float mag = m * udc / 1.7320508f;
+        alphabeta_t u = {mag * (float)cos(th), mag * (float)sin(th)};
+        abc_t d = svpwm_modulate(&mod, u, 1.0f / udc);
+        va[n] = (d.a - (d.a + d.b + d.c) / 3.0) * udc;
+        if (mod.om_region > r.region)
+            r.region = mod.om_region;
+    }
+
+    double harm[3];
+    double v1 = spectrum(va, 1, harm, 3, 2); /* 1, 3(为零), 5 次 */
+    double h7[2];
+    spectrum(va, 1, h7, 2, 6); /* 1, 7 次 */
+    r.m1 = v1 * 1.7320508 / udc;
+    r.h5 = harm[2] / v1;
+    r.h7 = h7[1] / v1;
+    return r;
+}
+
+static void test_modulator(void)
+{
+    printf("\n--- 调制器: 相电压 FFT, 调制比 0.9 ~ 六拍 ---\n");
+    printf("  %8s | %8s %6s | %8s\n", "m", "overmod", "region", "clipped");
+
+    double max_err = 0.0, max_err_dpwm = 0.0, clip_max = 0.0, clip_short = 0.0;
+    int region_ok = 1, monotonic = 1;
+    double prev = 0.0;
+    for (int i = 0; i <= 100; i++)
+    {
+        float m = 0.9f + (SVPWM_M_SIX_STEP - 0.9f) * i / 100.0f;
+        om_spec_t on = modulate_cycle(m, 1, SVPWM_MODE_SVPWM);
+        om_spec_t dp = modulate_cycle(m, 1, SVPWM_MODE_DPWM1);
+        om_spec_t off = modulate_cycle(m, 0, SVPWM_MODE_SVPWM);
+
+        max_err = fmax(max_err, fabs(on.m1 / m - 1.0));
+        max_err_dpwm = fmax(max_err_dpwm, fabs(dp.m1 / m - 1.0));
+        clip_max = fmax(clip_max, off.m1);
+        clip_short = fmax(clip_short, 1.0 - off.m1 / m);
+        monotonic &= (on.m1 > prev);
+        prev = on.m1;
+
+        uint8_t expect = (m <= 1.0f) ? 0 : ((m <= SVPWM_M_OM2) ? 1 : 2);
+        region_ok &= (on.region == expect);
+
+        if (i % 20 == 0)
+            printf("  %8.4f | %8.4f %6u | %8.4f\n", m, on.m1, on.region, off.m1);
+    }
+
+    TEST_CHECK(max_err < 2e-3, "fundamental = command over 0.9 .. six-step: max error %.2f%%", max_err * 100.0);
+    TEST_CHECK(max_err_dpwm < 2e-3, "same with DPWM1 underneath: max error %.2f%%", max_err_dpwm * 100.0);
+    TEST_CHECK(monotonic && region_ok, "fundamental monotonic, region I below m = %.4f, region II above", SVPWM_M_OM2);
+    /* 不补偿时按原角度截到六边形, 基波最多到六边形轨迹的 SVPWM_M_OM2, 比指令小 */
+    TEST_CHECK(clip_max < SVPWM_M_OM2 + 1e-3 && clip_short > 0.05,
+               "without overmodulation: fundamental stops at %.4f, up to %.1f%% short of the command", clip_max, clip_short * 100.0);
+
+    /* 区域分界两侧基波连续 */
+    float edges[] = {1.0f, SVPWM_M_OM2};
+    double jump = 0.0;
+    for (int i = 0; i < 2; i++)
+    {
+        om_spec_t lo = modulate_cycle(edges[i] - 1e-5f, 1, SVPWM_MODE_SVPWM);
+        om_spec_t hi = modulate_cycle(edges[i] + 1e-5f, 1, SVPWM_MODE_SVPWM);
+        jump = fmax(jump, fabs(hi.m1 - lo.m1));
+    }
+    TEST_CHECK(jump < 2e-4, "continuous across region boundaries: max step %.1e", jump);
+
+    om_spec_t six = modulate_cycle(SVPWM_M_SIX_STEP, 1, SVPWM_MODE_SVPWM);
+    om_spec_t beyond = modulate_cycle(1.2f, 1, SVPWM_MODE_SVPWM);
+    TEST_CHECK(fabs(six.h5 - 0.2) < 2e-3 && fabs(six.h7 - 1.0 / 7.0) < 2e-3 && fabs(beyond.m1 - six.m1) < 1e-6,
+               "six-step: h5 = %.4f (1/5), h7 = %.4f (1/7), commands beyond six-step saturate", six.h5, six.h7);
+}
+
+/* ------------------------------------------------------------------ */
+/*  被控对象相电压 FFT                                                 */
+/* ------------------------------------------------------------------ */
+static void test_plant_fft(void)
+{
+    printf("\n--- 被控对象: 电流闭环 (转子外部拖动), 相电压 FFT ---\n");
+
+    /* FFT_N 个控制周期内恰好 150 个电周期 (约 3140 RPM) */
+    const double fe = 150.0 / (FFT_N * TS);
+    const float rpm = (float)(fe * 60.0 / 7.0);
+    static double va[FFT_N];
+
+    double m1[2];
+    for (int om = 0; om < 2; om++)
+    {
+        pmsm_param_t param;
+        pmsm_model_default_param(&param);
+        param.u_dc = 6.0f;
+        foc_sim_init(&param);
+        mode_manager_init();
+        mode_manager_set_overmodulation((uint8_t)om);
+
+        mode_manager_current(0.0f, 0.0f);
+        foc_sim_run(1.2f);
+
+        pmsm_model_t *p = foc_sim_get_plant();
+        p->param.j = 1e3f;
+        p->param.b = 0.0f;
+        p->omega_m = rpm * (float)(2.0 * PI_D / 60.0);
+
+        /* 反电势约 3.45V + Rs·Iq, 电压需求超出线性区 (6V / √3 = 3.46V) */
+        mode_manager_current(0.0f, 2.0f);
+        foc_sim_run(0.2f);
+
+        for (int n = 0; n < FFT_N; n++)
+        {
+            foc_sim_step();
+            va[n] = p->va;
+        }
+        double harm[3];
+        double v1 = spectrum(va, 150, harm, 3, 2);
+        m1[om] = v1 * 1.7320508 / 6.0;
+        printf("  overmod %d: fundamental m = %.4f, h5 = %.2f%%\n", om, m1[om], harm[2] / v1 * 100.0);
+    }
+
+    TEST_CHECK(m1[0] < 0.55 / 0.57735 + 0.01, "linear only: fundamental limited to m = %.4f", m1[0]);
+    TEST_CHECK(m1[1] > 1.0 && m1[1] > m1[0] + 0.08, "overmodulation: fundamental m = %.4f beyond the linear limit", m1[1]);
+}
+
+/* ------------------------------------------------------------------ */
+/*  SIL: 弱磁速度闭环                                                  */
+/* ------------------------------------------------------------------ */
+typedef struct
+{
+    float rpm;   /* 稳态转速 */
+    float id;    /* 稳态 Id (A) */
+    float iq;    /* 稳态 Iq (A) */
+} fw_result_t;
+
+static fw_result_t run_flux_weak(uint8_t overmod, float rpm_ref)
+{
+    pmsm_param_t param;
+    pmsm_model_default_param(&param);
+    param.u_dc = 6.0f;
+    foc_sim_init(&param);
+    mode_manager_init();
+    mode_manager_set_overmodulation(overmod);
+
+    pmsm_model_t *p = foc_sim_get_plant();
+    mode_manager_flux_weak(rpm_ref);
+    foc_sim_run(6.0f);
+
+    fw_result_t r = {0.0f, 0.0f, 0.0f};
+    const int ticks = 5000;
+    for (int n = 0; n < ticks; n++)
+    {
+        foc_sim_step();
+        r.rpm += pmsm_model_get_speed_rpm(p) / ticks;
+        r.id += p->id / ticks;
+        r.iq += p->iq / ticks;
+    }
+    return r;
+}
+
+static void test_flux_weak(void)
+{
+    printf("\n--- SIL: 弱磁速度闭环, 母线 6V ---\n");
+
+    static const float speeds[] = {2600.0f, 2800.0f, 3000.0f, 4000.0f};
+    fw_result_t lin[4], om[4];
+    for (int i = 0; i < 4; i++)
+    {
+        lin[i] = run_flux_weak(0, speeds[i]);
+        om[i] = run_flux_weak(1, speeds[i]);
+        printf("  ref %5.0f | linear %7.1f rpm id %6.3f iq %6.3f | overmod %7.1f rpm id %6.3f iq %6.3f\n", speeds[i],
+               lin[i].rpm, lin[i].id, lin[i].iq, om[i].rpm, om[i].id, om[i].iq);
+    }
+
+    /* 4000 RPM 两者都到不了: 稳态转速即可达转速 */
+    TEST_CHECK(om[3].rpm > 1.12f * lin[3].rpm, "top speed %.0f rpm -> %.0f rpm (+%.1f%%)", lin[3].rpm, om[3].rpm,
+               (om[3].rpm / lin[3].rpm - 1.0f) * 100.0f);
+    TEST_CHECK(fabsf(lin[1].rpm - 2800.0f) < 5.0f && fabsf(om[1].rpm - 2800.0f) < 5.0f && lin[1].id < -1.9f && om[1].id > -0.1f,
+               "2800 rpm: id %.3f A -> %.3f A", lin[1].id, om[1].id);
+    TEST_CHECK(om[0].id > lin[0].id + 1.0f, "2600 rpm: id %.3f A -> %.3f A", lin[0].id, om[0].id);
+}
+
+int main(void)
+{
+    printf("=== overmodulation ===\n");
+
+    test_modulator();
+    test_plant_fft();
+    test_flux_weak();
+
+    return test_summary();
+}
+
+#endif /* FOC_SIM_HOST */
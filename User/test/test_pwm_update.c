@@ -0,0 +1,281 @@
+/**
+ * @file test_pwm_update.c
+ * @brief PWM 更新方式 (单更新 / 双更新) 的控制时序与输出延迟补偿测试（主机端 SIL）
+ *
+ * 编译命令（在 User 目录下运行, 双更新时加 -DPWM_DOUBLE_UPDATE=1, 两种方式都应通过）：
+ *   gcc -DFOC_SIM_HOST -std=gnu11 -O2 -I test/sim/hal -I . test/test_pwm_update.c \
+ *       $(find test/sim foc motor -name '*.c') bsp/as5047.c utils/ramp.c utils/isr_prof.c utils/telemetry.c -lm -o test_pwm_update
+ *
+ * 运行：
+ *   ./test_pwm_update          (任一失败返回非零)
+ *
+ * 1. 时序: 控制周期 = PWM 周期 / 每周期更新次数, 仿真时钟与 HAL_GetTick 一致;
+ *    mode_manager 的速度环仍为 1ms, 编码器转速按 1ms 窗口计算, 恒速下与被控对象一致
+ * 2. 输出延迟: 被控对象以恒定转速拖动, 电流闭环使用真实转子角度。每个周期计算的占空比在下一个控制周期输出,
+ *    把实际施加的电压矢量变换到输出区间中点的转子坐标, 与电流环的 dq 电压指令比较:
+ *    不补偿时滞后 ωe · 1.5 · Ts (双更新时减半), 补偿 (foc_set_speed_el) 后角度误差接近 0,
+ *    且超前角由 Park 的 sinθ / cosθ 旋转得到, 每个控制周期只调用一次 angle_sin_cos
+ * 3. 编码器读数延迟: 仿真中编码器角度取采样前 100us 的转子位置 (如读 ANGLEUNC), 电流闭环经真实驱动读角度与转速:
+ *    只补偿输出延迟时残留 ωe · 100us, foc_set_delay_comp 同时给出编码器延迟后角度误差接近 0;
+ *    mode_manager 的 "dly" 命令修改同一组延迟; 最大延迟下的高转速超前角饱和为 ±π
+ */
+
+#ifdef FOC_SIM_HOST
+
+#include <stdio.h>
+#include <math.h>
+
+#include "test/sim/foc_sim.h"
+#include "motor/mode_manager.h"
+#include "test/sim/test_check.h"
+
+#define TWO_PI 6.28318530718f
+#define RAD_TO_DEG 57.2957795f
+
+/* 编码器读数延迟测试中仿真的传感器延迟 (s) */
+#define ENC_LATENCY 100e-6f
+
+/* ------------------------------------------------------------------ */
+/*  时序                                                               */
+/* ------------------------------------------------------------------ */
+static void test_timing(void)
+{
+    printf("\n--- 时序: %u 次更新 / PWM 周期 ---\n", MOTOR_CTRL_PER_PWM);
+
+    TEST_CHECK(fabsf(FOC_SIM_TS * MOTOR_CTRL_PER_PWM - MOTOR_PWM_TS) < 1e-9f && FOC_SIM_TICKS_PER_SEC == MOTOR_CTRL_FREQ,
+               "control period %.1f us, %u ticks/s", FOC_SIM_TS * 1e6f, FOC_SIM_TICKS_PER_SEC);
+    TEST_CHECK(fabsf(FOC_PWM_DELAY_TS - 1.5f * MOTOR_PWM_TS / MOTOR_CTRL_PER_PWM) < 1e-9f,
+               "output delay %.1f us (1.5 control periods)", FOC_PWM_DELAY_TS * 1e6f);
+
+    foc_sim_init(NULL);
+    mode_manager_init();
+    uint32_t ms0 = HAL_GetTick();
+    foc_sim_run(0.1f);
+    TEST_CHECK(foc_sim_get_ticks() == MOTOR_CTRL_FREQ / 10U && HAL_GetTick() - ms0 == 100U,
+               "0.1 s = %u ticks = %u ms", foc_sim_get_ticks(), HAL_GetTick() - ms0);
+
+    /* 速度环周期与更新方式无关 */
+    mode_manager_status_t status;
+    uint32_t runs = 0;
+    mode_manager_speed(1000.0f);
+    foc_sim_run(2.5f); /* 对齐 1s + 斜坡 1000 RPM/s */
+    for (uint32_t i = 0; i < MOTOR_CTRL_FREQ / 10U; i++)
+    {
+        foc_sim_step();
+        mode_manager_get_status(&status);
+        runs += (status.slow_tasks & MODE_MANAGER_TASK_SPEED) != 0;
+    }
+    TEST_CHECK(runs == 100U, "speed loop ran %u times in 100 ms (every %u ticks)", runs, MODE_MANAGER_SPEED_DIV);
+
+    float plant = pmsm_model_get_speed_rpm(foc_sim_get_plant());
+    TEST_CHECK(fabsf(status.speed_rpm_encoder - plant) < 15.0f && fabsf(plant - 1000.0f) < 20.0f,
+               "encoder speed %.1f rpm, plant %.1f rpm", status.speed_rpm_encoder, plant);
+}
+
+/* ------------------------------------------------------------------ */
+/*  输出延迟                                                           */
+/* ------------------------------------------------------------------ */
+static foc_t foc;
+static pid_controller_t pid_id, pid_iq, pid_speed;
+static uint8_t use_encoder;
+static float drag_rpm;
+static uint32_t sin_cos_min, sin_cos_max; /* measure_lag 中每个控制周期 angle_sin_cos 的调用次数范围 */
+
+/*
+ * 控制回调: 电流闭环。角度取被控对象在采样时刻的真实电角度 (不经过编码器与对齐),
+ * 或经 bsp/as5047.c 读取编码器角度与转速并外推 (仿真中编码器零点与转子零点重合, angle_offset = 0)
+ */
+static void current_loop_callback(const adc_values_t *adc)
+{
+    foc_set_bus_voltage(&foc, adc->udc);
+
+    angle_t theta;
+    float speed_rpm;
+    if (use_encoder)
+    {
+        as5047_update_speed();
+        speed_rpm = as5047_get_speed_rpm();
+        theta = foc_encoder_angle(&foc, as5047_get_angle_el(), speed_rpm);
+    }
+    else
+    {
+        speed_rpm = drag_rpm;
+        theta = angle_from_rad(foc_sim_get_plant()->theta_e);
+    }
+
+    foc_transform_set_angle(&foc.transform, theta);
+    dq_t i_dq = foc_transform_park(&foc.transform, clark_transform((abc_t){adc->ia, adc->ib, adc->ic}));
+
+    /* 解耦未使能, omega_e 只用于延迟补偿 */
+    foc_set_speed_el(&foc, speed_rpm);
+    foc_current_closed_loop_run(&foc, i_dq, theta);
+}
+
+/**
+ * @brief 以给定转速拖动, 返回实际施加的电压矢量相对指令的角度 (rad, 正为超前)
+ * @param rpm        转速 (RPM)
+ * @param pwm_ts     控制器补偿的输出延迟 (s)
+ * @param encoder_ts 控制器补偿的编码器读数延迟 (s), 仅在 encoder 为 1 时起作用
+ * @param encoder    1: 经编码器取角度与转速; 0: 真实转子角度
+ * @param spread     输出: 各周期角度误差的最大偏离 (rad)
+ */
+static float measure_lag(float rpm, float pwm_ts, float encoder_ts, uint8_t encoder, float *spread)
+{
+    pmsm_param_t param;
+    pmsm_model_default_param(&param);
+    param.j = 1e3f;
+    param.b = 0.0f;
+    foc_sim_init(&param);
+
+    pid_init(&pid_id, MOTOR_CURRENT_KP, MOTOR_CURRENT_KI, -FOC_V_MAX_K * U_DC, FOC_V_MAX_K * U_DC);
+    pid_init(&pid_iq, MOTOR_CURRENT_KP, MOTOR_CURRENT_KI, -FOC_V_MAX_K * U_DC, FOC_V_MAX_K * U_DC);
+    pid_init(&pid_speed, 0.0f, 0.0f, 0.0f, 0.0f);
+    foc_init(&foc, &pid_id, &pid_iq, &pid_speed);
+    foc_set_delay_comp(&foc, pwm_ts, encoder_ts);
+    foc.target_iq = 1.0f;
+
+    use_encoder = encoder;
+    drag_rpm = rpm;
+    foc_sim_set_encoder_latency(ENC_LATENCY);
+    adc1_register_injected_callback(current_loop_callback);
+
+    pmsm_model_t *p = foc_sim_get_plant();
+    p->omega_m = rpm * (TWO_PI / 60.0f);
+    foc_sim_run(0.05f); /* 编码器转速经过若干个测速窗口后稳定 */
+
+    const float omega_e = rpm * MOTOR_RPM_TO_RAD_S;
+    float sum = 0.0f, lo = 1e9f, hi = -1e9f;
+    const uint32_t n = 1000;
+
+    sin_cos_min = UINT32_MAX;
+    sin_cos_max = 0;
+    for (uint32_t k = 0; k < n; k++)
+    {
+        uint32_t count = foc.transform.sin_cos_count;
+        foc_sim_step();
+        count = foc.transform.sin_cos_count - count;
+        sin_cos_min = count < sin_cos_min ? count : sin_cos_min;
+        sin_cos_max = count > sin_cos_max ? count : sin_cos_max;
+
+        /* 本周期计算的占空比已装载, 在 [t, t + Ts] 输出; 电压矢量换到区间中点的转子坐标 */
+        float da, db, dc;
+        foc_sim_get_duty(&da, &db, &dc);
+        float cm = (da + db + dc) * (1.0f / 3.0f);
+        float va = (da - cm) * p->param.u_dc;
+        float vb = (db - cm) * p->param.u_dc;
+        float vc = (dc - cm) * p->param.u_dc;
+        float v_alpha = va;
+        float v_beta = (vb - vc) * 0.577350269f;
+
+        float theta_mid = p->theta_e + omega_e * FOC_SIM_TS * 0.5f;
+        float vd = v_alpha * cosf(theta_mid) + v_beta * sinf(theta_mid);
+        float vq = -v_alpha * sinf(theta_mid) + v_beta * cosf(theta_mid);
+
+        float err = atan2f(vq, vd) - atan2f(foc.v_q_out, foc.v_d_out);
+        err = remainderf(err, TWO_PI);
+        sum += err;
+        lo = fminf(lo, err);
+        hi = fmaxf(hi, err);
+    }
+
+    *spread = hi - lo;
+    return -sum / n; /* 施加矢量落后于指令为正滞后 */
+}
+
+static void test_delay(void)
+{
+    printf("\n--- 输出延迟: 恒速拖动, Iq = 1A ---\n");
+    printf("  %6s | %-22s | %-22s | %s\n", "rpm", "uncompensated lag", "compensated lag", "expected");
+
+    static const float speeds[] = {1000.0f, 2000.0f, 3000.0f};
+    float worst_model = 0.0f, worst_comp = 0.0f, worst_spread = 0.0f;
+    uint32_t sin_cos_lo = UINT32_MAX, sin_cos_hi = 0;
+
+    for (int i = 0; i < 3; i++)
+    {
+        float spread_off, spread_on;
+        float lag_off = measure_lag(speeds[i], 0.0f, 0.0f, 0, &spread_off);
+        float lag_on = measure_lag(speeds[i], FOC_PWM_DELAY_TS, 0.0f, 0, &spread_on);
+        sin_cos_lo = sin_cos_min < sin_cos_lo ? sin_cos_min : sin_cos_lo;
+        sin_cos_hi = sin_cos_max > sin_cos_hi ? sin_cos_max : sin_cos_hi;
+        float expect = speeds[i] * MOTOR_RPM_TO_RAD_S * 1.5f * FOC_SIM_TS;
+
+        printf("  %6.0f | %7.3f deg (±%.3f) | %7.3f deg (±%.3f) | %.3f deg\n", speeds[i],
+               lag_off * RAD_TO_DEG, 0.5f * spread_off * RAD_TO_DEG, lag_on * RAD_TO_DEG,
+               0.5f * spread_on * RAD_TO_DEG, expect * RAD_TO_DEG);
+
+        worst_model = fmaxf(worst_model, fabsf(lag_off - expect) / expect);
+        worst_comp = fmaxf(worst_comp, fabsf(lag_on));
+        worst_spread = fmaxf(worst_spread, fmaxf(spread_off, spread_on));
+    }
+
+    TEST_CHECK(worst_model < 0.05f, "uncompensated lag = ωe · 1.5 · Ts (max relative error %.1f%%)", worst_model * 100.0f);
+    TEST_CHECK(worst_comp * RAD_TO_DEG < 0.2f, "compensated lag < 0.2 deg (max %.3f deg)", worst_comp * RAD_TO_DEG);
+    TEST_CHECK(worst_spread * RAD_TO_DEG < 0.5f, "per-tick spread < 0.5 deg (max %.3f deg)", worst_spread * RAD_TO_DEG);
+    TEST_CHECK(sin_cos_lo == 1 && sin_cos_hi == 1, "compensated: one sin/cos per tick (%u..%u), advance reuses the Park angle",
+               sin_cos_lo, sin_cos_hi);
+}
+
+/* ------------------------------------------------------------------ */
+/*  编码器读数延迟                                                     */
+/* ------------------------------------------------------------------ */
+static void test_encoder_delay(void)
+{
+    printf("\n--- 编码器读数延迟: 仿真传感器延迟 %.0f us ---\n", ENC_LATENCY * 1e6f);
+    printf("  %6s | %-22s | %-22s | %s\n", "rpm", "pwm comp only", "pwm + encoder comp", "expected");
+
+    static const float speeds[] = {1000.0f, 2000.0f, 3000.0f};
+    float worst_model = 0.0f, worst_comp = 0.0f, worst_spread = 0.0f;
+
+    for (int i = 0; i < 3; i++)
+    {
+        float spread_off, spread_on;
+        float lag_off = measure_lag(speeds[i], FOC_PWM_DELAY_TS, 0.0f, 1, &spread_off);
+        float lag_on = measure_lag(speeds[i], FOC_PWM_DELAY_TS, ENC_LATENCY, 1, &spread_on);
+        float expect = speeds[i] * MOTOR_RPM_TO_RAD_S * ENC_LATENCY;
+
+        printf("  %6.0f | %7.3f deg (±%.3f) | %7.3f deg (±%.3f) | %.3f deg\n", speeds[i],
+               lag_off * RAD_TO_DEG, 0.5f * spread_off * RAD_TO_DEG, lag_on * RAD_TO_DEG,
+               0.5f * spread_on * RAD_TO_DEG, expect * RAD_TO_DEG);
+
+        worst_model = fmaxf(worst_model, fabsf(lag_off - expect) / expect);
+        worst_comp = fmaxf(worst_comp, fabsf(lag_on));
+        worst_spread = fmaxf(worst_spread, fmaxf(spread_off, spread_on));
+    }
+
+    /* 14 位编码器的电角度分辨率为 2π · 7 / 16384 ≈ 0.15 deg, 截断带来约半个码值的固定偏差 */
+    TEST_CHECK(worst_model < 0.1f, "uncompensated encoder lag = ωe · latency (max relative error %.1f%%)", worst_model * 100.0f);
+    TEST_CHECK(worst_comp * RAD_TO_DEG < 0.3f, "compensated lag < 0.3 deg (max %.3f deg)", worst_comp * RAD_TO_DEG);
+    TEST_CHECK(worst_spread * RAD_TO_DEG < 1.0f, "per-tick spread < 1 deg (max %.3f deg)", worst_spread * RAD_TO_DEG);
+
+    /* 最大延迟 + 观测器转速上限: 超前角超出 int32_t, 饱和为 ±π 而不是未定义的转换 */
+    foc_init(&foc, &pid_id, &pid_iq, &pid_speed);
+    foc_set_delay_comp(&foc, MODE_MANAGER_DELAY_MAX_US * 1e-6f, MODE_MANAGER_DELAY_MAX_US * 1e-6f);
+    angle_t lead_pos = foc_encoder_angle(&foc, 0, 10000.0f);
+    angle_t lead_neg = foc_encoder_angle(&foc, 0, -10000.0f);
+    TEST_CHECK(fabsf(angle_to_rad(lead_pos) - 3.14159265f) < 1e-6f && fabsf(angle_to_rad(lead_neg) + 3.14159265f) < 1e-6f &&
+                   angle_delta_sat(NAN) == angle_delta_sat(1e30f),
+               "%.0f us at ±10000 rpm: lead saturates at %+.4f / %+.4f rad", MODE_MANAGER_DELAY_MAX_US,
+               angle_to_rad(lead_pos), angle_to_rad(lead_neg));
+
+    /* 串口命令修改 mode_manager 的延迟补偿 */
+    foc_sim_init(NULL);
+    mode_manager_init();
+    TEST_CHECK(mode_manager_command("dly 150 100") == 0 && mode_manager_command("dly 600 0") != 0 &&
+                   mode_manager_command("dly -1 0") != 0 && mode_manager_command("dly 150") != 0,
+               "\"dly\" command accepts 0..%.0f us", MODE_MANAGER_DELAY_MAX_US);
+}
+
+int main(void)
+{
+    printf("========== PWM update / output delay test (%s) ==========\n",
+           PWM_DOUBLE_UPDATE ? "double update" : "single update");
+
+    test_timing();
+    test_delay();
+    test_encoder_delay();
+
+    return test_summary();
+}
+
+#endif /* FOC_SIM_HOST */
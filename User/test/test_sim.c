@@ -0,0 +1,232 @@
+/**
+ * @file test_sim.c
+ * @brief 软件在环 (SIL) 回归测试: 未修改的 foc / motor 源码 + 主机端 PMSM 模型
+ *
+ * 编译命令（在 User 目录下运行）：
+ *   gcc -DFOC_SIM_HOST -std=gnu11 -O2 -I test/sim/hal -I . test/test_sim.c \
+ *       $(find test/sim foc motor -name '*.c') bsp/as5047.c utils/ramp.c utils/isr_prof.c utils/telemetry.c -lm -o test_sim
+ *
+ * 运行：
+ *   ./test_sim                 (全部用例, 任一失败返回非零)
+ *
+ * 判据均基于被控对象的真实状态 (转速、dq 电流), 与控制器内部估计量无关。
+ */
+
+#ifdef FOC_SIM_HOST
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+#include "test/sim/foc_sim.h"
+#include "utils/isr_prof.h"
+#include "motor/current_closed.h"
+#include "motor/speed_closed.h"
+#include "motor/flux_weak_speed_closed.h"
+#include "motor/sensorless_smo.h"
+#include "motor/sensorless_luenberger.h"
+#include "motor/speed_closed_with_smo.h"
+#include "test/sim/test_check.h"
+
+/* ------------------------------------------------------------------ */
+/*  断言与计时                                                          */
+/* ------------------------------------------------------------------ */
+static double get_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* 在一段时间窗口内统计被控对象转速的均值与峰峰值 */
+static void sim_measure_speed(float seconds, float *mean_rpm, float *ripple_rpm)
+{
+    uint32_t ticks = (uint32_t)(seconds * FOC_SIM_TICKS_PER_SEC);
+    float sum = 0.0f;
+    float max = -1e9f, min = 1e9f;
+
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        foc_sim_step();
+        float rpm = pmsm_model_get_speed_rpm(foc_sim_get_plant());
+        sum += rpm;
+        max = (rpm > max) ? rpm : max;
+        min = (rpm < min) ? rpm : min;
+    }
+
+    *mean_rpm = sum / (float)ticks;
+    *ripple_rpm = max - min;
+}
+
+/* ------------------------------------------------------------------ */
+/*  用例                                                                */
+/* ------------------------------------------------------------------ */
+
+/* 电流闭环: 对齐后 dq 电流跟踪给定 */
+static void test_current_closed(void)
+{
+    printf("current_closed (id = 0, iq = 0.3A)\n");
+
+    foc_sim_init(NULL);
+    /* 限制转速, 使电流环工作在接近堵转的工况 */
+    foc_sim_get_plant()->param.load_torque = 0.02f;
+    current_closed_init(0.0f, 0.3f);
+
+    foc_sim_run(0.05f);
+
+    float id_sum = 0.0f, iq_sum = 0.0f;
+    uint32_t n = 500;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        foc_sim_step();
+        id_sum += foc_sim_get_plant()->id;
+        iq_sum += foc_sim_get_plant()->iq;
+    }
+
+    float id = id_sum / n;
+    float iq = iq_sum / n;
+    TEST_CHECK(fabsf(id) < 0.05f, "id = %.3f A", id);
+    TEST_CHECK(fabsf(iq - 0.3f) < 0.05f, "iq = %.3f A", iq);
+}
+
+/* 有感速度闭环 */
+static void test_speed_closed(void)
+{
+    printf("speed_closed (1000 rpm)\n");
+
+    foc_sim_init(NULL);
+    foc_sim_set_encoder_offset(0.4f);
+    speed_closed_init(1000.0f);
+
+    foc_sim_run(2.0f);
+
+    float mean, ripple;
+    sim_measure_speed(0.5f, &mean, &ripple);
+    TEST_CHECK(fabsf(mean - 1000.0f) < 30.0f, "speed = %.1f rpm", mean);
+    TEST_CHECK(ripple < 100.0f, "ripple = %.1f rpm", ripple);
+}
+
+/* 弱磁速度闭环 */
+static void test_flux_weak_speed_closed(void)
+{
+    printf("flux_weak_speed_closed (1500 rpm)\n");
+
+    foc_sim_init(NULL);
+    flux_weak_speed_closed_init(1500.0f);
+
+    foc_sim_run(3.0f);
+
+    float mean, ripple;
+    sim_measure_speed(0.5f, &mean, &ripple);
+    TEST_CHECK(fabsf(mean - 1500.0f) < 50.0f, "speed = %.1f rpm", mean);
+    TEST_CHECK(ripple < 150.0f, "ripple = %.1f rpm", ripple);
+
+    float data[4];
+    print_flux_weak_speed_info();
+    foc_sim_get_vofa(data, 4);
+    TEST_CHECK(fabsf(data[1]) < 0.5f, "id = %.3f A", data[1]);
+}
+
+/* 无感启动: I/F 拖动 -> 观测器切换 -> 速度闭环 */
+static void test_sensorless(const char *name, void (*init)(float), void (*print)(void), float target_rpm)
+{
+    printf("%s (%.0f rpm)\n", name, target_rpm);
+
+    foc_sim_init(NULL);
+    init(target_rpm);
+
+    foc_sim_run(5.0f);
+
+    float mean, ripple;
+    sim_measure_speed(1.0f, &mean, &ripple);
+    TEST_CHECK(fabsf(mean - target_rpm) < 0.05f * target_rpm, "speed = %.1f rpm", mean);
+
+    /* VOFA 通道: 实际转速, 实际角度, 观测转速, 观测角度 */
+    float data[4];
+    print();
+    foc_sim_get_vofa(data, 4);
+
+    float angle_err = fmodf(data[3] - data[1] + 540.0f, 360.0f) - 180.0f;
+    TEST_CHECK(fabsf(data[2] - mean) < 0.1f * target_rpm, "observer speed = %.1f rpm", data[2]);
+    TEST_CHECK(fabsf(angle_err) < 30.0f, "observer angle error = %.1f deg", angle_err);
+}
+
+/* 中断分阶段耗时统计 */
+static void test_isr_prof(void)
+{
+    printf("isr_prof (speed_closed_with_smo)\n");
+
+    foc_sim_init(NULL);
+    speed_closed_with_smo_init(1000.0f);
+    isr_prof_init();
+
+    uint32_t ticks = 20000;
+    foc_sim_run((float)ticks / FOC_SIM_TICKS_PER_SEC);
+
+    static isr_prof_stat_t stat[ISR_PROF_NUM];
+    static isr_prof_worst_t worst;
+    isr_prof_snapshot(stat, &worst);
+
+    /* 每个周期都经过全部阶段 */
+    uint32_t missing = 0;
+    uint64_t stage_sum = 0;
+    for (int i = 0; i < ISR_PROF_NUM; i++)
+    {
+        if (stat[i].count != ticks)
+            missing++;
+        if (i != ISR_PROF_TOTAL)
+            stage_sum += stat[i].sum;
+    }
+    TEST_CHECK(missing == 0, "all %d stages sampled %u times", ISR_PROF_NUM, ticks);
+
+    /* 各阶段之和不超过总耗时, 且覆盖其绝大部分 */
+    double coverage = (double)stage_sum / (double)stat[ISR_PROF_TOTAL].sum;
+    TEST_CHECK(coverage > 0.5 && coverage <= 1.0, "stage coverage = %.1f%%", coverage * 100.0);
+
+    uint32_t hist_sum = 0;
+    for (int i = 0; i < ISR_PROF_HIST_BINS; i++)
+        hist_sum += stat[ISR_PROF_TOTAL].hist[i];
+    TEST_CHECK(hist_sum == ticks, "histogram count = %u", hist_sum);
+
+    TEST_CHECK(worst.stage[ISR_PROF_TOTAL] == stat[ISR_PROF_TOTAL].max && worst.trace_num > 0,
+               "worst trace = %u counts, %u marks", worst.stage[ISR_PROF_TOTAL], worst.trace_num);
+
+    isr_prof_print();
+}
+
+/* 仿真吞吐量 */
+static void test_throughput(void)
+{
+    printf("throughput\n");
+
+    foc_sim_init(NULL);
+    speed_closed_init(1000.0f);
+
+    uint32_t ticks = 2000000;
+    double t0 = get_s();
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        foc_sim_step();
+    }
+    double dt = get_s() - t0;
+
+    printf("  %.2f M ticks/s (%.0fx real time)\n", ticks / dt * 1e-6, ticks / dt / FOC_SIM_TICKS_PER_SEC);
+}
+
+/* ------------------------------------------------------------------ */
+/*  main                                                                */
+/* ------------------------------------------------------------------ */
+int main(void)
+{
+    test_current_closed();
+    test_speed_closed();
+    test_flux_weak_speed_closed();
+    test_sensorless("sensorless_smo", sensorless_smo_init, print_sensorless_smo_info, 1000.0f);
+    test_sensorless("sensorless_luenberger", sensorless_luenberger_init, print_sensorless_luenberger_info, 1000.0f);
+    test_isr_prof();
+    test_throughput();
+
+    return test_summary();
+}
+
+#endif /* FOC_SIM_HOST */
@@ -0,0 +1,293 @@
+/**
+ * @file test_single_shunt.c
+ * @brief 单电阻采样: 移相 PWM、采样时刻与三相电流重构测试（主机端）
+ *
+ * 编译命令（在 User 目录下运行）：
+ *   gcc -DFOC_SIM_HOST -std=gnu11 -O2 -I test/sim/hal -I . test/test_single_shunt.c \
+ *       $(find test/sim foc motor -name '*.c') bsp/as5047.c utils/ramp.c utils/isr_prof.c utils/telemetry.c -lm -o test_single_shunt
+ *
+ * 运行：
+ *   ./test_single_shunt       (任一失败返回非零)
+ *
+ * 1. 移相: 各调制方式、调制比下前后半周期的平均占空比不变, 两个窗口不短于最小窗口, 采样点在窗口结束前
+ *    TIM1_SS_SAMPLE 且距窗口开始不少于死区 + 振荡稳定时间, 采样对应的相为占空比最低 / 最高相;
+ *    不移相时低调制比下大部分周期至少有一个窗口不足
+ * 2. 合成波形: 按向下计数半周期的开关状态合成两次母线电流采样, 经 12 位 ADC 量化后重构, 与真实相电流之差
+ *    不超过量化误差
+ * 3. SIL: 仿真单电阻采样 (死区 + 振荡稳定 2us 内的采样读到零), 低速与中速速度闭环, 无效采样为零,
+ *    控制器得到的 Iq 与被控对象一致, 转速与三电阻采样相同
+ */
+
+#ifdef FOC_SIM_HOST
+
+#include <stdio.h>
+#include <math.h>
+
+#include "test/sim/foc_sim.h"
+#include "motor/mode_manager.h"
+#include "test/sim/test_check.h"
+
+#define TWO_PI 6.28318530718f
+#define DEG_TO_RAD 0.0174532925f
+
+/* 最小窗口 / 采样保持 (半周期的比例), 与 bsp/tim.c 相同 */
+#define SS_T_MIN ((float)TIM1_SS_MIN_WINDOW / TIM1_PERIOD)
+#define SS_T_SAMPLE ((float)TIM1_SS_SAMPLE / TIM1_PERIOD)
+
+/* 半周期 (us): 占空比刻度换算为时间 */
+#define SS_HALF_US ((float)TIM1_PERIOD / TIM1_CLK_FREQ * 1e6f)
+
+/* 死区 + 振荡稳定时间 (s): 仿真中采样距上一次翻转不足该时间时读到零 */
+#define SS_SETTLE_S ((float)(TIM1_DEADTIME + TIM1_SS_SETTLE) / TIM1_CLK_FREQ)
+
+/* 调制比 m 的电压矢量 (|u| = m · Udc / √3) */
+static alphabeta_t vector_of(float m, float theta)
+{
+    float r = m * U_DC * 0.577350269f;
+    return (alphabeta_t){r * cosf(theta), r * sinf(theta)};
+}
+
+/* 向下计数半周期内 τ 之前 / 之后最近的翻转时刻 */
+static void edges_around(const svpwm_single_shunt_t *ss, float tau, float *prev, float *next)
+{
+    *prev = 0.0f;
+    *next = 1.0f;
+    for (int i = 0; i < 3; i++)
+    {
+        float e = ss->duty_down[i];
+        if (e <= tau && e > *prev)
+            *prev = e;
+        if (e > tau && e < *next)
+            *next = e;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  移相                                                               */
+/* ------------------------------------------------------------------ */
+typedef struct
+{
+    float avg_err;     /* 前后半周期平均占空比与调制输出之差 */
+    float min_settle;  /* 采样点距上一次翻转的最短时间 (半周期的比例) */
+    float min_hold;    /* 采样点距下一次翻转的最短时间 */
+    uint32_t range;    /* 占空比超出 [0, 1] 的次数 */
+    uint32_t phase;    /* 采样对应的相不是最低 / 最高相的次数 */
+    uint32_t invalid;  /* 移相后仍无法保证窗口的周期数 */
+    uint32_t short_raw; /* 不移相时至少一个窗口短于最小窗口的周期数 */
+    uint32_t total;
+} shift_result_t;
+
+static shift_result_t run_shift(svpwm_mode_t mode, uint8_t overmod, float m)
+{
+    svpwm_modulator_t mod;
+    svpwm_modulator_init(&mod, mode);
+    svpwm_modulator_set_overmod(&mod, overmod);
+
+    shift_result_t r = {0.0f, 1.0f, 1.0f, 0, 0, 0, 0, 0};
+
+    for (int k = 0; k < 3600; k++)
+    {
+        abc_t d = svpwm_modulate(&mod, vector_of(m, k * 0.1f * DEG_TO_RAD + 0.001f), 1.0f / U_DC);
+        float duty[3] = {d.a, d.b, d.c};
+
+        svpwm_single_shunt_t ss;
+        svpwm_single_shunt(&ss, d.a, d.b, d.c, SS_T_MIN, SS_T_SAMPLE);
+        r.total++;
+
+        float d_max = fmaxf(d.a, fmaxf(d.b, d.c));
+        float d_min = fminf(d.a, fminf(d.b, d.c));
+        float d_mid = d.a + d.b + d.c - d_max - d_min;
+        r.short_raw += (d_mid - d_min < SS_T_MIN || d_max - d_mid < SS_T_MIN);
+
+        for (int i = 0; i < 3; i++)
+        {
+            r.avg_err = fmaxf(r.avg_err, fabsf(0.5f * (ss.duty_up[i] + ss.duty_down[i]) - duty[i]));
+            /* 过调制输出本身可能超出 [0, 1] 约 1e-8 */
+            r.range += (fminf(ss.duty_up[i], ss.duty_down[i]) < -1e-6f || fmaxf(ss.duty_up[i], ss.duty_down[i]) > 1.0f + 1e-6f);
+        }
+        r.phase += (duty[ss.phase[0]] != d_min || duty[ss.phase[1]] != d_max || ss.phase[0] == ss.phase[1]);
+
+        if (!ss.valid)
+        {
+            r.invalid++;
+            continue;
+        }
+        for (int n = 0; n < 2; n++)
+        {
+            float prev, next;
+            edges_around(&ss, ss.sample[n], &prev, &next);
+            r.min_settle = fminf(r.min_settle, ss.sample[n] - prev);
+            r.min_hold = fminf(r.min_hold, next - ss.sample[n]);
+        }
+    }
+    return r;
+}
+
+static void test_shift(void)
+{
+    printf("\n--- 移相: 最小窗口 %.2fus (半周期的 %.2f%%), 采样保持 %.2fus ---\n",
+           TIM1_SS_MIN_WINDOW / TIM1_CLK_FREQ * 1e6f, SS_T_MIN * 100.0f, TIM1_SS_SAMPLE / TIM1_CLK_FREQ * 1e6f);
+    printf("  %-10s %5s | %8s | %9s | %9s | %7s | %s\n", "mode", "m", "avg err", "settle", "hold", "invalid",
+           "short w/o shift");
+
+    static const struct
+    {
+        const char *name;
+        svpwm_mode_t mode;
+        uint8_t overmod;
+        float m;
+    } cases[] = {
+        {"SVPWM", SVPWM_MODE_SVPWM, 0, 0.0f},
+        {"SVPWM", SVPWM_MODE_SVPWM, 0, 0.05f},
+        {"SVPWM", SVPWM_MODE_SVPWM, 0, 0.3f},
+        {"SVPWM", SVPWM_MODE_SVPWM, 0, 0.6f},
+        {"SVPWM", SVPWM_MODE_SVPWM, 0, 0.9f},
+        {"DPWM1", SVPWM_MODE_DPWM1, 0, 0.8f},
+        {"SVPWM+OM", SVPWM_MODE_SVPWM, 1, 1.05f},
+    };
+
+    float avg_err = 0.0f, settle = 1.0f, hold = 1.0f;
+    uint32_t range = 0, phase = 0, linear_invalid = 0, low_m_short = 0, low_m_total = 0;
+
+    for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        shift_result_t r = run_shift(cases[i].mode, cases[i].overmod, cases[i].m);
+        printf("  %-10s %5.2f | %8.1e | %6.2f us | %6.2f us | %7u | %u / %u\n", cases[i].name, cases[i].m, r.avg_err,
+               r.min_settle * SS_HALF_US, r.min_hold * SS_HALF_US, r.invalid, r.short_raw,
+               r.total);
+
+        avg_err = fmaxf(avg_err, r.avg_err);
+        settle = fminf(settle, r.min_settle);
+        hold = fminf(hold, r.min_hold);
+        range += r.range;
+        phase += r.phase;
+        if (cases[i].mode == SVPWM_MODE_SVPWM && !cases[i].overmod)
+            linear_invalid += r.invalid;
+        if (cases[i].m <= 0.3f)
+        {
+            low_m_short += r.short_raw;
+            low_m_total += r.total;
+        }
+    }
+
+    TEST_CHECK(avg_err < 1e-6f, "average duty over the period is unchanged (max error %.1e)", avg_err);
+    TEST_CHECK(range == 0, "shifted duties stay within [0, 1]");
+    TEST_CHECK(phase == 0, "samples map to the lowest / highest duty phase");
+    TEST_CHECK(linear_invalid == 0, "SVPWM m <= 0.9: both windows always available");
+    TEST_CHECK(settle >= SS_T_MIN - SS_T_SAMPLE - 1e-6f, "sample >= %.2fus after the last edge (min %.2fus)",
+               (SS_T_MIN - SS_T_SAMPLE) * SS_HALF_US, settle * SS_HALF_US);
+    TEST_CHECK(hold >= SS_T_SAMPLE - 1e-6f, "conversion ends before the next edge (min %.2fus)",
+               hold * SS_HALF_US);
+    TEST_CHECK(low_m_short > low_m_total / 2, "without shifting, m <= 0.3 lacks a window in %u / %u periods", low_m_short,
+               low_m_total);
+}
+
+/* ------------------------------------------------------------------ */
+/*  合成波形                                                           */
+/* ------------------------------------------------------------------ */
+static uint16_t adc_code(float i)
+{
+    float code = (ADC_REF_VOLTAGE + i / ADC_CURRENT_SCALE) * 4096.0f / 3.3f;
+    return (uint16_t)lrintf(fminf(fmaxf(code, 0.0f), 4095.0f));
+}
+
+static void test_synthetic(void)
+{
+    printf("\n--- 合成波形: 两次母线电流采样重构三相电流 ---\n");
+
+    adc_scale_t scale;
+    adc_offset_t offset = {0};
+    adc1_scale_init(&scale, &offset);
+
+    svpwm_modulator_t mod;
+    svpwm_modulator_init(&mod, SVPWM_MODE_SVPWM);
+
+    const float i_peak = 4.0f, phi = 30.0f * DEG_TO_RAD;
+    float err = 0.0f;
+    uint32_t sign_wrong = 0;
+
+    for (int k = 0; k < 3600; k++)
+    {
+        float theta = k * 0.1f * DEG_TO_RAD;
+        float m = 0.05f + 0.85f * (float)(k % 97) / 96.0f;
+        abc_t d = svpwm_modulate(&mod, vector_of(m, theta), 1.0f / U_DC);
+        float i_true[3] = {i_peak * cosf(theta - phi), i_peak * cosf(theta - phi - TWO_PI / 3.0f),
+                           i_peak * cosf(theta - phi + TWO_PI / 3.0f)};
+
+        svpwm_single_shunt_t ss;
+        svpwm_single_shunt(&ss, d.a, d.b, d.c, SS_T_MIN, SS_T_SAMPLE);
+
+        /* 采样时刻上桥导通的相电流流过母线电阻 */
+        float i_dc[2] = {0.0f, 0.0f};
+        for (int n = 0; n < 2; n++)
+        {
+            for (int p = 0; p < 3; p++)
+            {
+                if (ss.sample[n] < ss.duty_down[p])
+                    i_dc[n] += i_true[p];
+            }
+        }
+        sign_wrong += (fabsf(i_dc[0] + i_true[ss.phase[0]]) > 1e-4f || fabsf(i_dc[1] - i_true[ss.phase[1]]) > 1e-4f);
+
+        adc_values_t v;
+        adc1_single_shunt_convert(&scale, adc_code(i_dc[0]), adc_code(i_dc[1]), ss.phase[0], ss.phase[1], &v);
+        err = fmaxf(err, fmaxf(fabsf(v.ia - i_true[0]), fmaxf(fabsf(v.ib - i_true[1]), fabsf(v.ic - i_true[2]))));
+    }
+
+    TEST_CHECK(sign_wrong == 0, "window 1 carries -i_min, window 2 carries +i_max");
+    TEST_CHECK(err <= 2.0f * scale.i_gain, "reconstruction error %.4f A <= 2 LSB (%.4f A)", err, 2.0f * scale.i_gain);
+}
+
+/* ------------------------------------------------------------------ */
+/*  SIL                                                                */
+/* ------------------------------------------------------------------ */
+/* 无效采样次数为母线电流采样 (单电阻) 或相采样 (三电阻) */
+static foc_sim_iq_error_t run_sil(uint8_t single_shunt, float rpm_ref)
+{
+    foc_sim_start(12.0f);
+    foc_sim_set_single_shunt(single_shunt);
+    foc_sim_set_adc_window(single_shunt ? SS_SETTLE_S : 0.0f);
+
+    mode_manager_speed(rpm_ref);
+    foc_sim_run(3.0f);
+
+    foc_sim_iq_error_t r;
+    foc_sim_measure_iq_error(5000, &r);
+    return r;
+}
+
+static void test_sil(void)
+{
+    printf("\n--- SIL: 速度闭环, 单电阻采样 (翻转后 %.1fus 内采样无效) 与三电阻采样对比 ---\n", SS_SETTLE_S * 1e6f);
+
+    static const float rpm_list[] = {200.0f, 2000.0f};
+
+    for (unsigned i = 0; i < sizeof(rpm_list) / sizeof(rpm_list[0]); i++)
+    {
+        foc_sim_iq_error_t three = run_sil(0, rpm_list[i]);
+        foc_sim_iq_error_t one = run_sil(1, rpm_list[i]);
+
+        printf("  %6.0f rpm | 3-shunt: %7.1f rpm, Iq err rms %.4f A | 1-shunt: %7.1f rpm, Iq err rms %.4f A max %.4f A, "
+               "invalid %u\n",
+               rpm_list[i], three.rpm, three.iq_err_rms, one.rpm, one.iq_err_rms, one.iq_err_max, one.invalid);
+
+        TEST_CHECK(one.invalid == 0, "%.0f rpm: every DC-link sample falls inside a settled window", rpm_list[i]);
+        TEST_CHECK(one.iq_err_max < 0.05f, "%.0f rpm: measured Iq matches the plant (max err %.4f A)", rpm_list[i],
+                   one.iq_err_max);
+        TEST_CHECK(fabsf(one.rpm - rpm_list[i]) < 5.0f && fabsf(one.rpm - three.rpm) < 2.0f,
+                   "%.0f rpm: speed held like the three-shunt run (%.1f / %.1f rpm)", rpm_list[i], one.rpm, three.rpm);
+    }
+}
+
+int main(void)
+{
+    printf("========== Single-shunt current reconstruction test ==========\n");
+
+    test_shift();
+    test_synthetic();
+    test_sil();
+
+    return test_summary();
+}
+
+#endif /* FOC_SIM_HOST */
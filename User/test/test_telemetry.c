@@ -0,0 +1,538 @@
+/**
+ * @file test_telemetry.c
+ * @brief 二进制遥测 (utils/telemetry) 帧格式 / 丢帧检测 / 触发 / 吞吐测试（主机端）
+ *
+ * 编译命令（在 User 目录下运行）：
+ *   gcc -DFOC_SIM_HOST -std=gnu11 -O2 -I test/sim/hal -I . test/test_telemetry.c utils/telemetry.c -lm -o test_telemetry
+ *
+ * 运行：
+ *   ./test_telemetry           (任一失败返回非零)
+ *
+ * 用串口模型替代 USART1 DMA: 921600 波特率 (8N1, 每字节 10 位), 每个 100us 控制周期传输 9.216 字节,
+ * 一次 DMA 发送的全部字节传完后调用 telemetry_tx_done()。每个周期依次执行:
+ * 控制中断 telemetry_sample() -> 串口模型推进 -> 主循环 telemetry_poll()。
+ * 收到的字节流交给上位机解码器 (JustFloat 按帧尾分帧, int16 按帧头同步 + 校验), 检查:
+ * 帧完整性、序号连续 / 丢帧数与发送端计数一致、数值、触发位置, 以及链路利用率。
+ */
+
+#ifdef FOC_SIM_HOST
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "utils/telemetry.h"
+#include "test/sim/test_check.h"
+
+#define UART_BAUD 921600.0
+#define UART_BYTES_PER_TICK (UART_BAUD / 10.0 * 0.0001) /* 每个控制周期可传输的字节数 */
+#define TICKS_PER_SEC 10000
+
+/* ------------------------------------------------------------------ */
+/*  串口模型                                                            */
+/* ------------------------------------------------------------------ */
+#define WIRE_MAX (1 << 20)
+
+static struct
+{
+    uint8_t *data;      /* 正在发送的 DMA 缓冲区 */
+    uint16_t size;
+    double sent;        /* 已发送字节数 (含小数, 按时间推进) */
+    uint8_t busy;
+    uint32_t blocked;   /* 模拟串口被其他发送占用的剩余周期数 */
+
+    uint8_t wire[WIRE_MAX]; /* 线上收到的字节流 */
+    uint32_t wire_len;
+    double idle_bytes;  /* 线路空闲 (可发送却没有数据) 的字节时间 */
+} uart;
+
+static uint8_t uart_send(uint8_t *data, uint16_t size)
+{
+    if (uart.busy || uart.blocked > 0)
+        return 1;
+
+    uart.data = data;
+    uart.size = size;
+    uart.sent = 0.0;
+    uart.busy = 1;
+    return 0;
+}
+
+static const telemetry_transport_t uart_transport = {NULL, uart_send};
+
+/* 推进一个控制周期的传输时间 */
+static void uart_tick(void)
+{
+    double budget = UART_BYTES_PER_TICK;
+
+    if (uart.blocked > 0)
+    {
+        uart.blocked--;
+        if (uart.blocked == 0)
+            telemetry_tx_done(); /* 其他发送结束, 发送完成中断同样会到来 */
+        return;
+    }
+
+    while (budget > 0.0 && uart.busy)
+    {
+        double remain = uart.size - uart.sent;
+        double step = remain < budget ? remain : budget;
+        uart.sent += step;
+        budget -= step;
+
+        if (uart.sent >= uart.size - 1e-9)
+        {
+            memcpy(&uart.wire[uart.wire_len], uart.data, uart.size);
+            uart.wire_len += uart.size;
+            uart.busy = 0;
+            telemetry_tx_done(); /* DMA 发送完成中断, 可能立即启动下一个缓冲区 */
+        }
+    }
+
+    uart.idle_bytes += budget;
+}
+
+static void uart_reset(void)
+{
+    memset(&uart, 0, sizeof(uart));
+    uart.data = NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/*  被采样的信号                                                        */
+/* ------------------------------------------------------------------ */
+static uint32_t tick;
+static float ch_tick;  /* 周期计数 */
+static float ch_sine;  /* 50Hz 正弦, 幅值 3 */
+static float ch_angle; /* 连续增长的电角度 (rad), 检验角度通道折算 */
+static float ch_const[5];
+
+static void signals_update(void)
+{
+    ch_tick = (float)tick;
+    ch_sine = 3.0f * sinf(6.28318530718f * 50.0f * tick * 0.0001f);
+    ch_angle = -20.0f + (float)tick * 0.01f;
+    for (int i = 0; i < 5; i++)
+        ch_const[i] = 0.25f * (i + 1);
+}
+
+/* 一个控制周期: 中断采样 -> 串口推进 -> 主循环 */
+static void run_ticks(uint32_t ticks)
+{
+    for (uint32_t n = 0; n < ticks; n++)
+    {
+        signals_update();
+        telemetry_sample();
+        uart_tick();
+        telemetry_poll();
+        tick++;
+    }
+}
+
+/* 让主循环把剩余数据发完 */
+static void drain(void)
+{
+    for (int n = 0; n < 5000; n++)
+    {
+        uart_tick();
+        telemetry_poll();
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  上位机解码器                                                        */
+/* ------------------------------------------------------------------ */
+#define DEC_MAX_FRAMES 40000
+#define DEC_MAX_CH 9
+
+typedef struct
+{
+    uint16_t seq;
+    uint8_t trig;
+    uint8_t num;
+    float value[DEC_MAX_CH];
+} frame_t;
+
+static frame_t frames[DEC_MAX_FRAMES];
+
+typedef struct
+{
+    uint32_t frames;
+    uint32_t bad;      /* 长度或校验错误 */
+    uint32_t gaps;     /* 序号跳过的帧数 */
+} decode_stat_t;
+
+static void decode_count_gaps(decode_stat_t *st)
+{
+    st->gaps = 0;
+    for (uint32_t i = 1; i < st->frames; i++)
+        st->gaps += (uint16_t)(frames[i].seq - frames[i - 1].seq - 1);
+}
+
+/* JustFloat: 以帧尾 00 00 80 7F 分帧, 最后一个 float 为序号 */
+static decode_stat_t decode_justfloat(const uint8_t *data, uint32_t len, uint8_t num)
+{
+    decode_stat_t st = {0};
+    uint32_t start = 0;
+
+    for (uint32_t i = 3; i < len; i++)
+    {
+        if (data[i - 3] == 0x00 && data[i - 2] == 0x00 && data[i - 1] == 0x80 && data[i] == 0x7F)
+        {
+            uint32_t frame_len = i + 1 - start;
+            if (frame_len == (uint32_t)TELEMETRY_JUSTFLOAT_FRAME_LEN(num) && st.frames < DEC_MAX_FRAMES)
+            {
+                float v[DEC_MAX_CH + 1];
+                memcpy(v, &data[start], (num + 1) * sizeof(float));
+                frame_t *f = &frames[st.frames++];
+                f->num = num;
+                f->trig = 0;
+                memcpy(f->value, v, num * sizeof(float));
+                f->seq = (uint16_t)v[num];
+            }
+            else
+            {
+                st.bad++;
+            }
+            start = i + 1;
+        }
+    }
+
+    decode_count_gaps(&st);
+    return st;
+}
+
+/* int16: 帧头同步, 校验失败时从下一个字节重新同步 */
+static decode_stat_t decode_int16(const uint8_t *data, uint32_t len, const float *scale)
+{
+    decode_stat_t st = {0};
+    uint32_t i = 0;
+
+    while (i + 6 <= len)
+    {
+        if (data[i] != TELEMETRY_INT16_SYNC0 || data[i + 1] != TELEMETRY_INT16_SYNC1)
+        {
+            i++;
+            continue;
+        }
+
+        uint8_t num = data[i + 4] & 0x7F;
+        uint32_t frame_len = TELEMETRY_INT16_FRAME_LEN(num);
+        if (num > DEC_MAX_CH || i + frame_len > len)
+        {
+            st.bad++;
+            i++;
+            continue;
+        }
+
+        uint8_t sum = 0;
+        for (uint32_t k = i + 2; k < i + frame_len - 1; k++)
+            sum += data[k];
+        if (sum != data[i + frame_len - 1])
+        {
+            st.bad++;
+            i++;
+            continue;
+        }
+
+        if (st.frames < DEC_MAX_FRAMES)
+        {
+            frame_t *f = &frames[st.frames++];
+            f->seq = (uint16_t)(data[i + 2] | (data[i + 3] << 8));
+            f->trig = (data[i + 4] & TELEMETRY_INT16_TRIG_FLAG) != 0;
+            f->num = num;
+            for (uint8_t c = 0; c < num; c++)
+            {
+                int16_t raw = (int16_t)(data[i + 5 + 2 * c] | (data[i + 6 + 2 * c] << 8));
+                f->value[c] = raw / scale[c];
+            }
+        }
+        i += frame_len;
+    }
+
+    decode_count_gaps(&st);
+    return st;
+}
+
+/* ------------------------------------------------------------------ */
+/*  测试                                                                */
+/* ------------------------------------------------------------------ */
+static void setup(void)
+{
+    uart_reset();
+    tick = 0;
+    telemetry_set_transport(&uart_transport);
+    telemetry_init();
+}
+
+/* 抽取第 seq 个样本时的周期号 (抽取计数在第 decimation 次调用时采样) */
+static uint32_t tick_of_seq(uint32_t seq, uint32_t decimation)
+{
+    return (seq + 1) * decimation - 1;
+}
+
+static void test_justfloat_stream(void)
+{
+    printf("\n--- JustFloat 自由运行: 4 通道, 抽取 4 (2500 帧/s, 60 kB/s) ---\n");
+
+    setup();
+    telemetry_add_channel(&ch_tick, 1.0f);
+    telemetry_add_channel(&ch_sine, 1000.0f);
+    telemetry_add_angle_channel(&ch_angle);
+    telemetry_add_channel(&ch_const[0], 1000.0f);
+    telemetry_config(TELEMETRY_FORMAT_JUSTFLOAT, 4);
+    telemetry_start();
+
+    run_ticks(TICKS_PER_SEC);
+    telemetry_stop();
+    drain();
+
+    telemetry_stats_t ts;
+    telemetry_get_stats(&ts);
+    decode_stat_t st = decode_justfloat(uart.wire, uart.wire_len, 4);
+
+    TEST_CHECK(ts.samples == 2500 && ts.dropped == 0, "samples = %u, dropped = %u", ts.samples, ts.dropped);
+    TEST_CHECK(st.frames == ts.samples && st.bad == 0, "decoded frames = %u, bad = %u", st.frames, st.bad);
+    TEST_CHECK(st.gaps == 0 && frames[0].seq == 0, "sequence contiguous (gaps = %u)", st.gaps);
+    TEST_CHECK(uart.wire_len == ts.bytes, "wire bytes = %u (packed %u)", uart.wire_len, ts.bytes);
+
+    /* 数值: 周期号、正弦、角度折算 */
+    uint32_t value_err = 0;
+    float angle_err = 0.0f;
+    for (uint32_t i = 0; i < st.frames; i++)
+    {
+        uint32_t t = tick_of_seq(frames[i].seq, 4);
+        float sine = 3.0f * sinf(6.28318530718f * 50.0f * t * 0.0001f);
+        float angle = -20.0f + (float)t * 0.01f;
+        float deg = fmodf(angle * 57.29577951f, 360.0f);
+        if (deg < 0.0f)
+            deg += 360.0f;
+
+        if (frames[i].value[0] != (float)t || frames[i].value[1] != sine || frames[i].value[3] != 0.25f)
+            value_err++;
+
+        float e = fabsf(frames[i].value[2] - deg);
+        e = fminf(e, 360.0f - e);
+        angle_err = fmaxf(angle_err, e);
+    }
+    TEST_CHECK(value_err == 0, "channel values exact (%u mismatches)", value_err);
+    TEST_CHECK(angle_err < 0.01f, "angle channel wrapped to [0, 360) deg, max error = %.4f deg", angle_err);
+}
+
+static void test_int16_stream(void)
+{
+    printf("\n--- int16 自由运行: 6 通道, 抽取 2 (5000 帧/s, 90 kB/s) ---\n");
+
+    setup();
+    float scale[6] = {1.0f, 1000.0f, TELEMETRY_ANGLE_INT16_SCALE, 1000.0f, 1000.0f, 1000.0f};
+    telemetry_add_channel(&ch_sine, scale[0]);
+    telemetry_add_channel(&ch_sine, scale[1]);
+    telemetry_add_angle_channel(&ch_angle);
+    telemetry_add_channel(&ch_const[0], scale[3]);
+    telemetry_add_channel(&ch_const[1], scale[4]);
+    telemetry_add_channel(&ch_const[2], scale[5]);
+    telemetry_config(TELEMETRY_FORMAT_INT16, 2);
+    telemetry_start();
+
+    run_ticks(TICKS_PER_SEC);
+    telemetry_stop();
+    drain();
+
+    telemetry_stats_t ts;
+    telemetry_get_stats(&ts);
+    decode_stat_t st = decode_int16(uart.wire, uart.wire_len, scale);
+
+    /* 18 字节 × 5000 = 90000 B/s, 链路 92160 B/s, 利用率 97.7%, 仍应不丢帧 */
+    TEST_CHECK(ts.samples == 5000 && ts.dropped == 0, "samples = %u, dropped = %u", ts.samples, ts.dropped);
+    TEST_CHECK(st.frames == ts.samples && st.bad == 0 && st.gaps == 0, "decoded frames = %u, bad = %u, gaps = %u",
+               st.frames, st.bad, st.gaps);
+
+    /* 量化误差不超过半个 LSB */
+    float max_err = 0.0f;
+    for (uint32_t i = 0; i < st.frames; i++)
+    {
+        uint32_t t = tick_of_seq(frames[i].seq, 2);
+        float sine = 3.0f * sinf(6.28318530718f * 50.0f * t * 0.0001f);
+        max_err = fmaxf(max_err, fabsf(frames[i].value[1] - sine) * scale[1]);
+        max_err = fmaxf(max_err, fabsf(frames[i].value[5] - 0.75f) * scale[5]);
+    }
+    TEST_CHECK(max_err <= 0.5f + 1e-3f, "quantization error = %.3f LSB", max_err);
+}
+
+static void test_overload(void)
+{
+    printf("\n--- 过载: int16 8 通道, 不抽取 (220 kB/s > 92 kB/s 链路) ---\n");
+
+    setup();
+    float scale[8];
+    for (int i = 0; i < 8; i++)
+    {
+        scale[i] = 1000.0f;
+        telemetry_add_channel(&ch_sine, scale[i]);
+    }
+    telemetry_config(TELEMETRY_FORMAT_INT16, 1);
+    telemetry_start();
+
+    run_ticks(TICKS_PER_SEC);
+    uint32_t run_bytes = uart.wire_len;
+    telemetry_stop();
+    drain();
+
+    telemetry_stats_t ts;
+    telemetry_get_stats(&ts);
+    decode_stat_t st = decode_int16(uart.wire, uart.wire_len, scale);
+
+    /* 序号跳变 + 首帧之前 + 末帧之后丢失的样本 = 发送端丢弃计数 */
+    uint32_t lead = frames[0].seq;
+    uint32_t trail = ts.samples - 1 - frames[st.frames - 1].seq;
+    TEST_CHECK(ts.dropped > 0, "producer dropped %u of %u samples", ts.dropped, ts.samples);
+    TEST_CHECK(st.bad == 0, "no corrupted frames (bad = %u)", st.bad);
+    TEST_CHECK(st.gaps + lead + trail == ts.dropped, "decoder detected gaps = %u + %u trailing (producer dropped %u)",
+               st.gaps, trail, ts.dropped);
+    TEST_CHECK(st.frames + ts.dropped == ts.samples, "frames + dropped = %u", st.frames + ts.dropped);
+
+    /* 满负荷时链路几乎不空闲 */
+    double utilization = (double)run_bytes / (UART_BYTES_PER_TICK * TICKS_PER_SEC);
+    TEST_CHECK(utilization > 0.95, "link utilization = %.1f%%", utilization * 100.0);
+}
+
+static void test_uart_shared(void)
+{
+    printf("\n--- 串口被其他发送占用 (printf) 后恢复 ---\n");
+
+    setup();
+    telemetry_add_channel(&ch_tick, 1.0f);
+    telemetry_add_channel(&ch_sine, 1000.0f);
+    telemetry_config(TELEMETRY_FORMAT_INT16, 10);
+    telemetry_start();
+
+    run_ticks(1000);
+    uart.blocked = 50; /* 5ms 内无法启动 DMA, 环形缓冲区可容纳 */
+    run_ticks(2000);
+    telemetry_stop();
+    drain();
+
+    telemetry_stats_t ts;
+    telemetry_get_stats(&ts);
+    float scale[2] = {1.0f, 1000.0f};
+    decode_stat_t st = decode_int16(uart.wire, uart.wire_len, scale);
+
+    TEST_CHECK(ts.tx_busy > 0, "send retried after busy (%u times)", ts.tx_busy);
+    TEST_CHECK(st.frames == ts.samples && st.gaps == 0 && ts.dropped == 0, "all %u frames delivered, gaps = %u",
+               st.frames, st.gaps);
+}
+
+static void test_trigger(void)
+{
+    printf("\n--- 触发: 正弦上升沿过 0, pre 20 / post 30, 自动重新布防 ---\n");
+
+    setup();
+    float scale[2] = {1000.0f, 1.0f};
+    telemetry_add_channel(&ch_sine, scale[0]);
+    telemetry_add_channel(&ch_tick, scale[1]);
+
+    telemetry_trigger_t trig = {
+        .channel = 0,
+        .edge = TELEMETRY_EDGE_RISING,
+        .level = 0.0f,
+        .pre = 20,
+        .post = 30,
+        .auto_rearm = 1,
+    };
+    telemetry_set_trigger(&trig);
+    telemetry_config(TELEMETRY_FORMAT_INT16, 1);
+
+    /* 从正弦中段开始, 第一次上升沿前已攒满触发前样本 */
+    tick = 50;
+    telemetry_start();
+    TEST_CHECK(telemetry_get_state() == TELEMETRY_STATE_ARMED, "armed after start");
+
+    run_ticks(1000); /* 100ms = 5 个电周期 */
+    telemetry_stop();
+    drain();
+
+    telemetry_stats_t ts;
+    telemetry_get_stats(&ts);
+    decode_stat_t st = decode_int16(uart.wire, uart.wire_len, scale);
+
+    /* 按触发标志切分捕获 */
+    uint32_t captures = 0, bad_capture = 0;
+    for (uint32_t i = 0; i < st.frames; i++)
+    {
+        if (!frames[i].trig)
+            continue;
+        captures++;
+
+        if (i < 20 || i + 30 >= st.frames)
+        {
+            bad_capture++;
+            continue;
+        }
+
+        /* 触发前 20 个 + 触发 + 触发后 30 个样本连续 */
+        uint8_t ok = 1;
+        for (uint32_t k = i - 20; k < i + 30; k++)
+            ok &= (uint16_t)(frames[k + 1].seq - frames[k].seq) == 1;
+
+        /* 触发样本过零 (前一个 < 0 <= 当前) */
+        ok &= frames[i - 1].value[0] < 0.0f && frames[i].value[0] >= 0.0f;
+
+        /* 周期号连续 */
+        ok &= frames[i + 30].value[1] - frames[i - 20].value[1] == 50.0f;
+
+        if (!ok)
+            bad_capture++;
+    }
+
+    TEST_CHECK(ts.triggers >= 3, "triggers = %u", ts.triggers);
+    TEST_CHECK(captures == ts.triggers && st.frames == captures * 51, "%u captures, %u frames (51 per capture)",
+               captures, st.frames);
+    TEST_CHECK(bad_capture == 0 && st.bad == 0, "pre/post window contiguous, trigger at zero crossing (%u bad)",
+               bad_capture);
+}
+
+/* 中断中的采样耗时 */
+static volatile float sink;
+
+static void test_sample_cost(void)
+{
+    printf("\n--- telemetry_sample() 耗时 (主机) ---\n");
+
+    setup();
+    for (int i = 0; i < 8; i++)
+        telemetry_add_channel(&ch_sine, 1000.0f);
+    telemetry_config(TELEMETRY_FORMAT_INT16, 1);
+    telemetry_start();
+
+    const int n = 2000000;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < n; i++)
+    {
+        telemetry_sample();
+        /* 清空环形缓冲区, 保持每次都写入样本 */
+        if ((i & 63) == 63)
+            telemetry_start();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double ns = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / n;
+    printf("  8 channels: %.1f ns/call\n", ns);
+}
+
+int main(void)
+{
+    printf("=== telemetry engine ===\n");
+
+    test_justfloat_stream();
+    test_int16_stream();
+    test_overload();
+    test_uart_shared();
+    test_trigger();
+    test_sample_cost();
+
+    return test_summary();
+}
+
+#endif /* FOC_SIM_HOST */
@@ -0,0 +1,278 @@
+/**
+ * @file test_voltage_limit.c
+ * @brief dq 电压矢量圆限幅 (d 轴优先) + 反算抗饱和测试（主机端）
+ *
+ * 编译命令（在 User 目录下运行）：
+ *   gcc -DFOC_SIM_HOST -std=gnu11 -O2 -I test/sim/hal -I . test/test_voltage_limit.c \
+ *       $(find test/sim foc motor -name '*.c') bsp/as5047.c utils/ramp.c utils/isr_prof.c utils/telemetry.c -lm -o test_voltage_limit
+ *
+ * 运行：
+ *   ./test_voltage_limit       (任一失败返回非零)
+ *
+ * 1. foc_voltage_limit: 幅值不超限、d 轴优先、未饱和时原样输出
+ * 2. pid_back_calculate: 外部限幅下积分项收敛到实际输出, 不再累积
+ * 3. dq 电流环 + RL 负载在电压上限运行: 与各轴单独限幅 + SVPWM 等比缩小 (原实现) 对比
+ *    Id 跟踪误差、积分项与退出饱和后的恢复时间
+ * 4. SIL (mode_manager): 12V 下速度闭环达到 4000 RPM (反电势 4.4V, 超过原 ±U_DC/3 的 q 轴限幅);
+ *    7V 下电压受限运行时实际电压矢量不超过 FOC_V_MAX_K · Udc
+ */
+
+#ifdef FOC_SIM_HOST
+
+#include <stdio.h>
+#include <math.h>
+
+#include "foc/foc.h"
+#include "test/sim/foc_sim.h"
+#include "motor/mode_manager.h"
+#include "test/sim/test_check.h"
+
+#define TS FOC_SIM_TS
+
+/* ------------------------------------------------------------------ */
+/*  foc_voltage_limit                                                  */
+/* ------------------------------------------------------------------ */
+static void test_limit(void)
+{
+    printf("\n--- foc_voltage_limit ---\n");
+
+    float max_over = 0.0f, max_mag_err = 0.0f;
+    int inside_changed = 0, d_changed = 0, sign_flip = 0;
+
+    for (int i = 0; i < 100000; i++)
+    {
+        float v_max = test_rand_range(1.0f, 10.0f);
+        dq_t v = {test_rand_range(-15.0f, 15.0f), test_rand_range(-15.0f, 15.0f)};
+        dq_t o = foc_voltage_limit(v, v_max);
+
+        float mag_in = sqrtf(v.d * v.d + v.q * v.q);
+        float mag = sqrtf(o.d * o.d + o.q * o.q);
+        max_over = fmaxf(max_over, mag / v_max - 1.0f);
+
+        if (mag_in <= v_max)
+        {
+            inside_changed += (o.d != v.d) || (o.q != v.q);
+            continue;
+        }
+
+        /* d 轴优先: |vd| 不超限时 vd 保持, vq 取剩余幅值, 合成幅值正好在圆上 */
+        if (fabsf(v.d) < v_max)
+        {
+            d_changed += (o.d != v.d);
+            max_mag_err = fmaxf(max_mag_err, fabsf(mag - v_max) / v_max);
+        }
+        else
+        {
+            d_changed += (o.d != copysignf(v_max, v.d)) || (o.q != 0.0f);
+        }
+        sign_flip += (o.q * v.q < 0.0f);
+    }
+
+    TEST_CHECK(max_over < 1e-6f, "|v_out| <= v_max (max relative excess %.2e)", max_over);
+    TEST_CHECK(inside_changed == 0, "inside circle: unchanged (%d changed)", inside_changed);
+    TEST_CHECK(d_changed == 0, "d priority: vd kept, clamped to ±v_max with vq = 0 (%d violations)", d_changed);
+    TEST_CHECK(max_mag_err < 1e-5f, "saturated output on the circle (max relative error %.2e)", max_mag_err);
+    TEST_CHECK(sign_flip == 0, "vq sign preserved (%d flips)", sign_flip);
+}
+
+/* ------------------------------------------------------------------ */
+/*  pid_back_calculate                                                 */
+/* ------------------------------------------------------------------ */
+static void test_back_calculate(void)
+{
+    printf("\n--- pid_back_calculate: 恒定误差 + 外部限幅 ---\n");
+
+    pid_controller_t pid;
+    pid_init(&pid, 0.017f, 0.002826f, -6.6f, 6.6f);
+    TEST_CHECK(fabsf(pid.kb - 0.002826f / 0.017f) < 1e-7f, "default kb = ki / kp = %.4f", pid.kb);
+
+    /* PI 输出一直大于外部限幅 3V: 积分项 (含本周期增量 ki·e) 应收敛到 3V, 而不是积到单轴限幅 */
+    const float limit = 3.0f;
+    for (int n = 0; n < 2000; n++)
+    {
+        float out = pid_calculate(&pid, 200.0f, 0.0f);
+        if (out > limit)
+            pid_back_calculate(&pid, limit);
+    }
+    float integral_next = pid.integral + pid.ki * pid.error;
+    TEST_CHECK(fabsf(integral_next - limit) < 0.01f * limit, "integral settles at the limit: %.3f V", integral_next);
+    TEST_CHECK(pid.out == limit, "out holds the limited value %.3f V", pid.out);
+
+    /* 误差反向后第一个周期输出即离开限幅 */
+    float out = pid_calculate(&pid, -10.0f, 0.0f);
+    TEST_CHECK(out < limit, "leaves the limit on the first tick after error reversal: %.3f V", out);
+
+    /* 外部限幅未生效 (实际输出 = PI 输出) 时反算不改变 PI 状态 */
+    pid_controller_t a, b;
+    pid_init(&a, 0.017f, 0.002826f, -6.6f, 6.6f);
+    pid_init(&b, 0.017f, 0.002826f, -6.6f, 6.6f);
+    int mismatch = 0;
+    for (int n = 0; n < 1000; n++)
+    {
+        float sp = test_rand_range(-50.0f, 50.0f), fb = test_rand_range(-50.0f, 50.0f);
+        float oa = pid_calculate(&a, sp, fb);
+        float ob = pid_calculate(&b, sp, fb);
+        pid_back_calculate(&b, ob);
+        mismatch += (oa != ob) || (a.integral != b.integral);
+    }
+    TEST_CHECK(mismatch == 0, "back-calculation with out == limited is a no-op (%d mismatches)", mismatch);
+}
+
+/* ------------------------------------------------------------------ */
+/*  dq 电流环 + RL 负载                                                */
+/* ------------------------------------------------------------------ */
+#define RL_R 0.12f
+#define RL_L 3e-5f
+#define RL_PSI 0.0015f
+
+typedef struct
+{
+    float id_err_sat; /* 饱和末段 Id 跟踪误差最大值 (A) */
+    float int_max;    /* 饱和期间积分项幅值最大值 (V) */
+    float v_max_out;  /* 输出电压矢量幅值最大值 (V) */
+    int settle;       /* Iq 指令下降后进入 ±1A 的周期数 */
+} rl_result_t;
+
+/*
+ * 固定电角速度下的 dq 电流环: Id* = -20A (弱磁), Iq* = 80A 使电压饱和 30ms, 然后 Iq* = 5A 回到线性区。
+ * circle = 1: foc_voltage_limit + 反算; circle = 0: 各轴 PI 单独限幅, 矢量超出后等比缩小 (原 SVPWM 行为)
+ */
+static rl_result_t rl_run(int circle, float we, float v_max)
+{
+    pid_controller_t pd, pq;
+    pid_init(&pd, 0.017f, 0.002826f, -v_max, v_max);
+    pid_init(&pq, 0.017f, 0.002826f, -v_max, v_max);
+
+    float id = 0.0f, iq = 0.0f;
+    dq_t v_next = {0.0f, 0.0f};
+    rl_result_t r = {0.0f, 0.0f, 0.0f, -1};
+
+    for (int n = 0; n < 600; n++)
+    {
+        float id_ref = -20.0f;
+        float iq_ref = (n < 300) ? 80.0f : 5.0f;
+
+        dq_t v_pi = {pid_calculate(&pd, id_ref, id), pid_calculate(&pq, iq_ref, iq)};
+        dq_t v = v_pi;
+        if (circle)
+        {
+            v = foc_voltage_limit(v_pi, v_max);
+            if (v.d != v_pi.d || v.q != v_pi.q)
+            {
+                pid_back_calculate(&pd, v.d);
+                pid_back_calculate(&pq, v.q);
+            }
+        }
+        else
+        {
+            float mag = sqrtf(v.d * v.d + v.q * v.q);
+            if (mag > v_max)
+            {
+                v.d *= v_max / mag;
+                v.q *= v_max / mag;
+            }
+        }
+
+        /* 占空比下一周期生效 */
+        dq_t u = v_next;
+        v_next = v;
+        r.v_max_out = fmaxf(r.v_max_out, sqrtf(u.d * u.d + u.q * u.q));
+
+        for (int k = 0; k < 20; k++)
+        {
+            const float h = TS / 20.0f;
+            float did = (u.d - RL_R * id + we * RL_L * iq) / RL_L;
+            float diq = (u.q - RL_R * iq - we * RL_L * id - we * RL_PSI) / RL_L;
+            id += did * h;
+            iq += diq * h;
+        }
+
+        if (n > 200 && n < 300)
+        {
+            r.id_err_sat = fmaxf(r.id_err_sat, fabsf(id - id_ref));
+            r.int_max = fmaxf(r.int_max, sqrtf(pd.integral * pd.integral + pq.integral * pq.integral));
+        }
+        if (n >= 300)
+        {
+            if (fabsf(iq - iq_ref) >= 1.0f)
+                r.settle = -1;
+            else if (r.settle < 0)
+                r.settle = n - 300;
+        }
+    }
+    return r;
+}
+
+static void test_current_loop(void)
+{
+    printf("\n--- dq 电流环 @3500 RPM, 12V: 电压饱和 30ms 后恢复 ---\n");
+
+    const float we = 3500.0f * 7.0f * 6.28318531f / 60.0f;
+    const float v_max = FOC_V_MAX_K * 12.0f;
+
+    rl_result_t old = rl_run(0, we, v_max);
+    rl_result_t neu = rl_run(1, we, v_max);
+
+    printf("  per-axis + rescale: id err %.2f A, |integral| %.2f V, settle %d ticks\n", old.id_err_sat, old.int_max, old.settle);
+    printf("  circle + back-calc: id err %.2f A, |integral| %.2f V, settle %d ticks\n", neu.id_err_sat, neu.int_max, neu.settle);
+
+    TEST_CHECK(neu.v_max_out <= v_max * 1.000001f, "applied |v| %.3f V <= v_max %.3f V", neu.v_max_out, v_max);
+    TEST_CHECK(neu.id_err_sat < 0.5f && neu.id_err_sat < old.id_err_sat, "d priority: Id error at saturation %.2f A", neu.id_err_sat);
+    TEST_CHECK(neu.int_max < v_max * 1.01f, "integrators stay on the circle: %.2f V", neu.int_max);
+    TEST_CHECK(neu.settle >= 0 && neu.settle <= old.settle, "recovery %d ticks (per-axis %d ticks)", neu.settle, old.settle);
+}
+
+/* ------------------------------------------------------------------ */
+/*  SIL                                                                */
+/* ------------------------------------------------------------------ */
+/* 被控对象相电压合成矢量幅值 (等幅值变换) */
+static float plant_v_mag(const pmsm_model_t *p)
+{
+    return sqrtf((p->va * p->va + p->vb * p->vb + p->vc * p->vc) * (2.0f / 3.0f));
+}
+
+static void test_sil(void)
+{
+    printf("\n--- SIL: 速度闭环 4000 RPM 带载, 12V / 7V ---\n");
+
+    /* 12V: 反电势 4.4V 超过原 ±U_DC/3 = 4V 的 q 轴限幅, 圆限幅下可达 */
+    pmsm_model_t *p = foc_sim_start(12.0f);
+    p->param.load_torque = 0.003f;
+    mode_manager_speed(4000.0f);
+    foc_sim_run(6.0f);
+    float rpm12 = pmsm_model_get_speed_rpm(p);
+    TEST_CHECK(fabsf(rpm12 - 4000.0f) < 20.0f, "12V: reaches %.0f RPM", rpm12);
+
+    /* 7V: 电压受限, 转速稳定在最高转速, 实际电压矢量不超过上限 (SVPWM 不再等比缩小) */
+    p = foc_sim_start(7.0f);
+    p->param.load_torque = 0.003f;
+    mode_manager_speed(4000.0f);
+    foc_sim_run(5.5f);
+
+    float v_peak = 0.0f, rpm_min = 1e9f, rpm_max = -1e9f;
+    for (int n = 0; n < 5000; n++)
+    {
+        foc_sim_step();
+        v_peak = fmaxf(v_peak, plant_v_mag(p));
+        float rpm = pmsm_model_get_speed_rpm(p);
+        rpm_min = fminf(rpm_min, rpm);
+        rpm_max = fmaxf(rpm_max, rpm);
+    }
+    TEST_CHECK(rpm_max < 4000.0f && rpm_min > 3000.0f, "7V: voltage-limited top speed %.0f RPM", rpm_min);
+    TEST_CHECK(rpm_max - rpm_min < 10.0f, "7V: speed ripple at the ceiling %.1f RPM", rpm_max - rpm_min);
+    TEST_CHECK(v_peak <= FOC_V_MAX_K * 7.0f * 1.01f, "7V: applied |v| %.3f V <= %.3f V", v_peak, FOC_V_MAX_K * 7.0f);
+}
+
+int main(void)
+{
+    printf("=== dq voltage limit ===\n");
+
+    test_limit();
+    test_back_calculate();
+    test_current_loop();
+    test_sil();
+
+    return test_summary();
+}
+
+#endif /* FOC_SIM_HOST */
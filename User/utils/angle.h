@@ -0,0 +1,101 @@
+/**
+ * @file angle.h
+ * @brief 整数电角度: uint32_t 表示一圈 (2^32 = 2π), 加减溢出即回绕
+ *
+ * 与定点后端 (qmath.h) 的角度表示相同。编码器、I/F 开环角、观测器 PLL 与 Park 变换都用 angle_t 传递电角度:
+ * - 回绕由整数溢出完成, 不需要 while / fmodf 归一化;
+ * - 分辨率处处为 2π / 2^32 (约 1.5e-9 rad), 不随转速或运行时间变差 (浮点弧度累加越大越粗);
+ * - 两角之差转为 int32_t 即得 [-π, π) 内的最短角差。
+ * 浮点弧度只用于显示、遥测与观测器内部的小角度增量。
+ */
+
+#ifndef __ANGLE_H__
+#define __ANGLE_H__
+
+#include <stdint.h>
+#include "fast_sin_cos.h"
+
+typedef uint32_t angle_t;
+
+#define ANGLE_PI 0x80000000UL      /* π */
+#define ANGLE_HALF_PI 0x40000000UL /* π/2 */
+
+/*
+ * sin/cos 后端 (编译时选择, 见 fast_sin_cos.h): Park / 反 Park 与观测器 PLL 鉴相可分别配置,
+ * 如 PLL 只需角度误差的符号与大小, 可用查表换取周期数
+ */
+#ifndef ANGLE_SIN_COS_BACKEND
+#define ANGLE_SIN_COS_BACKEND FAST_SIN_COS_POLY
+#endif
+
+#ifndef ANGLE_SIN_COS_PLL_BACKEND
+#define ANGLE_SIN_COS_PLL_BACKEND ANGLE_SIN_COS_BACKEND
+#endif
+
+#define ANGLE_FROM_RAD_K 683565275.576431632f  /* 2^32 / 2π */
+#define ANGLE_TO_RAD_K 1.46291807926715968e-9f /* 2π / 2^32 */
+
+/**
+ * @brief 弧度 -> 整数角度, 任意范围的弧度都回绕到一圈内
+ * @note  先取整圈数再转换, 不会溢出; 控制中断中的小角度增量用 angle_delta_from_rad()
+ */
+static inline angle_t angle_from_rad(float rad)
+{
+    float turns = rad * (1.0f / 6.28318530718f);
+    turns -= rintf(turns); /* [-0.5, 0.5] */
+    if (turns >= 0.5f)
+        turns -= 1.0f;
+    return (angle_t)(int32_t)(turns * 4294967296.0f);
+}
+
+/* 弧度 -> 整数角度增量, 要求 |rad| < π (每周期角度增量、补偿角等) */
+static inline angle_t angle_delta_from_rad(float rad)
+{
+    return (angle_t)(int32_t)(rad * ANGLE_FROM_RAD_K);
+}
+
+/**
+ * @brief 以整数角度单位 (2^32 = 2π) 表示的浮点增量 -> angle_t, 先限幅到 [-π, π) 再转换
+ * @note  转速 × 延迟等乘积在高速或大延迟时可能超出 int32_t, 直接转换是未定义行为; 超出时饱和为 ±π
+ *        (NaN 按 +π 处理)
+ */
+static inline angle_t angle_delta_sat(float delta)
+{
+    if (!(delta < 2147483520.0f)) /* 小于 2^31 的最大单精度数 */
+        delta = 2147483520.0f;
+    else if (delta < -2147483648.0f)
+        delta = -2147483648.0f;
+    return (angle_t)(int32_t)delta;
+}
+
+/* 整数角度 -> 弧度 [-π, π) */
+static inline float angle_to_rad(angle_t angle)
+{
+    return (float)(int32_t)angle * ANGLE_TO_RAD_K;
+}
+
+/* 整数角度 -> 弧度 [0, 2π), 用于显示 */
+static inline float angle_to_rad_pos(angle_t angle)
+{
+    return (float)angle * ANGLE_TO_RAD_K;
+}
+
+/* 最短角差 a - b (rad, [-π, π)) */
+static inline float angle_diff_rad(angle_t a, angle_t b)
+{
+    return angle_to_rad(a - b);
+}
+
+/* 由整数角度计算正弦 / 余弦, Park / 反 Park 使用 */
+FAST_MATH_OPT static inline void angle_sin_cos(angle_t angle, float *sin_x, float *cos_x)
+{
+    FAST_SIN_COS_U32(ANGLE_SIN_COS_BACKEND)(angle, sin_x, cos_x);
+}
+
+/* 由整数角度计算正弦 / 余弦, 观测器 PLL 鉴相使用 */
+FAST_MATH_OPT static inline void angle_sin_cos_pll(angle_t angle, float *sin_x, float *cos_x)
+{
+    FAST_SIN_COS_U32(ANGLE_SIN_COS_PLL_BACKEND)(angle, sin_x, cos_x);
+}
+
+#endif /* __ANGLE_H__ */
@@ -0,0 +1,40 @@
+#ifndef __CCMRAM_H__
+#define __CCMRAM_H__
+
+/**
+ * CCMSRAM 放置属性
+ *
+ * STM32G431 的 10KB CCMSRAM (0x10000000) 挂在 I-Code / D-Code 总线上, 零等待执行, 且不与
+ * DMA 访问的普通 SRAM 争用总线。控制中断调用链 (ADC 中断 -> 模式回调 -> Clark/Park ->
+ * 观测器 -> PI -> SVPWM -> 写 PWM) 及其状态结构放在这里, 使控制周期耗时不受 Flash 等待
+ * 周期与预取命中率影响。
+ *
+ *   CCMRAM_FUNC  函数放入 .ccmram.text, 启动时从 Flash 拷贝
+ *   CCMRAM_DATA  有初值的变量放入 .ccmram.data, 启动时从 Flash 拷贝
+ *   CCMRAM_BSS   零初值变量放入 .ccmram.bss, 启动时清零 (不占 Flash)
+ *
+ * 段定义见 STM32G431KBTX_FLASH.ld, 拷贝/清零见 startup_stm32g431xx.s,
+ * 构建后由 python_tools/ccmram_report.py 解析 map 文件列出各段内容与占用。
+ *
+ * 注意:
+ *   - DMA 缓冲区不要放在 CCMSRAM
+ *   - always_inline 的函数 (如 fast_sin_cos) 随调用者进入 CCMSRAM, 无需标注
+ *   - 从 CCMSRAM 调用 Flash 中的函数 (HAL、libm) 由链接器自动插入长跳转桩
+ *   - 主机仿真 (FOC_SIM_HOST) 或 CCMRAM_ENABLE 置 0 时属性为空, 全部回到 Flash / SRAM
+ */
+
+#ifndef CCMRAM_ENABLE
+#define CCMRAM_ENABLE 1
+#endif
+
+#if CCMRAM_ENABLE && defined(__GNUC__) && !defined(FOC_SIM_HOST)
+#define CCMRAM_FUNC __attribute__((section(".ccmram.text")))
+#define CCMRAM_DATA __attribute__((section(".ccmram.data")))
+#define CCMRAM_BSS __attribute__((section(".ccmram.bss")))
+#else
+#define CCMRAM_FUNC
+#define CCMRAM_DATA
+#define CCMRAM_BSS
+#endif
+
+#endif /* __CCMRAM_H__ */
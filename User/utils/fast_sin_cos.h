@@ -8,6 +8,13 @@
  * - FMA 指令优化
  * - 多项式逼近方法
  * - 编译器特定的优化指令
+ *
+ * 另提供以整数角度 (uint32_t, 2^32 = 2π, 与 angle_t 相同) 为输入的 sin/cos, 编译时选择后端:
+ * - FAST_SIN_COS_POLY:     与 fast_sin_cos() 相同的 11/12 阶多项式, 误差约 1e-7
+ * - FAST_SIN_COS_MINIMAX:  5/4 阶 minimax 多项式, 误差约 1.2e-5
+ * - FAST_SIN_COS_LUT:      1/4 周期查表 + 线性插值, 误差见 sin_lut.h
+ * - FAST_SIN_COS_LUT_QUAD: 1/4 周期查表 + 二次插值
+ * 12 位电流采样的分辨率约 2.4e-4, 低阶后端的误差远小于采样量化。
  */
 
 #ifndef __FAST_SIN_COS_H__
@@ -33,6 +40,7 @@
 
 #include <math.h>
 #include <stdint.h>
+#include "sin_lut.h"
 
 /**
  * @def M_1_PI_F
@@ -246,6 +254,173 @@ FAST_MATH_OPT static inline void fast_sin_cos(float x, float *sin_x, float *cos_
     *cos_x = uc.f;
 }
 
+/* ------------------------------------------------------------------ */
+/*  整数角度输入 (2^32 = 2π)                                            */
+/* ------------------------------------------------------------------ */
+
+#define FAST_SIN_COS_POLY 0
+#define FAST_SIN_COS_MINIMAX 1
+#define FAST_SIN_COS_LUT 2
+#define FAST_SIN_COS_LUT_QUAD 3
+
+/**
+ * @def FAST_SIN_COS_U32
+ * @brief 后端编号 -> 函数名, 用于编译时选择: FAST_SIN_COS_U32(FAST_SIN_COS_LUT)(angle, &s, &c)
+ */
+#define FAST_SIN_COS_U32(backend) FAST_SIN_COS_U32_(backend)
+#define FAST_SIN_COS_U32_(backend) FAST_SIN_COS_U32_##backend
+#define FAST_SIN_COS_U32_0 fast_sin_cos_u32
+#define FAST_SIN_COS_U32_1 fast_sin_cos_u32_minimax
+#define FAST_SIN_COS_U32_2 fast_sin_cos_u32_lut
+#define FAST_SIN_COS_U32_3 fast_sin_cos_u32_lut_quad
+
+#define FAST_ANGLE_TO_RAD_K 1.46291807926715968e-9f /* 2π / 2^32 */
+
+/**
+ * @brief 整数角度归约: 高 2 位 (四舍五入) 给出最近的 π/2 倍数 q, 返回余量 x ∈ [-π/4, π/4)
+ * @note  不需要浮点归约, 任意角度精度相同
+ */
+FAST_MATH_OPT static inline float reduce_u32(uint32_t angle, uint32_t *quadrant)
+{
+    uint32_t q = (angle + 0x20000000UL) >> 30;
+    *quadrant = q;
+    return (float)(int32_t)(angle - (q << 30)) * FAST_ANGLE_TO_RAD_K;
+}
+
+/**
+ * @brief 由余量的 sin / cos 还原 θ = q·π/2 + x 的 sin / cos
+ * @note  q 为奇数时 sin / cos 交换, sin 在 q = 2, 3 取反, cos 在 q = 1, 2 取反
+ */
+FAST_MATH_OPT static inline void restore_quadrant(uint32_t q, float s, float c, float *sin_x, float *cos_x)
+{
+    float sq = (q & 1) ? c : s;
+    float cq = (q & 1) ? s : c;
+    *sin_x = (q & 2) ? -sq : sq;
+    *cos_x = ((q + 1) & 2) ? -cq : cq;
+}
+
+/**
+ * @brief 整数角度 sin/cos, 11/12 阶多项式 (与 fast_sin_cos() 相同的 f1_opt / f2_opt)
+ */
+FAST_MATH_OPT static inline void fast_sin_cos_u32(uint32_t angle, float *sin_x, float *cos_x)
+{
+    uint32_t q;
+    float x = reduce_u32(angle, &q);
+    float x2 = x * x;
+
+    float s = MY_FMA(x * x2, f1_opt(x2), x);
+    float c = MY_FMA(x2, f2_opt(x2), 1.0f);
+    restore_quadrant(q, s, c, sin_x, cos_x);
+}
+
+/**
+ * @brief 整数角度 sin/cos, [-π/4, π/4] 上的 5 阶 (sin) / 4 阶 (cos) minimax 多项式
+ * @note  系数由 Remez 算法按绝对误差求得, sin 最大误差 9.4e-7, cos 最大误差 1.2e-5;
+ *        比 fast_sin_cos_u32() 少 7 次乘加
+ */
+FAST_MATH_OPT static inline void fast_sin_cos_u32_minimax(uint32_t angle, float *sin_x, float *cos_x)
+{
+    uint32_t q;
+    float x = reduce_u32(angle, &q);
+    float x2 = x * x;
+
+    float s = MY_FMA(x * x2, MY_FMA(x2, 0.00815299234f, -0.166628338f), x);
+    float c = MY_FMA(x2, MY_FMA(x2, 0.0404889358f, -0.499776307f), 1.0f);
+    restore_quadrant(q, s, c, sin_x, cos_x);
+}
+
+#define SIN_LUT_SHIFT (30 - FAST_SIN_LUT_BITS)                  /* 象限内 30 位角度 -> 表索引 */
+#define SIN_LUT_FRAC_MASK ((1UL << SIN_LUT_SHIFT) - 1UL)
+#define SIN_LUT_FRAC_K (1.0f / (float)(1UL << SIN_LUT_SHIFT))   /* 索引余数 -> [0, 1) */
+
+/**
+ * @brief 查表求 sin(angle), 线性插值
+ * @note  象限内角度 p ∈ [0, 2^30), 偶数象限查 sin(p), 奇数象限查 sin(π/2 - p), 后两象限取反;
+ *        p 的高 FAST_SIN_LUT_BITS 位为索引, 其余位为插值系数。镜像后 p 可等于 2^30, 表尾多存一点
+ */
+FAST_MATH_OPT static inline float sin_lut_u32(uint32_t angle)
+{
+    uint32_t q = angle >> 30;
+    uint32_t p = angle & 0x3FFFFFFFUL;
+    if (q & 1)
+        p = 0x40000000UL - p;
+
+    uint32_t i = p >> SIN_LUT_SHIFT;
+    float t = (float)(p & SIN_LUT_FRAC_MASK) * SIN_LUT_FRAC_K;
+    float y0 = SIN_LUT[i + 1];
+    float y = MY_FMA(t, SIN_LUT[i + 2] - y0, y0);
+    return (q & 2) ? -y : y;
+}
+
+/**
+ * @brief 查表求 sin(angle), 以最近表点为中心的二次插值
+ * @note  t ∈ [-0.5, 0.5], y = y0 + t·(y+ - y-)/2 + t²·(y+ - 2·y0 + y-)/2, 表头表尾各多存一点
+ */
+FAST_MATH_OPT static inline float sin_lut_quad_u32(uint32_t angle)
+{
+    uint32_t q = angle >> 30;
+    uint32_t p = angle & 0x3FFFFFFFUL;
+    if (q & 1)
+        p = 0x40000000UL - p;
+
+    uint32_t i = (p + (1UL << (SIN_LUT_SHIFT - 1))) >> SIN_LUT_SHIFT;
+    float t = (float)(int32_t)(p - (i << SIN_LUT_SHIFT)) * SIN_LUT_FRAC_K;
+    float ym = SIN_LUT[i], y0 = SIN_LUT[i + 1], yp = SIN_LUT[i + 2];
+    float d1 = 0.5f * (yp - ym);
+    float d2 = MY_FMA(0.5f, yp + ym, -y0);
+    float y = MY_FMA(t, MY_FMA(t, d2, d1), y0);
+    return (q & 2) ? -y : y;
+}
+
+/**
+ * @brief 整数角度 sin/cos, 查表 + 线性插值 (cos(θ) = sin(θ + π/2))
+ */
+FAST_MATH_OPT static inline void fast_sin_cos_u32_lut(uint32_t angle, float *sin_x, float *cos_x)
+{
+    *sin_x = sin_lut_u32(angle);
+    *cos_x = sin_lut_u32(angle + 0x40000000UL);
+}
+
+/**
+ * @brief 整数角度 sin/cos, 查表 + 二次插值
+ */
+FAST_MATH_OPT static inline void fast_sin_cos_u32_lut_quad(uint32_t angle, float *sin_x, float *cos_x)
+{
+    *sin_x = sin_lut_quad_u32(angle);
+    *cos_x = sin_lut_quad_u32(angle + 0x40000000UL);
+}
+
+#define FAST_ANGLE_FROM_RAD_K 683565275.576431632f /* 2^32 / 2π */
+
+/* atan(r) ≈ r·(a1 + a3·r² + a5·r⁴ + a7·r⁶ + a9·r⁸), r ∈ [0, 1], 系数已乘 2^32 / 2π */
+#define FAST_ATAN_A1 (0.9998660f * FAST_ANGLE_FROM_RAD_K)
+#define FAST_ATAN_A3 (-0.3302995f * FAST_ANGLE_FROM_RAD_K)
+#define FAST_ATAN_A5 (0.1801410f * FAST_ANGLE_FROM_RAD_K)
+#define FAST_ATAN_A7 (-0.0851330f * FAST_ANGLE_FROM_RAD_K)
+#define FAST_ATAN_A9 (0.0208351f * FAST_ANGLE_FROM_RAD_K)
+
+/**
+ * @brief 反正切, 结果为整数角度 (2^32 = 2π) 表示的 [-π/2, π/2]
+ * @note  |x| <= 1 时为 9 阶奇次多项式 (Abramowitz & Stegun 4.4.49, 最大误差 1e-5 rad);
+ *        |x| > 1 时 atan(x) = π/2 - atan(1/x), 多一次除法。结果不超过 ±2^30, 转换不会溢出; x 不能为 NaN
+ */
+FAST_MATH_OPT static inline uint32_t fast_atan_u32(float x)
+{
+    float ax = fabsf(x);
+    int inv = ax > 1.0f;
+    float r = inv ? 1.0f / ax : ax;
+    float r2 = r * r;
+
+    float p = MY_FMA(r2, MY_FMA(r2, MY_FMA(r2, MY_FMA(r2, FAST_ATAN_A9, FAST_ATAN_A7), FAST_ATAN_A5), FAST_ATAN_A3),
+                     FAST_ATAN_A1);
+    float a = r * p;
+    if (inv)
+        a = 1073741824.0f - a; /* π/2 */
+
+    int32_t d = (int32_t)a;
+    return (uint32_t)(x < 0.0f ? -d : d);
+}
+
 #if defined(__CC_ARM) || defined(__ARMCC_VERSION)
     #pragma pop
 #endif
@@ -0,0 +1,198 @@
+#include "isr_prof.h"
+#include <stdio.h>
+#include <string.h>
+
+isr_prof_t isr_prof;
+
+static const char *const isr_prof_stage_name[ISR_PROF_NUM] = {
+    "adc_read",
+    "clark_park",
+    "observer",
+    "pi",
+    "svpwm",
+    "pwm_write",
+    "encoder",
+    "total",
+};
+
+/* 清空累计统计 */
+static void isr_prof_clear(void)
+{
+    memset(isr_prof.stat, 0, sizeof(isr_prof.stat));
+    memset(&isr_prof.worst, 0, sizeof(isr_prof.worst));
+
+    for (int i = 0; i < ISR_PROF_NUM; i++)
+    {
+        isr_prof.stat[i].min = UINT32_MAX;
+    }
+
+    isr_prof.seq = 0;
+}
+
+void isr_prof_init(void)
+{
+#ifndef FOC_SIM_HOST
+    /* 使能 DWT 周期计数器 */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+    memset(&isr_prof, 0, sizeof(isr_prof));
+    isr_prof_clear();
+    isr_prof.enable = 1;
+}
+
+/**
+ * @brief 停止统计, 保留已有结果
+ */
+void isr_prof_stop(void)
+{
+    isr_prof.enable = 0;
+}
+
+/**
+ * @brief 请求清空统计, 在下一次中断结束时执行, 避免与中断中的更新冲突
+ */
+void isr_prof_reset(void)
+{
+    isr_prof.reset_req = 1;
+}
+
+#if ISR_PROF_ENABLE
+
+/* 直方图箱号: floor(log2(x)) + 1 */
+static inline uint32_t isr_prof_bin(uint32_t x)
+{
+    if (x == 0)
+        return 0;
+
+    uint32_t bin = 32U - (uint32_t)__builtin_clz(x);
+    return (bin < ISR_PROF_HIST_BINS) ? bin : (ISR_PROF_HIST_BINS - 1);
+}
+
+/**
+ * @brief 中断出口: 更新各阶段统计, 记录最坏周期
+ */
+void isr_prof_end(void)
+{
+    if (!isr_prof.enable)
+        return;
+
+    uint32_t total = isr_prof_now() - isr_prof.t_start;
+
+    if (isr_prof.reset_req)
+    {
+        isr_prof_clear();
+        isr_prof.reset_req = 0;
+    }
+
+    isr_prof.stage_sum[ISR_PROF_TOTAL] = total;
+    isr_prof.stage_hit |= 1U << ISR_PROF_TOTAL;
+
+    for (int i = 0; i < ISR_PROF_NUM; i++)
+    {
+        if (!(isr_prof.stage_hit & (1U << i)))
+            continue;
+
+        uint32_t t = isr_prof.stage_sum[i];
+        isr_prof_stat_t *stat = &isr_prof.stat[i];
+
+        if (t < stat->min)
+            stat->min = t;
+        if (t > stat->max)
+            stat->max = t;
+        stat->sum += t;
+        stat->count++;
+        stat->hist[isr_prof_bin(t)]++;
+    }
+
+    /* 最坏周期: 保存各阶段耗时与打点序列 */
+    if (total >= isr_prof.stat[ISR_PROF_TOTAL].max)
+    {
+        isr_prof.worst.seq = isr_prof.seq;
+        for (int i = 0; i < ISR_PROF_NUM; i++)
+        {
+            isr_prof.worst.stage[i] = (isr_prof.stage_hit & (1U << i)) ? isr_prof.stage_sum[i] : 0;
+        }
+        isr_prof.worst.trace_num = isr_prof.trace_num;
+        memcpy(isr_prof.worst.trace, isr_prof.trace, isr_prof.trace_num * sizeof(isr_prof_trace_t));
+    }
+
+    isr_prof.seq++;
+}
+
+#else
+
+void isr_prof_end(void)
+{
+}
+
+#endif /* ISR_PROF_ENABLE */
+
+void isr_prof_snapshot(isr_prof_stat_t stat[ISR_PROF_NUM], isr_prof_worst_t *worst)
+{
+#ifndef FOC_SIM_HOST
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+#endif
+
+    memcpy(stat, isr_prof.stat, sizeof(isr_prof.stat));
+    memcpy(worst, &isr_prof.worst, sizeof(isr_prof.worst));
+
+#ifndef FOC_SIM_HOST
+    __set_PRIMASK(primask);
+#endif
+}
+
+/* 计数值 -> us */
+static float isr_prof_to_us(uint32_t count)
+{
+    return (float)count * (1000000.0f / (float)ISR_PROF_CLOCK_HZ);
+}
+
+void isr_prof_print(void)
+{
+    static isr_prof_stat_t stat[ISR_PROF_NUM];
+    static isr_prof_worst_t worst;
+
+    isr_prof_snapshot(stat, &worst);
+
+    printf("ISR profile: %lu samples, budget %lu counts/period\n",
+           (unsigned long)stat[ISR_PROF_TOTAL].count, (unsigned long)ISR_PROF_PERIOD_COUNT);
+    printf("%-10s %8s %8s %8s %8s %8s %7s\n", "stage", "count", "min", "mean", "max", "max_us", "max_%");
+
+    for (int i = 0; i < ISR_PROF_NUM; i++)
+    {
+        if (stat[i].count == 0)
+            continue;
+
+        uint32_t mean = (uint32_t)(stat[i].sum / stat[i].count);
+        printf("%-10s %8lu %8lu %8lu %8lu %8.2f %6.1f%%\n", isr_prof_stage_name[i],
+               (unsigned long)stat[i].count, (unsigned long)stat[i].min, (unsigned long)mean,
+               (unsigned long)stat[i].max, isr_prof_to_us(stat[i].max),
+               100.0f * (float)stat[i].max / (float)ISR_PROF_PERIOD_COUNT);
+    }
+
+    /* 总耗时直方图 */
+    printf("total histogram:");
+    for (int i = 0; i < ISR_PROF_HIST_BINS; i++)
+    {
+        if (stat[ISR_PROF_TOTAL].hist[i] == 0)
+            continue;
+
+        if (i == ISR_PROF_HIST_BINS - 1)
+            printf(" >=%lu:%lu", 1UL << (i - 1), (unsigned long)stat[ISR_PROF_TOTAL].hist[i]);
+        else
+            printf(" <%lu:%lu", 1UL << i, (unsigned long)stat[ISR_PROF_TOTAL].hist[i]);
+    }
+    printf("\n");
+
+    /* 最坏周期打点序列 */
+    printf("worst @%lu:", (unsigned long)worst.seq);
+    for (int i = 0; i < worst.trace_num; i++)
+    {
+        printf(" %s+%lu", isr_prof_stage_name[worst.trace[i].stage], (unsigned long)worst.trace[i].offset);
+    }
+    printf(" end+%lu\n", (unsigned long)worst.stage[ISR_PROF_TOTAL]);
+}
@@ -0,0 +1,177 @@
+#ifndef __ISR_PROF_H__
+#define __ISR_PROF_H__
+
+#include "stm32g4xx_hal.h"
+#include "foc/motor_profile.h"
+
+/**
+ * ADC 注入组中断 (控制律) 分阶段耗时统计
+ *
+ * isr_prof_init() 之后开始统计。中断入口调用 isr_prof_begin(), 出口调用 isr_prof_end(),
+ * 中间每完成一段代码调用 isr_prof_mark(stage), 将距上一个打点的耗时记到该阶段。
+ * 同一阶段在一个周期内多次打点时累加 (例如 Park 与反 Park 都记入 CLARK_PARK)。
+ *
+ * 固件使用 DWT->CYCCNT (1 个计数 = 1 个 CPU 周期),
+ * 主机仿真 (FOC_SIM_HOST) 使用 clock_gettime (1 个计数 = 1ns)。
+ */
+
+/* 编译开关, 置 0 时所有打点函数为空 */
+#ifndef ISR_PROF_ENABLE
+#define ISR_PROF_ENABLE 1
+#endif
+
+#ifdef FOC_SIM_HOST
+#include <time.h>
+#define ISR_PROF_CLOCK_HZ 1000000000U /* 计数频率: 1ns */
+#else
+#define ISR_PROF_CLOCK_HZ 170000000U /* 计数频率: 系统时钟 170MHz */
+#endif
+
+#define ISR_PROF_PWM_FREQ MOTOR_CTRL_FREQ                          /* 控制中断频率 (Hz), 双更新时为 PWM 频率的 2 倍 */
+#define ISR_PROF_PERIOD_COUNT (ISR_PROF_CLOCK_HZ / ISR_PROF_PWM_FREQ) /* 一个控制周期的计数值 */
+
+#define ISR_PROF_HIST_BINS 16 /* 直方图箱数, 第 k 箱统计 [2^(k-1), 2^k) 个计数 */
+#define ISR_PROF_TRACE_LEN 24 /* 单个周期最多记录的打点数 */
+
+/* 统计阶段 */
+typedef enum
+{
+    ISR_PROF_ADC_READ = 0, /* 读取注入组结果 + 换算 */
+    ISR_PROF_CLARK_PARK,   /* Clark / Park / 反 Park */
+    ISR_PROF_OBSERVER,     /* SMO / Luenberger 观测器 */
+    ISR_PROF_PI,           /* 电流环 / 速度环 / 弱磁 PI */
+    ISR_PROF_SVPWM,        /* SVPWM 调制 */
+    ISR_PROF_PWM_WRITE,    /* 写 TIM1 比较寄存器 */
+    ISR_PROF_ENCODER,      /* AS5047P SPI 读取 + 速度计算 */
+    ISR_PROF_TOTAL,        /* 整个中断 */
+    ISR_PROF_NUM
+} isr_prof_stage_t;
+
+/* 单个阶段的统计量 */
+typedef struct
+{
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t count;
+    uint32_t hist[ISR_PROF_HIST_BINS];
+} isr_prof_stat_t;
+
+/* 打点记录 */
+typedef struct
+{
+    uint8_t stage;
+    uint32_t offset; /* 距中断入口的计数值 */
+} isr_prof_trace_t;
+
+/* 最坏周期快照 */
+typedef struct
+{
+    uint32_t seq;                   /* 发生在第几次中断 */
+    uint32_t stage[ISR_PROF_NUM];   /* 各阶段耗时 */
+    uint8_t trace_num;              /* 打点数 */
+    isr_prof_trace_t trace[ISR_PROF_TRACE_LEN];
+} isr_prof_worst_t;
+
+/* 统计对象 */
+typedef struct
+{
+    /* 当前周期 */
+    uint32_t t_start;
+    uint32_t t_last;
+    uint32_t stage_sum[ISR_PROF_NUM];
+    uint8_t stage_hit;
+    uint8_t trace_num;
+    isr_prof_trace_t trace[ISR_PROF_TRACE_LEN];
+
+    /* 累计统计 */
+    uint32_t seq;
+    isr_prof_stat_t stat[ISR_PROF_NUM];
+    isr_prof_worst_t worst;
+
+    uint8_t enable; /* isr_prof_init() 置位, isr_prof_stop() 清零 */
+    volatile uint8_t reset_req;
+} isr_prof_t;
+
+extern isr_prof_t isr_prof;
+
+void isr_prof_init(void);
+void isr_prof_stop(void);
+void isr_prof_reset(void);
+void isr_prof_end(void);
+
+/**
+ * @brief 复制一份统计结果 (关中断拷贝, 可在主循环中调用)
+ */
+void isr_prof_snapshot(isr_prof_stat_t stat[ISR_PROF_NUM], isr_prof_worst_t *worst);
+
+/**
+ * @brief 打印统计报告 (printf → USART1 DMA), 与 vofa 输出二选一
+ */
+void isr_prof_print(void);
+
+/* 读取计数器 */
+static inline uint32_t isr_prof_now(void)
+{
+#ifdef FOC_SIM_HOST
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec);
+#else
+    return DWT->CYCCNT;
+#endif
+}
+
+#if ISR_PROF_ENABLE
+
+/* 中断入口 */
+static inline void isr_prof_begin(void)
+{
+    if (!isr_prof.enable)
+        return;
+
+    uint32_t now = isr_prof_now();
+
+    isr_prof.t_start = now;
+    isr_prof.t_last = now;
+    isr_prof.stage_hit = 0;
+    isr_prof.trace_num = 0;
+}
+
+/* 阶段结束打点 */
+static inline void isr_prof_mark(isr_prof_stage_t stage)
+{
+    if (!isr_prof.enable)
+        return;
+
+    uint32_t now = isr_prof_now();
+    uint32_t bit = 1U << stage;
+
+    if (isr_prof.stage_hit & bit)
+    {
+        isr_prof.stage_sum[stage] += now - isr_prof.t_last;
+    }
+    else
+    {
+        isr_prof.stage_sum[stage] = now - isr_prof.t_last;
+        isr_prof.stage_hit |= bit;
+    }
+
+    if (isr_prof.trace_num < ISR_PROF_TRACE_LEN)
+    {
+        isr_prof.trace[isr_prof.trace_num].stage = stage;
+        isr_prof.trace[isr_prof.trace_num].offset = now - isr_prof.t_start;
+        isr_prof.trace_num++;
+    }
+
+    isr_prof.t_last = now;
+}
+
+#else
+
+static inline void isr_prof_begin(void) {}
+static inline void isr_prof_mark(isr_prof_stage_t stage) { (void)stage; }
+
+#endif /* ISR_PROF_ENABLE */
+
+#endif /* __ISR_PROF_H__ */
@@ -0,0 +1,178 @@
+/**
+ * @file qmath.h
+ * @brief Q15 / Q31 定点运算基础库
+ *
+ * - q15_t: 16 位有符号, 1 LSB = 2^-15, 范围 [-1, 1)
+ * - q31_t: 32 位有符号, 1 LSB = 2^-31, 范围 [-1, 1)
+ * - 增益系数使用 s15.16 (int32_t, 1.0 = 65536), 允许大于 1 的系数, 乘法经 64 位中间结果
+ * - 角度使用无符号整数表示一圈: uint16_t 时 65536 = 2π, uint32_t 时 2^32 = 2π, 溢出即回绕
+ *
+ * 只使用整数运算, 可直接移植到无 FPU 的内核; 浮点仅出现在 Q15() / QGAIN() 等编译期 / 初始化换算中。
+ */
+
+#ifndef __QMATH_H__
+#define __QMATH_H__
+
+#include <stdint.h>
+
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+
+#define Q15_MAX 32767
+#define Q15_MIN (-32768)
+#define Q31_MAX 2147483647L
+#define Q31_MIN (-2147483647L - 1)
+
+#define QGAIN_SHIFT 16
+
+/* 编译期 / 初始化时的浮点换算 (四舍五入) */
+#define Q15(x) ((q15_t)((x) >= 0.999969482421875 ? Q15_MAX : ((x) <= -1.0 ? Q15_MIN : (x) * 32768.0 + ((x) >= 0 ? 0.5 : -0.5))))
+#define QGAIN(x) ((int32_t)((x) * 65536.0 + ((x) >= 0 ? 0.5 : -0.5)))
+#define Q15_TO_FLOAT(x) ((float)(x) * (1.0f / 32768.0f))
+
+/* 弧度 <-> 16 位角度 */
+#define QANGLE_FROM_RAD(rad) ((uint16_t)(int32_t)((rad) * (65536.0f / 6.28318530718f)))
+#define QANGLE_TO_RAD(angle) ((float)(uint16_t)(angle) * (6.28318530718f / 65536.0f))
+
+/* 饱和到 Q15 */
+static inline q15_t q15_sat(int32_t x)
+{
+    if (x > Q15_MAX)
+        return Q15_MAX;
+    if (x < Q15_MIN)
+        return Q15_MIN;
+    return (q15_t)x;
+}
+
+/* 饱和到 Q31 */
+static inline q31_t q31_sat(int64_t x)
+{
+    if (x > Q31_MAX)
+        return Q31_MAX;
+    if (x < Q31_MIN)
+        return Q31_MIN;
+    return (q31_t)x;
+}
+
+/* Q15 × Q15 -> Q15 (四舍五入, 饱和) */
+static inline q15_t q15_mul(q15_t a, q15_t b)
+{
+    return q15_sat(((int32_t)a * b + (1 << 14)) >> 15);
+}
+
+/* Q15 × Q15 -> Q15, 结果放在 int32 中不饱和 (供中间运算累加) */
+static inline int32_t q15_mul32(int32_t a, int32_t b)
+{
+    return (a * b + (1 << 14)) >> 15;
+}
+
+/* x × s15.16 增益 -> 与 x 同格式 (64 位中间结果, 四舍五入) */
+static inline int32_t qgain_mul(int32_t x, int32_t gain)
+{
+    return (int32_t)(((int64_t)x * gain + (1 << (QGAIN_SHIFT - 1))) >> QGAIN_SHIFT);
+}
+
+/*
+ * Q27 扩展精度状态 (int32_t, 范围 ±16): 观测器等递推状态使用,
+ * 小增益 × 小信号的增量不会被截断, 又留有 4 位溢出余量
+ */
+#define Q27_SHIFT 12
+#define Q27_ONE (1L << 27)
+
+static inline int32_t q27_from_q15(q15_t x)
+{
+    return (int32_t)x * (1 << Q27_SHIFT);
+}
+
+static inline q15_t q15_from_q27(int32_t x)
+{
+    return q15_sat((x + (1 << (Q27_SHIFT - 1))) >> Q27_SHIFT);
+}
+
+/* Q15 × s15.16 增益 -> Q31 (用于 PI 积分累加) */
+static inline int64_t qgain_mul_q31(int32_t x_q15, int32_t gain)
+{
+    return (int64_t)x_q15 * gain;
+}
+
+/**
+ * @brief 正弦 / 余弦, 输入 16 位角度, 输出 Q15
+ * @note  四分之一周期内用 5 阶奇多项式 sin(πx/2) ≈ x(a - x²(b - c·x²)),
+ *        系数按最大误差最小拟合 (约 1.6e-4, 含舍入不超过 7 LSB), 且 a - b + c 恰为 32767
+ */
+static inline q15_t qmath_sin_quarter(uint32_t x)
+{
+    /* x: 四分之一周期内的位置, Q15 [0, 32768] */
+    const int32_t a = 51473; /* Q15 */
+    const int32_t b = 21085; /* Q15 */
+    const int32_t c = 2379;  /* Q15 */
+
+    int32_t x2 = (int32_t)((x * x) >> 15);          /* Q15 */
+    int32_t t = b - ((c * x2 + (1 << 14)) >> 15);    /* Q15 */
+    t = a - ((t * x2 + (1 << 14)) >> 15);            /* Q15 */
+    int32_t y = (int32_t)(((int64_t)t * x + (1 << 14)) >> 15);
+    return q15_sat(y);
+}
+
+static inline void qmath_sin_cos(uint16_t angle, q15_t *sin_x, q15_t *cos_x)
+{
+    uint32_t quadrant = angle >> 14;
+    uint32_t x = (uint32_t)(angle & 0x3FFF) << 1; /* 象限内位置 Q15 */
+    q15_t s = qmath_sin_quarter(x);
+    q15_t c = qmath_sin_quarter(32768 - x);
+
+    switch (quadrant)
+    {
+    case 0:
+        *sin_x = s;
+        *cos_x = c;
+        break;
+    case 1:
+        *sin_x = c;
+        *cos_x = (q15_t)-s;
+        break;
+    case 2:
+        *sin_x = (q15_t)-s;
+        *cos_x = (q15_t)-c;
+        break;
+    default:
+        *sin_x = (q15_t)-c;
+        *cos_x = s;
+        break;
+    }
+}
+
+/**
+ * @brief 四象限反正切, 输出 16 位角度
+ * @note  折算到第一八分圆 r = min/max ∈ [0, 1], atan(r) ≈ r(π/4 + 0.273(1 - r)), 最大误差约 0.22°
+ */
+static inline uint16_t qmath_atan2(int32_t y, int32_t x)
+{
+    if (x == 0 && y == 0)
+        return 0;
+
+    uint32_t ax = (uint32_t)(x < 0 ? -(int64_t)x : x);
+    uint32_t ay = (uint32_t)(y < 0 ? -(int64_t)y : y);
+    uint8_t swap = ay > ax;
+    uint32_t num = swap ? ax : ay;
+    uint32_t den = swap ? ay : ax;
+
+    /* r: Q15 */
+    int32_t r = (int32_t)(((uint64_t)num << 15) / den);
+
+    /* atan(r) 的圈数: (π/4 + 0.273(1 - r)) r / 2π, 系数以 1/65536 圈为单位 */
+    const int32_t k1 = 8192; /* π/4 / 2π × 65536 */
+    const int32_t k2 = 2847; /* 0.273 / 2π × 65536 */
+    int32_t angle = (int32_t)(((int64_t)(k1 + ((k2 * (32768 - r)) >> 15)) * r) >> 15);
+
+    if (swap)
+        angle = 16384 - angle;
+    if (x < 0)
+        angle = 32768 - angle;
+    if (y < 0)
+        angle = -angle;
+
+    return (uint16_t)angle;
+}
+
+#endif /* __QMATH_H__ */
@@ -1,4 +1,5 @@
 #include "ramp.h"
+#include "utils/ccmram.h"
 
 /**
  * @brief 通用斜坡函数
@@ -8,7 +9,7 @@
  * @param dt      时间步长（秒）
  * @return 更新后的当前值
  */
-float ramp_update(float current, float target, float rate, float dt)
+CCMRAM_FUNC float ramp_update(float current, float target, float rate, float dt)
 {
     float delta = target - current;
     float max_step = rate * dt; // 本次允许的最大变化量
@@ -0,0 +1,45 @@
+/**
+ * @file sched.h
+ * @brief 控制中断内的多速率调度: 分频任务按固定相位执行
+ *
+ * 每个控制周期对每个任务调用一次 sched_task_due(), 任务在 tick ≡ phase (mod div) 的周期返回 1
+ * (tick 从 sched_task_init 之后的第一次调用记为 0)。全部计数在同一中断中推进, 相位关系确定,
+ * 给各慢速任务分配不同的 phase 即可保证它们不在同一个周期执行, 中断最坏耗时不叠加。
+ */
+
+#ifndef __SCHED_H__
+#define __SCHED_H__
+
+#include <stdint.h>
+
+typedef struct
+{
+    uint16_t div; /* 执行间隔 (控制周期数, >= 1) */
+    uint16_t cnt; /* 距下一次执行的周期数 */
+} sched_task_t;
+
+/**
+ * @brief 初始化分频任务
+ * @param task  任务
+ * @param div   执行间隔 (控制周期数), 0 按 1 处理
+ * @param phase 在 div 个周期内的执行相位, 取 phase % div
+ */
+static inline void sched_task_init(sched_task_t *task, uint16_t div, uint16_t phase)
+{
+    task->div = div > 0 ? div : 1;
+    task->cnt = phase % task->div;
+}
+
+/* 每个控制周期调用一次, 本周期需要执行时返回 1 */
+static inline uint8_t sched_task_due(sched_task_t *task)
+{
+    if (task->cnt == 0)
+    {
+        task->cnt = task->div - 1;
+        return 1;
+    }
+    task->cnt--;
+    return 0;
+}
+
+#endif /* __SCHED_H__ */
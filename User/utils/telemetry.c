@@ -0,0 +1,513 @@
+#include "telemetry.h"
+#include <string.h>
+#include <math.h>
+
+#ifndef FOC_SIM_HOST
+#include "bsp/usart.h"
+
+/* 主循环启动发送时屏蔽中断, 与发送完成中断互斥 */
+#define TELEMETRY_CRITICAL_ENTER()       \
+    uint32_t primask = __get_PRIMASK(); \
+    __disable_irq()
+#define TELEMETRY_CRITICAL_EXIT() __set_PRIMASK(primask)
+
+/* 环形缓冲区索引与数据之间的访存顺序 */
+#define TELEMETRY_BARRIER() __DMB()
+#else
+#define TELEMETRY_CRITICAL_ENTER()
+#define TELEMETRY_CRITICAL_EXIT()
+#define TELEMETRY_BARRIER() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+#define TELEMETRY_TWO_PI 6.28318530718f
+
+/* DMA 缓冲区状态 */
+#define TELEMETRY_BUF_FREE 0    /* 主循环持有, 正在打包 (buf_len 为已打包字节数) */
+#define TELEMETRY_BUF_READY 1   /* 已打包完成, 等待发送 */
+#define TELEMETRY_BUF_SENDING 2 /* DMA 发送中 */
+
+/* 环形缓冲区中的样本 */
+typedef struct
+{
+    uint16_t seq;
+    uint8_t flags; /* TELEMETRY_INT16_TRIG_FLAG: 触发样本 */
+    float value[TELEMETRY_MAX_CHANNELS];
+} telemetry_sample_t;
+
+/* 通道 */
+typedef struct
+{
+    const volatile float *src;
+    float int16_scale;
+    uint8_t angle; /* 角度通道, 打包时折算到 [0, 360)° */
+} telemetry_channel_t;
+
+static struct
+{
+    const telemetry_transport_t *transport;
+
+    /* 配置 (启动前设置) */
+    telemetry_channel_t channel[TELEMETRY_MAX_CHANNELS];
+    uint8_t channel_num;
+    telemetry_format_t format;
+    uint16_t decimation;
+    telemetry_trigger_t trigger;
+    uint8_t trigger_enable;
+
+    /* 生产者 (控制中断) */
+    volatile telemetry_state_t state;
+    uint16_t decimation_cnt;
+    volatile uint8_t resync; /* 启动后等待 telemetry_align() 对齐抽取相位 */
+    uint16_t seq;
+    uint16_t post_remain;
+    float trigger_prev;
+    uint8_t trigger_prev_valid;
+
+    /* 环形缓冲区: head 只由中断写; tail 由主循环写, 布防期间由中断写 (丢弃最旧的触发前样本) */
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    telemetry_sample_t ring[TELEMETRY_RING_SIZE];
+
+    /* 双 DMA 缓冲区, 按 0 / 1 交替打包与发送 */
+    uint8_t buf[2][TELEMETRY_DMA_BUF_SIZE];
+    volatile uint16_t buf_len[2];
+    volatile uint8_t buf_state[2];
+    uint8_t fill_index;
+    volatile uint8_t send_index;
+    volatile uint8_t tx_active;
+
+    telemetry_stats_t stats;
+} telemetry;
+
+/*----------------------------------------- 默认发送接口: USART1 DMA -----------------------------------------*/
+
+#ifndef FOC_SIM_HOST
+
+static void telemetry_uart_init(void)
+{
+    usart1_register_tx_callback(telemetry_tx_done);
+}
+
+static uint8_t telemetry_uart_send(uint8_t *data, uint16_t size)
+{
+    return usart1_send_dma_async(data, size);
+}
+
+static const telemetry_transport_t telemetry_transport_uart = {telemetry_uart_init, telemetry_uart_send};
+
+#endif /* FOC_SIM_HOST */
+
+/*----------------------------------------- 配置 -----------------------------------------*/
+
+void telemetry_set_transport(const telemetry_transport_t *transport)
+{
+    telemetry.transport = transport;
+}
+
+void telemetry_init(void)
+{
+    const telemetry_transport_t *transport = telemetry.transport;
+
+#ifndef FOC_SIM_HOST
+    if (transport == NULL)
+    {
+        transport = &telemetry_transport_uart;
+    }
+#endif
+
+    memset(&telemetry, 0, sizeof(telemetry));
+    telemetry.transport = transport;
+    telemetry.format = TELEMETRY_FORMAT_JUSTFLOAT;
+    telemetry.decimation = 1;
+
+    if (transport != NULL && transport->init != NULL)
+    {
+        transport->init();
+    }
+}
+
+void telemetry_clear_channels(void)
+{
+    telemetry.state = TELEMETRY_STATE_IDLE;
+    telemetry.channel_num = 0;
+}
+
+static int8_t telemetry_add(const volatile float *src, float int16_scale, uint8_t angle)
+{
+    if (telemetry.channel_num >= TELEMETRY_MAX_CHANNELS)
+        return -1;
+
+    telemetry_channel_t *channel = &telemetry.channel[telemetry.channel_num];
+    channel->src = src;
+    channel->int16_scale = int16_scale;
+    channel->angle = angle;
+
+    return (int8_t)telemetry.channel_num++;
+}
+
+int8_t telemetry_add_channel(const volatile float *src, float int16_scale)
+{
+    return telemetry_add(src, int16_scale, 0);
+}
+
+int8_t telemetry_add_angle_channel(const volatile float *src)
+{
+    return telemetry_add(src, TELEMETRY_ANGLE_INT16_SCALE, 1);
+}
+
+void telemetry_config(telemetry_format_t format, uint16_t decimation)
+{
+    telemetry.format = format;
+    telemetry.decimation = decimation > 0 ? decimation : 1;
+}
+
+void telemetry_set_trigger(const telemetry_trigger_t *trigger)
+{
+    if (trigger == NULL)
+    {
+        telemetry.trigger_enable = 0;
+        return;
+    }
+
+    telemetry.trigger = *trigger;
+    if (telemetry.trigger.pre >= TELEMETRY_RING_SIZE)
+        telemetry.trigger.pre = TELEMETRY_RING_SIZE - 1;
+    telemetry.trigger_enable = 1;
+}
+
+/* 清空环形缓冲区并进入自由运行 / 布防 (主循环调用, 序号继续累加) */
+static void telemetry_arm(void)
+{
+    /* 先停止生产者, 主循环运行时中断不在执行中, 之后可安全复位索引 */
+    telemetry.state = TELEMETRY_STATE_IDLE;
+    TELEMETRY_BARRIER();
+
+    telemetry.head = 0;
+    telemetry.tail = 0;
+    telemetry.decimation_cnt = 0;
+    telemetry.resync = 1;
+    telemetry.trigger_prev_valid = 0;
+    TELEMETRY_BARRIER();
+
+    telemetry.state = telemetry.trigger_enable ? TELEMETRY_STATE_ARMED : TELEMETRY_STATE_STREAM;
+}
+
+void telemetry_start(void)
+{
+    telemetry.state = TELEMETRY_STATE_IDLE;
+    telemetry.seq = 0;
+    telemetry_arm();
+}
+
+void telemetry_stop(void)
+{
+    telemetry_state_t state = telemetry.state;
+    telemetry.state = TELEMETRY_STATE_IDLE;
+    TELEMETRY_BARRIER();
+
+    /* 布防中停止: 未触发的历史样本不输出 */
+    if (state == TELEMETRY_STATE_ARMED)
+        telemetry.tail = telemetry.head;
+}
+
+telemetry_state_t telemetry_get_state(void)
+{
+    return telemetry.state;
+}
+
+void telemetry_get_stats(telemetry_stats_t *stats)
+{
+    *stats = telemetry.stats;
+}
+
+/*----------------------------------------- 采样 (控制中断) -----------------------------------------*/
+
+/* 触发判断: 前一个样本与当前样本跨越电平 */
+static uint8_t telemetry_trigger_hit(float prev, float value)
+{
+    float level = telemetry.trigger.level;
+    uint8_t rising = prev < level && value >= level;
+    uint8_t falling = prev > level && value <= level;
+
+    switch (telemetry.trigger.edge)
+    {
+    case TELEMETRY_EDGE_RISING:
+        return rising;
+    case TELEMETRY_EDGE_FALLING:
+        return falling;
+    default:
+        return rising || falling;
+    }
+}
+
+void telemetry_align(void)
+{
+    if (!telemetry.resync)
+        return;
+
+    /* 本周期随后的 telemetry_sample() 即采样 */
+    telemetry.resync = 0;
+    telemetry.decimation_cnt = telemetry.decimation - 1;
+}
+
+void telemetry_sample(void)
+{
+    telemetry_state_t state = telemetry.state;
+    if (state == TELEMETRY_STATE_IDLE || state == TELEMETRY_STATE_DONE)
+        return;
+
+    /* 抽取 */
+    if (++telemetry.decimation_cnt < telemetry.decimation)
+        return;
+    telemetry.decimation_cnt = 0;
+
+    uint16_t seq = telemetry.seq++;
+    telemetry.stats.samples++;
+
+    uint32_t head = telemetry.head;
+    uint32_t tail = telemetry.tail;
+
+    if (head - tail >= TELEMETRY_RING_SIZE)
+    {
+        /* 缓冲区满: 丢弃新样本 (布防期间最多保存 pre 个, 不会满), 序号已递增, 上位机可检测 */
+        telemetry.stats.dropped++;
+    }
+    else
+    {
+        telemetry_sample_t *sample = &telemetry.ring[head & TELEMETRY_RING_MASK];
+        sample->seq = seq;
+        sample->flags = 0;
+        for (uint8_t i = 0; i < telemetry.channel_num; i++)
+        {
+            sample->value[i] = *telemetry.channel[i].src;
+        }
+
+        if (state == TELEMETRY_STATE_ARMED)
+        {
+            float value = sample->value[telemetry.trigger.channel];
+
+            /* 触发前样本攒满 pre 个之后才接受触发, 每次捕获的长度固定 */
+            uint8_t hit = telemetry.trigger_prev_valid && head - tail >= telemetry.trigger.pre &&
+                          telemetry_trigger_hit(telemetry.trigger_prev, value);
+            telemetry.trigger_prev = value;
+            telemetry.trigger_prev_valid = 1;
+
+            if (hit)
+            {
+                sample->flags = TELEMETRY_INT16_TRIG_FLAG;
+                telemetry.post_remain = telemetry.trigger.post;
+                telemetry.stats.triggers++;
+                state = telemetry.post_remain > 0 ? TELEMETRY_STATE_TRIGGERED : TELEMETRY_STATE_DONE;
+            }
+            else if (head + 1 - tail > telemetry.trigger.pre)
+            {
+                /* 只保留最近 pre 个样本 */
+                telemetry.tail = tail + 1;
+            }
+        }
+
+        /* 样本写完再发布 head */
+        TELEMETRY_BARRIER();
+        telemetry.head = head + 1;
+    }
+
+    /* 触发后样本按时间计数, 被丢弃的样本同样计入 */
+    if (telemetry.state == TELEMETRY_STATE_TRIGGERED)
+    {
+        if (--telemetry.post_remain == 0)
+            state = TELEMETRY_STATE_DONE;
+    }
+
+    if (state != telemetry.state)
+    {
+        TELEMETRY_BARRIER();
+        telemetry.state = state;
+    }
+}
+
+/*----------------------------------------- 打包与发送 (主循环 / 发送完成中断) -----------------------------------------*/
+
+static uint16_t telemetry_frame_len(void)
+{
+    if (telemetry.format == TELEMETRY_FORMAT_INT16)
+        return TELEMETRY_INT16_FRAME_LEN(telemetry.channel_num);
+    return TELEMETRY_JUSTFLOAT_FRAME_LEN(telemetry.channel_num);
+}
+
+/* 通道值换算: 角度通道折算到 [0, 360)° */
+static float telemetry_channel_value(uint8_t index, float value)
+{
+    if (!telemetry.channel[index].angle)
+        return value;
+
+    float turns = value * (1.0f / TELEMETRY_TWO_PI);
+    turns -= floorf(turns);
+    return turns * 360.0f;
+}
+
+static int16_t telemetry_to_int16(float value, float scale)
+{
+    float x = value * scale;
+    x += x >= 0.0f ? 0.5f : -0.5f;
+
+    if (x >= 32767.0f)
+        return 32767;
+    if (x <= -32768.0f)
+        return -32768;
+    return (int16_t)x;
+}
+
+/* 打包一帧, 返回字节数 */
+static uint16_t telemetry_pack_frame(uint8_t *dst, const telemetry_sample_t *sample)
+{
+    uint8_t num = telemetry.channel_num;
+
+    if (telemetry.format == TELEMETRY_FORMAT_INT16)
+    {
+        uint8_t *p = dst;
+        *p++ = TELEMETRY_INT16_SYNC0;
+        *p++ = TELEMETRY_INT16_SYNC1;
+        *p++ = (uint8_t)sample->seq;
+        *p++ = (uint8_t)(sample->seq >> 8);
+        *p++ = num | sample->flags;
+
+        for (uint8_t i = 0; i < num; i++)
+        {
+            float value = telemetry_channel_value(i, sample->value[i]);
+            uint16_t raw = (uint16_t)telemetry_to_int16(value, telemetry.channel[i].int16_scale);
+            *p++ = (uint8_t)raw;
+            *p++ = (uint8_t)(raw >> 8);
+        }
+
+        /* 校验: 序号到最后一个数据字节的字节和 */
+        uint8_t sum = 0;
+        for (uint8_t *q = dst + 2; q < p; q++)
+            sum += *q;
+        *p++ = sum;
+
+        return (uint16_t)(p - dst);
+    }
+
+    /* JustFloat: 通道值 + 序号 + 帧尾 */
+    static const uint8_t justfloat_tail[4] = {0x00, 0x00, 0x80, 0x7f};
+    float values[TELEMETRY_MAX_CHANNELS + 1];
+
+    for (uint8_t i = 0; i < num; i++)
+        values[i] = telemetry_channel_value(i, sample->value[i]);
+    values[num] = (float)sample->seq;
+
+    memcpy(dst, values, (num + 1) * sizeof(float));
+    memcpy(dst + (num + 1) * sizeof(float), justfloat_tail, sizeof(justfloat_tail));
+
+    return TELEMETRY_JUSTFLOAT_FRAME_LEN(num);
+}
+
+/* 启动下一个已就绪的缓冲区 (发送完成中断中, 或主循环的临界区内调用) */
+static void telemetry_start_next(void)
+{
+    if (telemetry.tx_active)
+        return;
+
+    uint8_t index = telemetry.send_index;
+    if (telemetry.buf_state[index] != TELEMETRY_BUF_READY)
+        return;
+
+    telemetry.buf_state[index] = TELEMETRY_BUF_SENDING;
+    telemetry.tx_active = 1;
+
+    if (telemetry.transport->send(telemetry.buf[index], telemetry.buf_len[index]) != 0)
+    {
+        /* 串口被其他发送占用, 等其完成中断再试 */
+        telemetry.buf_state[index] = TELEMETRY_BUF_READY;
+        telemetry.tx_active = 0;
+        telemetry.stats.tx_busy++;
+    }
+}
+
+static void telemetry_kick(void)
+{
+    TELEMETRY_CRITICAL_ENTER();
+    telemetry_start_next();
+    TELEMETRY_CRITICAL_EXIT();
+}
+
+void telemetry_tx_done(void)
+{
+    if (telemetry.tx_active)
+    {
+        uint8_t index = telemetry.send_index;
+        telemetry.buf_len[index] = 0;
+        telemetry.buf_state[index] = TELEMETRY_BUF_FREE;
+        telemetry.send_index = index ^ 1;
+        telemetry.tx_active = 0;
+    }
+
+    /* 另一个缓冲区已就绪则立即接着发送, 不等主循环 */
+    telemetry_start_next();
+}
+
+void telemetry_poll(void)
+{
+    if (telemetry.transport == NULL)
+        return;
+
+    telemetry_state_t state = telemetry.state;
+    TELEMETRY_BARRIER();
+
+    /* 布防期间环形缓冲区归中断所有 */
+    if (state != TELEMETRY_STATE_ARMED)
+    {
+        uint16_t frame_len = telemetry_frame_len();
+
+        /* 不会再有新样本时, 未满的缓冲区也立即交出 */
+        uint8_t flush = state == TELEMETRY_STATE_DONE || state == TELEMETRY_STATE_IDLE;
+
+        while (1)
+        {
+            uint8_t index = telemetry.fill_index;
+            if (telemetry.buf_state[index] != TELEMETRY_BUF_FREE)
+                break;
+
+            uint32_t head = telemetry.head;
+            uint32_t tail = telemetry.tail;
+            TELEMETRY_BARRIER();
+
+            uint16_t len = telemetry.buf_len[index];
+            while (tail != head && len + frame_len <= TELEMETRY_DMA_BUF_SIZE)
+            {
+                len += telemetry_pack_frame(&telemetry.buf[index][len], &telemetry.ring[tail & TELEMETRY_RING_MASK]);
+                tail++;
+                telemetry.stats.frames++;
+                telemetry.stats.bytes += frame_len;
+            }
+
+            TELEMETRY_BARRIER();
+            telemetry.tail = tail;
+            telemetry.buf_len[index] = len;
+
+            if (len == 0)
+                break;
+
+            /* 发送中且缓冲区未满时继续积累, 减少 DMA 启动次数 */
+            uint8_t full = len + frame_len > TELEMETRY_DMA_BUF_SIZE;
+            if (!full && telemetry.tx_active && !flush)
+                break;
+
+            telemetry.buf_state[index] = TELEMETRY_BUF_READY;
+            telemetry.fill_index = index ^ 1;
+            telemetry_kick();
+
+            if (!full)
+                break;
+        }
+    }
+
+    telemetry_kick();
+
+    /* 自动重新布防: 本次捕获已全部打包 */
+    if (state == TELEMETRY_STATE_DONE && telemetry.trigger.auto_rearm && telemetry.head == telemetry.tail &&
+        telemetry.buf_len[telemetry.fill_index] == 0)
+    {
+        telemetry_arm();
+    }
+}
@@ -0,0 +1,169 @@
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#include "stm32g4xx_hal.h"
+
+/**
+ * 二进制遥测 (示波器式数据流)
+ *
+ * 控制中断 (10kHz) 中调用 telemetry_sample(), 每 decimation 个周期把已登记通道的当前值
+ * 写入无锁环形缓冲区 (单生产者 / 单消费者, 中断只写 head, 主循环只写 tail);
+ * 主循环调用 telemetry_poll() 把样本打包成帧, 填入两个 DMA 缓冲区中空闲的一个,
+ * 一个缓冲区发送时另一个可以继续打包, 发送完成中断直接启动已就绪的下一个缓冲区。
+ * 中断与主循环都不会忙等串口。
+ *
+ * 运行方式:
+ *   - 自由运行: 连续输出, 环形缓冲区满时丢弃新样本并计数
+ *   - 触发: 环形缓冲区先循环保存最近 pre 个样本, 指定通道按边沿越过电平后
+ *           再记录 post 个样本, 输出 pre + 1 + post 个连续样本; 可选发送完后自动重新布防
+ *
+ * 帧格式 (每个样本一帧, 多字节均为小端):
+ *   - JustFloat (VOFA+): float × n, float 序号, 帧尾 00 00 80 7F
+ *   - int16: A5 5A | 序号 u16 | 通道数 u8 (bit7 = 触发样本) | int16 × n | 校验 u8
+ *            校验为序号到最后一个数据字节的字节和 (低 8 位)
+ * 序号每个抽取样本加 1 (包括被丢弃的样本), 上位机由序号跳变检测丢帧。
+ */
+
+/* 最大通道数 */
+#ifndef TELEMETRY_MAX_CHANNELS
+#define TELEMETRY_MAX_CHANNELS 8
+#endif
+
+/* 环形缓冲区样本数 (2 的幂), 同时是触发模式下 pre + 1 + post 可保证不丢的上限 */
+#ifndef TELEMETRY_RING_SIZE
+#define TELEMETRY_RING_SIZE 128
+#endif
+
+/* 单个 DMA 缓冲区字节数 (共两个) */
+#ifndef TELEMETRY_DMA_BUF_SIZE
+#define TELEMETRY_DMA_BUF_SIZE 256
+#endif
+
+#define TELEMETRY_RING_MASK (TELEMETRY_RING_SIZE - 1)
+
+/* int16 帧 */
+#define TELEMETRY_INT16_SYNC0 0xA5
+#define TELEMETRY_INT16_SYNC1 0x5A
+#define TELEMETRY_INT16_TRIG_FLAG 0x80
+#define TELEMETRY_INT16_FRAME_LEN(n) (6 + 2 * (n))
+
+/* JustFloat 帧 (含序号通道) */
+#define TELEMETRY_JUSTFLOAT_FRAME_LEN(n) (4 * ((n) + 1) + 4)
+
+/* 角度通道的 int16 比例: 0 ~ 360° -> 0 ~ 32400 */
+#define TELEMETRY_ANGLE_INT16_SCALE 90.0f
+
+/* 帧格式 */
+typedef enum
+{
+    TELEMETRY_FORMAT_JUSTFLOAT = 0,
+    TELEMETRY_FORMAT_INT16,
+} telemetry_format_t;
+
+/* 触发边沿 */
+typedef enum
+{
+    TELEMETRY_EDGE_RISING = 0,
+    TELEMETRY_EDGE_FALLING,
+    TELEMETRY_EDGE_BOTH,
+} telemetry_edge_t;
+
+/* 运行状态 */
+typedef enum
+{
+    TELEMETRY_STATE_IDLE = 0,  /* 未启动 */
+    TELEMETRY_STATE_STREAM,    /* 自由运行 */
+    TELEMETRY_STATE_ARMED,     /* 已布防, 循环记录触发前样本 */
+    TELEMETRY_STATE_TRIGGERED, /* 已触发, 记录触发后样本 */
+    TELEMETRY_STATE_DONE,      /* 一次捕获记录完成, 等待发送完毕 */
+} telemetry_state_t;
+
+/* 触发配置 */
+typedef struct
+{
+    uint8_t channel;       /* 触发通道 */
+    telemetry_edge_t edge; /* 触发边沿 */
+    float level;           /* 触发电平 (通道原始单位) */
+    uint16_t pre;          /* 触发前样本数 (< TELEMETRY_RING_SIZE) */
+    uint16_t post;         /* 触发后样本数 */
+    uint8_t auto_rearm;    /* 捕获发送完毕后自动重新布防 */
+} telemetry_trigger_t;
+
+/* 统计 */
+typedef struct
+{
+    uint32_t samples;   /* 抽取后的样本数 */
+    uint32_t dropped;   /* 环形缓冲区满丢弃的样本数 */
+    uint32_t frames;    /* 已打包的帧数 */
+    uint32_t bytes;     /* 已打包的字节数 */
+    uint32_t triggers;  /* 触发次数 */
+    uint32_t tx_busy;   /* 启动发送时串口被占用 (如 printf) 的次数 */
+} telemetry_stats_t;
+
+/**
+ * 发送接口
+ *
+ * 固件默认使用 USART1 DMA; 主机端测试通过 telemetry_set_transport() 替换为串口模型。
+ * 一次发送完成后, 接口需调用 telemetry_tx_done()。
+ */
+typedef struct
+{
+    void (*init)(void);                                /* 初始化, 可为 NULL */
+    uint8_t (*send)(uint8_t *data, uint16_t size);     /* 启动异步发送, 0: 已启动, 非 0: 忙 */
+} telemetry_transport_t;
+
+/* 替换发送接口, 需在 telemetry_init() 之前调用 */
+void telemetry_set_transport(const telemetry_transport_t *transport);
+
+/* 初始化: 清空通道与配置 (JustFloat, 不抽取, 自由运行), 初始化发送接口 */
+void telemetry_init(void);
+
+/* 清空已登记的通道 (会停止输出) */
+void telemetry_clear_channels(void);
+
+/**
+ * @brief 登记通道
+ * @param src          数据源, 采样时直接读取
+ * @param int16_scale  int16 格式的比例 (int16 = 值 × scale, 饱和)
+ * @return 通道号, 通道已满返回 -1
+ */
+int8_t telemetry_add_channel(const volatile float *src, float int16_scale);
+
+/* 登记角度通道 (rad), 打包时折算到 [0, 360)°, 折算在主循环中完成, 不占用中断时间 */
+int8_t telemetry_add_angle_channel(const volatile float *src);
+
+/**
+ * @brief 设置帧格式与抽取系数, 下次 telemetry_start() 生效
+ * @param decimation 每 decimation 个控制周期采一个样本 (>= 1)
+ */
+void telemetry_config(telemetry_format_t format, uint16_t decimation);
+
+/* 设置触发, NULL 为自由运行; 下次 telemetry_start() 生效 */
+void telemetry_set_trigger(const telemetry_trigger_t *trigger);
+
+/* 开始输出 (自由运行或布防), 清空环形缓冲区, 序号归零 */
+void telemetry_start(void);
+
+/* 停止采样 (已打包的缓冲区继续发送完) */
+void telemetry_stop(void);
+
+telemetry_state_t telemetry_get_state(void);
+void telemetry_get_stats(telemetry_stats_t *stats);
+
+/* 采样, 在控制中断中调用 */
+void telemetry_sample(void);
+
+/*
+ * 抽取相位对齐, 由控制中断的调度器在分配给遥测的周期、telemetry_sample() 之前调用:
+ * 启动后的第一个样本落在该周期, decimation 为调度帧长的整数倍时之后的样本都在该周期, 不与其他慢速任务重叠。
+ * 不调用时按启动时刻计数 (原行为)
+ */
+void telemetry_align(void);
+
+/* 打包并启动发送, 在主循环中调用 */
+void telemetry_poll(void);
+
+/* 发送完成, 由发送接口在中断中调用 */
+void telemetry_tx_done(void);
+
+#endif /* __TELEMETRY_H__ */
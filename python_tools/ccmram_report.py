@@ -0,0 +1,160 @@
+"""
+CCMSRAM 占用报告
+
+解析 GNU ld 生成的 map 文件, 列出 .ccmram (代码 + 有初值数据) 与 .ccmram_bss 中的
+每个输入段 (目标文件) 及其全局符号, 并统计 10KB CCMSRAM 的占用。
+
+用法:
+    python python_tools/ccmram_report.py build/Debug/FOC.map [--size 10240]
+
+EIDE 构建后任务 (.eide/eide.yml afterBuildTasks) 会自动调用。
+占用超出容量, 或某个应在 CCMSRAM 的控制中断函数被放到了 Flash 时返回非零。
+"""
+
+import re
+import sys
+
+CCMRAM_SIZE = 10 * 1024
+OUTPUT_SECTIONS = (".ccmram", ".ccmram_bss")
+
+# 控制中断调用链中应位于 CCMSRAM 的全局函数 (static 函数不出现在 map 中)
+EXPECTED_SYMBOLS = (
+    "ADC1_2_IRQHandler",
+    "clark_transform",
+    "park_transform",
+    "svpwm_update_udc",
+    "pid_calculate",
+    "smo_estimate",
+    "luenberger_estimate",
+)
+
+RE_OUTPUT = re.compile(r"^(\.\S+)(?:\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+))?")
+RE_INPUT = re.compile(r"^ (\.\S+)(?:\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(\S+))?")
+RE_INPUT_CONT = re.compile(r"^\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(\S+)")
+RE_SYMBOL = re.compile(r"^\s+(0x[0-9a-fA-F]+)\s+([A-Za-z_]\w*)\s*$")
+
+
+def parse_map(path):
+    """
+    返回 {输出段名: {"addr", "size", "inputs": [{"name", "addr", "size", "object", "symbols"}]}}
+    以及所有全局符号的地址表
+    """
+    sections = {}
+    symbols = {}
+
+    with open(path, encoding="utf-8", errors="replace") as f:
+        lines = f.read().splitlines()
+
+    # 只解析 "Linker script and memory map" 之后的部分
+    start = 0
+    for i, line in enumerate(lines):
+        if line.startswith("Linker script and memory map"):
+            start = i + 1
+            break
+
+    current = None      # 当前输出段 (仅关心 OUTPUT_SECTIONS)
+    pending_out = None  # 输出段名过长时地址在下一行
+    pending_in = None   # 输入段名过长时地址在下一行
+    last_input = None
+
+    for line in lines[start:]:
+        if pending_out is not None:
+            m = re.match(r"^\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)", line)
+            if m and pending_out in OUTPUT_SECTIONS:
+                sections[pending_out] = {"addr": int(m.group(1), 16), "size": int(m.group(2), 16), "inputs": []}
+                current = pending_out
+            pending_out = None
+            continue
+
+        if pending_in is not None:
+            m = RE_INPUT_CONT.match(line)
+            if m:
+                last_input = {"name": pending_in, "addr": int(m.group(1), 16), "size": int(m.group(2), 16),
+                              "object": m.group(3), "symbols": []}
+                if current:
+                    sections[current]["inputs"].append(last_input)
+            pending_in = None
+            continue
+
+        m = RE_OUTPUT.match(line)
+        if m:
+            name = m.group(1)
+            current = None
+            last_input = None
+            if m.group(2) is None:
+                pending_out = name
+            elif name in OUTPUT_SECTIONS:
+                sections[name] = {"addr": int(m.group(2), 16), "size": int(m.group(3), 16), "inputs": []}
+                current = name
+            continue
+
+        m = RE_INPUT.match(line)
+        if m:
+            if m.group(2) is None:
+                pending_in = m.group(1)
+                continue
+            last_input = {"name": m.group(1), "addr": int(m.group(2), 16), "size": int(m.group(3), 16),
+                          "object": m.group(4), "symbols": []}
+            if current:
+                sections[current]["inputs"].append(last_input)
+            continue
+
+        m = RE_SYMBOL.match(line)
+        if m:
+            symbols[m.group(2)] = int(m.group(1), 16)
+            if current and last_input is not None:
+                last_input["symbols"].append(m.group(2))
+
+    return sections, symbols
+
+
+def main(argv):
+    if len(argv) < 2:
+        print(__doc__)
+        return 2
+
+    path = argv[1]
+    size = CCMRAM_SIZE
+    if "--size" in argv:
+        size = int(argv[argv.index("--size") + 1], 0)
+
+    sections, symbols = parse_map(path)
+    if not sections:
+        print(f"{path}: 未找到 .ccmram 段 (链接脚本未更新或未使用 CCMRAM_* 属性)")
+        return 1
+
+    base = min(s["addr"] for s in sections.values())
+    used = 0
+    print(f"CCMSRAM @ 0x{base:08X} ({path})")
+    for name in OUTPUT_SECTIONS:
+        sec = sections.get(name)
+        if sec is None:
+            continue
+        used += sec["size"]
+        print(f"\n{name}: {sec['size']} 字节")
+        for inp in sec["inputs"]:
+            if inp["size"] == 0:
+                continue
+            obj = inp["object"].replace("\\", "/").split("/")[-1]
+            syms = ", ".join(inp["symbols"])
+            print(f"  0x{inp['addr']:08X} {inp['size']:6d}  {inp['name']:<14} {obj:<24} {syms}")
+
+    print(f"\n合计 {used} / {size} 字节 ({100.0 * used / size:.1f}%)")
+
+    ret = 0
+    if used > size:
+        print("错误: CCMSRAM 溢出")
+        ret = 1
+
+    # 检查调用链中的关键函数确实在 CCMSRAM (0x10000000 起), 未链接的函数忽略
+    for sym in EXPECTED_SYMBOLS:
+        addr = symbols.get(sym)
+        if addr is not None and not (base <= addr < base + size):
+            print(f"警告: {sym} 位于 0x{addr:08X}, 不在 CCMSRAM")
+            ret = 1
+
+    return ret
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
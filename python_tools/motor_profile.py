@@ -0,0 +1,188 @@
+"""
+电机参数配置生成
+
+读取 motor_profiles.json 中的电机描述, 生成 User/foc/motor_profile.h:
+- 电机参数 (Rs、Ld / Lq、磁链、极对数) 与控制周期;
+- 离散观测器系数 (1 - Rs·Ts/Ls, Ts/Ls) 与 Luenberger 增益 (ST 方法, 见 luenberger_calulate.py);
+- PLL 增益 (临界阻尼, ki 已乘 Ts);
+- 电流环 PI 增益, 按带宽 ωc 零极点对消: kp = L·ωc, ki = Rs·ωc·Ts (pid_calculate 内部不乘 Ts),
+  配置了 current_pi 时使用实测整定值;
+- 转速换算的倒数常量, 控制中断中只做乘法。
+
+每个配置生成一组 MOTOR_* 宏, 编译时用 MOTOR_PROFILE 选择 (默认 motor_profiles.json 中的 default)。
+json 中的 ts 为 PWM 周期; 编译选项 PWM_DOUBLE_UPDATE=1 (峰值、谷底各更新一次) 时控制周期为 ts / 2,
+与控制周期有关的常量按两种周期各生成一份, 由 PWM_DOUBLE_UPDATE 选择。
+
+用法:
+    python python_tools/motor_profile.py            重新生成头文件
+    python python_tools/motor_profile.py --check    头文件与 json 不一致时返回非零 (EIDE 构建前任务)
+"""
+
+import json
+import math
+import os
+import sys
+
+from luenberger_calulate import calculate_st_gains
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+PROFILES_JSON = os.path.join(ROOT, "python_tools", "motor_profiles.json")
+OUTPUT_HEADER = os.path.join(ROOT, "User", "foc", "motor_profile.h")
+
+
+def c_float(x):
+    """浮点常量, 9 位有效数字保证 float 精确往返"""
+    s = f"{x:.9g}"
+    if "e" not in s and "." not in s:
+        s += ".0"
+    return s + "f"
+
+
+def derive(p, ts, pwm_ts):
+    """由电机描述计算全部常量 (ts 为控制周期), 返回 [(宏名, 值, 注释)]"""
+    rs, ld, lq, flux = p["rs"], p["ld"], p["lq"], p["flux"]
+    poles = int(p["pole_pairs"])
+    ls = 0.5 * (ld + lq)
+
+    l1, l2 = calculate_st_gains(rs, ls, ts, p["observer_f"])
+
+    wn = 2.0 * math.pi * p["pll_fc"]
+    pll_kp = 2.0 * wn
+    pll_ki = wn * wn * ts
+
+    wc = 2.0 * math.pi * p["current_bw_hz"]
+    if "current_pi" in p:
+        # 实测 ki 按 PWM 周期整定, 控制周期变化时按周期缩放
+        cur_kp, cur_ki = p["current_pi"]["kp"], p["current_pi"]["ki"] * ts / pwm_ts
+        cur_note = "实测整定值"
+    else:
+        cur_kp, cur_ki = ls * wc, rs * wc * ts
+        cur_note = f"带宽 {p['current_bw_hz']:g} Hz"
+
+    rpm_to_rad_s = 2.0 * math.pi * poles / 60.0
+
+    return [
+        ("MOTOR_PROFILE_NAME", f"\"{p['name']}\"", p["desc"]),
+        ("MOTOR_RS", c_float(rs), "定子电阻 (Ω)"),
+        ("MOTOR_LD", c_float(ld), "D 轴电感 (H)"),
+        ("MOTOR_LQ", c_float(lq), "Q 轴电感 (H)"),
+        ("MOTOR_LS", c_float(ls), "观测器使用的平均电感 (H)"),
+        ("MOTOR_FLUX", c_float(flux), "永磁体磁链 (Wb)"),
+        ("MOTOR_POLE_PAIRS", str(poles), "极对数"),
+        ("MOTOR_TS", c_float(ts), "控制周期 (s)"),
+        ("MOTOR_OBS_F", c_float(1.0 - rs * ts / ls), "离散电流模型 i(k+1) = F·i(k) + G·(u - e)"),
+        ("MOTOR_OBS_G", c_float(ts / ls), ""),
+        ("MOTOR_LUENBERGER_L1", c_float(l1), f"Luenberger 增益, 极点系数 f = {p['observer_f']:g}"),
+        ("MOTOR_LUENBERGER_L2", c_float(l2), ""),
+        ("MOTOR_PLL_FC", c_float(p["pll_fc"]), "PLL 带宽 (Hz)"),
+        ("MOTOR_PLL_KP", c_float(pll_kp), "PLL 增益, ζ = 1, ki 已乘 Ts"),
+        ("MOTOR_PLL_KI", c_float(pll_ki), ""),
+        ("MOTOR_CURRENT_KP", c_float(cur_kp), f"电流环 PI ({cur_note}), ki 已乘 Ts"),
+        ("MOTOR_CURRENT_KI", c_float(cur_ki), ""),
+        ("MOTOR_RPM_TO_RAD_S", c_float(rpm_to_rad_s), "机械转速 (RPM) -> 电角速度 (rad/s)"),
+        ("MOTOR_RAD_S_TO_RPM", c_float(1.0 / rpm_to_rad_s), "电角速度 (rad/s) -> 机械转速 (RPM)"),
+        ("MOTOR_RPM_TO_DELTA_ANGLE", c_float(rpm_to_rad_s * ts), "机械转速 (RPM) -> 每周期电角度增量 (rad)"),
+    ]
+
+
+def emit_rows(out, rows):
+    width = max(len(m) + len(v) for m, v, _ in rows) + 1
+    for macro, value, note in rows:
+        line = f"#define {macro} {value}"
+        if note:
+            line = f"{line:<{width + 8}} /* {note} */"
+        out.append(line.rstrip())
+
+
+def generate(cfg):
+    ts = cfg["ts"]
+    names = list(cfg["profiles"])
+    if cfg["default"] not in names:
+        raise ValueError(f"default 配置 {cfg['default']} 不存在")
+
+    out = []
+    out.append("/**")
+    out.append(" * @file motor_profile.h")
+    out.append(" * @brief 电机参数配置 (由 python_tools/motor_profile.py 根据 motor_profiles.json 生成, 请勿手工修改)")
+    out.append(" *")
+    out.append(" * 编译选项中定义 MOTOR_PROFILE=MOTOR_PROFILE_<名称> 选择电机, 未定义时使用默认配置。")
+    out.append(" * 所有常量在生成时算好, 控制中断中只需乘法。")
+    out.append(" */")
+    out.append("")
+    out.append("#ifndef __MOTOR_PROFILE_H__")
+    out.append("#define __MOTOR_PROFILE_H__")
+    out.append("")
+    for i, name in enumerate(names):
+        out.append(f"#define MOTOR_PROFILE_{name} {i}")
+    out.append("")
+    out.append("#ifndef MOTOR_PROFILE")
+    out.append(f"#define MOTOR_PROFILE MOTOR_PROFILE_{cfg['default']}")
+    out.append("#endif")
+    out.append("")
+    out.append("/* PWM 周期; PWM_DOUBLE_UPDATE=1 时峰值与谷底各有一次更新事件 (采样 + 控制中断), 控制周期减半 */")
+    out.append("#ifndef PWM_DOUBLE_UPDATE")
+    out.append("#define PWM_DOUBLE_UPDATE 0")
+    out.append("#endif")
+    out.append("")
+    emit_rows(out, [
+        ("MOTOR_PWM_TS", c_float(ts), "PWM 周期 (s)"),
+        ("MOTOR_PWM_FREQ", f"{round(1.0 / ts)}U", "PWM 频率 (Hz)"),
+    ])
+    out.append("#if PWM_DOUBLE_UPDATE")
+    out.append("#define MOTOR_CTRL_PER_PWM 2U /* 每个 PWM 周期的控制周期数 */")
+    out.append("#else")
+    out.append("#define MOTOR_CTRL_PER_PWM 1U")
+    out.append("#endif")
+    out.append("#define MOTOR_CTRL_FREQ (MOTOR_PWM_FREQ * MOTOR_CTRL_PER_PWM) /* 控制频率 (Hz) */")
+
+    for i, name in enumerate(names):
+        p = dict(cfg["profiles"][name], name=name)
+        out.append("")
+        out.append(f"{'#if' if i == 0 else '#elif'} MOTOR_PROFILE == MOTOR_PROFILE_{name}")
+        out.append("")
+        single = derive(p, ts, ts)
+        double = derive(p, 0.5 * ts, ts)
+
+        # 与控制周期无关的常量只生成一份, 其余按 PWM_DOUBLE_UPDATE 分两份
+        common = [r for r, d in zip(single, double) if r[1] == d[1]]
+        emit_rows(out, common)
+        out.append("#if PWM_DOUBLE_UPDATE")
+        emit_rows(out, [d for r, d in zip(single, double) if r[1] != d[1]])
+        out.append("#else")
+        emit_rows(out, [r for r, d in zip(single, double) if r[1] != d[1]])
+        out.append("#endif")
+
+    out.append("")
+    out.append("#else")
+    out.append("#error \"MOTOR_PROFILE: 未知的电机配置\"")
+    out.append("#endif")
+    out.append("")
+    out.append("#endif /* __MOTOR_PROFILE_H__ */")
+    out.append("")
+    return "\n".join(out)
+
+
+def main(argv):
+    with open(PROFILES_JSON, encoding="utf-8") as f:
+        cfg = json.load(f)
+    text = generate(cfg)
+
+    if "--check" in argv:
+        try:
+            with open(OUTPUT_HEADER, encoding="utf-8") as f:
+                current = f.read()
+        except FileNotFoundError:
+            current = ""
+        if current != text:
+            print(f"{OUTPUT_HEADER} 与 {PROFILES_JSON} 不一致, 请运行 python python_tools/motor_profile.py")
+            return 1
+        return 0
+
+    with open(OUTPUT_HEADER, "w", encoding="utf-8", newline="\n") as f:
+        f.write(text)
+    print(f"已生成 {OUTPUT_HEADER} ({len(cfg['profiles'])} 个配置, 默认 {cfg['default']})")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
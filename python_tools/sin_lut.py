@@ -0,0 +1,90 @@
+"""
+正弦查表生成
+
+生成 User/utils/sin_lut.h: 1/4 周期 [0, π/2] 的正弦表, 供 fast_sin_cos.h 的查表后端使用。
+表长 N = 2^bits 个区间, 两端各多存一点 (sin(-h) 与 sin(π/2 + h)), 线性插值与以最近点为中心的
+二次插值都不需要边界判断。每种 bits 生成一张表, 编译时由 FAST_SIN_LUT_BITS 选择。
+
+误差 (h = π/2 / N):
+- 线性插值: h² / 8
+- 二次插值: h³ / 16 (t ∈ [-0.5, 0.5])
+
+用法:
+    python python_tools/sin_lut.py
+"""
+
+import math
+import os
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+OUTPUT_HEADER = os.path.join(ROOT, "User", "utils", "sin_lut.h")
+
+LUT_BITS = (6, 7, 8)
+DEFAULT_BITS = 7
+PER_LINE = 8
+
+
+def c_float(x):
+    """浮点常量, 9 位有效数字保证 float 精确往返"""
+    s = f"{x:.9g}"
+    if "e" not in s and "." not in s:
+        s += ".0"
+    return s + "f"
+
+
+def table(bits):
+    n = 1 << bits
+    h = 0.5 * math.pi / n
+    return [math.sin(k * h) for k in range(-1, n + 2)]
+
+
+def generate():
+    out = []
+    out.append("/**")
+    out.append(" * @file sin_lut.h")
+    out.append(" * @brief 1/4 周期正弦表 (由 python_tools/sin_lut.py 生成, 请勿手工修改)")
+    out.append(" *")
+    out.append(" * SIN_LUT[k + 1] = sin(k·h), h = (π/2) / SIN_LUT_N, k = -1 ... SIN_LUT_N + 1。")
+    out.append(" * 编译选项中定义 FAST_SIN_LUT_BITS 选择表长, 只被查表后端引用。")
+    out.append(" */")
+    out.append("")
+    out.append("#ifndef __SIN_LUT_H__")
+    out.append("#define __SIN_LUT_H__")
+    out.append("")
+    out.append("#ifndef FAST_SIN_LUT_BITS")
+    out.append(f"#define FAST_SIN_LUT_BITS {DEFAULT_BITS}")
+    out.append("#endif")
+
+    for i, bits in enumerate(LUT_BITS):
+        n = 1 << bits
+        h = 0.5 * math.pi / n
+        values = table(bits)
+        out.append("")
+        out.append(f"{'#if' if i == 0 else '#elif'} FAST_SIN_LUT_BITS == {bits}")
+        out.append("")
+        out.append(f"/* {n} 区间, 线性插值误差 {h * h / 8:.1e}, 二次插值误差 {h ** 3 / 16:.1e} */")
+        out.append(f"static const float SIN_LUT[{n} + 3] = {{")
+        for k in range(0, len(values), PER_LINE):
+            out.append("    " + ", ".join(c_float(v) for v in values[k:k + PER_LINE]) + ",")
+        out.append("};")
+
+    out.append("")
+    out.append("#else")
+    out.append(f"#error \"FAST_SIN_LUT_BITS: 只生成了 {' / '.join(str(b) for b in LUT_BITS)} 位的表\"")
+    out.append("#endif")
+    out.append("")
+    out.append("#define SIN_LUT_N (1UL << FAST_SIN_LUT_BITS)")
+    out.append("")
+    out.append("#endif /* __SIN_LUT_H__ */")
+    out.append("")
+    return "\n".join(out)
+
+
+def main():
+    with open(OUTPUT_HEADER, "w", encoding="utf-8", newline="\n") as f:
+        f.write(generate())
+    print(f"已生成 {OUTPUT_HEADER} ({' / '.join(str(b) for b in LUT_BITS)} 位, 默认 {DEFAULT_BITS})")
+
+
+if __name__ == "__main__":
+    main()